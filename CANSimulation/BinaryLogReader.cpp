@@ -0,0 +1,87 @@
+#include "BinaryLogReader.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <QByteArray>
+
+#include "BinaryLogWriter.h"
+
+static const uint32_t MAX_BLOCK_SIZE = 64 * 1024 * 1024;    // far above any block the writer makes
+
+static uint32_t readUint32(const char* bytes)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = value << 8 | static_cast<uint8_t>(bytes[i]);
+    }
+    return value;
+}
+
+BinaryLogReader::BinaryLogReader(const std::string& path)
+    : path(path), file(path, std::ios::binary), position(0), blockRecords(0), truncated(false), blockCount(0), compressedBytes(0)
+{
+    if (!file.is_open()) {
+        throw std::invalid_argument("Cannot open file: " + path);
+    }
+
+    char magic[sizeof(BinaryLogWriter::MAGIC)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, BinaryLogWriter::MAGIC, sizeof(magic)) != 0) {
+        throw std::invalid_argument("Not a binary log: " + path);
+    }
+}
+
+bool BinaryLogReader::next(LogRecord& record)
+{
+    while (blockRecords == 0) {
+        if (!readBlock()) {
+            return false;
+        }
+    }
+
+    const char* p = block.data() + position;
+    if (!LogRecord::decode(p, block.data() + block.size(), record)) {
+        throw std::invalid_argument("Corrupt record in block " + std::to_string(blockCount) + " of " + path);
+    }
+
+    position = p - block.data();
+    --blockRecords;
+    return true;
+}
+
+bool BinaryLogReader::readBlock()
+{
+    char header[8];
+    file.read(header, sizeof(header));
+    if (file.gcount() == 0) {
+        return false;
+    }
+    if (file.gcount() < static_cast<std::streamsize>(sizeof(header))) {
+        truncated = true;
+        return false;
+    }
+
+    uint32_t size = readUint32(header);
+    if (size > MAX_BLOCK_SIZE) {
+        throw std::invalid_argument("Corrupt block " + std::to_string(blockCount + 1) + " of " + path);
+    }
+
+    std::vector<char> compressed(size);
+    if (!file.read(compressed.data(), size)) {
+        truncated = true;
+        return false;
+    }
+
+    QByteArray raw = qUncompress(reinterpret_cast<const uchar*>(compressed.data()), static_cast<qsizetype>(size));
+    if (raw.isEmpty()) {
+        throw std::invalid_argument("Corrupt block " + std::to_string(blockCount + 1) + " of " + path);
+    }
+
+    block.assign(raw.constData(), raw.size());
+    position = 0;
+    blockRecords = readUint32(header + 4);
+    ++blockCount;
+    compressedBytes += sizeof(header) + size;
+    return true;
+}
\ No newline at end of file
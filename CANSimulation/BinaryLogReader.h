@@ -0,0 +1,36 @@
+#ifndef BINARY_LOG_READER_H
+#define BINARY_LOG_READER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "LogRecord.h"
+
+// Reads the records of a file written by BinaryLogWriter, one block in memory at a time.
+// A block cut short, as the last one of a file still being written may be, ends the
+// records without an error.
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(const std::string& path);
+
+    bool next(LogRecord& record);
+
+    bool isTruncated() const { return truncated; }
+    uint64_t getBlockCount() const { return blockCount; }
+    uint64_t getCompressedBytes() const { return compressedBytes; }
+
+private:
+    bool readBlock();
+
+    std::string path;
+    std::ifstream file;
+    std::string block;
+    size_t position;
+    uint32_t blockRecords;          // records left in the current block
+    bool truncated;
+    uint64_t blockCount;
+    uint64_t compressedBytes;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "BinaryLogWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include <QByteArray>
+
+static const size_t BLOCK_SIZE = 256 * 1024;       // encoded bytes compressed together
+static const size_t STAMP_LENGTH = 19;             // "-YYYYMMDD-HHMMSS-NN" between base name and extension
+
+static void appendUint32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+BinaryLogWriter::BinaryLogWriter(const Settings& settings)
+    : settings(settings), fileSize(0), blockRecords(0)
+{
+    openFile();
+    if (!file.is_open()) {
+        throw std::invalid_argument("Cannot open binary log: " + currentPath);
+    }
+}
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    flush();
+}
+
+void BinaryLogWriter::write(const LogRecord& record)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (fileSize >= settings.maxFileSize || std::chrono::steady_clock::now() - fileStart >= settings.maxFileAge) {
+        writeBlock();
+        openFile();
+        removeOldFiles();
+    }
+
+    record.encode(block);
+    ++blockRecords;
+
+    if (block.size() >= BLOCK_SIZE) {
+        writeBlock();
+    }
+}
+
+void BinaryLogWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    writeBlock();
+    file.flush();
+}
+
+std::string BinaryLogWriter::getCurrentPath() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return currentPath;
+}
+
+void BinaryLogWriter::openFile()
+{
+    file.close();
+
+    std::time_t now = std::time(nullptr);
+    struct tm localTime = {};
+    localtime_s(&localTime, &now);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &localTime);
+
+    // Files started within the same second are numbered so they still sort by age
+    for (int sequence = 0; sequence < 100; ++sequence) {
+        char suffix[8];
+        std::snprintf(suffix, sizeof(suffix), "-%02d", sequence);
+        currentPath = settings.basePath + "-" + stamp + suffix + EXTENSION;
+        if (!std::filesystem::exists(currentPath)) {
+            break;
+        }
+    }
+
+    // Records are dropped like text lines are when the file cannot be opened
+    file.open(currentPath, std::ios::binary | std::ios::trunc);
+    file.write(MAGIC, sizeof(MAGIC));
+    fileSize = sizeof(MAGIC);
+    fileStart = std::chrono::steady_clock::now();
+}
+
+void BinaryLogWriter::writeBlock()
+{
+    if (blockRecords == 0) {
+        return;
+    }
+
+    QByteArray compressed = qCompress(reinterpret_cast<const uchar*>(block.data()), static_cast<qsizetype>(block.size()));
+
+    std::string header;
+    appendUint32(header, static_cast<uint32_t>(compressed.size()));
+    appendUint32(header, blockRecords);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(compressed.constData(), compressed.size());
+    fileSize += header.size() + compressed.size();
+
+    block.clear();
+    blockRecords = 0;
+}
+
+void BinaryLogWriter::removeOldFiles()
+{
+    if (settings.maxFiles <= 0) {
+        return;
+    }
+
+    std::filesystem::path base(settings.basePath);
+    std::filesystem::path directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+    std::string prefix = base.filename().string() + "-";
+    std::string extension = EXTENSION;
+
+    std::error_code error;
+    std::vector<std::filesystem::path> logs;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (entry.is_regular_file(error) && name.size() == prefix.size() - 1 + STAMP_LENGTH + extension.size() &&
+            name.compare(0, prefix.size(), prefix) == 0 && name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+            logs.push_back(entry.path());
+        }
+    }
+
+    if (logs.size() <= static_cast<size_t>(settings.maxFiles)) {
+        return;
+    }
+
+    // The time stamps in the names sort oldest first
+    std::sort(logs.begin(), logs.end());
+    for (size_t i = 0; i + settings.maxFiles < logs.size(); ++i) {
+        std::filesystem::remove(logs[i], error);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef BINARY_LOG_WRITER_H
+#define BINARY_LOG_WRITER_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "LogRecord.h"
+
+// Writes log records in binary, compressed a block at a time, in place of the text log.
+// A new file is started when the current one reaches maxFileSize or maxFileAge, and only
+// the newest maxFiles files of the base name are kept. Each block decodes on its own, so a
+// run that stops abruptly loses at most the records of its last block.
+class BinaryLogWriter {
+public:
+    static constexpr const char* EXTENSION = ".canlog";
+    static constexpr char MAGIC[8] = { 'C', 'A', 'N', 'L', 'O', 'G', '1', '\n' };
+
+    struct Settings {
+        std::string basePath = "log";       // files are named <basePath>-<start time>.canlog
+        uint64_t maxFileSize = 64 * 1024 * 1024;
+        std::chrono::minutes maxFileAge = std::chrono::minutes(60);
+        int maxFiles = 48;                  // 0 keeps every file
+    };
+
+    explicit BinaryLogWriter(const Settings& settings);
+    ~BinaryLogWriter();
+
+    void write(const LogRecord& record);
+    // Writes the records held back for the current block
+    void flush();
+
+    std::string getCurrentPath() const;
+
+private:
+    void openFile();
+    void writeBlock();
+    void removeOldFiles();
+
+    Settings settings;
+    mutable std::mutex mutex;
+    std::ofstream file;
+    std::string currentPath;
+    uint64_t fileSize;
+    std::chrono::steady_clock::time_point fileStart;
+    std::string block;
+    uint32_t blockRecords;
+};
+
+#endif
\ No newline at end of file
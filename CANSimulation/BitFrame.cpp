@@ -0,0 +1,195 @@
+#include "BitFrame.h"
+
+#include <algorithm>
+
+#include "ErrorCheck.h"
+
+// SOF, 11 bit identifier, RTR, IDE, r0 and the 4 bit DLC
+static const size_t HEADER_BITS = 19;
+static const size_t CRC_BITS = 15;
+static const size_t EOF_BITS = 7;
+
+static void appendBits(std::vector<uint8_t>& bits, uint32_t value, int width)
+{
+    for (int i = width - 1; i >= 0; --i) {
+        bits.push_back((value >> i) & 1);
+    }
+}
+
+EncodedFrame encodeFrame(uint16_t id, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> raw;
+    raw.push_back(0);                               // SOF
+    appendBits(raw, id, 11);
+    raw.push_back(0);                               // RTR
+    raw.push_back(0);                               // IDE
+    raw.push_back(0);                               // r0
+    appendBits(raw, static_cast<uint32_t>(data.size()), 4);
+    for (uint8_t byte : data) {
+        appendBits(raw, byte, 8);
+    }
+
+    ErrorCheck errorCheck;
+    appendBits(raw, errorCheck.calculateCRC15(raw, raw.size()), CRC_BITS);
+
+    EncodedFrame frame;
+    frame.arbitrationEnd = 0;
+
+    int consecutiveBits = 0;
+    uint8_t lastBit = 2;
+
+    for (size_t i = 0; i < raw.size(); ++i) {
+        uint8_t bit = raw[i];
+        frame.bits.push_back(bit);
+        frame.stuffBit.push_back(false);
+
+        if (i == 12) {
+            frame.arbitrationEnd = frame.bits.size() - 1;
+        }
+
+        if (bit == lastBit) {
+            ++consecutiveBits;
+        }
+        else {
+            consecutiveBits = 1;
+        }
+        lastBit = bit;
+
+        if (consecutiveBits == 5) {
+            lastBit = bit ^ 1;
+            frame.bits.push_back(lastBit);
+            frame.stuffBit.push_back(true);
+            consecutiveBits = 1;
+        }
+    }
+
+    frame.crcDelimiter = frame.bits.size();
+    frame.ackSlot = frame.crcDelimiter + 1;
+    frame.ackDelimiter = frame.crcDelimiter + 2;
+
+    // CRC delimiter, ACK slot (sent recessive), ACK delimiter and EOF
+    for (size_t i = 0; i < 3 + EOF_BITS; ++i) {
+        frame.bits.push_back(1);
+        frame.stuffBit.push_back(false);
+    }
+
+    return frame;
+}
+
+void FrameDecoder::start()
+{
+    phase = Stuffed;
+    bits.clear();
+    expectedBits = HEADER_BITS;
+    lastBit = 2;
+    run = 0;
+    dataLength = 0;
+    endOfFrameBits = 0;
+    crcValid = false;
+}
+
+FrameDecoder::Result FrameDecoder::fail(BusErrorType type)
+{
+    error = type;
+    return Error;
+}
+
+void FrameDecoder::checkCrc()
+{
+    size_t payloadBits = bits.size() - CRC_BITS;
+
+    uint16_t received = 0;
+    for (size_t i = payloadBits; i < bits.size(); ++i) {
+        received = (received << 1) | bits[i];
+    }
+
+    ErrorCheck errorCheck;
+    crcValid = errorCheck.calculateCRC15(bits, payloadBits) == received;
+}
+
+FrameDecoder::Result FrameDecoder::feed(uint8_t bit)
+{
+    switch (phase) {
+    case Stuffed:
+        if (run == 5) {
+            if (bit == lastBit) {
+                return fail(BusErrorType::Stuff);
+            }
+
+            lastBit = bit;
+            run = 1;
+            if (bits.size() == expectedBits) {
+                phase = CrcDelimiter;
+            }
+            return Continue;
+        }
+
+        if (bit == lastBit) {
+            ++run;
+        }
+        else {
+            lastBit = bit;
+            run = 1;
+        }
+        bits.push_back(bit);
+
+        if (bits.size() == HEADER_BITS) {
+            int dlc = 0;
+            for (size_t i = HEADER_BITS - 4; i < HEADER_BITS; ++i) {
+                dlc = (dlc << 1) | bits[i];
+            }
+            dataLength = std::min(dlc, 8);
+            expectedBits = HEADER_BITS + 8 * dataLength + CRC_BITS;
+        }
+
+        if (bits.size() == expectedBits) {
+            checkCrc();
+            if (run < 5) {
+                phase = CrcDelimiter;
+            }
+        }
+        return Continue;
+
+    case CrcDelimiter:
+        if (bit == 0) {
+            return fail(BusErrorType::Form);
+        }
+        phase = AckSlot;
+        return Continue;
+
+    case AckSlot:
+        phase = AckDelimiter;
+        return Continue;
+
+    case AckDelimiter:
+        if (bit == 0) {
+            return fail(BusErrorType::Form);
+        }
+        // A CRC error is signalled with the bit following the ACK delimiter
+        if (!crcValid) {
+            return fail(BusErrorType::CRC);
+        }
+        phase = EndOfFrame;
+        return Continue;
+
+    case EndOfFrame:
+        if (bit == 0 && endOfFrameBits < static_cast<int>(EOF_BITS) - 1) {
+            return fail(BusErrorType::Form);
+        }
+        if (++endOfFrameBits == static_cast<int>(EOF_BITS)) {
+            return Complete;
+        }
+        return Continue;
+    }
+
+    return Continue;
+}
+
+uint16_t FrameDecoder::getId() const
+{
+    uint16_t id = 0;
+    for (size_t i = 1; i < 12 && i < bits.size(); ++i) {
+        id = (id << 1) | bits[i];
+    }
+    return id;
+}
\ No newline at end of file
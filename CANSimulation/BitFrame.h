@@ -0,0 +1,56 @@
+#ifndef BIT_FRAME_H
+#define BIT_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class BusErrorType { Bit, Stuff, Form, CRC, ACK };
+
+const int BUS_ERROR_TYPES = 5;
+
+// A base format data frame as it appears on the wire, SOF through the last EOF bit
+struct EncodedFrame {
+    std::vector<uint8_t> bits;
+    std::vector<bool> stuffBit;
+    size_t arbitrationEnd;      // index of the RTR bit
+    size_t crcDelimiter;
+    size_t ackSlot;
+    size_t ackDelimiter;
+};
+
+EncodedFrame encodeFrame(uint16_t id, const std::vector<uint8_t>& data);
+
+// Follows one frame on the bus from the receiver side: destuffs, tracks fields and
+// reports stuff, form and CRC errors at the bit where ISO 11898 detects them
+class FrameDecoder {
+public:
+    enum Result { Continue, Error, Complete };
+
+    void start();
+    Result feed(uint8_t bit);
+
+    bool atAckSlot() const { return phase == AckSlot; }
+    bool isCrcValid() const { return crcValid; }
+    BusErrorType getError() const { return error; }
+    uint16_t getId() const;
+    int getDataLength() const { return dataLength; }
+
+private:
+    enum Phase { Stuffed, CrcDelimiter, AckSlot, AckDelimiter, EndOfFrame };
+
+    Result fail(BusErrorType type);
+    void checkCrc();
+
+    Phase phase = Stuffed;
+    std::vector<uint8_t> bits;
+    size_t expectedBits = 0;
+    uint8_t lastBit = 2;
+    int run = 0;
+    int dataLength = 0;
+    int endOfFrameBits = 0;
+    bool crcValid = false;
+    BusErrorType error = BusErrorType::Bit;
+};
+
+#endif
\ No newline at end of file
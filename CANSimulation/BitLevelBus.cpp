@@ -0,0 +1,456 @@
+#include "BitLevelBus.h"
+
+#include <algorithm>
+
+BitLevelBus::BitLevelBus(int nodeCount, uint64_t seed)
+    : nodes(nodeCount), generator(seed)
+{
+}
+
+void BitLevelBus::setFaultProfile(int node, const FaultProfile& profile)
+{
+    nodes[node].faults = profile;
+}
+
+void BitLevelBus::queueFrame(int node, uint16_t id, const std::vector<uint8_t>& data, uint64_t releaseTime)
+{
+    std::deque<QueuedFrame>& queue = nodes[node].queue;
+    QueuedFrame frame{ id, data, releaseTime };
+
+    if (queue.empty() || queue.back().releaseTime <= releaseTime) {
+        queue.push_back(frame);
+        return;
+    }
+
+    auto it = std::upper_bound(queue.begin(), queue.end(), releaseTime,
+        [](uint64_t time, const QueuedFrame& queued) { return time < queued.releaseTime; });
+    queue.insert(it, frame);
+}
+
+void BitLevelBus::setScheduler(PeriodicScheduler* periodicScheduler, uint32_t rate)
+{
+    scheduler = periodicScheduler;
+    bitRate = rate;
+}
+
+void BitLevelBus::pollScheduler()
+{
+    // The scheduler counts microseconds, the bus counts bit times
+    uint64_t microseconds = now * 1000000 / bitRate;
+    if (scheduler->nextReleaseTime() > microseconds) {
+        return;
+    }
+
+    releases.clear();
+    scheduler->releaseUntil(microseconds, releases);
+
+    for (const PeriodicScheduler::Release& release : releases) {
+        uint64_t releaseTime = (release.time * bitRate + 999999) / 1000000;
+        queueFrame(release.node, release.id, scheduler->getMessage(release.stream).data, releaseTime);
+    }
+}
+
+void BitLevelBus::setMailboxes(int node, int mailboxCount, TransmitQueue::Order order)
+{
+    nodes[node].transmit.configure(mailboxCount, order);
+}
+
+void BitLevelBus::submitReleased(NodeRuntime& node)
+{
+    while (!node.queue.empty() && node.queue.front().releaseTime <= now) {
+        uint64_t key = node.submittedFrames++;
+        node.submitted[key] = node.queue.front();
+        node.transmit.push(node.queue.front().id, key, now);
+        node.queue.pop_front();
+    }
+}
+
+bool BitLevelBus::chance(double probability)
+{
+    return probability > 0.0 && uniform(generator) < probability;
+}
+
+void BitLevelBus::run(uint64_t bitTimes)
+{
+    for (uint64_t i = 0; i < bitTimes; ++i) {
+        step();
+    }
+}
+
+void BitLevelBus::step()
+{
+    if (scheduler) {
+        pollScheduler();
+    }
+
+    std::vector<uint8_t> driven(nodes.size());
+    uint8_t bus = 1;
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        submitReleased(nodes[i]);
+        driven[i] = drive(nodes[i]);
+        bus &= driven[i];
+    }
+
+    bool transmitterOnBus = false;
+    bool errorOnBus = false;
+    for (const NodeRuntime& node : nodes) {
+        transmitterOnBus |= node.mode == Mode::Transmitting;
+        errorOnBus |= node.mode == Mode::ErrorFlag || node.mode == Mode::ErrorDelimiterWait || node.mode == Mode::ErrorDelimiter;
+    }
+
+    busStatistics.bitTimes++;
+    if (counters) {
+        counters->addBusTime(1);
+    }
+    if (transmitterOnBus) {
+        busStatistics.frameBits++;
+    }
+    else if (errorOnBus) {
+        busStatistics.errorBits++;
+    }
+    if (trace) {
+        trace->append(driven, bus, transmitterOnBus, errorOnBus);
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        NodeRuntime& node = nodes[i];
+
+        uint8_t level = bus;
+        if (node.mode != Mode::BusOff && chance(node.faults.receiveBitErrorRate)) {
+            level ^= 1;
+        }
+
+        sample(node, level);
+    }
+
+    ++now;
+}
+
+uint8_t BitLevelBus::drive(NodeRuntime& node)
+{
+    uint8_t bit = 1;
+
+    switch (node.mode) {
+    case Mode::Idle: {
+        TransmitQueue::Frame next;
+        if (!node.transmit.next(next)) {
+            return 1;
+        }
+
+        node.activeKey = next.key;
+        node.frame = encodeFrame(next.id, activeFrame(node).data);
+        node.position = 0;
+        node.attemptStart = now;
+        node.transmitter = true;
+        node.mode = Mode::Transmitting;
+        node.decoder.start();
+        bit = node.frame.bits[0];
+        break;
+    }
+
+    case Mode::Transmitting:
+        bit = (node.position == node.frame.ackSlot) ? 1 : node.frame.bits[node.position];
+        break;
+
+    case Mode::Receiving:
+        return (node.decoder.atAckSlot() && node.decoder.isCrcValid() && !node.faults.ackDisabled) ? 0 : 1;
+
+    case Mode::ErrorFlag:
+        return node.activeFlag ? 0 : 1;
+
+    default:
+        return 1;
+    }
+
+    if (chance(node.faults.transmitBitErrorRate)) {
+        bit ^= 1;
+    }
+    return bit;
+}
+
+void BitLevelBus::sample(NodeRuntime& node, uint8_t level)
+{
+    switch (node.mode) {
+    case Mode::Idle:
+        if (level == 0) {
+            startReceiving(node, level);
+        }
+        break;
+
+    case Mode::Suspend:
+        if (level == 0) {
+            startReceiving(node, level);
+        }
+        else if (--node.counter == 0) {
+            node.mode = Mode::Idle;
+        }
+        break;
+
+    case Mode::Intermission:
+        if (level == 0) {
+            startReceiving(node, level);
+        }
+        else if (--node.counter == 0) {
+            node.mode = node.suspendAfterIntermission ? Mode::Suspend : Mode::Idle;
+            node.counter = 8;
+            node.suspendAfterIntermission = false;
+        }
+        break;
+
+    case Mode::Transmitting:
+        sampleTransmitter(node, level);
+        break;
+
+    case Mode::Receiving:
+        switch (node.decoder.feed(level)) {
+        case FrameDecoder::Error:
+            detectError(node, node.decoder.getError());
+            break;
+        case FrameDecoder::Complete:
+            node.confinement.receiveSuccess();
+            node.statistics.framesReceived++;
+            if (counters) {
+                counters->addReception(indexOf(node));
+            }
+            node.mode = Mode::Intermission;
+            node.counter = 3;
+            break;
+        default:
+            break;
+        }
+        break;
+
+    case Mode::ErrorFlag:
+        sampleErrorFlag(node, level);
+        break;
+
+    case Mode::ErrorDelimiterWait:
+        sampleDelimiterWait(node, level);
+        break;
+
+    case Mode::ErrorDelimiter:
+        if (level == 0) {
+            detectError(node, BusErrorType::Form);
+        }
+        else if (++node.counter == 8) {
+            // An error-passive transmitter also suspends after the error frame of its own frame
+            node.mode = Mode::Intermission;
+            node.counter = 3;
+            node.suspendAfterIntermission = node.transmitter &&
+                node.confinement.getState() == ErrorConfinement::State::ErrorPassive;
+        }
+        break;
+
+    case Mode::BusOff:
+        node.statistics.busOffBits++;
+        if (level == 0) {
+            node.recessiveRun = 0;
+        }
+        else if (++node.recessiveRun == 11) {
+            node.recessiveRun = 0;
+            if (node.confinement.recessiveSequence()) {
+                node.mode = Mode::Idle;
+                node.transmitter = false;
+            }
+        }
+        break;
+    }
+}
+
+void BitLevelBus::sampleTransmitter(NodeRuntime& node, uint8_t level)
+{
+    const EncodedFrame& frame = node.frame;
+    uint8_t intended = (node.position == frame.ackSlot) ? 1 : frame.bits[node.position];
+
+    // Keep the receiver view in step so a lost arbitration continues as a normal reception
+    FrameDecoder::Result result = node.decoder.feed(level);
+
+    bool arbitration = node.position >= 1 && node.position <= frame.arbitrationEnd;
+    if (arbitration && intended == 1 && level == 0) {
+        if (frame.stuffBit[node.position]) {
+            detectError(node, BusErrorType::Stuff, true);
+            return;
+        }
+
+        node.mode = Mode::Receiving;
+        node.transmitter = false;
+        node.statistics.arbitrationLosses++;
+        if (metrics) {
+            metrics->recordArbitrationLoss(indexOf(node), activeFrame(node).id);
+        }
+        if (result == FrameDecoder::Error) {
+            detectError(node, node.decoder.getError());
+        }
+        return;
+    }
+
+    if (node.position == frame.ackSlot) {
+        if (level == 1) {
+            // An error-passive transmitter does not count a missing acknowledgement
+            bool passive = node.confinement.getState() == ErrorConfinement::State::ErrorPassive;
+            detectError(node, BusErrorType::ACK, passive);
+            return;
+        }
+    }
+    else if (level != intended) {
+        detectError(node, node.position >= frame.crcDelimiter ? BusErrorType::Form : BusErrorType::Bit);
+        return;
+    }
+
+    if (++node.position < frame.bits.size()) {
+        return;
+    }
+
+    const QueuedFrame& sent = activeFrame(node);
+    uint64_t latency = now + 1 - sent.releaseTime;
+
+    node.confinement.transmitSuccess();
+    node.statistics.framesTransmitted++;
+    node.statistics.totalLatency += latency;
+    node.statistics.maxLatency = std::max(node.statistics.maxLatency, latency);
+    if (metrics) {
+        metrics->recordDelivery(indexOf(node), sent.id, sent.releaseTime, node.attemptStart, now + 1);
+    }
+    if (counters) {
+        uint64_t stuffBits = std::count(frame.stuffBit.begin(), frame.stuffBit.end(), true);
+        counters->addFrame(indexOf(node), frame.bits.size(), stuffBits);
+    }
+
+    uint64_t inversion = 0;
+    node.transmit.remove(node.activeKey, now + 1, &inversion);
+    if (metrics) {
+        metrics->recordPriorityInversion(indexOf(node), sent.id, inversion);
+    }
+    node.submitted.erase(node.activeKey);
+
+    node.mode = Mode::Intermission;
+    node.counter = 3;
+    node.suspendAfterIntermission = node.confinement.getState() == ErrorConfinement::State::ErrorPassive;
+}
+
+void BitLevelBus::sampleErrorFlag(NodeRuntime& node, uint8_t level)
+{
+    if (node.activeFlag) {
+        if (level == 1) {
+            penalize(node);
+            if (node.mode == Mode::BusOff) return;
+        }
+
+        if (++node.counter == 6) {
+            node.mode = Mode::ErrorDelimiterWait;
+            node.dominantRun = 6;
+            node.firstAfterFlag = true;
+        }
+        return;
+    }
+
+    // A passive error flag is complete after six consecutive equal bits
+    if (level == node.lastSample) {
+        node.equalRun++;
+    }
+    else {
+        node.lastSample = level;
+        node.equalRun = 1;
+    }
+
+    if (++node.counter >= 6 && node.equalRun >= 6) {
+        node.mode = Mode::ErrorDelimiterWait;
+        node.dominantRun = 0;
+        node.firstAfterFlag = true;
+    }
+}
+
+void BitLevelBus::sampleDelimiterWait(NodeRuntime& node, uint8_t level)
+{
+    if (level == 1) {
+        node.mode = Mode::ErrorDelimiter;
+        node.counter = 1;
+        node.firstAfterFlag = false;
+        return;
+    }
+
+    if (node.firstAfterFlag && !node.transmitter) {
+        node.confinement.severeReceiveError();
+    }
+    node.firstAfterFlag = false;
+
+    // Up to 7 dominant bits of other nodes' flags are tolerated, every further 8 cost the node 8 points
+    int tolerance = node.activeFlag ? 14 : 8;
+    if (++node.dominantRun >= tolerance && (node.dominantRun - tolerance) % 8 == 0) {
+        penalize(node);
+    }
+}
+
+void BitLevelBus::detectError(NodeRuntime& node, BusErrorType type, bool keepCounters)
+{
+    node.statistics.errorsDetected[static_cast<int>(type)]++;
+
+    if (counters) {
+        // Flags of the other nodes overlap the first one, so the bus sees a single error frame
+        bool errorFrameStarted = false;
+        for (const NodeRuntime& other : nodes) {
+            errorFrameStarted |= other.mode == Mode::ErrorFlag || other.mode == Mode::ErrorDelimiterWait || other.mode == Mode::ErrorDelimiter;
+        }
+        if (!errorFrameStarted) {
+            counters->addErrorFrame();
+        }
+    }
+
+    if (node.transmitter) {
+        node.statistics.retransmissions++;
+        if (metrics) {
+            metrics->recordRetransmission(indexOf(node), activeFrame(node).id);
+        }
+    }
+
+    if (!keepCounters) {
+        if (node.transmitter) {
+            node.confinement.transmitError();
+        }
+        else {
+            node.confinement.receiveError();
+        }
+    }
+
+    if (node.confinement.getState() == ErrorConfinement::State::BusOff) {
+        enterBusOff(node);
+        return;
+    }
+
+    node.mode = Mode::ErrorFlag;
+    node.activeFlag = node.confinement.getState() == ErrorConfinement::State::ErrorActive;
+    node.counter = 0;
+    node.equalRun = 0;
+    node.lastSample = 2;
+    node.statistics.errorFlags++;
+}
+
+void BitLevelBus::penalize(NodeRuntime& node)
+{
+    if (node.transmitter) {
+        node.confinement.transmitError();
+    }
+    else {
+        node.confinement.severeReceiveError();
+    }
+
+    if (node.confinement.getState() == ErrorConfinement::State::BusOff) {
+        enterBusOff(node);
+    }
+}
+
+void BitLevelBus::enterBusOff(NodeRuntime& node)
+{
+    node.mode = Mode::BusOff;
+    node.recessiveRun = 0;
+    node.statistics.busOffEvents++;
+}
+
+void BitLevelBus::startReceiving(NodeRuntime& node, uint8_t level)
+{
+    node.mode = Mode::Receiving;
+    node.transmitter = false;
+    node.decoder.start();
+    node.decoder.feed(level);
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef BIT_LEVEL_BUS_H
+#define BIT_LEVEL_BUS_H
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "BitFrame.h"
+#include "BitTrace.h"
+#include "BusCounters.h"
+#include "ErrorConfinement.h"
+#include "PeriodicScheduler.h"
+#include "TransmitQueue.h"
+#include "TimingMetrics.h"
+
+// Bit-time simulation of a CAN bus with ISO 11898 error handling. Every node drives
+// the wired-AND bus each bit time and follows the frame with its own decoder, so
+// errors are detected by the node and at the bit where they occur, signalled with
+// active or passive error flags and answered by automatic retransmission.
+class BitLevelBus {
+public:
+    struct FaultProfile {
+        double transmitBitErrorRate = 0.0;  // chance per transmitted bit that the node drives the wrong level
+        double receiveBitErrorRate = 0.0;   // chance per bit that the node samples the wrong level
+        bool ackDisabled = false;           // never acknowledges frames
+    };
+
+    struct NodeStatistics {
+        uint64_t framesTransmitted = 0;
+        uint64_t framesReceived = 0;
+        uint64_t retransmissions = 0;
+        uint64_t arbitrationLosses = 0;
+        uint64_t errorFlags = 0;
+        uint64_t errorsDetected[BUS_ERROR_TYPES] = {};
+        uint64_t busOffEvents = 0;
+        uint64_t busOffBits = 0;
+        uint64_t totalLatency = 0;          // release to end of EOF, in bit times
+        uint64_t maxLatency = 0;
+    };
+
+    struct BusStatistics {
+        uint64_t bitTimes = 0;
+        uint64_t frameBits = 0;             // a transmitter is on the bus
+        uint64_t errorBits = 0;             // error flags and delimiters without a transmitter
+    };
+
+    BitLevelBus(int nodeCount, uint64_t seed = 0);
+
+    void setFaultProfile(int node, const FaultProfile& profile);
+    void setMetrics(TimingMetrics* timingMetrics) { metrics = timingMetrics; }
+    void setCounters(BusCounters* busCounters) { counters = busCounters; }
+    void setTrace(BitTrace* bitTrace) { trace = bitTrace; }
+    void setScheduler(PeriodicScheduler* periodicScheduler, uint32_t bitRate);
+    void queueFrame(int node, uint16_t id, const std::vector<uint8_t>& data, uint64_t releaseTime);
+
+    // Every node starts with a single mailbox fed in FIFO order, i.e. frames go out in release order
+    void setMailboxes(int node, int mailboxCount, TransmitQueue::Order order);
+
+    void step();
+    void run(uint64_t bitTimes);
+
+    uint64_t getTime() const { return now; }
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    const ErrorConfinement& getConfinement(int node) const { return nodes[node].confinement; }
+    const NodeStatistics& getStatistics(int node) const { return nodes[node].statistics; }
+    const BusStatistics& getBusStatistics() const { return busStatistics; }
+    size_t getQueuedFrames(int node) const { return nodes[node].queue.size() + nodes[node].transmit.size(); }
+    const TransmitQueue& getTransmitQueue(int node) const { return nodes[node].transmit; }
+
+private:
+    enum class Mode {
+        Idle, Transmitting, Receiving, ErrorFlag, ErrorDelimiterWait,
+        ErrorDelimiter, Intermission, Suspend, BusOff
+    };
+
+    struct QueuedFrame {
+        uint16_t id;
+        std::vector<uint8_t> data;
+        uint64_t releaseTime;
+    };
+
+    struct NodeRuntime {
+        Mode mode = Mode::Idle;
+        ErrorConfinement confinement;
+        FaultProfile faults;
+        std::deque<QueuedFrame> queue;                          // not released yet
+        TransmitQueue transmit{ 1, TransmitQueue::Order::Fifo };
+        std::unordered_map<uint64_t, QueuedFrame> submitted;    // released frames by transmit queue key
+        uint64_t submittedFrames = 0;
+        uint64_t activeKey = 0;
+        NodeStatistics statistics;
+
+        EncodedFrame frame;
+        size_t position = 0;
+        uint64_t attemptStart = 0;
+        bool transmitter = false;
+        FrameDecoder decoder;
+
+        int counter = 0;
+        bool activeFlag = false;
+        bool firstAfterFlag = false;
+        bool suspendAfterIntermission = false;
+        int dominantRun = 0;
+        int equalRun = 0;
+        uint8_t lastSample = 1;
+        int recessiveRun = 0;
+    };
+
+    uint8_t drive(NodeRuntime& node);
+    void sample(NodeRuntime& node, uint8_t level);
+    void sampleTransmitter(NodeRuntime& node, uint8_t level);
+    void sampleErrorFlag(NodeRuntime& node, uint8_t level);
+    void sampleDelimiterWait(NodeRuntime& node, uint8_t level);
+    void detectError(NodeRuntime& node, BusErrorType type, bool keepCounters = false);
+    void penalize(NodeRuntime& node);
+    void enterBusOff(NodeRuntime& node);
+    void startReceiving(NodeRuntime& node, uint8_t level);
+    void pollScheduler();
+    void submitReleased(NodeRuntime& node);
+    const QueuedFrame& activeFrame(const NodeRuntime& node) const { return node.submitted.at(node.activeKey); }
+    bool chance(double probability);
+    int indexOf(const NodeRuntime& node) const { return static_cast<int>(&node - nodes.data()); }
+
+    std::vector<NodeRuntime> nodes;
+    BusStatistics busStatistics;
+    TimingMetrics* metrics = nullptr;
+    BusCounters* counters = nullptr;
+    BitTrace* trace = nullptr;
+    PeriodicScheduler* scheduler = nullptr;
+    uint32_t bitRate = 500000;
+    std::vector<PeriodicScheduler::Release> releases;
+    uint64_t now = 0;
+    std::mt19937_64 generator;
+    std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "BitSlicedBus.h"
+
+#include <algorithm>
+#include <random>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "CANBus.h"
+#include "Message.h"
+#include "Node.h"
+
+static int lowestLane(uint64_t lanes)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, lanes);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(lanes);
+#endif
+}
+
+template <typename Function>
+static void forEachLane(uint64_t lanes, Function function)
+{
+    while (lanes) {
+        function(lowestLane(lanes));
+        lanes &= lanes - 1;
+    }
+}
+
+BitSlicedBus::BitSlicedBus(const ScenarioDefinition& scenario, const Options& options)
+    : options(options), nodeCount(0)
+{
+    for (const auto& definition : scenario.nodes) {
+        nodeCount = std::max(nodeCount, definition.nodeId);
+    }
+
+    scenarioErrors.assign(nodeCount, false);
+    nodeQueues.assign(nodeCount, std::vector<int>());
+
+    // Generate the messages exactly like CANSim::addPredefinedNode so slot order matches collectAllMessages
+    int networkSize = getNetworkSize(scenario);
+    for (const auto& definition : scenario.nodes) {
+        scenarioErrors[definition.nodeId - 1] = definition.error;
+
+        Node node(definition.nodeId, nullptr);
+        node.setError(definition.error);
+        node.setNodeActive(true);
+        scheduleScenarioNode(&node, definition, networkSize);
+
+        for (Message* msg : node.getMessagesToBeSent()) {
+            Slot slot;
+            slot.id = msg->getId();
+            slot.round = msg->getRound();
+            slot.sender = definition.nodeId - 1;
+
+            for (int receiverId : msg->getReceivers()) {
+                if (receiverId <= nodeCount) {
+                    slot.receivers.push_back(receiverId - 1);
+                }
+            }
+
+            nodeQueues[slot.sender].push_back(static_cast<int>(frameSlots.size()));
+            frameSlots.push_back(slot);
+            delete msg;
+        }
+    }
+}
+
+std::vector<SimulationStatistics> BitSlicedBus::run(const std::vector<uint64_t>& seeds)
+{
+    std::vector<SimulationStatistics> results;
+    results.reserve(seeds.size());
+
+    for (size_t first = 0; first < seeds.size(); first += LANES) {
+        int laneCount = static_cast<int>(std::min<size_t>(LANES, seeds.size() - first));
+        runBatch(seeds.data() + first, laneCount, results);
+    }
+
+    return results;
+}
+
+// Same bookkeeping as the "no active receiver" branch of CANBus::arbitrate: every queued message of
+// the sender with the dropped identifier and receivers pops the front of the node queue and leaves the pending list
+void BitSlicedBus::dropQueuedSlots(int slotIndex, uint64_t lanes)
+{
+    const Slot& dropped = frameSlots[slotIndex];
+    const std::vector<int>& queue = nodeQueues[dropped.sender];
+    int* head = &queueHead[static_cast<size_t>(dropped.sender) * LANES];
+
+    forEachLane(lanes, [&](int l) {
+        int first = head[l];
+        for (size_t k = first; k < queue.size(); ++k) {
+            const Slot& queued = frameSlots[queue[k]];
+            if (queued.id != dropped.id || queued.receivers != dropped.receivers) continue;
+
+            if (head[l] < static_cast<int>(queue.size())) head[l]++;
+
+            for (int j : queue) {
+                if (frameSlots[j].id == queued.id && frameSlots[j].round == queued.round) {
+                    pending[j] &= ~(1ULL << l);
+                }
+            }
+        }
+        });
+}
+
+void BitSlicedBus::runBatch(const uint64_t* seeds, int laneCount, std::vector<SimulationStatistics>& results)
+{
+    const uint64_t laneMask = (laneCount == LANES) ? ~0ULL : ((1ULL << laneCount) - 1);
+
+    size_t firstResult = results.size();
+    for (int l = 0; l < laneCount; ++l) {
+        SimulationStatistics statistics;
+        statistics.seed = seeds[l];
+        results.push_back(statistics);
+    }
+    SimulationStatistics* lane = results.data() + firstResult;
+
+    pending.assign(frameSlots.size(), laneMask);
+    contending.assign(frameSlots.size(), 0);
+    active.assign(nodeCount, laneMask);
+    faulty.assign(nodeCount, 0);
+    TEC.assign(static_cast<size_t>(nodeCount) * LANES, 0);
+    REC.assign(static_cast<size_t>(nodeCount) * LANES, 0);
+    queueHead.assign(static_cast<size_t>(nodeCount) * LANES, 0);
+
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    for (int l = 0; l < laneCount; ++l) {
+        std::mt19937_64 generator(seeds[l]);
+        for (int n = 0; n < nodeCount; ++n) {
+            if (scenarioErrors[n] || chance(generator) < options.errorProbability) {
+                faulty[n] |= 1ULL << l;
+            }
+        }
+    }
+
+    uint64_t running = frameSlots.empty() ? 0 : laneMask;
+
+    for (int round = 0; running; ++round) {
+        for (size_t j = 0; j < frameSlots.size(); ++j) {
+            contending[j] = (frameSlots[j].round <= round) ? (pending[j] & active[frameSlots[j].sender] & running) : 0;
+        }
+
+        // Wired-AND: a lane's bus is dominant as soon as one contender drives a 0
+        for (int bit = 10; bit >= 0; --bit) {
+            uint64_t dominant = 0;
+            for (size_t j = 0; j < frameSlots.size(); ++j) {
+                if (((frameSlots[j].id >> bit) & 1) == 0) {
+                    dominant |= contending[j];
+                }
+            }
+
+            if (dominant == 0) continue;
+
+            for (size_t j = 0; j < frameSlots.size(); ++j) {
+                if ((frameSlots[j].id >> bit) & 1) {
+                    contending[j] &= ~dominant;
+                }
+            }
+        }
+
+        // Equal identifiers tie; like CANBus the first pending message wins
+        uint64_t taken = 0;
+        for (size_t j = 0; j < frameSlots.size(); ++j) {
+            uint64_t won = contending[j] & ~taken;
+            if (!won) continue;
+            taken |= won;
+
+            const Slot& slot = frameSlots[j];
+            int* senderTEC = &TEC[static_cast<size_t>(slot.sender) * LANES];
+            int* senderHead = &queueHead[static_cast<size_t>(slot.sender) * LANES];
+            int queueSize = static_cast<int>(nodeQueues[slot.sender].size());
+
+            uint64_t activeReceiver = 0;
+            uint64_t acknowledged = 0;
+            for (int receiver : slot.receivers) {
+                uint64_t listening = active[receiver] & won;
+
+                // CRC only matches when sender and receiver agree on the simulated error
+                uint64_t received = listening & ~(faulty[slot.sender] ^ faulty[receiver]);
+                activeReceiver |= listening;
+                acknowledged |= received;
+
+                int* receiverREC = &REC[static_cast<size_t>(receiver) * LANES];
+                forEachLane(received, [&](int l) { if (receiverREC[l] > 0) receiverREC[l]--; });
+                forEachLane(listening & ~received, [&](int l) { receiverREC[l]++; });
+            }
+
+            uint64_t failed = won & activeReceiver & ~acknowledged;
+            forEachLane(failed, [&](int l) {
+                senderTEC[l]++;
+                lane[l].failedTransmissions++;
+                });
+
+            uint64_t dropped = won & ~activeReceiver;
+            forEachLane(dropped, [&](int l) { lane[l].droppedFrames++; });
+            dropQueuedSlots(static_cast<int>(j), dropped);
+
+            uint64_t delivered = won & acknowledged;
+            pending[j] &= ~delivered;
+            forEachLane(delivered, [&](int l) {
+                if (senderTEC[l] > 0) senderTEC[l]--;
+                if (senderHead[l] < queueSize) senderHead[l]++;
+                lane[l].framesDelivered++;
+                });
+        }
+
+        for (int n = 0; n < nodeCount; ++n) {
+            const int* nodeTEC = &TEC[static_cast<size_t>(n) * LANES];
+            const int* nodeREC = &REC[static_cast<size_t>(n) * LANES];
+
+            forEachLane(active[n] & taken, [&](int l) {
+                if (nodeTEC[l] >= CANBus::TEC_LIMIT || nodeREC[l] >= CANBus::REC_LIMIT) {
+                    active[n] &= ~(1ULL << l);
+                }
+                });
+        }
+
+        uint64_t stillPending = 0;
+        for (size_t j = 0; j < frameSlots.size(); ++j) {
+            stillPending |= pending[j];
+        }
+
+        uint64_t finished = running & ~stillPending;
+        if (round + 1 > options.maxRound) {
+            finished = running;
+        }
+
+        forEachLane(finished, [&](int l) { lane[l].rounds = round + 1; });
+        running &= ~finished;
+    }
+
+    for (int l = 0; l < laneCount; ++l) {
+        for (int n = 0; n < nodeCount; ++n) {
+            lane[l].TEC.push_back(TEC[static_cast<size_t>(n) * LANES + l]);
+            lane[l].REC.push_back(REC[static_cast<size_t>(n) * LANES + l]);
+            lane[l].nodeActive.push_back((active[n] >> l) & 1);
+            lane[l].nodeError.push_back((faulty[n] >> l) & 1);
+        }
+    }
+}
\ No newline at end of file
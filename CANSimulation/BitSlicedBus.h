@@ -0,0 +1,55 @@
+#ifndef BIT_SLICED_BUS_H
+#define BIT_SLICED_BUS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Scenario.h"
+#include "SimulationStatistics.h"
+
+// Runs up to 64 independent copies of a scenario at once. Every bus is one bit lane of a
+// uint64_t, so the wired-AND of the bus during arbitration is a single bitwise operation
+// across all lanes. The round rules mirror CANBus::arbitrate so every lane produces the
+// same statistics the scalar engine would for that error assignment.
+class BitSlicedBus {
+public:
+    static const int LANES = 64;
+
+    struct Options {
+        int maxRound = 60;
+        double errorProbability = 0.0;      // chance per lane that a node without a scenario error is faulty
+    };
+
+    BitSlicedBus(const ScenarioDefinition& scenario, const Options& options);
+
+    // One statistics entry per seed, simulated in batches of LANES
+    std::vector<SimulationStatistics> run(const std::vector<uint64_t>& seeds);
+
+private:
+    struct Slot {
+        uint16_t id;
+        int round;
+        int sender;                         // index into the node arrays
+        std::vector<int> receivers;
+    };
+
+    void runBatch(const uint64_t* seeds, int laneCount, std::vector<SimulationStatistics>& results);
+    void dropQueuedSlots(int slotIndex, uint64_t lanes);
+
+    Options options;
+    int nodeCount;
+    std::vector<bool> scenarioErrors;
+    std::vector<Slot> frameSlots;
+    std::vector<std::vector<int>> nodeQueues;   // slot indices per node in Node::messagesToBeSent order
+
+    // Per batch lane state
+    std::vector<uint64_t> pending;          // per slot
+    std::vector<uint64_t> contending;       // per slot
+    std::vector<uint64_t> active;           // per node
+    std::vector<uint64_t> faulty;           // per node
+    std::vector<int> TEC;                   // node * LANES + lane
+    std::vector<int> REC;
+    std::vector<int> queueHead;             // messages popped from the node queue, node * LANES + lane
+};
+
+#endif
\ No newline at end of file
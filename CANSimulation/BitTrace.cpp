@@ -0,0 +1,147 @@
+#include "BitTrace.h"
+
+#include <algorithm>
+
+BitTrace::BitTrace(int nodeCount)
+    : lanes(nodeCount + 1), length(0), frameOpen(false), errorOpen(false)
+{
+}
+
+void BitTrace::append(const std::vector<uint8_t>& driven, uint8_t bus, bool frame, bool error)
+{
+    for (size_t i = 0; i < lanes.size(); ++i) {
+        Lane& lane = lanes[i];
+        uint8_t value = i == 0 ? bus : (i - 1 < driven.size() ? driven[i - 1] : 1);
+
+        if ((length & 63) == 0) {
+            lane.levels.push_back(0);
+        }
+
+        if (value) {
+            lane.levels.back() |= 1ULL << (length & 63);
+            mark(lane.recessive, length);
+        }
+        else {
+            mark(lane.dominant, length);
+        }
+    }
+
+    extend(frames, frameOpen, frame, length);
+    extend(errorFrames, errorOpen, error, length);
+    ++length;
+}
+
+void BitTrace::mark(std::vector<uint64_t>* summary, uint64_t time)
+{
+    uint64_t bucket = time;
+    for (int level = 0; level < SUMMARY_LEVELS; ++level) {
+        bucket >>= 6;
+
+        std::vector<uint64_t>& words = summary[level];
+        size_t word = static_cast<size_t>(bucket >> 6);
+        if (word >= words.size()) {
+            words.resize(word + 1, 0);
+        }
+
+        uint64_t bit = 1ULL << (bucket & 63);
+        if (words[word] & bit) {
+            return;     // the levels above were marked together with this one
+        }
+        words[word] |= bit;
+    }
+}
+
+void BitTrace::extend(std::vector<Span>& spans, bool& open, bool active, uint64_t time)
+{
+    if (active) {
+        if (open) {
+            spans.back().end = time + 1;
+        }
+        else {
+            spans.push_back({ time, time + 1 });
+        }
+    }
+    open = active;
+}
+
+uint8_t BitTrace::level(int lane, uint64_t time) const
+{
+    if (time >= length) {
+        return 1;
+    }
+    return static_cast<uint8_t>((lanes[lane].levels[time >> 6] >> (time & 63)) & 1);
+}
+
+bool BitTrace::anySet(const std::vector<uint64_t>& bits, uint64_t begin, uint64_t end, bool inverted)
+{
+    if (begin >= end) {
+        return false;
+    }
+
+    size_t first = static_cast<size_t>(begin >> 6);
+    size_t last = static_cast<size_t>((end - 1) >> 6);
+    for (size_t i = first; i <= last && i < bits.size(); ++i) {
+        uint64_t word = inverted ? ~bits[i] : bits[i];
+        if (i == first) {
+            word &= ~0ULL << (begin & 63);
+        }
+        if (i == last && (end & 63) != 0) {
+            word &= (1ULL << (end & 63)) - 1;
+        }
+        if (word) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BitTrace::anyInRange(const std::vector<uint64_t>& levels, const std::vector<uint64_t>* summary,
+    uint64_t begin, uint64_t end, bool dominant)
+{
+    // Level 0 is the recorded bits, level k + 1 the summary with buckets of 64^(k+1) bit times.
+    // The unaligned ends of the range are read at one level and the middle at the next one up.
+    for (int level = 0; begin < end; ++level) {
+        const std::vector<uint64_t>& bits = level == 0 ? levels : summary[level - 1];
+        bool inverted = level == 0 && dominant;
+
+        if (level == SUMMARY_LEVELS || end - begin <= 128) {
+            return anySet(bits, begin, end, inverted);
+        }
+
+        uint64_t alignedBegin = (begin + 63) & ~63ULL;
+        uint64_t alignedEnd = end & ~63ULL;
+        if (anySet(bits, begin, alignedBegin, inverted) || anySet(bits, alignedEnd, end, inverted)) {
+            return true;
+        }
+
+        begin = alignedBegin >> 6;
+        end = alignedEnd >> 6;
+    }
+    return false;
+}
+
+BitTrace::Summary BitTrace::summarize(int lane, uint64_t begin, uint64_t end) const
+{
+    Summary summary;
+    end = std::min(end, length);
+    if (begin >= end) {
+        return summary;
+    }
+
+    const Lane& trace = lanes[lane];
+    summary.dominant = anyInRange(trace.levels, trace.dominant, begin, end, true);
+    summary.recessive = anyInRange(trace.levels, trace.recessive, begin, end, false);
+    return summary;
+}
+
+const std::vector<BitTrace::Span>& BitTrace::getSpans(SpanKind kind) const
+{
+    return kind == SpanKind::Frame ? frames : errorFrames;
+}
+
+size_t BitTrace::firstSpanAfter(SpanKind kind, uint64_t time) const
+{
+    const std::vector<Span>& spans = getSpans(kind);
+    auto first = std::partition_point(spans.begin(), spans.end(), [time](const Span& span) { return span.end <= time; });
+    return static_cast<size_t>(first - spans.begin());
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef BIT_TRACE_H
+#define BIT_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bit-time recording of a BitLevelBus run for the timeline view: the bus level and the
+// level every node drives, one bit per bit time, plus the spans of frames and error frames.
+// Each lane also keeps a pyramid of summaries, where a level marks which buckets of 64^k
+// bit times saw a dominant and which a recessive level, so the min/max of any range is
+// answered from at most two words per level however long the range is.
+class BitTrace {
+public:
+    static const int SUMMARY_LEVELS = 6;    // top buckets hold 64^6 bit times, about 19 hours at 1 Mbit/s
+
+    enum class SpanKind { Frame, ErrorFrame };
+
+    struct Span {
+        uint64_t begin;
+        uint64_t end;                       // exclusive
+    };
+
+    struct Summary {
+        bool dominant = false;
+        bool recessive = false;
+    };
+
+    explicit BitTrace(int nodeCount = 0);
+
+    // Records one bit time; frame and error tell whether a frame or an error frame is on the bus
+    void append(const std::vector<uint8_t>& driven, uint8_t bus, bool frame, bool error);
+
+    uint64_t getLength() const { return length; }
+    int getNodeCount() const { return static_cast<int>(lanes.size()) - 1; }
+
+    // Lane 0 is the bus, lane i + 1 the level node i drives
+    uint8_t level(int lane, uint64_t time) const;
+    Summary summarize(int lane, uint64_t begin, uint64_t end) const;
+
+    const std::vector<Span>& getSpans(SpanKind kind) const;
+
+    // Index of the first span that ends after the given time
+    size_t firstSpanAfter(SpanKind kind, uint64_t time) const;
+
+private:
+    struct Lane {
+        std::vector<uint64_t> levels;                           // 1 = recessive
+        std::vector<uint64_t> dominant[SUMMARY_LEVELS];         // bit i of level k: bucket i of 64^(k+1) bit times
+        std::vector<uint64_t> recessive[SUMMARY_LEVELS];
+    };
+
+    static void mark(std::vector<uint64_t>* summary, uint64_t time);
+    static bool anySet(const std::vector<uint64_t>& bits, uint64_t begin, uint64_t end, bool inverted);
+    static bool anyInRange(const std::vector<uint64_t>& levels, const std::vector<uint64_t>* summary,
+        uint64_t begin, uint64_t end, bool dominant);
+    static void extend(std::vector<Span>& spans, bool& open, bool active, uint64_t time);
+
+    std::vector<Lane> lanes;
+    uint64_t length;
+    std::vector<Span> frames;
+    std::vector<Span> errorFrames;
+    bool frameOpen;
+    bool errorOpen;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "BusCounters.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+BusCounters::BusCounters()
+{
+    reset();
+}
+
+void BusCounters::reset()
+{
+    frames.store(0, std::memory_order_relaxed);
+    bits.store(0, std::memory_order_relaxed);
+    stuffBits.store(0, std::memory_order_relaxed);
+    errorFrames.store(0, std::memory_order_relaxed);
+    busTime.store(0, std::memory_order_relaxed);
+    nodeCount.store(0, std::memory_order_relaxed);
+
+    for (int i = 0; i < MAX_NODES; ++i) {
+        txFrames[i].store(0, std::memory_order_relaxed);
+        rxFrames[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void BusCounters::touchNode(int node)
+{
+    if (node < 0 || node >= MAX_NODES) {
+        throw std::invalid_argument("Node index " + std::to_string(node) + " is outside the " + std::to_string(MAX_NODES) +
+            " nodes the bus counters keep");
+    }
+
+    int known = nodeCount.load(std::memory_order_relaxed);
+    while (node >= known && !nodeCount.compare_exchange_weak(known, node + 1, std::memory_order_relaxed)) {
+    }
+}
+
+void BusCounters::addFrame(int node, uint64_t frameBits, uint64_t frameStuffBits)
+{
+    frames.fetch_add(1, std::memory_order_relaxed);
+    bits.fetch_add(frameBits, std::memory_order_relaxed);
+    stuffBits.fetch_add(frameStuffBits, std::memory_order_relaxed);
+
+    touchNode(node);
+    txFrames[node].fetch_add(1, std::memory_order_relaxed);
+}
+
+void BusCounters::addReception(int node)
+{
+    touchNode(node);
+    rxFrames[node].fetch_add(1, std::memory_order_relaxed);
+}
+
+void BusCounters::addErrorFrame()
+{
+    errorFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BusCounters::addBusTime(uint64_t bitTimes)
+{
+    busTime.fetch_add(bitTimes, std::memory_order_relaxed);
+}
+
+void BusCounters::restore(const Snapshot& snapshot)
+{
+    reset();
+    frames.store(snapshot.frames, std::memory_order_relaxed);
+    bits.store(snapshot.bits, std::memory_order_relaxed);
+    stuffBits.store(snapshot.stuffBits, std::memory_order_relaxed);
+    errorFrames.store(snapshot.errorFrames, std::memory_order_relaxed);
+    busTime.store(snapshot.busTime, std::memory_order_relaxed);
+
+    int count = static_cast<int>(std::min<size_t>(snapshot.txFrames.size(), MAX_NODES));
+    for (int i = 0; i < count; ++i) {
+        txFrames[i].store(snapshot.txFrames[i], std::memory_order_relaxed);
+        rxFrames[i].store(snapshot.rxFrames[i], std::memory_order_relaxed);
+    }
+    nodeCount.store(count, std::memory_order_relaxed);
+}
+
+BusCounters::Snapshot BusCounters::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.frames = frames.load(std::memory_order_relaxed);
+    snapshot.bits = bits.load(std::memory_order_relaxed);
+    snapshot.stuffBits = stuffBits.load(std::memory_order_relaxed);
+    snapshot.errorFrames = errorFrames.load(std::memory_order_relaxed);
+    snapshot.busTime = busTime.load(std::memory_order_relaxed);
+
+    int count = nodeCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        snapshot.txFrames.push_back(txFrames[i].load(std::memory_order_relaxed));
+        snapshot.rxFrames.push_back(rxFrames[i].load(std::memory_order_relaxed));
+    }
+
+    return snapshot;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef BUS_COUNTERS_H
+#define BUS_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Throughput counters updated from the simulation thread with relaxed atomics,
+// so an exporter thread can take snapshots while a run is in progress
+class BusCounters {
+public:
+    static const int MAX_NODES = 0x7FF;    // Node::MAX_NODES, every node id a frame identifier can carry
+
+    struct Snapshot {
+        uint64_t frames = 0;
+        uint64_t bits = 0;
+        uint64_t stuffBits = 0;
+        uint64_t errorFrames = 0;
+        uint64_t busTime = 0;               // simulated bit times, 0 if the engine does not track them
+        std::vector<uint64_t> txFrames;
+        std::vector<uint64_t> rxFrames;
+    };
+
+    BusCounters();
+
+    // Throw std::invalid_argument for a node index outside 0..MAX_NODES - 1
+    void addFrame(int node, uint64_t frameBits, uint64_t stuffBits);
+    void addReception(int node);
+    void addErrorFrame();
+    void addBusTime(uint64_t bitTimes);
+    void reset();
+
+    Snapshot snapshot() const;
+
+    // Sets every counter to a snapshot taken earlier, for resuming a run
+    void restore(const Snapshot& snapshot);
+
+private:
+    void touchNode(int node);
+
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> bits;
+    std::atomic<uint64_t> stuffBits;
+    std::atomic<uint64_t> errorFrames;
+    std::atomic<uint64_t> busTime;
+    std::atomic<int> nodeCount;
+    std::atomic<uint64_t> txFrames[MAX_NODES];
+    std::atomic<uint64_t> rxFrames[MAX_NODES];
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "BusTimelineWidget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QVector>
+#include <QWheelEvent>
+
+static const int LABEL_WIDTH = 80;
+static const int AXIS_HEIGHT = 22;
+static const int LANE_HEIGHT = 40;
+static const int LANE_GAP = 10;
+static const double MIN_BITS_PER_PIXEL = 1.0 / 32;
+static const double BIT_TICK_PIXELS = 8.0;          // pixels per bit time from which bit boundaries are drawn
+
+BusTimelineWidget::BusTimelineWidget(QWidget* parent)
+    : QAbstractScrollArea(parent), bitRate(500000), start(0), bitsPerPixel(1), scrollUnit(1),
+    updatingScrollBar(false), dragX(0), dragStart(0)
+{
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    setMinimumHeight(AXIS_HEIGHT + 2 * (LANE_HEIGHT + LANE_GAP));
+}
+
+void BusTimelineWidget::setTrace(BitTrace bitTrace, uint32_t rate)
+{
+    trace = std::move(bitTrace);
+    bitRate = rate;
+    showRange(0, trace.getLength());
+}
+
+void BusTimelineWidget::showRange(uint64_t begin, uint64_t end)
+{
+    if (end <= begin) {
+        end = begin + 1;
+    }
+    setView(static_cast<double>(begin), static_cast<double>(end - begin) / traceWidth());
+}
+
+int BusTimelineWidget::traceWidth() const
+{
+    return std::max(1, viewport()->width() - LABEL_WIDTH);
+}
+
+double BusTimelineWidget::clampScale(double scale) const
+{
+    double widest = static_cast<double>(trace.getLength()) / traceWidth();
+    return std::min(std::max(scale, MIN_BITS_PER_PIXEL), std::max(widest, MIN_BITS_PER_PIXEL));
+}
+
+int BusTimelineWidget::xAt(double time) const
+{
+    double x = (time - start) / bitsPerPixel;
+    return static_cast<int>(std::floor(std::min(std::max(x, -1.0), traceWidth() + 1.0)));
+}
+
+void BusTimelineWidget::setView(double firstBit, double scale)
+{
+    bitsPerPixel = clampScale(scale);
+
+    double lastStart = static_cast<double>(trace.getLength()) - traceWidth() * bitsPerPixel;
+    start = std::min(std::max(firstBit, 0.0), std::max(lastStart, 0.0));
+
+    updateScrollBar();
+    viewport()->update();
+}
+
+void BusTimelineWidget::updateScrollBar()
+{
+    updatingScrollBar = true;
+
+    uint64_t length = trace.getLength();
+    uint64_t visible = static_cast<uint64_t>(traceWidth() * bitsPerPixel);
+    scrollUnit = std::max<uint64_t>(1, length >> 30);
+
+    QScrollBar* horizontal = horizontalScrollBar();
+    horizontal->setRange(0, static_cast<int>((length > visible ? length - visible : 0) / scrollUnit));
+    horizontal->setPageStep(std::max(1, static_cast<int>(visible / scrollUnit)));
+    horizontal->setSingleStep(std::max(1, horizontal->pageStep() / 10));
+    horizontal->setValue(static_cast<int>(start / scrollUnit));
+
+    int contentHeight = (trace.getNodeCount() + 1) * (LANE_HEIGHT + LANE_GAP);
+    QScrollBar* vertical = verticalScrollBar();
+    vertical->setRange(0, std::max(0, contentHeight - (viewport()->height() - AXIS_HEIGHT)));
+    vertical->setPageStep(std::max(1, viewport()->height() - AXIS_HEIGHT));
+    vertical->setSingleStep(LANE_HEIGHT + LANE_GAP);
+
+    updatingScrollBar = false;
+}
+
+void BusTimelineWidget::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dy);
+
+    if (dx != 0 && !updatingScrollBar) {
+        start = static_cast<double>(horizontalScrollBar()->value()) * scrollUnit;
+    }
+    viewport()->update();
+}
+
+void BusTimelineWidget::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    setView(start, bitsPerPixel);
+}
+
+void BusTimelineWidget::wheelEvent(QWheelEvent* event)
+{
+    int x = std::min(std::max(static_cast<int>(event->position().x()) - LABEL_WIDTH, 0), traceWidth());
+    double anchor = timeAt(x);
+
+    double scale = clampScale(bitsPerPixel * std::pow(1.25, -event->angleDelta().y() / 120.0));
+    setView(anchor - x * scale, scale);
+    event->accept();
+}
+
+void BusTimelineWidget::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton) {
+        dragX = static_cast<int>(event->position().x());
+        dragStart = start;
+        event->accept();
+    }
+}
+
+void BusTimelineWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    if (event->buttons() & Qt::LeftButton) {
+        setView(dragStart - (static_cast<int>(event->position().x()) - dragX) * bitsPerPixel, bitsPerPixel);
+        event->accept();
+    }
+}
+
+void BusTimelineWidget::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), palette().base());
+    painter.setPen(palette().text().color());
+
+    if (trace.getLength() == 0) {
+        painter.drawText(viewport()->rect(), Qt::AlignCenter, "No bit trace recorded");
+        return;
+    }
+
+    int height = viewport()->height();
+    painter.save();
+    painter.setClipRect(0, AXIS_HEIGHT, viewport()->width(), height - AXIS_HEIGHT);
+
+    drawSpans(painter, BitTrace::SpanKind::ErrorFrame, AXIS_HEIGHT, height);
+    drawSpans(painter, BitTrace::SpanKind::Frame, AXIS_HEIGHT, height);
+
+    if (1.0 / bitsPerPixel >= BIT_TICK_PIXELS) {
+        painter.setPen(QPen(palette().mid().color(), 0, Qt::DotLine));
+        for (double bit = std::ceil(start); bit <= timeAt(traceWidth()); bit += 1.0) {
+            int x = LABEL_WIDTH + xAt(bit);
+            painter.drawLine(x, AXIS_HEIGHT, x, height);
+        }
+    }
+
+    int firstTop = AXIS_HEIGHT + LANE_GAP / 2 - verticalScrollBar()->value();
+    for (int lane = 0; lane <= trace.getNodeCount(); ++lane) {
+        int top = firstTop + lane * (LANE_HEIGHT + LANE_GAP);
+        if (top + LANE_HEIGHT >= AXIS_HEIGHT && top < height) {
+            drawLane(painter, lane, top);
+        }
+    }
+
+    painter.restore();
+    drawAxis(painter);
+}
+
+void BusTimelineWidget::drawAxis(QPainter& painter)
+{
+    painter.fillRect(0, 0, viewport()->width(), AXIS_HEIGHT, palette().window());
+    painter.setPen(palette().text().color());
+    painter.drawLine(LABEL_WIDTH, AXIS_HEIGHT - 1, viewport()->width(), AXIS_HEIGHT - 1);
+
+    // Ticks at 1, 2 or 5 times a power of ten bit times, roughly 100 pixels apart
+    double target = 100 * bitsPerPixel;
+    double step = 1;
+    for (double decade = 1; step < target; decade *= 10) {
+        for (double multiple : { 1.0, 2.0, 5.0, 10.0 }) {
+            step = decade * multiple;
+            if (step >= target) {
+                break;
+            }
+        }
+    }
+
+    for (double tick = std::ceil(start / step) * step; tick <= timeAt(traceWidth()); tick += step) {
+        int x = LABEL_WIDTH + xAt(tick);
+        painter.drawLine(x, AXIS_HEIGHT - 6, x, AXIS_HEIGHT - 1);
+        painter.drawText(x + 3, AXIS_HEIGHT - 8, QString("%1 ms").arg(tick * 1000.0 / bitRate, 0, 'g', 10));
+    }
+}
+
+void BusTimelineWidget::drawLane(QPainter& painter, int lane, int top)
+{
+    painter.setPen(palette().text().color());
+    painter.drawText(QRect(4, top, LABEL_WIDTH - 8, LANE_HEIGHT), Qt::AlignVCenter | Qt::AlignLeft,
+        lane == 0 ? QString("Bus") : QString("Node %1").arg(lane));
+
+    // Recessive puts both wires at the middle, dominant pulls CAN_H up and CAN_L down
+    int highY = top + 4;
+    int middleY = top + LANE_HEIGHT / 2;
+    int lowY = top + LANE_HEIGHT - 4;
+
+    QVector<QLine> high;
+    QVector<QLine> low;
+    uint64_t length = trace.getLength();
+    uint64_t previousEnd = 0;
+
+    for (int x = 0; x < traceWidth(); ++x) {
+        double from = timeAt(x);
+        if (from >= length) {
+            break;
+        }
+
+        uint64_t begin = static_cast<uint64_t>(from);
+        uint64_t end = std::max(begin + 1, static_cast<uint64_t>(timeAt(x + 1)));
+        BitTrace::Summary summary = trace.summarize(lane, begin, end);
+
+        // A column starting a new bit time also covers the level it changes from
+        if (x > 0 && begin > 0 && begin == previousEnd) {
+            if (trace.level(lane, begin - 1)) {
+                summary.recessive = true;
+            }
+            else {
+                summary.dominant = true;
+            }
+        }
+        previousEnd = end;
+
+        int column = LABEL_WIDTH + x;
+        high.append(QLine(column, summary.dominant ? highY : middleY, column, summary.recessive ? middleY : highY));
+        low.append(QLine(column, summary.recessive ? middleY : lowY, column, summary.dominant ? lowY : middleY));
+    }
+
+    painter.setPen(QPen(Qt::green, 0));
+    painter.drawLines(high);
+    painter.setPen(QPen(Qt::red, 0));
+    painter.drawLines(low);
+}
+
+void BusTimelineWidget::drawSpans(QPainter& painter, BitTrace::SpanKind kind, int top, int bottom)
+{
+    const std::vector<BitTrace::Span>& spans = trace.getSpans(kind);
+    double viewEnd = timeAt(traceWidth());
+    QColor errorColor(255, 0, 0, 60);
+    painter.setPen(QPen(palette().mid().color(), 0));
+
+    size_t i = trace.firstSpanAfter(kind, static_cast<uint64_t>(start));
+    while (i < spans.size() && spans[i].begin < viewEnd) {
+        const BitTrace::Span& span = spans[i];
+        int first = std::max(0, xAt(static_cast<double>(span.begin)));
+        int last = std::min(traceWidth(), std::max(first, xAt(static_cast<double>(span.end))));
+
+        if (kind == BitTrace::SpanKind::ErrorFrame) {
+            painter.fillRect(LABEL_WIDTH + first, top, last - first + 1, bottom - top, errorColor);
+        }
+        else {
+            painter.drawLine(LABEL_WIDTH + first, top, LABEL_WIDTH + first, bottom);
+            painter.drawLine(LABEL_WIDTH + last, top, LABEL_WIDTH + last, bottom);
+        }
+
+        // Spans that end within the columns just drawn would only paint the same pixels again
+        i = std::max(i + 1, trace.firstSpanAfter(kind, static_cast<uint64_t>(timeAt(last + 1))));
+    }
+}
\ No newline at end of file
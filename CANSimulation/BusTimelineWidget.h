@@ -0,0 +1,56 @@
+#ifndef BUS_TIMELINE_WIDGET_H
+#define BUS_TIMELINE_WIDGET_H
+
+#include <cstdint>
+
+#include <QAbstractScrollArea>
+#include <QPainter>
+
+#include "BitTrace.h"
+
+// Logic-analyzer view of a BitTrace: CAN_H and CAN_L of the bus and of every node's
+// transmitter, with frame boundaries and error frames. The wheel zooms around the cursor
+// and dragging pans. Every pixel column is drawn from the min/max summary of the bit
+// times it covers, so a frame costs the same at any zoom and for any trace length.
+class BusTimelineWidget : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit BusTimelineWidget(QWidget* parent = nullptr);
+
+    void setTrace(BitTrace bitTrace, uint32_t bitRate);
+
+    // Fits the given range of bit times to the width of the view
+    void showRange(uint64_t begin, uint64_t end);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    void setView(double firstBit, double scale);
+    void updateScrollBar();
+    double clampScale(double scale) const;
+    int traceWidth() const;
+    double timeAt(int x) const { return start + x * bitsPerPixel; }
+    int xAt(double time) const;         // clamped to just outside the trace area
+
+    void drawAxis(QPainter& painter);
+    void drawLane(QPainter& painter, int lane, int top);
+    void drawSpans(QPainter& painter, BitTrace::SpanKind kind, int top, int bottom);
+
+    BitTrace trace;
+    uint32_t bitRate;
+    double start;                   // bit time at the left edge of the trace area
+    double bitsPerPixel;
+    uint64_t scrollUnit;            // bit times per scroll bar step, so long traces fit an int range
+    bool updatingScrollBar;
+    int dragX;
+    double dragStart;
+};
+
+#endif
\ No newline at end of file
@@ -1,352 +1,461 @@
-#include "CANBus.h"
-
-#include <iostream>
-#include <vector>
-
-#include "Message.h"
-#include "CANSim.h"
-#include "ErrorCheck.h"
-
-CANBus::CANBus(CANSim* simulation, QObject* parent)
-    : QObject(nullptr), round(0), sim(simulation) 
-{
-    std::ofstream logFile("log.txt", std::ios::app);
-
-    if (logFile.is_open()) {
-        std::time_t now = std::time(nullptr);
-        struct tm localTime;
-
-        if (localtime_s(&localTime, &now) == 0) {
-            char timeBuffer[80];
-            std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", &localTime);
-
-            logMessage("-----------------------");
-            logFile << "CANBus initialized at: " << timeBuffer << "\n";
-            logMessage("-----------------------");
-        }
-        else {
-            logFile << "Error: Failed to retrieve local time.\n";
-        }
-
-        logFile.close();
-    }
-}
-
-void CANBus::logMessage(const std::string& message) 
-{
-    std::ofstream logFile("log.txt", std::ios::app);
-
-    if (logFile.is_open()) {
-        logFile << message << "\n";
-        logFile.close();
-    }
-}
-
-void CANBus::incrementRound() {
-    ++round;
-}
-
-void CANBus::addNode(Node* node) {
-    nodes.push_back(node);
-}
-
-bool CANBus::arbitrate()
-{
-    bool successfullArbitration = true;
-
-    if(round == 0)
-        nodes = sim->nodesInSim;
-
-    if (pendingMessages.empty()) {
-        logMessage("No messages to transmit.");
-        return false;
-    }
-
-    // Filter messages based on the current round and active senders
-    std::vector<Message> filteredMessages;
-    for (const auto& msg : pendingMessages) {
-        int senderId = msg.getSenderId();
-        if (msg.getRound() <= round && nodes[senderId - 1]->nodeActive) {
-            filteredMessages.push_back(msg);
-        }
-    }
-
-    // If no messages for this round, return false
-    if (filteredMessages.empty()) {
-        logMessage("No messages for the current round: " + std::to_string(round));
-        return true;
-    }
-
-    // Bitwise arbitration
-    std::vector<Message> contenders = filteredMessages;
-    std::vector<Message> nonContenders;
-
-    int ID_BITS = 11;
-    if (bitStuffingVisible) {
-        int maxStuffedBits = 0; 
-
-        for (auto& msg : contenders) {
-            std::string stuffedId = errorCheck->applyBitStuffingToId(msg.getId());
-            uint16_t id = errorCheck->binaryStringToUint16(stuffedId);
-            msg.setStuffedId(id);
-
-            if (stuffedId.size() > maxStuffedBits) {
-                maxStuffedBits = stuffedId.size();
-            }
-        }
-
-        ID_BITS = maxStuffedBits;
-    }
-
-    std::string logEntry = "ROUND: " + std::to_string(round);
-    logMessage(logEntry);
-
-    for (int bit = ID_BITS - 1; bit >= 0; --bit) {
-
-        ArbitrationStep step = ArbitrationStep(round, bit, contenders, nonContenders); 
-
-        std::string logEntry = "  Arbitrating at bit position: " + std::to_string(bit+1);
-        logMessage(logEntry);
-
-        // Print the message IDs still in the race at this bit position
-        logMessage("      Messages still in the race at the beginning: ");
-        for (const auto& msg : contenders) {
-			int senderId = msg.getSenderId();
-            uint16_t id = msg.getId();
-
-			if (nodes[senderId - 1]->nodeActive == false)
-            {
-				logMessage("Node " + std::to_string(senderId) + " is disabled. It will not participate in the arbitration.");
-				continue;
-			}
-
-            if (bitStuffingVisible)
-            {
-                std::string stuffedId = errorCheck->applyBitStuffingToId(msg.getId());
-                logEntry = "         - message: " + stuffedId;
-                logEntry += ", sender ID: " + std::to_string(senderId);
-                logEntry += ", initial round: " + std::to_string(msg.getRound());
-
-                logMessage(logEntry);
-            }
-            else
-            {
-                std::string idBinary;
-                for (int i = 10; i >= 0; --i) {
-                    idBinary += ((id >> i) & 1) ? '1' : '0';
-                }
-                logEntry = "         - message: " + idBinary;
-                logEntry += ", sender ID: " + std::to_string(senderId);
-                logEntry += ", initial round: " + std::to_string(msg.getRound());
-
-                logMessage(logEntry);
-            }
-        }
-
-        logMessage(" ");
-        std::vector<Message> newContenders;
-
-        for (auto& msg : contenders) {
-            uint16_t idBit;
-            if (bitStuffingVisible) {
-				idBit = (msg.getStuffedId() >> bit) & 1;
-            }
-            else
-            {
-                idBit = (msg.getId() >> bit) & 1;
-            }
-
-			step.roundContenderBitValues[round][msg.getSenderId()].push_back(idBit);
-			for (int i = 0; i < nodes.size(); i++)
-            {
-                Node node = Node(nodes[i]->getNodeId(), this);
-				node.setNodeActive(nodes[i]->nodeActive);
-				node.TEC = nodes[i]->getTEC();
-				node.REC = nodes[i]->getREC();
-				step.nodes[round][i].push_back(node);
-			}   
-
-            if (newContenders.empty()) {
-                newContenders.push_back(msg);
-            }
-            else {
-                uint16_t prevBit = (newContenders[0].getId() >> bit) & 1;
-
-                if (idBit < prevBit) {
-                    nonContenders.push_back(msg);
-                    newContenders.clear();
-                    newContenders.push_back(msg);
-                }
-                else if (idBit == prevBit) {
-                    newContenders.push_back(msg);
-                }
-                else {
-                    nonContenders.push_back(msg);
-                }
-            }
-        }
-
-        contenders = newContenders;
-
-        arbitrationSteps.push_back(step);
-
-        if (contenders.empty()) {
-            logMessage("No more contenders at bit position " + std::to_string(bit));
-            break;
-        }
-    }
-
-    // If we have a winner, process the winning message
-    if (!contenders.empty()) {
-        Message winningMsg = contenders.front();
-
-        uint16_t id = winningMsg.getId();
-        int senderId = winningMsg.getSenderId();
-        std::string idBinary;
-        for (int i = 10; i >= 0; --i) {
-            idBinary += ((id >> i) & 1) ? '1' : '0';
-        }
-        logMessage("!!!");
-        logEntry = "Winner " + idBinary;
-        logEntry += ", sender ID: " + std::to_string(senderId);
-        logEntry += ", initial round: " + std::to_string(winningMsg.getRound());
-        logMessage(logEntry);
-
-        if (nodes[senderId - 1]->nodeActive) {
-            std::string stuffedMessage = nodes[senderId - 1]->sendNextMessage();
-            logMessage("Stuffed Message: " + stuffedMessage);
-        }
-
-        uint16_t receiverBits = id & 0xFF;
-        Message winningMsgCopy = winningMsg;
-
-        uint16_t crcValue = winningMsgCopy.getCRC();
-        std::string crcBinary;
-        for (int i = 15; i >= 0; --i) {
-            crcBinary += (crcValue & (1 << i)) ? '1' : '0';
-        }
-        logMessage("CRC: " + crcBinary);
-
-        // Print the nodes that received the message and when they set the acknowledgement bit to 1
-        bool activeReceiver = false;
-        for (int i = 0; i < 8; ++i)
-        {
-            if (receiverBits & (1 << i)) {
-                int receiverId = i + 1;
-
-                if (nodes[receiverId - 1]->nodeActive == true)
-                {
-                    activeReceiver = true;
-                    bool received = nodes[receiverId - 1]->receiveMessage(winningMsgCopy);
-
-                    if (nodes[receiverId - 1]) {
-                        if (received) {
-                            if (!nodes[receiverId - 1]->receivedMessages.empty()) {
-                                logMessage("Node " + std::to_string(receiverId) + " received the message, CRC verification was valid.");
-                                if (!winningMsg.getACK())
-                                {
-                                    winningMsg.setACK(true);
-                                    logMessage(" - ack bit was set to valid by node: " + std::to_string(receiverId) + "");
-                                }
-                                nodes[receiverId - 1]->decrementREC();
-                            }
-                            else {
-                                logMessage("CRC check failed for Node " + std::to_string(receiverId) + ". Message was not received.");
-                                nodes[receiverId - 1]->incrREC();
-                            }
-                        }
-                        else {
-                            logMessage("Message was not received.");
-                            nodes[receiverId - 1]->incrREC();
-                        }
-                    }
-                }
-            }
-        }
-
-        int sender_id = winningMsg.getSenderId();
-        // Check if the acknowledgement bit was set to 1
-        if ((!winningMsg.getACK()) && (activeReceiver)) {
-            logMessage("No nodes received the winning message. Adding it back to the pending messages.");
-            nodes[sender_id - 1]->incrTEC();
-            Message falseWinner = Message(0, std::vector<uint8_t>{0}, 0, false);
-            winners.push_back(falseWinner);
-        }
-        else if (!activeReceiver) {
-            logMessage("No nodes received the winning message. Adding it back to the pending messages.");
-            Message falseWinner = Message(0, std::vector<uint8_t>{0}, 0, false);
-            winners.push_back(falseWinner);
-        }
-        else {
-			logMessage("Winning message was received by at least one node. Removing it from the pending messages.");
-            winners.push_back(winningMsg);
-
-            auto it = std::find(pendingMessages.begin(), pendingMessages.end(), winningMsg);
-
-            if (it != pendingMessages.end()) {
-                pendingMessages.erase(it);
-            }
-            nodes[sender_id - 1]->decrementTEC();
-            nodes[sender_id - 1]->removeMessage();
-
-			successfullArbitration = true;
-        }
-
-        if (activeReceiver == false)
-        {
-			for (const auto& msg : nodes[senderId-1]->getMessagesToBeSent())
-            {
-                if (msg->getId() == winningMsg.getId())
-                {
-					nodes[senderId - 1]->removeMessage();
-                    pendingMessages.erase(
-                        std::remove_if(
-                            pendingMessages.begin(),
-                            pendingMessages.end(),
-                            [&msg](const Message& m) {
-                                return (m.getId() == msg->getId()) && (m.getRound() == msg->getRound());
-                            }
-                        ),
-                        pendingMessages.end()
-                    );
-				}
-			}
-        }
-
-        logMessage("NODE ERROR COUNTERS :");
-        for (size_t i = 0; i < nodes.size(); ++i) 
-        {
-            if (!nodes[i]->nodeActive) continue;
-
-            logMessage("- node " + std::to_string(i + 1) + "  TEC: " + std::to_string(nodes[i]->getTEC()) + "  REC: " + std::to_string(nodes[i]->getREC()));
-			if (nodes[i]->getTEC() >= 9)
-            {
-				logMessage("Node " + std::to_string(i + 1) + " has reached the maximum TEC value. It will be disabled.");
-                nodes[i]->setNodeActive(false);
-			}  
-
-			if (nodes[i]->getREC() >= 4)
-			{
-				logMessage("Node " + std::to_string(i + 1) + " has reached the maximum REC value. It will be disabled.");
-                nodes[i]->setNodeActive(false);
-			}   
-        }
-
-        logMessage(" ");
-
-        if (nodes[winningMsg.getSenderId() - 1]->nodeActive == false)
-        {
-            successfullArbitration = true;
-        }
-    }
-
-    for (const auto& msg : nonContenders) {
-        if (msg.getId() != contenders.front().getId() &&
-            std::find_if(pendingMessages.begin(), pendingMessages.end(),
-                [&msg](const Message& m) { return m.getId() == msg.getId(); }) == pendingMessages.end()) {
-            pendingMessages.push_back(msg);
-        }
-    }
-
-    return successfullArbitration;
+#include "CANBus.h"
+
+#include <iostream>
+#include <vector>
+
+#include "Message.h"
+#include "ErrorCheck.h"
+#include "BitFrame.h"
+#include "BinaryLogWriter.h"
+#include "MonitorNode.h"
+
+// A round takes the bus for one frame and the intermission after it. A round without a
+// frame is idle for as long as an unstuffed frame with 8 data bytes would have taken.
+static const uint64_t INTERMISSION_BITS = 3;
+static const uint64_t IDLE_SLOT_BITS = 108 + INTERMISSION_BITS;
+
+static_assert(BusCounters::MAX_NODES >= Node::MAX_NODES, "the bus counters keep every node a frame can come from");
+
+static uint64_t transmitKey(const Message& msg)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(msg.getRound())) << 16) | msg.getId();
+}
+
+CANBus::CANBus(CANSim* simulation, QObject* parent, Logging logging)
+    : QObject(nullptr), round(0), sim(simulation), logging(logging == Logging::On)
+{
+    std::time_t now = std::time(nullptr);
+    struct tm localTime;
+
+    if (localtime_s(&localTime, &now) == 0) {
+        char timeBuffer[80];
+        std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", &localTime);
+
+        // Both separators come first, as the text log has always had them
+        log(LogRecord(LogRecord::Type::Separator));
+        log(LogRecord(LogRecord::Type::Separator));
+        log(LogRecord(LogRecord::Type::Session, timeBuffer));
+    }
+    else {
+        logMessage("Error: Failed to retrieve local time.");
+    }
+}
+
+void CANBus::setBinaryLog(BinaryLogWriter* writer)
+{
+    binaryLog = writer;
+}
+
+void CANBus::flushLog()
+{
+    if (binaryLog) {
+        binaryLog->flush();
+    }
+}
+
+void CANBus::log(const LogRecord& record)
+{
+    if (!logging) {
+        return;
+    }
+
+    if (binaryLog) {
+        binaryLog->write(record);
+        return;
+    }
+
+    std::ofstream logFile(LOG_PATH, std::ios::app);
+
+    if (logFile.is_open()) {
+        logFile << record.render() << "\n";
+        logFile.close();
+    }
+}
+
+void CANBus::logMessage(const std::string& message) 
+{
+    if (!logging) {
+        return;
+    }
+
+    if (binaryLog) {
+        binaryLog->write(LogRecord(LogRecord::Type::Text, message));
+        return;
+    }
+
+    std::ofstream logFile(LOG_PATH, std::ios::app);
+
+    if (logFile.is_open()) {
+        logFile << message << "\n";
+        logFile.close();
+    }
+}
+
+void CANBus::incrementRound() {
+    ++round;
+}
+
+void CANBus::addNode(Node* node) {
+    nodes.push_back(node);
+}
+
+void CANBus::addMonitor(MonitorNode* monitor)
+{
+    monitors.push_back(monitor);
+}
+
+void CANBus::observeFrame(const Message& message, bool delivered, bool error, int crcErrors, int receivers)
+{
+    // One frame for every monitor, each runs its own compiled filter on it
+    FrameFilter::Frame frame;
+    frame.values[FrameFilter::Id] = message.getId();
+    frame.values[FrameFilter::Sender] = message.getSenderId();
+    frame.values[FrameFilter::Dlc] = message.getDataLength();
+    frame.values[FrameFilter::Round] = round;
+    frame.values[FrameFilter::Delivered] = delivered;
+    frame.values[FrameFilter::Error] = error;
+    frame.values[FrameFilter::CrcErrors] = crcErrors;
+    frame.values[FrameFilter::Receivers] = receivers;
+
+    std::vector<uint8_t> data = message.getData();
+    for (size_t i = 0; i < data.size() && i < 8; ++i) {
+        frame.values[FrameFilter::Data0 + i] = data[i];
+    }
+
+    for (MonitorNode* monitor : monitors) {
+        monitor->observe(frame);
+    }
+}
+
+SimulationStatistics CANBus::getStatistics() const
+{
+    SimulationStatistics result = statistics;
+    result.rounds = round;
+
+    for (const Node* node : nodes) {
+        result.TEC.push_back(node->getTEC());
+        result.REC.push_back(node->getREC());
+        result.nodeActive.push_back(node->nodeActive);
+        result.nodeError.push_back(node->nodeError);
+    }
+
+    return result;
+}
+
+bool CANBus::arbitrate()
+{
+    bool successfullArbitration = true;
+
+    if (pendingMessages.empty()) {
+        log(LogRecord(LogRecord::Type::NoMessages));
+        return false;
+    }
+
+    // Released frames enter their node's transmit queue, only frames in a mailbox can arbitrate
+    for (const auto& msg : pendingMessages) {
+        if (msg.getRound() <= round) {
+            nodes[msg.getSenderId() - 1]->transmitQueue.push(msg.getId(), transmitKey(msg), round);
+        }
+    }
+
+    // Filter messages based on the current round and active senders
+    std::vector<Message> filteredMessages;
+    for (const auto& msg : pendingMessages) {
+        int senderId = msg.getSenderId();
+        if (msg.getRound() <= round && nodes[senderId - 1]->nodeActive &&
+            nodes[senderId - 1]->transmitQueue.inMailbox(transmitKey(msg))) {
+            filteredMessages.push_back(msg);
+        }
+    }
+
+    // If no messages for this round, return false
+    if (filteredMessages.empty()) {
+        log(LogRecord(LogRecord::Type::NoMessagesInRound, round));
+        counters.addBusTime(IDLE_SLOT_BITS);
+        return true;
+    }
+
+    // Bitwise arbitration
+    std::vector<Message> contenders = filteredMessages;
+    std::vector<Message> nonContenders;
+
+    int ID_BITS = 11;
+    if (bitStuffingVisible) {
+        int maxStuffedBits = 0; 
+
+        for (auto& msg : contenders) {
+            std::string stuffedId = errorCheck->applyBitStuffingToId(msg.getId());
+            uint16_t id = errorCheck->binaryStringToUint16(stuffedId);
+            msg.setStuffedId(id);
+
+            if (stuffedId.size() > maxStuffedBits) {
+                maxStuffedBits = stuffedId.size();
+            }
+        }
+
+        ID_BITS = maxStuffedBits;
+    }
+
+    log(LogRecord(LogRecord::Type::Round, round));
+
+    arbitrationNodes.clear();
+    for (const Node* node : nodes) {
+        arbitrationNodes.push_back({ node->TEC, node->REC, node->nodeActive });
+    }
+
+    for (int bit = ID_BITS - 1; bit >= 0; --bit) {
+
+        ArbitrationStep step = { round, bit, {} };
+
+        log(LogRecord(LogRecord::Type::ArbitrationBit, bit + 1));
+
+        // Print the message IDs still in the race at this bit position
+        log(LogRecord(LogRecord::Type::ContendersHeader));
+        for (const auto& msg : contenders) {
+			int senderId = msg.getSenderId();
+            uint16_t id = msg.getId();
+
+			if (nodes[senderId - 1]->nodeActive == false)
+            {
+				log(LogRecord(LogRecord::Type::DisabledContender, senderId));
+				continue;
+			}
+
+            if (bitStuffingVisible)
+            {
+                std::string stuffedId = errorCheck->applyBitStuffingToId(msg.getId());
+                log(LogRecord(LogRecord::Type::StuffedContender, stuffedId, senderId, msg.getRound()));
+            }
+            else
+            {
+                log(LogRecord(LogRecord::Type::Contender, id, senderId, msg.getRound()));
+            }
+        }
+
+        log(LogRecord(LogRecord::Type::Blank));
+        std::vector<Message> newContenders;
+
+        for (auto& msg : contenders) {
+            uint16_t idBit;
+            if (bitStuffingVisible) {
+				idBit = (msg.getStuffedId() >> bit) & 1;
+            }
+            else
+            {
+                idBit = (msg.getId() >> bit) & 1;
+            }
+
+			step.contenders.push_back({ msg.getSenderId(), static_cast<uint8_t>(idBit) });
+
+            if (newContenders.empty()) {
+                newContenders.push_back(msg);
+            }
+            else {
+                uint16_t prevBit = (newContenders[0].getId() >> bit) & 1;
+
+                if (idBit < prevBit) {
+                    nonContenders.push_back(msg);
+                    newContenders.clear();
+                    newContenders.push_back(msg);
+                }
+                else if (idBit == prevBit) {
+                    newContenders.push_back(msg);
+                }
+                else {
+                    nonContenders.push_back(msg);
+                }
+            }
+        }
+
+        contenders = newContenders;
+
+        arbitrationSteps.push_back(std::move(step));
+
+        if (contenders.empty()) {
+            log(LogRecord(LogRecord::Type::NoMoreContenders, bit));
+            break;
+        }
+    }
+
+    // If we have a winner, process the winning message
+    if (!contenders.empty()) {
+        Message winningMsg = contenders.front();
+
+        uint16_t id = winningMsg.getId();
+        int senderId = winningMsg.getSenderId();
+        log(LogRecord(LogRecord::Type::WinnerMark));
+        log(LogRecord(LogRecord::Type::Winner, id, senderId, winningMsg.getRound()));
+
+        // Sent frames take the bus whether they are acknowledged or not
+        EncodedFrame frame = encodeFrame(winningMsg.getId(), winningMsg.getData());
+        counters.addBusTime(frame.bits.size() + INTERMISSION_BITS);
+
+        for (const auto& msg : filteredMessages) {
+            if (!(msg == winningMsg)) {
+                metrics.recordArbitrationLoss(msg.getSenderId() - 1, msg.getId());
+            }
+        }
+
+        if (nodes[senderId - 1]->nodeActive) {
+            std::string stuffedMessage = nodes[senderId - 1]->sendNextMessage();
+            log(LogRecord(LogRecord::Type::StuffedFrame, stuffedMessage));
+        }
+
+        Message winningMsgCopy = winningMsg;
+
+        uint16_t crcValue = winningMsgCopy.getCRC();
+        log(LogRecord(LogRecord::Type::Crc, crcValue));
+
+        // Print the nodes that received the message and when they set the acknowledgement bit to 1
+        bool activeReceiver = false;
+        int acceptedReceivers = 0;
+        int crcErrors = 0;
+        for (int receiverId : winningMsg.getReceivers())
+        {
+            if (receiverId <= static_cast<int>(nodes.size())) {
+                int i = receiverId - 1;
+
+                if (nodes[receiverId - 1]->nodeActive == true)
+                {
+                    activeReceiver = true;
+                    bool received = nodes[receiverId - 1]->receiveMessage(winningMsgCopy);
+
+                    if (nodes[receiverId - 1]) {
+                        if (received) {
+                            if (!nodes[receiverId - 1]->receivedMessages.empty()) {
+                                log(LogRecord(LogRecord::Type::Received, receiverId));
+                                counters.addReception(receiverId - 1);
+                                if (i < FrameFilter::RECEIVER_BITS) {
+                                    acceptedReceivers |= 1 << i;
+                                }
+                                if (!winningMsg.getACK())
+                                {
+                                    winningMsg.setACK(true);
+                                    log(LogRecord(LogRecord::Type::AckSet, receiverId));
+                                }
+                                nodes[receiverId - 1]->decrementREC();
+                            }
+                            else {
+                                log(LogRecord(LogRecord::Type::CrcFailed, receiverId));
+                                nodes[receiverId - 1]->incrREC();
+                                ++crcErrors;
+                            }
+                        }
+                        else {
+                            log(LogRecord(LogRecord::Type::NotReceived));
+                            nodes[receiverId - 1]->incrREC();
+                        }
+                    }
+                }
+            }
+        }
+
+        int sender_id = winningMsg.getSenderId();
+        bool unacknowledged = !winningMsg.getACK() && activeReceiver;
+        // Check if the acknowledgement bit was set to 1
+        if (unacknowledged) {
+            log(LogRecord(LogRecord::Type::NoReceivers));
+            nodes[sender_id - 1]->incrTEC();
+            statistics.failedTransmissions++;
+            metrics.recordRetransmission(sender_id - 1, winningMsg.getId());
+            counters.addErrorFrame();
+            Message falseWinner = Message(0, std::vector<uint8_t>{0}, 0, false);
+            winners.push_back(falseWinner);
+        }
+        else if (!activeReceiver) {
+            log(LogRecord(LogRecord::Type::NoReceivers));
+            statistics.droppedFrames++;
+            Message falseWinner = Message(0, std::vector<uint8_t>{0}, 0, false);
+            winners.push_back(falseWinner);
+        }
+        else {
+			log(LogRecord(LogRecord::Type::Delivered));
+            winners.push_back(winningMsg);
+
+            auto it = std::find(pendingMessages.begin(), pendingMessages.end(), winningMsg);
+
+            if (it != pendingMessages.end()) {
+                pendingMessages.erase(it);
+            }
+
+            uint64_t inversion = 0;
+            nodes[sender_id - 1]->transmitQueue.remove(transmitKey(winningMsg), round + 1, &inversion);
+            metrics.recordPriorityInversion(sender_id - 1, winningMsg.getId(), inversion);
+
+            nodes[sender_id - 1]->decrementTEC();
+            nodes[sender_id - 1]->removeMessage();
+            statistics.framesDelivered++;
+            metrics.recordDelivery(sender_id - 1, winningMsg.getId(), winningMsg.getRound(), round, round + 1);
+
+            counters.addFrame(sender_id - 1, frame.bits.size(), std::count(frame.stuffBit.begin(), frame.stuffBit.end(), true));
+
+			successfullArbitration = true;
+        }
+
+        if (!monitors.empty()) {
+            observeFrame(winningMsg, winningMsg.getACK() && activeReceiver, crcErrors > 0 || unacknowledged, crcErrors,
+                acceptedReceivers);
+        }
+
+        if (activeReceiver == false)
+        {
+			for (const auto& msg : nodes[senderId-1]->getMessagesToBeSent())
+            {
+                if (msg->getId() == winningMsg.getId() && msg->getReceivers() == winningMsg.getReceivers())
+                {
+					nodes[senderId - 1]->removeMessage();
+                    nodes[senderId - 1]->transmitQueue.remove(transmitKey(*msg), round);
+                    pendingMessages.erase(
+                        std::remove_if(
+                            pendingMessages.begin(),
+                            pendingMessages.end(),
+                            [&msg](const Message& m) {
+                                return (m.getId() == msg->getId()) && (m.getRound() == msg->getRound());
+                            }
+                        ),
+                        pendingMessages.end()
+                    );
+				}
+			}
+        }
+
+        log(LogRecord(LogRecord::Type::CountersHeader));
+        for (size_t i = 0; i < nodes.size(); ++i) 
+        {
+            if (!nodes[i]->nodeActive) continue;
+
+            log(LogRecord(LogRecord::Type::NodeCounters, static_cast<int>(i + 1), nodes[i]->getTEC(), nodes[i]->getREC()));
+			if (nodes[i]->getTEC() >= TEC_LIMIT)
+            {
+				log(LogRecord(LogRecord::Type::TecLimit, static_cast<int>(i + 1)));
+                nodes[i]->setNodeActive(false);
+			}  
+
+			if (nodes[i]->getREC() >= REC_LIMIT)
+			{
+				log(LogRecord(LogRecord::Type::RecLimit, static_cast<int>(i + 1)));
+                nodes[i]->setNodeActive(false);
+			}   
+        }
+
+        log(LogRecord(LogRecord::Type::Blank));
+
+        if (nodes[winningMsg.getSenderId() - 1]->nodeActive == false)
+        {
+            successfullArbitration = true;
+        }
+    }
+    else {
+        counters.addBusTime(IDLE_SLOT_BITS);
+    }
+
+    for (const auto& msg : nonContenders) {
+        if (msg.getId() != contenders.front().getId() &&
+            std::find_if(pendingMessages.begin(), pendingMessages.end(),
+                [&msg](const Message& m) { return m.getId() == msg.getId(); }) == pendingMessages.end()) {
+            pendingMessages.push_back(msg);
+        }
+    }
+
+    return successfullArbitration;
 }
\ No newline at end of file
@@ -1,57 +1,98 @@
-#ifndef CANBUS_H
-#define CANBUS_H
-
-#include <iostream>
-#include <iomanip>
-#include <queue>
-#include <vector>
-#include <memory>
-#include <fstream> 
-#include <map>     
-#include <ctime>   
-
-#include <QObject>
-
-#include "Message.h"
-#include "Node.h"
-#include "CANSim.h"
-#include "ErrorCheck.h"
-
-class Node; 
-class CANSim;
-
-class CANBus : public QObject {
-    Q_OBJECT
-
-public:
-    explicit CANBus(CANSim* simulation, QObject* parent = nullptr);
-
-    bool arbitrate();
-    void addNode(Node* node);
-    bool hasPendingMessages() const { return !pendingMessages.empty(); }
-    int getRound() const { return round; }
-    void incrementRound();
-    void logMessage(const std::string& message); 
-
-    std::vector<Node*> nodes;
-    std::vector<Message> pendingMessages;
-    int round;
-    CANSim* sim;
-    struct ArbitrationStep {
-        int round;
-        int bitPosition;
-        std::vector<Message> contenders;
-        std::vector<Message> nonContenders;
-        std::map<int, std::map<int, std::vector<int>>> roundContenderBitValues;
-        std::map<int, std::map<int, std::vector<Node>>> nodes;
-
-        ArbitrationStep(int r, int bp, const std::vector<Message>& c, const std::vector<Message>& nc)
-            : round(r), bitPosition(bp), contenders(c), nonContenders(nc) {}
-    };
-    std::vector<ArbitrationStep> arbitrationSteps;
-    std::vector<Message> winners;
-    bool bitStuffingVisible;
-    ErrorCheck* errorCheck = new ErrorCheck();
-};
-
+#ifndef CANBUS_H
+#define CANBUS_H
+
+#include <iostream>
+#include <iomanip>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <fstream> 
+#include <map>     
+#include <ctime>   
+
+#include <QObject>
+
+#include "Message.h"
+#include "Node.h"
+#include "ErrorCheck.h"
+#include "SimulationStatistics.h"
+#include "TimingMetrics.h"
+#include "BusCounters.h"
+#include "LogRecord.h"
+
+class Node; 
+class CANSim;
+class BinaryLogWriter;
+class MonitorNode;
+
+class CANBus : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr const char* LOG_PATH = "log.txt";
+
+    // Counter values at which a node is taken off the bus at the end of a round
+    static constexpr int TEC_LIMIT = 9;
+    static constexpr int REC_LIMIT = 4;
+
+    // Buses run without a window, such as what-if runs and tests, can leave the log alone
+    enum class Logging { On, Off };
+
+    explicit CANBus(CANSim* simulation, QObject* parent = nullptr, Logging logging = Logging::On);
+
+    // Every bus writes records to the binary log instead of the text log while one is set.
+    // Set it before the first bus is created and clear it after the last one is gone.
+    static void setBinaryLog(BinaryLogWriter* writer);
+    static bool hasBinaryLog() { return binaryLog != nullptr; }
+    static void flushLog();
+
+    bool arbitrate();
+    void addNode(Node* node);
+    // Monitors see every frame that wins arbitration; the bus does not own them
+    void addMonitor(MonitorNode* monitor);
+    bool hasPendingMessages() const { return !pendingMessages.empty(); }
+    int getRound() const { return round; }
+    void incrementRound();
+    void log(const LogRecord& record);
+    void logMessage(const std::string& message); 
+    SimulationStatistics getStatistics() const;
+
+    std::vector<Node*> nodes;
+    std::vector<Message> pendingMessages;
+    int round;
+    CANSim* sim;
+    // What the viewer shows of arbitration, kept small because a replay holds every step of the run
+    struct Contender {
+        int senderId;
+        uint8_t bit;        // identifier bit the sender puts on the bus at this step
+    };
+    struct ArbitrationStep {
+        int round;
+        int bitPosition;
+        std::vector<Contender> contenders;
+    };
+    struct NodeState {
+        int TEC;
+        int REC;
+        bool active;
+    };
+    std::vector<ArbitrationStep> arbitrationSteps;
+    std::vector<NodeState> arbitrationNodes;    // by node index; the counters do not change while arbitrating
+    std::vector<Message> winners;
+    bool bitStuffingVisible;
+    SimulationStatistics statistics;
+    TimingMetrics metrics;
+    BusCounters counters;
+    ErrorCheck* errorCheck = new ErrorCheck();
+
+private:
+    void observeFrame(const Message& message, bool delivered, bool error, int crcErrors, int receivers);
+
+    std::vector<MonitorNode*> monitors;
+
+    bool logging;
+
+    static inline BinaryLogWriter* binaryLog = nullptr;
+};
+
 #endif
\ No newline at end of file
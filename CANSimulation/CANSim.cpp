@@ -1,941 +1,1337 @@
-#include "CANSim.h"
-
-#include <QGraphicsScene>
-#include <QGraphicsView>
-#include <QVBoxLayout>
-#include <QPushButton>
-#include <QGraphicsTextItem>
-#include <QPen>
-#include <QRandomGenerator>
-#include <QTimer>
-#include <QDockWidget>
-#include <QTableWidget>
-#include <QLabel>
-#include <QDialog>
-#include <QCheckBox>
-#include <QMessageBox>
-#include <QCoreApplication>
-#include <QDesktopServices>
-#include <QFile>
-#include <QUrl>
-#include <random>
-
-#include "NodeConfigWidget.h"
-#include "Message.h"
-#include "MessageDialog.h"
-#include "Node.h"
-
-
-CANSim::CANSim(QWidget* parent)
-    : QMainWindow(parent), nextXPosition(50), simulationStarted(false)
-{
-    resize(600, 500);
-    createWelcomeScreen();
-}
-
-void CANSim::createWelcomeScreen()
-{
-    QWidget* welcomeWidget = new QWidget(this);
-    setCentralWidget(welcomeWidget);
-
-    QVBoxLayout* welcomeLayout = new QVBoxLayout(welcomeWidget);
-
-    QLabel* welcomeLabel = new QLabel("Welcome to CAN Simulator", this);
-    welcomeLabel->setAlignment(Qt::AlignCenter);
-    QFont font = welcomeLabel->font();
-    font.setPointSize(18);
-    welcomeLabel->setFont(font);
-    welcomeLayout->addWidget(welcomeLabel);
-
-    QPushButton* predefinedButton = new QPushButton("Use Predefined Scenario", this);
-    QPushButton* customButton = new QPushButton("Configure Your Own", this);
-
-    welcomeLayout->addWidget(predefinedButton);
-    welcomeLayout->addWidget(customButton);
-
-    connect(predefinedButton, &QPushButton::clicked, this, &CANSim::selectPredefinedScenario);
-    connect(customButton, &QPushButton::clicked, this, &CANSim::initializeCustomConfiguration);
-}
-
-void CANSim::selectPredefinedScenario()
-{
-    QDialog* predefinedDialog = new QDialog(this);
-    predefinedDialog->setWindowTitle("Select Predefined Scenario");
-
-    QVBoxLayout* layout = new QVBoxLayout(predefinedDialog);
-
-    QLabel* label = new QLabel("Choose a predefined scenario:", predefinedDialog);
-    layout->addWidget(label);
-
-    QPushButton* scenario1Button = new QPushButton("Scenario 1", predefinedDialog);
-    QPushButton* scenario2Button = new QPushButton("Scenario 2", predefinedDialog);
-    QPushButton* scenario3Button = new QPushButton("Scenario 3", predefinedDialog);
-
-    layout->addWidget(scenario1Button);
-    layout->addWidget(scenario2Button);
-    layout->addWidget(scenario3Button);
-
-    connect(scenario1Button, &QPushButton::clicked, this, [this, predefinedDialog]() {
-        setupPredefinedScenario(1);
-        predefinedDialog->accept();
-        });
-
-    connect(scenario2Button, &QPushButton::clicked, this, [this, predefinedDialog]() {
-        setupPredefinedScenario(2);
-        predefinedDialog->accept();
-        });
-
-    connect(scenario3Button, &QPushButton::clicked, this, [this, predefinedDialog]() {
-        setupPredefinedScenario(3);
-        predefinedDialog->accept();
-        });
-
-    predefinedDialog->exec();
-}
-
-void CANSim::setupPredefinedScenario(int scenario)
-{
-    QWidget* centralWidget = new QWidget(this);
-    setCentralWidget(centralWidget);
-    layout = new QVBoxLayout(centralWidget);
-
-    graphicsView = new QGraphicsView(this);
-    scene = new QGraphicsScene(this);
-    graphicsView->setScene(scene);
-    layout->addWidget(graphicsView);
-
-    QGraphicsLineItem* canHighLine = scene->addLine(0, 100, 500, 100);
-    QGraphicsLineItem* canLowLine = scene->addLine(0, 200, 500, 200);
-
-    changeLineColor(canHighLine, Qt::white);
-    changeLineColor(canLowLine, Qt::white);
-
-    canLines.append(canHighLine);
-    canLines.append(canLowLine);
-
-    QGraphicsTextItem* canHighLabel = scene->addText("CAN High");
-    canHighLabel->setPos(10, 80);
-
-    QGraphicsTextItem* canLowLabel = scene->addText("CAN Low");
-    canLowLabel->setPos(10, 180);
-
-    canBusLabel = scene->addText("CAN Bus");
-    canBusLabel->setPos(250, 140);
-
-    canBus = new CANBus(this);
-    canBus->bitStuffingVisible = false;
-
-    roundLabel = scene->addText("Round: -");
-    roundLabel->setDefaultTextColor(Qt::white);
-    roundLabel->setFont(QFont("Arial", 14));
-    roundLabel->setPos(1, 10);
-
-    bitPositionLabel = scene->addText("Bit Position: -");
-    bitPositionLabel->setDefaultTextColor(Qt::white);
-    bitPositionLabel->setFont(QFont("Arial", 14));
-    bitPositionLabel->setPos(1, 40);
-
-    switch (scenario) {
-    case 1: 
-        addPredefinedNode(1, { {2, 5}, {3, 10} }, false);
-        addPredefinedNode(2, { {3, 1} }, false);
-        addPredefinedNode(3, {}, true);
-        break;
-
-    case 2:
-        addPredefinedNode(1, { {2, 5} }, false);
-        addPredefinedNode(2, { {1, 5}, {3, 5} }, false);
-        addPredefinedNode(3, { {1, 1} }, false);
-        break;
-
-    case 3:
-        addPredefinedNode(1, { {2, 5}, {3, 1} }, false);
-        addPredefinedNode(2, { {3, 1} }, true);
-        addPredefinedNode(3, { {1, 5} }, false);
-        addPredefinedNode(4, { {3, 1}, {1, 5} }, false);
-        break;
-    }
-
-    startPredefinedSimulation();
-}
-
-void CANSim::addPredefinedNode(int nodeId, const std::map<int, int>& messageAndFreq, bool error) 
-{
-    NodeConfigWidget* newNode = new NodeConfigWidget(nodeId, 0, 0, true);
-    nodeWidgets.append(newNode);
-
-    Node* node = new Node(nodeId, canBus);
-    addNode(node, error);
-
-    scene->addItem(newNode);
-
-    newNode->setPos(nextXPosition, 600);
-    nextXPosition += 150;
-
-    for (const auto& target : messageAndFreq) {
-        int targetId = target.first;
-        int frequency = target.second;
-
-        int interval = 60 / frequency;
-        for (int sec = 0; sec < 60; sec += interval) {
-            node->addNodesAndRound(sec, targetId);
-            qDebug() << "Node " << nodeId << " will send a message to Node " << targetId << " at second " << sec;
-        }
-
-        node->generate11BitID();
-    }
-
-    QGraphicsLineItem* line1 = scene->addLine(newNode->x() + 25, newNode->y(), newNode->x() + 25, 100);
-    QGraphicsLineItem* line2 = scene->addLine(newNode->x() + 75, newNode->y(), newNode->x() + 75, 200);
-
-    changeLineColor(line1, Qt::white);
-    changeLineColor(line2, Qt::white);
-
-    canLines.append(line1);
-    canLines.append(line2);
-    nodeLinesHigh.append(line1);
-    nodeLinesLow.append(line2);
-
-    updateCANBusLines();
-}
-
-void CANSim::startPredefinedSimulation() 
-{
-    canBus->pendingMessages = collectAllMessages();
-
-    createMessagePanel();
-    processPendingMessages();
-
-    QPushButton* seeLogFileButton = new QPushButton("See Log File", this);
-    layout->addWidget(seeLogFileButton);
-
-    connect(seeLogFileButton, &QPushButton::clicked, this, [this]() {
-        QString logFilePath = "C:/Users/Maria\ Gozman-Pop/OneDrive/Desktop/Semester1/SCS_p/CANSim/log.txt";
-
-        if (QFile::exists(logFilePath)) {
-            QDesktopServices::openUrl(QUrl::fromLocalFile(logFilePath));
-        }
-        else {
-            QMessageBox::warning(this, "File Not Found", "The log file 'log.txt' does not exist in the current directory.");
-        }
-        });
-
-    bool messagesPending;
-    do {
-        messagesPending = true;
-
-        std::cout << "Round: " << canBus->getRound() << "\n";
-
-        bool success = canBus->arbitrate();
-
-        if (!canBus->hasPendingMessages()) {
-            messagesPending = false;
-        }
-
-        if (success)
-            canBus->incrementRound();
-
-        if (canBus->getRound() > 60) {
-            messagesPending = false;
-        }
-
-    } while (messagesPending);
-
-    processSimulation();
-}
-
-void CANSim::initializeCustomConfiguration()
-{
-    QWidget* centralWidget = new QWidget(this);
-    setCentralWidget(centralWidget);
-    layout = new QVBoxLayout(centralWidget);
-
-    graphicsView = new QGraphicsView(this);
-    scene = new QGraphicsScene(this);
-    graphicsView->setScene(scene);
-    layout->addWidget(graphicsView);
-
-    QGraphicsLineItem* canHighLine = scene->addLine(0, 100, 500, 100);
-    QGraphicsLineItem* canLowLine = scene->addLine(0, 200, 500, 200); 
-
-    changeLineColor(canHighLine, Qt::white);
-    changeLineColor(canLowLine, Qt::white);
-
-    canLines.append(canHighLine);
-    canLines.append(canLowLine);
-
-    QGraphicsTextItem* canHighLabel = scene->addText("CAN High");
-    canHighLabel->setPos(10, 80); 
-
-    QGraphicsTextItem* canLowLabel = scene->addText("CAN Low");
-    canLowLabel->setPos(10, 180);  
-
-    canBusLabel = scene->addText("CAN Bus");
-    canBusLabel->setPos(250, 140); 
-
-    canBus = new CANBus(this);
-
-    NodeConfigWidget* exampleNode1 = new NodeConfigWidget(1, 0, 0, true);
-	nodeWidgets.append(exampleNode1);
-
-    NodeConfigWidget* exampleNode2 = new NodeConfigWidget(2, 0, 0, true);
-    nodeWidgets.append(exampleNode2);
-
-    scene->addItem(exampleNode1);
-    scene->addItem(exampleNode2);
-
-    Node* node1 = new Node(1, canBus);
-    bool error = getRandomBool();
-    addNode(node1, false);
-
-    roundLabel = scene->addText("Round: -");
-    roundLabel->setDefaultTextColor(Qt::white);
-    roundLabel->setFont(QFont("Arial", 14));
-    roundLabel->setPos(1, 10);  
-
-    bitPositionLabel = scene->addText("Bit Position: -");
-    bitPositionLabel->setDefaultTextColor(Qt::white);
-    bitPositionLabel->setFont(QFont("Arial", 14));
-    bitPositionLabel->setPos(1, 40);
-
-    connect(exampleNode1, &NodeConfigWidget::nodeClicked, this,
-        [this, node1](int nodeId) {
-            openSendMessageDialog(nodeId, node1);
-        });
-
-    Node* node2 = new Node(2, canBus);
-	error = getRandomBool();
-    addNode(node2, true);
-
-    connect(exampleNode2, &NodeConfigWidget::nodeClicked, this,
-        [this, node2](int nodeId) {
-            openSendMessageDialog(nodeId, node2);
-        });
-
-    exampleNode1->setPos(nextXPosition, 600);  
-    nextXPosition += 150; 
-    exampleNode2->setPos(nextXPosition, 600); 
-    nextXPosition += 150; 
-
-    QGraphicsLineItem* line1 = scene->addLine(exampleNode1->x() + 25, exampleNode1->y(), exampleNode1->x() + 25, 100);
-    QGraphicsLineItem* line2 = scene->addLine(exampleNode1->x() + 75, exampleNode1->y(), exampleNode1->x() + 75, 200);  
-
-    QGraphicsLineItem* line3 = scene->addLine(exampleNode2->x() + 25, exampleNode2->y(), exampleNode2->x() + 25, 100);  
-    QGraphicsLineItem* line4 = scene->addLine(exampleNode2->x() + 75, exampleNode2->y(), exampleNode2->x() + 75, 200);  
-
-    changeLineColor(line1, Qt::white);
-    changeLineColor(line2, Qt::white);
-    changeLineColor(line3, Qt::white);
-    changeLineColor(line4, Qt::white);
-
-    canLines.append(line1);
-    canLines.append(line2);
-    canLines.append(line3);
-    canLines.append(line4);
-
-    nodeLinesHigh.append(line1); 
-    nodeLinesLow.append(line2); 
-    nodeLinesHigh.append(line3); 
-    nodeLinesLow.append(line4);   
-
-    QCheckBox* bitStuffingCheckBox = new QCheckBox("Show Bit Stuffing", this);
-    layout->addWidget(bitStuffingCheckBox);
-
-    addNodeButton = new QPushButton("Add Node", this);
-    layout->addWidget(addNodeButton);
-
-    startSimButton = new QPushButton("Start Simulation", this);
-    layout->addWidget(startSimButton);
-
-    connect(bitStuffingCheckBox, &QCheckBox::stateChanged, this, [this](int state) {
-        canBus->bitStuffingVisible = (state == Qt::Checked); 
-        if (state == Qt::Checked) {
-            QMessageBox::information(this, "Bit Stuffing", "Bit stuffing is now visible.");
-        }
-        else {
-            QMessageBox::information(this, "Bit Stuffing", "Bit stuffing is now hidden.");
-        }
-        });
-
-    connect(startSimButton, &QPushButton::clicked, this, [this]() {
-        simulationStarted = true;
-		addMessage = false;
-        startSimButton->setEnabled(false);
-        addNodeButton->setEnabled(false);
-
-        canBus->pendingMessages = collectAllMessages();
-
-        createMessagePanel();
-        processPendingMessages();
-
-        QPushButton* seeLogFileButton = new QPushButton("See Log File", this);
-        layout->addWidget(seeLogFileButton);
-
-        connect(seeLogFileButton, &QPushButton::clicked, this, [this]() {
-            QString logFilePath = "C:/Users/Maria\ Gozman-Pop/OneDrive/Desktop/Semester1/SCS_p/CANSim/log.txt";
-
-            if (QFile::exists(logFilePath)) {
-                QDesktopServices::openUrl(QUrl::fromLocalFile(logFilePath));
-            }
-            else {
-                QMessageBox::warning(this, "File Not Found", "The log file 'log.txt' does not exist in the current directory.");
-            }
-            });
-
-        bool messagesPending;
-        do {
-            messagesPending = true;
-
-            std::cout << "Round: " << canBus->getRound() << "\n";
-
-            bool success = canBus->arbitrate();
-
-            if (!canBus->hasPendingMessages()) {
-                messagesPending = false;
-            }
-
-            if (success)
-                canBus->incrementRound();
-
-			if (canBus->getRound() > 60) {
-				messagesPending = false;
-			}
-
-        } while (messagesPending);
-
-        processSimulation();
-
-        });
-
-    connect(addNodeButton, &QPushButton::clicked, this, [this]() {
-        if (simulationStarted) {
-            return; 
-        }
-
-        if (nodesInSim.size() >= 8) {
-            QMessageBox::warning(this, "Max Nodes Reached", "You cannot add more than 8 nodes.");
-            return;
-        }
-
-        static int nodeId = 3; 
-        NodeConfigWidget* newNode = new NodeConfigWidget(nodeId, 0, 0, true);
-        nodeWidgets.append(newNode);
-
-        Node* node = new Node(nodeId, canBus);
-		bool error = getRandomBool();
-        addNode(node, error);
-
-        scene->addItem(newNode);
-
-        connect(newNode, &NodeConfigWidget::nodeClicked, this,
-            [this, node](int nodeId) {
-                openSendMessageDialog(nodeId, node);
-            });
-
-        newNode->setPos(nextXPosition, 600);  
-        nextXPosition += 150;  
-
-        QGraphicsLineItem* line1 = scene->addLine(newNode->x() + 25, newNode->y(), newNode->x() + 25, 100);  
-        QGraphicsLineItem* line2 = scene->addLine(newNode->x() + 75, newNode->y(), newNode->x() + 75, 200); 
-
-        changeLineColor(line1, Qt::white);
-        changeLineColor(line2, Qt::white);
-
-        canLines.append(line1);
-        canLines.append(line2);
-
-        nodeLinesHigh.append(line1);  
-        nodeLinesLow.append(line2);  
-
-        updateCANBusLines();
-
-        nodeId++;
-        });
-}
-
-CANSim::~CANSim()
-{
-    delete graphicsView;
-    delete scene;
-}
-
-//void CANSim::processSimulation() {
-//
-//    int counter = 0;
-//    for (const auto& step : canBus->arbitrationSteps) {
-//        // Print the arbitration details for the current step
-//        if (counter % 11 == 0)
-//        {
-//            qDebug() << "Arbitration step for round:" << step.round;
-//        }
-//
-//        qDebug() << "-----";
-//        qDebug() << "Bit Position:" << step.bitPosition;
-//
-//        // Print contenders and their bit values for the current step
-//        qDebug() << "---";
-//        qDebug() << "Contenders for round" << step.round << ":";
-//        for (const auto& msg : step.contenders) {
-//            uint16_t id = msg.getId();
-//            qDebug() << "Message ID: " << id << " Bit: " << ((id >> (11 - 1)) & 1);  // Example: show the bit value
-//        }
-//
-//        // Print non-contenders for the current step
-//        qDebug() << "---";
-//        qDebug() << "Non-Contenders for round" << step.round << ":";
-//        for (const auto& msg : step.nonContenders) {
-//            qDebug() << "Message ID: " << msg.getId();
-//        }
-//
-//        qDebug() << "---";
-//        if (step.bitPosition == 0) {
-//            qDebug() << "Winner for round" << step.round << ":";
-//            Message winner = canBus->winners.front();
-//			markMessageAsSent(winner.getSenderId(), winner.getId(), winner.getRound());
-//            canBus->winners.erase(canBus->winners.begin());
-//            qDebug() << "Winner Message ID: " << winner.getId();
-//            qDebug() << "---------------------------";
-//        }
-//
-//        counter++;
-//    }
-//}
-
-void CANSim::processSimulation()
-{
-    stepCounter = 0;
-    roundCount = 0;
-
-    simulationTimer = new QTimer(this);
-    simulationTimer->start(500);
-
-    connect(simulationTimer, &QTimer::timeout, this, [this]() {
-
-        //qDebug() << "Step Counter: " << stepCounter;
-        //qDebug() << "Round Count: " << roundCount;
-
-        nodesInSim = canBus->nodes;
-
-        bool errorSent = false;
-
-        if (stepCounter < canBus->arbitrationSteps.size()) {
-            const auto& step = canBus->arbitrationSteps[stepCounter];
-
-            int i = 0;
-            for (const auto& node : nodeWidgets) {
-                Node nodeStep = step.nodes.at(step.round).at(i).front();
-                int tecCount = nodeStep.getTEC();
-                int recCount = nodeStep.getREC();
-
-                node->setTECCount(tecCount);
-                node->setRECCount(recCount);
-
-                if (nodeStep.nodeActive == false) {
-                    node->setNodeActive(false);
-                    errorSent = true;
-                }
-
-                i++;
-            }
-
-            if (roundCount < step.round) {
-                setAllLinesToWhite();
-                roundLabel->setPlainText(QString("Round (event/second): %1").arg(roundCount));
-                //qDebug() << "Round " << roundCount << " has no arbitration steps.";
-                roundCount++;
-                return;
-            }
-
-            setAllLinesToWhite();
-
-            dom = false;
-            rec = false;
-
-            roundLabel->setPlainText(QString("Round (event/second): %1").arg(step.round));
-
-            for (const auto& msg : step.contenders)
-            {
-                bitPositionLabel->setPlainText(QString("Bit Position: %1").arg(step.bitPosition));
-
-                uint16_t bitValue = step.roundContenderBitValues.at(step.round).at(msg.getSenderId()).front();
-
-                int senderId = msg.getSenderId() - 1;
-
-                if (bitValue == 1) {
-                    rec = true;
-                    toggleLineColorRec(nodeLinesLow[senderId], nodeLinesHigh[senderId]);
-                    //qDebug() << "Node " << senderId + 1 << " is recessive.";
-                }
-                else {
-                    rec = false;
-                    dom = true;
-                    toggleLineColorDom(nodeLinesLow[senderId], nodeLinesHigh[senderId]);
-                    //qDebug() << "Node " << senderId + 1 << " is dominant.";
-                }
-            }
-
-            /*for (const auto& msg : step.nonContenders) {
-                qDebug() << "Message ID: " << msg.getId();
-            }*/
-
-            if (step.bitPosition == 0)
-            {
-                Message winner = canBus->winners.front();
-                if (winner.getId() != 0)
-                {
-                    markMessageAsSent(winner.getSenderId(), winner.getId(), winner.getRound());
-                    
-					uint16_t message_id = winner.getId();
-                    int winner_round = winner.getRound();
-                    for (int i = 0; i < 8; i++)
-                    {
-                        if ((message_id >> i) & 1)
-                        {
-                            std::vector<Message*> receivedMessages = canBus->nodes[i]->getReceivedMessages();
-                            if (receivedMessages.empty())
-                            {
-                                qDebug() << "EMPTY FOR NODE " << canBus->nodes[i]->getNodeId();
-                            }
-                            for (const auto& msg : receivedMessages) {
-								//qDebug() << "Message ID: " << msg->getId() << " Round: " << msg->getRound();
-                                if (msg->getRound() == winner_round && msg->getId() == message_id) {
-                                    if (nodeWidgets[i]->isActive()) {
-                                        nodeWidgets[i]->receiveMessage(message_id);
-                                    }
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-                canBus->winners.erase(canBus->winners.begin());
-            }
-
-            stepCounter++;
-            roundCount = step.round;
-        }
-        else
-        {
-            setAllLinesToWhite();
-            roundLabel->setPlainText(QString("Round (event/second): %1").arg(roundCount));
-            roundCount++;
-
-            if (roundCount >= 60) {
-                qDebug() << "Simulation complete.";
-                QMessageBox::information(this, "Simulation Complete", "The simulation has successfully completed!");
-                simulationTimer->stop();
-            }
-        }
-        });
-}
-
-void CANSim::createMessagePanel()
-{
-    QDockWidget* messageDockWidget = new QDockWidget("Message Status", this);
-    messageDockWidget->setAllowedAreas(Qt::RightDockWidgetArea | Qt::LeftDockWidgetArea);
-    addDockWidget(Qt::RightDockWidgetArea, messageDockWidget);
-
-    QWidget* messagePanelWidget = new QWidget(messageDockWidget);
-    QVBoxLayout* panelLayout = new QVBoxLayout(messagePanelWidget);
-
-    pendingMessagesTable = new QTableWidget(0, 3, this);
-    pendingMessagesTable->setHorizontalHeaderLabels({ "Node ID", "Message ID", "Initial Round" });
-    pendingMessagesTable->setObjectName("pendingMessagesTable");
-    panelLayout->addWidget(new QLabel("Pending Messages"));
-    panelLayout->addWidget(pendingMessagesTable);
-
-    sentMessagesTable = new QTableWidget(0, 3, this);
-    sentMessagesTable->setHorizontalHeaderLabels({ "Node ID", "Message ID", "Initial Round" });
-    sentMessagesTable->setObjectName("sentMessagesTable");
-    panelLayout->addWidget(new QLabel("Sent Messages"));
-    panelLayout->addWidget(sentMessagesTable);
-
-    messagePanelWidget->setLayout(panelLayout);
-    messageDockWidget->setWidget(messagePanelWidget);
-}
-
-void CANSim::addPendingMessage(int nodeId, uint16_t identifier, int round)
-{
-    int row = pendingMessagesTable->rowCount();
-    pendingMessagesTable->insertRow(row);
-
-    pendingMessagesTable->setItem(row, 0, new QTableWidgetItem(QString::number(nodeId)));
-
-    QString binaryIdentifier = QString::number(identifier, 2).rightJustified(11, '0');
-    pendingMessagesTable->setItem(row, 1, new QTableWidgetItem(binaryIdentifier));
-
-    pendingMessagesTable->setItem(row, 2, new QTableWidgetItem(QString::number(round)));
-}
-
-void CANSim::processPendingMessages()
-{
-    for (Node* node : nodesInSim) {
-        const std::vector<Message*> messages = node->getMessagesToBeSent();
-
-        for (const auto& message : messages) {
-            int round = message->getRound();
-            int senderNodeId = node->getNodeId();
-            uint16_t identifier = message->getId();
-
-            addPendingMessage(senderNodeId, identifier, round);
-        }
-    }
-}
-
-void CANSim::markMessageAsSent(int nodeId, uint16_t messageId, int round)
-{
-    for (int row = 0; row < pendingMessagesTable->rowCount(); ++row) {
-        if (pendingMessagesTable->item(row, 0)->text().toInt() == nodeId &&
-            pendingMessagesTable->item(row, 1)->text().toInt(nullptr, 2) == messageId &&
-            pendingMessagesTable->item(row, 2)->text().toInt() == round) {
-
-            QString binaryIdentifier = QString::number(messageId, 2).rightJustified(11, '0');
-
-            int sentRow = sentMessagesTable->rowCount();
-            sentMessagesTable->insertRow(sentRow);
-            sentMessagesTable->setItem(sentRow, 0, new QTableWidgetItem(QString::number(nodeId)));
-            sentMessagesTable->setItem(sentRow, 1, new QTableWidgetItem(binaryIdentifier));
-            sentMessagesTable->setItem(sentRow, 2, new QTableWidgetItem(QString::number(round)));
-
-            pendingMessagesTable->removeRow(row);
-
-            break;
-        }
-    }
-
-    pendingMessagesTable->viewport()->update();
-    sentMessagesTable->viewport()->update();
-
-}
-
-void CANSim::changeLineColor(QGraphicsLineItem* line, const QColor& color)
-{
-    QPen pen = line->pen();
-    pen.setColor(color);  
-    line->setPen(pen);  
-}
-
-void CANSim::updateCANBusLines()
-{
-    canLines[0]->setLine(0, 100, nextXPosition + 50, 100);
-    canLines[1]->setLine(0, 200, nextXPosition + 50, 200); 
-
-    int centerY = (100 + 200) / 2; 
-    canBusLabel->setPos(nextXPosition / 2 - 50, centerY - 10);
-}
-
-void CANSim::toggleLineColorDom(QGraphicsLineItem* canl, QGraphicsLineItem* canh)
-{
-    changeLineColor(canl, Qt::yellow);
-    changeLineColor(canh, Qt::yellow);
-    changeLineColor(canLines[0], Qt::yellow);
-    changeLineColor(canLines[1], Qt::yellow);
-}
-
-void CANSim::toggleLineColorRec(QGraphicsLineItem* canl, QGraphicsLineItem* canh)
-{
-    changeLineColor(canl, Qt::red);
-    changeLineColor(canh, Qt::green);
-    if (rec == true && dom == false) {
-        changeLineColor(canLines[1], Qt::red);
-        changeLineColor(canLines[0], Qt::green);
-    }
-}
-
-// added for dem
-//void CANSim::toggleRandomLineColor()
-//{
-//    int random = QRandomGenerator::global()->bounded(5);
-//
-//    if (!nodeLinesHigh.isEmpty() && !nodeLinesLow.isEmpty()) {
-//        if (random == 0)
-//        {
-//            dom = true;
-//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
-//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
-//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
-//            toggleLineColorDom(lineHigh, lineLow);
-//            dom = false;
-//        }
-//        else if (random == 1)
-//        {
-//            rec = true;
-//            dom = false;
-//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
-//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
-//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
-//            toggleLineColorRec(lineHigh, lineLow);
-//            rec = false;
-//        }
-//        else if (random == 2)
-//        {
-//            dom = true;
-//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
-//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
-//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
-//            toggleLineColorDom(lineHigh, lineLow);
-//
-//            randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
-//            lineHigh = nodeLinesHigh[randomIndex];
-//            lineLow = nodeLinesLow[randomIndex];
-//            toggleLineColorRec(lineHigh, lineLow);
-//        }
-//        else
-//        {
-//            rec = true;
-//            dom = false;
-//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
-//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
-//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
-//            toggleLineColorRec(lineHigh, lineLow);
-//
-//            randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
-//            lineHigh = nodeLinesHigh[randomIndex];
-//            lineLow = nodeLinesLow[randomIndex];
-//            toggleLineColorRec(lineHigh, lineLow);
-//        }
-//    }
-//}
-
-void CANSim::setAllLinesToWhite()
-{
-    dom = false;
-    rec = false;
-    for (QGraphicsLineItem* line : canLines) {
-        changeLineColor(line, Qt::white);
-    }
-
-    for (QGraphicsLineItem* line : nodeLinesHigh) {
-        changeLineColor(line, Qt::white);
-    }
-    for (QGraphicsLineItem* line : nodeLinesLow) {
-        changeLineColor(line, Qt::white);
-    }
-	for (NodeConfigWidget* node : nodeWidgets) {
-        node->messageReceived = false;
-		node->update();
-	}
-}
-
-//void CANSim::resetLinesAndToggleColor()
-//{
-//    //necessary
-//    setAllLinesToWhite();
-//
-//    if (pendingMessagesTable->rowCount() == 0) {
-//        simulationTimer->stop();  // Stop the simulation timer when no more messages are pending
-//        return;  // Exit the function to prevent further toggling
-//    }
-//
-//    //added for dem
-//    toggleCount++;
-//    if (toggleCount % 4 == 0) {
-//        int rowCount = pendingMessagesTable->rowCount();
-//
-//        if (rowCount > 0) {
-//            // Select a random pending message to mark as sent
-//            int randomRow = QRandomGenerator::global()->bounded(rowCount);
-//
-//            // Retrieve the message details from the selected row
-//            int nodeId = pendingMessagesTable->item(randomRow, 0)->text().toInt();
-//            int messageId = pendingMessagesTable->item(randomRow, 1)->text().toInt();
-//            bool errorDetected = QRandomGenerator::global()->bounded(2);
-//
-//            // Move the message to "Sent Messages" table
-//            //markMessageAsSent(nodeId, messageId, errorDetected);
-//        }
-//    }
-//
-//    QTimer::singleShot(500, this, &CANSim::toggleRandomLineColor); 
-//}
-
-void CANSim::openSendMessageDialog(int senderNodeId, Node* node) {
-    QVector<int> availableNodes;
-    for (auto nodeItem : scene->items()) {
-        NodeConfigWidget* node = dynamic_cast<NodeConfigWidget*>(nodeItem);
-        if (node) {
-            availableNodes.append(node->getNodeId());
-        }
-    }
-
-    MessageDialog* dialog = new MessageDialog(senderNodeId, availableNodes, node, this);
-
-    connect(dialog, &MessageDialog::messageReady, this, [this](int senderNodeId, int messageId, QVector<int> targetNodeIds) {
-        messageList.append(qMakePair(senderNodeId, messageId));
-    });
-
-    dialog->exec();
-}
-
-void CANSim::addNode(Node* node, bool error) {
-    if (error){
-		node->setError(true);
-    }
-    else {
-        node->setError(false);
-    }
-    node->setNodeActive(true);
-    nodesInSim.push_back(node);
-}
-
-std::vector<Node*>&CANSim::getNodes() {
-    return nodesInSim;
-}
-
-Node* CANSim::findNodeById(int id) {
-    for (auto nodePtr : nodesInSim) { 
-        if (nodePtr->getNodeId() == id) {  
-            return nodePtr; 
-        }
-    }
-    return nullptr;
-}
-
-std::vector<Message> CANSim::collectAllMessages() const {
-    std::vector<Message> allMessages;
-
-    for (Node* node : nodesInSim) {
-        const auto& messagesAndRounds = node->getMessagesToBeSent();
-
-        for (const auto& roundMessagePair : messagesAndRounds) {
-            const Message* msg = roundMessagePair;
-            if (msg) {
-                allMessages.push_back(*msg);
-            }
-        }
-    }
-
-    return allMessages;
-}
-
-bool CANSim::getRandomBool() {
-    std::random_device rd;  
-    std::mt19937 gen(rd()); 
-    std::uniform_int_distribution<> dist(0, 1); 
-    return dist(gen);
-}
-
-//void CANSim::printNodesAndRounds() {
-//    // Iterate through each node in the simulation
-//    for (Node* node : nodesInSim) {
-//        // Print the node ID in debug output
-//        qDebug() << "Node ID:" << node->getNodeId();
-//
-//        // Get the nodesAndRounds map for this node
-//        const std::map<int, std::vector<int>>& nodesAndRounds = node->getNodesAndRounds();
-//
-//        // Iterate through the map (rounds -> nodes)
-//        for (auto it = nodesAndRounds.begin(); it != nodesAndRounds.end(); ++it) {
-//            int second = it->first;  // The round (second)
-//            const std::vector<int>& nodeIds = it->second;  // List of node IDs in this round
-//
-//            // Print the second (round) and node IDs in debug output
-//            QString nodeIdsString = "Nodes -> ";
-//            for (int id : nodeIds) {
-//                nodeIdsString += QString::number(id) + " ";
-//            }
-//
-//            qDebug() << "  Second" << second << ":" << nodeIdsString;
-//        }
-//    }
+#include "CANSim.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QVBoxLayout>
+#include <QPushButton>
+#include <QGraphicsTextItem>
+#include <QPen>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QDockWidget>
+#include <QTableView>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QDialog>
+#include <QCheckBox>
+#include <QMessageBox>
+#include <QCoreApplication>
+#include <QFileDialog>
+#include <QProgressBar>
+#include <QHBoxLayout>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QSlider>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "NodeConfigWidget.h"
+#include "NodeGroupItem.h"
+#include "BitLevelBus.h"
+#include "BitTrace.h"
+#include "BusTimelineWidget.h"
+#include "DbcImporter.h"
+#include "LogViewer.h"
+#include "Message.h"
+#include "MessageDialog.h"
+#include "MessageTableModel.h"
+#include "Node.h"
+#include "PeriodicScheduler.h"
+#include "ReplayIndex.h"
+#include "Scenario.h"
+#include "ScenarioFile.h"
+#include "CounterExporter.h"
+#include "MonitorNode.h"
+#include "SimulationWorker.h"
+#include "ResponseTimeAnalysis.h"
+#include "TopologyView.h"
+
+static const int NODES_PER_ROW = 32;
+static const int NODE_SPACING = 150;
+static const int FIRST_NODE_X = 50;
+static const int ROW_HEIGHT = 450;             // each row: CAN_H, CAN_L, then the nodes
+static const int CAN_HIGH_Y = 100;
+static const int CAN_LOW_Y = 200;
+static const int NODE_Y = 300;
+static const int BUS_TRUNK_OFFSET = 20;
+static const int REPLAY_STEP_INTERVAL = 500;    // milliseconds per step at 1x
+static const int MIN_REPLAY_INTERVAL = 16;      // one display frame
+
+CANSim::CANSim(QWidget* parent)
+    : QMainWindow(parent), simulationStarted(false)
+{
+    resize(600, 500);
+    createWelcomeScreen();
+}
+
+void CANSim::createWelcomeScreen()
+{
+    QWidget* welcomeWidget = new QWidget(this);
+    setCentralWidget(welcomeWidget);
+
+    QVBoxLayout* welcomeLayout = new QVBoxLayout(welcomeWidget);
+
+    QLabel* welcomeLabel = new QLabel("Welcome to CAN Simulator", this);
+    welcomeLabel->setAlignment(Qt::AlignCenter);
+    QFont font = welcomeLabel->font();
+    font.setPointSize(18);
+    welcomeLabel->setFont(font);
+    welcomeLayout->addWidget(welcomeLabel);
+
+    QPushButton* predefinedButton = new QPushButton("Use Predefined Scenario", this);
+    QPushButton* scenarioFileButton = new QPushButton("Load Scenario File", this);
+    QPushButton* dbcFileButton = new QPushButton("Load DBC", this);
+    QPushButton* customButton = new QPushButton("Configure Your Own", this);
+
+    welcomeLayout->addWidget(predefinedButton);
+    welcomeLayout->addWidget(scenarioFileButton);
+    welcomeLayout->addWidget(dbcFileButton);
+    welcomeLayout->addWidget(customButton);
+
+    connect(predefinedButton, &QPushButton::clicked, this, &CANSim::selectPredefinedScenario);
+    connect(scenarioFileButton, &QPushButton::clicked, this, &CANSim::selectScenarioFile);
+    connect(dbcFileButton, &QPushButton::clicked, this, &CANSim::selectDbcFile);
+    connect(customButton, &QPushButton::clicked, this, &CANSim::initializeCustomConfiguration);
+}
+
+void CANSim::selectPredefinedScenario()
+{
+    QDialog* predefinedDialog = new QDialog(this);
+    predefinedDialog->setWindowTitle("Select Predefined Scenario");
+
+    QVBoxLayout* layout = new QVBoxLayout(predefinedDialog);
+
+    QLabel* label = new QLabel("Choose a predefined scenario:", predefinedDialog);
+    layout->addWidget(label);
+
+    QPushButton* scenario1Button = new QPushButton("Scenario 1", predefinedDialog);
+    QPushButton* scenario2Button = new QPushButton("Scenario 2", predefinedDialog);
+    QPushButton* scenario3Button = new QPushButton("Scenario 3", predefinedDialog);
+
+    layout->addWidget(scenario1Button);
+    layout->addWidget(scenario2Button);
+    layout->addWidget(scenario3Button);
+
+    connect(scenario1Button, &QPushButton::clicked, this, [this, predefinedDialog]() {
+        setupPredefinedScenario(1);
+        predefinedDialog->accept();
+        });
+
+    connect(scenario2Button, &QPushButton::clicked, this, [this, predefinedDialog]() {
+        setupPredefinedScenario(2);
+        predefinedDialog->accept();
+        });
+
+    connect(scenario3Button, &QPushButton::clicked, this, [this, predefinedDialog]() {
+        setupPredefinedScenario(3);
+        predefinedDialog->accept();
+        });
+
+    predefinedDialog->exec();
+}
+
+void CANSim::selectScenarioFile()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Load Scenario File", QString(), "Scenario files (*.json)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    try {
+        setupScenario(loadScenarioFile(path));
+    }
+    catch (const std::invalid_argument& error) {
+        QMessageBox::warning(this, "Invalid Scenario", QString::fromStdString(error.what()));
+    }
+}
+
+void CANSim::selectDbcFile()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Load DBC", QString(), "DBC files (*.dbc)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    try {
+        setupNetwork(DbcImporter::load(path.toStdString()));
+    }
+    catch (const std::invalid_argument& error) {
+        QMessageBox::warning(this, "Invalid DBC", QString::fromStdString(error.what()));
+    }
+}
+
+void CANSim::setupPredefinedScenario(int scenario)
+{
+    try {
+        setupScenario(getPredefinedScenario(scenario));
+    }
+    catch (const std::invalid_argument& error) {
+        QMessageBox::warning(this, "Invalid Scenario", QString::fromStdString(error.what()));
+    }
+}
+
+void CANSim::setupScenario(const ScenarioDefinition& scenario)
+{
+    // Large networks give every sender an identifier of its own, and there are 0x7FF of them
+    int networkSize = getNetworkSize(scenario);
+    if (networkSize > Node::MAX_NODES) {
+        throw std::invalid_argument("The simulation view supports node ids 1 to " + std::to_string(Node::MAX_NODES) +
+            ", the scenario uses " + std::to_string(networkSize));
+    }
+    scenarioRounds = scenario.rounds;
+
+    QWidget* centralWidget = new QWidget(this);
+    setCentralWidget(centralWidget);
+    layout = new QVBoxLayout(centralWidget);
+
+    graphicsView = new TopologyView(this);
+    scene = new QGraphicsScene(this);
+    graphicsView->setScene(scene);
+    layout->addWidget(graphicsView);
+
+    QGraphicsLineItem* canHighLine = scene->addLine(0, 100, 500, 100);
+    QGraphicsLineItem* canLowLine = scene->addLine(0, 200, 500, 200);
+
+    changeLineColor(canHighLine, Qt::white);
+    changeLineColor(canLowLine, Qt::white);
+
+    canLines.append(canHighLine);
+    canLines.append(canLowLine);
+
+    QGraphicsTextItem* canHighLabel = scene->addText("CAN High");
+    canHighLabel->setPos(10, 80);
+
+    QGraphicsTextItem* canLowLabel = scene->addText("CAN Low");
+    canLowLabel->setPos(10, 180);
+
+    canBusLabel = scene->addText("CAN Bus");
+    canBusLabel->setPos(250, 140);
+
+    canBus = new CANBus(this);
+    canBus->bitStuffingVisible = false;
+
+    for (const ScenarioMonitor& definition : scenario.monitors) {
+        MonitorNode* monitor = new MonitorNode(definition.name, definition.filter, definition.capacity);
+        monitors.push_back(monitor);
+        canBus->addMonitor(monitor);
+    }
+
+    roundLabel = scene->addText("Round: -");
+    roundLabel->setDefaultTextColor(Qt::white);
+    roundLabel->setFont(QFont("Arial", 14));
+    roundLabel->setPos(1, 10);
+
+    bitPositionLabel = scene->addText("Bit Position: -");
+    bitPositionLabel->setDefaultTextColor(Qt::white);
+    bitPositionLabel->setFont(QFont("Arial", 14));
+    bitPositionLabel->setPos(1, 40);
+
+    for (const ScenarioNode& definition : scenario.nodes) {
+        addPredefinedNode(definition, networkSize);
+    }
+
+    QPushButton* timelineButton = new QPushButton("Bus Timeline", this);
+    layout->addWidget(timelineButton);
+    connect(timelineButton, &QPushButton::clicked, this, [this, scenario]() {
+        showBusTimeline(scenario);
+        });
+
+    startPredefinedSimulation();
+}
+
+void CANSim::showBusTimeline(const ScenarioDefinition& scenario)
+{
+    int nodeCount = 0;
+    for (const ScenarioNode& definition : scenario.nodes) {
+        nodeCount = std::max(nodeCount, definition.nodeId);
+    }
+
+    // The replay only shows arbitration, so run the scenario again at bit level for the timeline
+    BitLevelBus bus(nodeCount);
+    PeriodicScheduler scheduler;
+    BitTrace trace(nodeCount);
+    applyScenario(bus, scheduler, scenario);
+    for (const ScenarioNode& definition : scenario.nodes) {
+        if (definition.periodicMessages.empty()) {
+            scheduleScenarioNode(scheduler, definition, getNetworkSize(scenario));
+        }
+    }
+    bus.setScheduler(&scheduler, scenario.bitRate);
+    bus.setTrace(&trace);
+    bus.run(static_cast<uint64_t>(scenario.duration * scenario.bitRate / 1000.0));
+
+    showBitTrace(std::move(trace), scenario.bitRate);
+}
+
+// The periodic messages of a DBC network have no rounds to replay, so the network runs on the
+// bit-level engine only: a table of what each node ended with, and the timeline of the run
+void CANSim::setupNetwork(const NetworkDefinition& network)
+{
+    int nodeCount = static_cast<int>(network.nodes.size());
+    if (nodeCount == 0) {
+        throw std::invalid_argument("The network has no nodes");
+    }
+
+    const ScenarioDefinition defaults;
+    BitLevelBus bus(nodeCount);
+    PeriodicScheduler scheduler;
+    BitTrace trace(nodeCount);
+
+    int scheduled = scheduleNetwork(scheduler, network);
+    if (scheduled == 0) {
+        throw std::invalid_argument("None of the messages has a cycle time, a transmitter and a standard identifier");
+    }
+    bus.setScheduler(&scheduler, defaults.bitRate);
+    bus.setTrace(&trace);
+    bus.run(static_cast<uint64_t>(defaults.duration * defaults.bitRate / 1000.0));
+
+    QWidget* centralWidget = new QWidget(this);
+    setCentralWidget(centralWidget);
+    layout = new QVBoxLayout(centralWidget);
+
+    QLabel* summaryLabel = new QLabel(QString("%1 nodes, %2 of %3 messages sent periodically for %4 ms at %5 kbit/s")
+        .arg(nodeCount).arg(scheduled).arg(network.messages.size()).arg(defaults.duration).arg(defaults.bitRate / 1000), this);
+    layout->addWidget(summaryLabel);
+
+    static const char* STATES[] = { "Error active", "Error passive", "Bus off" };
+    QTableWidget* nodeTable = new QTableWidget(nodeCount, 7, this);
+    nodeTable->setHorizontalHeaderLabels({ "Node", "Sent", "Received", "Retransmissions", "TEC", "REC", "State" });
+    nodeTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    nodeTable->verticalHeader()->hide();
+    nodeTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    for (int node = 0; node < nodeCount; ++node) {
+        const BitLevelBus::NodeStatistics& statistics = bus.getStatistics(node);
+        const ErrorConfinement& confinement = bus.getConfinement(node);
+        QStringList cells = {
+            QString::fromStdString(network.nodes[node]),
+            QString::number(statistics.framesTransmitted),
+            QString::number(statistics.framesReceived),
+            QString::number(statistics.retransmissions),
+            QString::number(confinement.getTEC()),
+            QString::number(confinement.getREC()),
+            STATES[static_cast<int>(confinement.getState())],
+        };
+        for (int column = 0; column < cells.size(); ++column) {
+            nodeTable->setItem(node, column, new QTableWidgetItem(cells[column]));
+        }
+    }
+    layout->addWidget(nodeTable);
+
+    showBitTrace(std::move(trace), defaults.bitRate);
+}
+
+void CANSim::showBitTrace(BitTrace&& trace, uint32_t bitRate)
+{
+    if (!busTimeline) {
+        QDockWidget* timelineDockWidget = new QDockWidget("Bus Timeline", this);
+        timelineDockWidget->setAllowedAreas(Qt::BottomDockWidgetArea | Qt::TopDockWidgetArea);
+        addDockWidget(Qt::BottomDockWidgetArea, timelineDockWidget);
+
+        busTimeline = new BusTimelineWidget(timelineDockWidget);
+        timelineDockWidget->setWidget(busTimeline);
+    }
+    busTimeline->setTrace(std::move(trace), bitRate);
+    busTimeline->parentWidget()->show();
+}
+
+void CANSim::addLogButton()
+{
+    QPushButton* seeLogFileButton = new QPushButton("See Log File", this);
+    layout->addWidget(seeLogFileButton);
+    connect(seeLogFileButton, &QPushButton::clicked, this, &CANSim::showLogViewer);
+
+    // The viewer follows the text log, which is not written while a binary log is set
+    if (CANBus::hasBinaryLog()) {
+        seeLogFileButton->setEnabled(false);
+        seeLogFileButton->setToolTip("The log is written in binary (--binary-log), CANTools render turns it into text");
+    }
+}
+
+void CANSim::showLogViewer()
+{
+    if (CANBus::hasBinaryLog()) {
+        return;
+    }
+
+    if (!logViewer) {
+        QDockWidget* logDockWidget = new QDockWidget("Log", this);
+        logDockWidget->setAllowedAreas(Qt::AllDockWidgetAreas);
+        addDockWidget(Qt::BottomDockWidgetArea, logDockWidget);
+
+        logViewer = new LogViewer(QString::fromUtf8(CANBus::LOG_PATH), logDockWidget);
+        logDockWidget->setWidget(logViewer);
+    }
+    logViewer->parentWidget()->show();
+}
+
+void CANSim::addPredefinedNode(const ScenarioNode& definition, int networkSize)
+{
+    int nodeId = definition.nodeId;
+
+    NodeConfigWidget* newNode = new NodeConfigWidget(nodeId, 0, 0, true);
+    nodeWidgets.append(newNode);
+
+    Node* node = new Node(nodeId, canBus);
+    addNode(node, definition.error);
+
+    scene->addItem(newNode);
+    placeNode(newNode);
+
+    scheduleScenarioNode(node, definition, networkSize);
+}
+
+void CANSim::startPredefinedSimulation() 
+{
+    canBus->pendingMessages = collectAllMessages();
+
+    createMessagePanel();
+    processPendingMessages();
+
+    addLogButton();
+
+    counterExporter = new CounterExporter(canBus->counters, "bus_counters.prom", CounterExporter::Format::Prometheus, std::chrono::milliseconds(1000));
+    counterExporter->start();
+
+    startSimulation();
+}
+
+void CANSim::initializeCustomConfiguration()
+{
+    QWidget* centralWidget = new QWidget(this);
+    setCentralWidget(centralWidget);
+    layout = new QVBoxLayout(centralWidget);
+
+    graphicsView = new TopologyView(this);
+    scene = new QGraphicsScene(this);
+    graphicsView->setScene(scene);
+    layout->addWidget(graphicsView);
+
+    QGraphicsLineItem* canHighLine = scene->addLine(0, 100, 500, 100);
+    QGraphicsLineItem* canLowLine = scene->addLine(0, 200, 500, 200); 
+
+    changeLineColor(canHighLine, Qt::white);
+    changeLineColor(canLowLine, Qt::white);
+
+    canLines.append(canHighLine);
+    canLines.append(canLowLine);
+
+    QGraphicsTextItem* canHighLabel = scene->addText("CAN High");
+    canHighLabel->setPos(10, 80); 
+
+    QGraphicsTextItem* canLowLabel = scene->addText("CAN Low");
+    canLowLabel->setPos(10, 180);  
+
+    canBusLabel = scene->addText("CAN Bus");
+    canBusLabel->setPos(250, 140); 
+
+    canBus = new CANBus(this);
+
+    NodeConfigWidget* exampleNode1 = new NodeConfigWidget(1, 0, 0, true);
+	nodeWidgets.append(exampleNode1);
+
+    NodeConfigWidget* exampleNode2 = new NodeConfigWidget(2, 0, 0, true);
+    nodeWidgets.append(exampleNode2);
+
+    scene->addItem(exampleNode1);
+    scene->addItem(exampleNode2);
+
+    Node* node1 = new Node(1, canBus);
+    bool error = getRandomBool();
+    addNode(node1, false);
+
+    roundLabel = scene->addText("Round: -");
+    roundLabel->setDefaultTextColor(Qt::white);
+    roundLabel->setFont(QFont("Arial", 14));
+    roundLabel->setPos(1, 10);  
+
+    bitPositionLabel = scene->addText("Bit Position: -");
+    bitPositionLabel->setDefaultTextColor(Qt::white);
+    bitPositionLabel->setFont(QFont("Arial", 14));
+    bitPositionLabel->setPos(1, 40);
+
+    connect(exampleNode1, &NodeConfigWidget::nodeClicked, this,
+        [this, node1](int nodeId) {
+            openSendMessageDialog(nodeId, node1);
+        });
+
+    Node* node2 = new Node(2, canBus);
+	error = getRandomBool();
+    addNode(node2, true);
+
+    connect(exampleNode2, &NodeConfigWidget::nodeClicked, this,
+        [this, node2](int nodeId) {
+            openSendMessageDialog(nodeId, node2);
+        });
+
+    placeNode(exampleNode1);
+    placeNode(exampleNode2);
+
+    QCheckBox* bitStuffingCheckBox = new QCheckBox("Show Bit Stuffing", this);
+    layout->addWidget(bitStuffingCheckBox);
+
+    addNodeButton = new QPushButton("Add Node", this);
+    layout->addWidget(addNodeButton);
+
+    startSimButton = new QPushButton("Start Simulation", this);
+    layout->addWidget(startSimButton);
+
+    connect(bitStuffingCheckBox, &QCheckBox::stateChanged, this, [this](int state) {
+        canBus->bitStuffingVisible = (state == Qt::Checked); 
+        if (state == Qt::Checked) {
+            QMessageBox::information(this, "Bit Stuffing", "Bit stuffing is now visible.");
+        }
+        else {
+            QMessageBox::information(this, "Bit Stuffing", "Bit stuffing is now hidden.");
+        }
+        });
+
+    connect(startSimButton, &QPushButton::clicked, this, [this, bitStuffingCheckBox]() {
+        simulationStarted = true;
+		addMessage = false;
+        startSimButton->setEnabled(false);
+        addNodeButton->setEnabled(false);
+        bitStuffingCheckBox->setEnabled(false);
+
+        // Nodes added after the first messages were set up can change the identifier layout
+        int networkSize = 0;
+        for (Node* node : nodesInSim) {
+            networkSize = std::max(networkSize, node->getNodeId());
+        }
+        for (Node* node : nodesInSim) {
+            node->setNetworkSize(networkSize);
+            node->generate11BitID();
+        }
+
+        canBus->pendingMessages = collectAllMessages();
+
+        createMessagePanel();
+        processPendingMessages();
+
+        addLogButton();
+
+        startSimulation();
+
+        });
+
+    connect(addNodeButton, &QPushButton::clicked, this, [this]() {
+        if (simulationStarted) {
+            return; 
+        }
+
+        if (static_cast<int>(nodesInSim.size()) >= Node::MAX_NODES) {
+            QMessageBox::warning(this, "Max Nodes Reached", QString("You cannot add more than %1 nodes.").arg(Node::MAX_NODES));
+            return;
+        }
+
+        static int nodeId = 3; 
+        NodeConfigWidget* newNode = new NodeConfigWidget(nodeId, 0, 0, true);
+        nodeWidgets.append(newNode);
+
+        Node* node = new Node(nodeId, canBus);
+		bool error = getRandomBool();
+        addNode(node, error);
+
+        scene->addItem(newNode);
+
+        connect(newNode, &NodeConfigWidget::nodeClicked, this,
+            [this, node](int nodeId) {
+                openSendMessageDialog(nodeId, node);
+            });
+
+        placeNode(newNode);
+
+        nodeId++;
+        });
+}
+
+CANSim::~CANSim()
+{
+    delete simulationWorker;
+    delete counterExporter;
+    for (MonitorNode* monitor : monitors) {
+        delete monitor;
+    }
+    delete graphicsView;
+    delete scene;
+}
+
+//void CANSim::processSimulation() {
+//
+//    int counter = 0;
+//    for (const auto& step : canBus->arbitrationSteps) {
+//        // Print the arbitration details for the current step
+//        if (counter % 11 == 0)
+//        {
+//            qDebug() << "Arbitration step for round:" << step.round;
+//        }
+//
+//        qDebug() << "-----";
+//        qDebug() << "Bit Position:" << step.bitPosition;
+//
+//        // Print contenders and their bit values for the current step
+//        qDebug() << "---";
+//        qDebug() << "Contenders for round" << step.round << ":";
+//        for (const auto& msg : step.contenders) {
+//            uint16_t id = msg.getId();
+//            qDebug() << "Message ID: " << id << " Bit: " << ((id >> (11 - 1)) & 1);  // Example: show the bit value
+//        }
+//
+//        // Print non-contenders for the current step
+//        qDebug() << "---";
+//        qDebug() << "Non-Contenders for round" << step.round << ":";
+//        for (const auto& msg : step.nonContenders) {
+//            qDebug() << "Message ID: " << msg.getId();
+//        }
+//
+//        qDebug() << "---";
+//        if (step.bitPosition == 0) {
+//            qDebug() << "Winner for round" << step.round << ":";
+//            Message winner = canBus->winners.front();
+//			markMessageAsSent(winner.getSenderId(), winner.getId(), winner.getRound());
+//            canBus->winners.erase(canBus->winners.begin());
+//            qDebug() << "Winner Message ID: " << winner.getId();
+//            qDebug() << "---------------------------";
+//        }
+//
+//        counter++;
+//    }
+//}
+
+void CANSim::analyzeResponseTimes()
+{
+    // Rounds are one frame slot each, so the bounds are in rounds like the simulated latencies
+    ResponseTimeAnalysis analysis(1.0, false);
+    for (Node* node : nodesInSim) {
+        analysis.addScenarioNode(*node, 1.0, 1.0);
+    }
+    responseTimeBounds = analysis.analyze();
+
+    for (const ResponseTimeAnalysis::Result& bound : responseTimeBounds) {
+        if (std::isinf(bound.responseTime)) {
+            canBus->logMessage("WCRT bound for ID " + std::to_string(bound.id) + ": none, deadline " +
+                std::to_string(bound.deadline) + " missed");
+            continue;
+        }
+        canBus->logMessage("WCRT bound for ID " + std::to_string(bound.id) + ": " + std::to_string(bound.responseTime) +
+            (bound.schedulable ? " rounds" : " rounds, deadline " + std::to_string(bound.deadline) + " missed"));
+    }
+}
+
+void CANSim::startSimulation()
+{
+    // Both the scenario and the custom set-up end here, so both get the bounds
+    analyzeResponseTimes();
+
+    // The worker owns the bus from here on, it must not copy the node list from this thread
+    canBus->nodes = nodesInSim;
+
+    simulationProgress = new QProgressBar(this);
+    simulationProgress->setRange(0, scenarioRounds + 1);
+    simulationProgress->setFormat("Simulated %v of %m rounds");
+    layout->addWidget(simulationProgress);
+
+    simulationWorker = new SimulationWorker(*canBus, scenarioRounds);
+    simulationWorker->start();
+
+    // Polled at display rate, reading two atomics costs nothing
+    progressTimer = new QTimer(this);
+    connect(progressTimer, &QTimer::timeout, this, [this]() {
+        simulationProgress->setValue(std::min(simulationWorker->getRoundsSimulated(), scenarioRounds + 1));
+        if (simulationWorker->isFinished()) {
+            simulationProgress->setValue(simulationProgress->maximum());
+            progressTimer->stop();
+
+            delete counterExporter;
+            counterExporter = nullptr;
+
+            // A finished run can be rendered without waiting for the next block to fill
+            CANBus::flushLog();
+        }
+        });
+    progressTimer->start(16);
+
+    processSimulation();
+}
+
+void CANSim::processSimulation()
+{
+    replayPosition = 0;
+    replayComplete = false;
+
+    createReplayControls();
+
+    simulationTimer = new QTimer(this);
+    connect(simulationTimer, &QTimer::timeout, this, &CANSim::advanceReplay);
+    setReplaySpeed(1.0);
+}
+
+void CANSim::createReplayControls()
+{
+    QWidget* controls = new QWidget(this);
+    QHBoxLayout* controlsLayout = new QHBoxLayout(controls);
+    controlsLayout->setContentsMargins(0, 0, 0, 0);
+
+    playButton = new QPushButton("Pause", controls);
+    QPushButton* stepButton = new QPushButton("Step", controls);
+
+    speedBox = new QComboBox(controls);
+    for (double speed : { 0.25, 0.5, 1.0, 2.0, 5.0, 10.0, 100.0, 1000.0 }) {
+        speedBox->addItem(QString("%1x").arg(speed), speed);
+    }
+    speedBox->setCurrentIndex(speedBox->findData(1.0));
+
+    replaySlider = new QSlider(Qt::Horizontal, controls);
+    replaySlider->setRange(0, 0);
+
+    seekRoundBox = new QSpinBox(controls);
+    seekRoundBox->setPrefix("Round ");
+    seekRoundBox->setRange(0, std::max(0, scenarioRounds - 1));
+
+    seekTimeBox = new QDoubleSpinBox(controls);
+    seekTimeBox->setSuffix(" s");
+    seekTimeBox->setDecimals(3);
+    seekTimeBox->setRange(0, scenarioRounds);
+
+    controlsLayout->addWidget(playButton);
+    controlsLayout->addWidget(stepButton);
+    controlsLayout->addWidget(speedBox);
+    controlsLayout->addWidget(replaySlider, 1);
+    controlsLayout->addWidget(seekRoundBox);
+    controlsLayout->addWidget(seekTimeBox);
+    layout->addWidget(controls);
+
+    connect(playButton, &QPushButton::clicked, this, [this]() {
+        setReplayPaused(!replayPaused);
+        });
+    connect(stepButton, &QPushButton::clicked, this, [this]() {
+        setReplayPaused(true);
+        indexReplayRounds(replayPosition + 1);
+        moveReplayTo(std::min(replayPosition + 1, replayIndex.size()));
+        });
+    connect(speedBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        setReplaySpeed(speedBox->itemData(index).toDouble());
+        });
+    connect(replaySlider, &QSlider::valueChanged, this, [this](int value) {
+        moveReplayTo(static_cast<size_t>(value));
+        });
+    connect(seekRoundBox, &QSpinBox::editingFinished, this, [this]() {
+        indexReplayRounds(0, seekRoundBox->value());
+        moveReplayTo(std::min(replayIndex.positionOfRound(seekRoundBox->value()) + 1, replayIndex.size()));
+        });
+    connect(seekTimeBox, &QDoubleSpinBox::editingFinished, this, [this]() {
+        indexReplayRounds(0, static_cast<int>(seekTimeBox->value()));
+        moveReplayTo(std::min(replayIndex.positionAtTime(seekTimeBox->value()) + 1, replayIndex.size()));
+        });
+}
+
+void CANSim::setReplaySpeed(double speed)
+{
+    // At 1x a step is shown every 500 ms. Faster speeds shorten the interval down to a display
+    // frame and then show only the last of the steps that fall into one frame.
+    int interval = std::max(MIN_REPLAY_INTERVAL, static_cast<int>(REPLAY_STEP_INTERVAL / speed));
+    replayStepsPerTick = std::max<size_t>(1, static_cast<size_t>(std::lround(speed * interval / REPLAY_STEP_INTERVAL)));
+    simulationTimer->start(interval);
+}
+
+void CANSim::setReplayPaused(bool paused)
+{
+    replayPaused = paused;
+    playButton->setText(paused ? "Play" : "Pause");
+}
+
+bool CANSim::indexReplayRounds(size_t position, int round)
+{
+    // Read before draining the queue, so a finished worker has nothing left behind
+    bool workerFinished = simulationWorker->isFinished();
+
+    SimulationWorker::Round next;
+    bool drained = false;
+    while (replayIndex.size() < position || replayIndex.getRoundCount() <= round) {
+        if (!simulationWorker->next(next)) {
+            drained = true;
+            break;
+        }
+        replayIndex.append(std::move(next));
+    }
+    if (workerFinished && drained) {
+        replayIndex.extendTo(scenarioRounds - 1);
+    }
+
+    QSignalBlocker blocker(replaySlider);
+    replaySlider->setMaximum(static_cast<int>(replayIndex.size()));
+    return workerFinished && drained;
+}
+
+void CANSim::advanceReplay()
+{
+    if (replayPaused) {
+        return;
+    }
+
+    // Only the rounds this tick shows leave the worker's queue. While the replay is paused or
+    // slower than the simulation the queue stays full and the worker waits.
+    bool workerFinished = indexReplayRounds(replayPosition + replayStepsPerTick);
+
+    if (replayPosition < replayIndex.size()) {
+        moveReplayTo(std::min(replayPosition + replayStepsPerTick, replayIndex.size()));
+    }
+    else if (workerFinished) {
+        completeReplay();
+    }
+    // Otherwise the worker is behind the replay, wait for its next round
+}
+
+void CANSim::moveReplayTo(size_t position)
+{
+    if (position == replayPosition) {
+        return;
+    }
+
+    // Steps skipped over still move their frames between the tables, in either direction
+    size_t first = std::min(position, replayPosition);
+    size_t last = std::max(position, replayPosition);
+    for (int round = replayIndex.roundOf(first); round <= replayIndex.roundOf(last - 1); ++round) {
+        size_t delivered = replayIndex.deliveryPosition(round);
+        if (delivered == ReplayIndex::NONE || delivered < first || delivered >= last) {
+            continue;
+        }
+
+        const Message& winner = replayIndex.getRound(round).winner;
+        if (position > replayPosition) {
+            markMessageAsSent(winner.getSenderId(), winner.getId(), winner.getRound());
+        }
+        else {
+            markMessageAsPending(winner.getSenderId(), winner.getId(), winner.getRound());
+        }
+    }
+
+    replayPosition = position;
+    if (position > 0) {
+        showReplayPosition(position - 1);
+    }
+    else {
+        setAllLinesToWhite();
+        roundLabel->setPlainText("Round: -");
+        bitPositionLabel->setPlainText("Bit Position: -");
+    }
+
+    graphicsView->updateAggregates();
+
+    QSignalBlocker blocker(replaySlider);
+    replaySlider->setValue(static_cast<int>(position));
+}
+
+void CANSim::showReplayPosition(size_t position)
+{
+    int round = replayIndex.roundOf(position);
+    size_t stepIndex = replayIndex.stepOf(position);
+
+    roundLabel->setPlainText(QString("Round (event/second): %1").arg(round));
+    if (stepIndex == ReplayIndex::NONE) {
+        setAllLinesToWhite();
+        return;
+    }
+
+    const SimulationWorker::Round& replayRound = replayIndex.getRound(round);
+    const auto& step = replayRound.steps[stepIndex];
+
+    for (int i = 0; i < nodeWidgets.size() && i < static_cast<int>(replayRound.nodes.size()); ++i) {
+        const CANBus::NodeState& state = replayRound.nodes[i];
+
+        nodeWidgets[i]->setTECCount(state.TEC);
+        nodeWidgets[i]->setRECCount(state.REC);
+        nodeWidgets[i]->setNodeActive(state.active);
+    }
+
+    // Colour of every line at this step, so only the lines that change are repainted
+    QHash<QGraphicsLineItem*, QRgb> colors;
+    bool dominant = false;
+    for (const CANBus::Contender& contender : step.contenders)
+    {
+        int senderId = contender.senderId - 1;
+
+        if (contender.bit == 1) {
+            colors[nodeLinesLow[senderId]] = QColor(Qt::red).rgb();
+            colors[nodeLinesHigh[senderId]] = QColor(Qt::green).rgb();
+        }
+        else {
+            dominant = true;
+            colors[nodeLinesLow[senderId]] = QColor(Qt::yellow).rgb();
+            colors[nodeLinesHigh[senderId]] = QColor(Qt::yellow).rgb();
+        }
+    }
+
+    if (!step.contenders.empty()) {
+        bitPositionLabel->setPlainText(QString("Bit Position: %1").arg(step.bitPosition));
+
+        QRgb high = QColor(dominant ? Qt::yellow : Qt::green).rgb();
+        QRgb low = QColor(dominant ? Qt::yellow : Qt::red).rgb();
+        for (QGraphicsLineItem* line : busLinesHigh) {
+            colors[line] = high;
+        }
+        for (QGraphicsLineItem* line : busLinesLow) {
+            colors[line] = low;
+        }
+        if (busTrunkHigh) {
+            colors[busTrunkHigh] = high;
+            colors[busTrunkLow] = low;
+        }
+    }
+    showLineColors(colors);
+
+    bool delivered = position == replayIndex.deliveryPosition(round);
+    uint16_t message_id = replayRound.winner.getId();
+    for (int i = 0; i < nodeWidgets.size(); ++i) {
+        bool receives = delivered && nodeWidgets[i]->isActive() &&
+            std::find(replayRound.receivers.begin(), replayRound.receivers.end(), i + 1) != replayRound.receivers.end();
+        if (receives) {
+            nodeWidgets[i]->receiveMessage(message_id);
+        }
+        else {
+            nodeWidgets[i]->clearReceivedMessage();
+        }
+    }
+}
+
+void CANSim::completeReplay()
+{
+    if (replayComplete) {
+        return;
+    }
+    replayComplete = true;
+    setReplayPaused(true);
+
+    simulationWorker->stop();
+    canBus->metrics.exportCsv("metrics.csv");
+    ResponseTimeAnalysis::exportCsv("response_times.csv", ResponseTimeAnalysis::compare(responseTimeBounds, canBus->metrics));
+
+    QString summary = "The simulation has successfully completed!";
+    for (MonitorNode* monitor : monitors) {
+        monitor->exportCsv("monitor_" + monitor->getName() + ".csv");
+        summary += QString("\nMonitor %1 matched %2 of %3 frames").arg(QString::fromStdString(monitor->getName()))
+            .arg(monitor->getFramesMatched()).arg(monitor->getFramesSeen());
+    }
+    QMessageBox::information(this, "Simulation Complete", summary);
+}
+
+void CANSim::createMessagePanel()
+{
+    QDockWidget* messageDockWidget = new QDockWidget("Message Status", this);
+    messageDockWidget->setAllowedAreas(Qt::RightDockWidgetArea | Qt::LeftDockWidgetArea);
+    addDockWidget(Qt::RightDockWidgetArea, messageDockWidget);
+
+    QWidget* messagePanelWidget = new QWidget(messageDockWidget);
+    QVBoxLayout* panelLayout = new QVBoxLayout(messagePanelWidget);
+
+    pendingMessagesModel = new MessageTableModel(this);
+    pendingMessagesTable = createMessageTable(pendingMessagesModel);
+    pendingMessagesTable->setObjectName("pendingMessagesTable");
+    panelLayout->addWidget(new QLabel("Pending Messages"));
+    panelLayout->addWidget(pendingMessagesTable);
+
+    sentMessagesModel = new MessageTableModel(this);
+    sentMessagesTable = createMessageTable(sentMessagesModel);
+    sentMessagesTable->setObjectName("sentMessagesTable");
+    panelLayout->addWidget(new QLabel("Sent Messages"));
+    panelLayout->addWidget(sentMessagesTable);
+
+    messagePanelWidget->setLayout(panelLayout);
+    messageDockWidget->setWidget(messagePanelWidget);
+}
+
+QTableView* CANSim::createMessageTable(MessageTableModel* model)
+{
+    QTableView* table = new QTableView(this);
+    table->setModel(model);
+
+    // Uniform rows let the view place any row without measuring the ones above it
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 6);
+    return table;
+}
+
+void CANSim::addPendingMessage(int nodeId, uint16_t identifier, int round)
+{
+    pendingMessagesModel->addMessage(nodeId, identifier, round);
+}
+
+void CANSim::processPendingMessages()
+{
+    for (Node* node : nodesInSim) {
+        const std::vector<Message*> messages = node->getMessagesToBeSent();
+
+        for (const auto& message : messages) {
+            int round = message->getRound();
+            int senderNodeId = node->getNodeId();
+            uint16_t identifier = message->getId();
+
+            addPendingMessage(senderNodeId, identifier, round);
+        }
+    }
+}
+
+void CANSim::markMessageAsSent(int nodeId, uint16_t messageId, int round)
+{
+    if (pendingMessagesModel->removeMessage(nodeId, messageId, round)) {
+        sentMessagesModel->addMessage(nodeId, messageId, round);
+    }
+}
+
+void CANSim::markMessageAsPending(int nodeId, uint16_t messageId, int round)
+{
+    if (sentMessagesModel->removeMessage(nodeId, messageId, round)) {
+        pendingMessagesModel->addMessage(nodeId, messageId, round);
+    }
+}
+
+void CANSim::changeLineColor(QGraphicsLineItem* line, const QColor& color)
+{
+    QRgb rgb = color.rgb();
+    auto current = lineColors.find(line);
+    if (current != lineColors.end() && *current == rgb) {
+        return;
+    }
+
+    bool wasLit = current != lineColors.end() && *current != QColor(Qt::white).rgb();
+    lineColors[line] = rgb;
+    if (!wasLit && rgb != QColor(Qt::white).rgb()) {
+        litLines.append(line);
+    }
+
+    QPen pen = line->pen();
+    pen.setColor(color);  
+    line->setPen(pen);  
+}
+
+void CANSim::showLineColors(const QHash<QGraphicsLineItem*, QRgb>& colors)
+{
+    // Lines left out go back to white, changeLineColor leaves alone the ones already in their colour
+    QVector<QGraphicsLineItem*> lines;
+    lines.swap(litLines);
+    for (QGraphicsLineItem* line : lines) {
+        if (!colors.contains(line)) {
+            changeLineColor(line, Qt::white);
+        }
+    }
+    for (auto it = colors.constBegin(); it != colors.constEnd(); ++it) {
+        changeLineColor(it.key(), QColor(it.value()));
+    }
+    litLines = colors.keys();
+}
+
+void CANSim::placeNode(NodeConfigWidget* widget)
+{
+    int index = static_cast<int>(nodeWidgets.indexOf(widget));
+    int row = index / NODES_PER_ROW;
+    int rowTop = row * ROW_HEIGHT;
+    widget->setPos(FIRST_NODE_X + (index % NODES_PER_ROW) * NODE_SPACING, rowTop + NODE_Y);
+
+    QGraphicsLineItem* line1 = scene->addLine(widget->x() + 25, widget->y(), widget->x() + 25, rowTop + CAN_HIGH_Y);
+    QGraphicsLineItem* line2 = scene->addLine(widget->x() + 75, widget->y(), widget->x() + 75, rowTop + CAN_LOW_Y);
+
+    changeLineColor(line1, Qt::white);
+    changeLineColor(line2, Qt::white);
+
+    canLines.append(line1);
+    canLines.append(line2);
+    nodeLinesHigh.append(line1);
+    nodeLinesLow.append(line2);
+
+    graphicsView->addDetailItem(widget);
+    graphicsView->addDetailItem(line1);
+    graphicsView->addDetailItem(line2);
+
+    if (row >= nodeGroups.size()) {
+        NodeGroupItem* group = new NodeGroupItem();
+        scene->addItem(group);
+        graphicsView->addAggregateItem(group);
+        nodeGroups.append(group);
+    }
+    nodeGroups[row]->addNode(widget);
+
+    updateCANBusLines();
+}
+
+void CANSim::updateCANBusLines()
+{
+    // Row 0 uses the bus lines created with the scene, every further row of nodes gets its own
+    // pair. The CAN_H rows are joined on the left and the CAN_L rows on the right, so the two
+    // wires never cross.
+    if (busLinesHigh.isEmpty()) {
+        busLinesHigh.append(canLines[0]);
+        busLinesLow.append(canLines[1]);
+    }
+
+    int rows = std::max(1, static_cast<int>((nodeWidgets.size() + NODES_PER_ROW - 1) / NODES_PER_ROW));
+    while (busLinesHigh.size() < rows) {
+        QGraphicsLineItem* high = scene->addLine(0, 0, 0, 0);
+        QGraphicsLineItem* low = scene->addLine(0, 0, 0, 0);
+        changeLineColor(high, Qt::white);
+        changeLineColor(low, Qt::white);
+        busLinesHigh.append(high);
+        busLinesLow.append(low);
+    }
+
+    int widest = 0;
+    for (int row = 0; row < rows; ++row) {
+        int nodesInRow = std::min(NODES_PER_ROW, static_cast<int>(nodeWidgets.size()) - row * NODES_PER_ROW);
+        widest = std::max(widest, FIRST_NODE_X + std::max(nodesInRow, 0) * NODE_SPACING + 50);
+    }
+
+    for (int row = 0; row < rows; ++row) {
+        int rowTop = row * ROW_HEIGHT;
+        int nodesInRow = std::min(NODES_PER_ROW, static_cast<int>(nodeWidgets.size()) - row * NODES_PER_ROW);
+        int rowEnd = FIRST_NODE_X + std::max(nodesInRow, 0) * NODE_SPACING + 50;
+
+        busLinesHigh[row]->setLine(rows > 1 ? -BUS_TRUNK_OFFSET : 0, rowTop + CAN_HIGH_Y, rowEnd, rowTop + CAN_HIGH_Y);
+        busLinesLow[row]->setLine(0, rowTop + CAN_LOW_Y, rows > 1 ? widest + BUS_TRUNK_OFFSET : rowEnd, rowTop + CAN_LOW_Y);
+    }
+
+    if (rows > 1) {
+        if (!busTrunkHigh) {
+            busTrunkHigh = scene->addLine(0, 0, 0, 0);
+            busTrunkLow = scene->addLine(0, 0, 0, 0);
+            changeLineColor(busTrunkHigh, Qt::white);
+            changeLineColor(busTrunkLow, Qt::white);
+        }
+
+        int lastTop = (rows - 1) * ROW_HEIGHT;
+        busTrunkHigh->setLine(-BUS_TRUNK_OFFSET, CAN_HIGH_Y, -BUS_TRUNK_OFFSET, lastTop + CAN_HIGH_Y);
+        busTrunkLow->setLine(widest + BUS_TRUNK_OFFSET, CAN_LOW_Y, widest + BUS_TRUNK_OFFSET, lastTop + CAN_LOW_Y);
+    }
+
+    int firstRowNodes = std::min(NODES_PER_ROW, static_cast<int>(nodeWidgets.size()));
+    int centerY = (CAN_HIGH_Y + CAN_LOW_Y) / 2; 
+    canBusLabel->setPos((FIRST_NODE_X + firstRowNodes * NODE_SPACING) / 2 - 50, centerY - 10);
+}
+
+void CANSim::setBusColor(const QColor& high, const QColor& low)
+{
+    for (QGraphicsLineItem* line : busLinesHigh) {
+        changeLineColor(line, high);
+    }
+    for (QGraphicsLineItem* line : busLinesLow) {
+        changeLineColor(line, low);
+    }
+    if (busTrunkHigh) {
+        changeLineColor(busTrunkHigh, high);
+        changeLineColor(busTrunkLow, low);
+    }
+}
+
+void CANSim::toggleLineColorDom(QGraphicsLineItem* canl, QGraphicsLineItem* canh)
+{
+    changeLineColor(canl, Qt::yellow);
+    changeLineColor(canh, Qt::yellow);
+    setBusColor(Qt::yellow, Qt::yellow);
+}
+
+void CANSim::toggleLineColorRec(QGraphicsLineItem* canl, QGraphicsLineItem* canh)
+{
+    changeLineColor(canl, Qt::red);
+    changeLineColor(canh, Qt::green);
+    if (rec == true && dom == false) {
+        setBusColor(Qt::green, Qt::red);
+    }
+}
+
+// added for dem
+//void CANSim::toggleRandomLineColor()
+//{
+//    int random = QRandomGenerator::global()->bounded(5);
+//
+//    if (!nodeLinesHigh.isEmpty() && !nodeLinesLow.isEmpty()) {
+//        if (random == 0)
+//        {
+//            dom = true;
+//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
+//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
+//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
+//            toggleLineColorDom(lineHigh, lineLow);
+//            dom = false;
+//        }
+//        else if (random == 1)
+//        {
+//            rec = true;
+//            dom = false;
+//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
+//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
+//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
+//            toggleLineColorRec(lineHigh, lineLow);
+//            rec = false;
+//        }
+//        else if (random == 2)
+//        {
+//            dom = true;
+//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
+//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
+//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
+//            toggleLineColorDom(lineHigh, lineLow);
+//
+//            randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
+//            lineHigh = nodeLinesHigh[randomIndex];
+//            lineLow = nodeLinesLow[randomIndex];
+//            toggleLineColorRec(lineHigh, lineLow);
+//        }
+//        else
+//        {
+//            rec = true;
+//            dom = false;
+//            int randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
+//            QGraphicsLineItem* lineHigh = nodeLinesHigh[randomIndex];
+//            QGraphicsLineItem* lineLow = nodeLinesLow[randomIndex];
+//            toggleLineColorRec(lineHigh, lineLow);
+//
+//            randomIndex = QRandomGenerator::global()->bounded(nodeLinesHigh.size()-1);
+//            lineHigh = nodeLinesHigh[randomIndex];
+//            lineLow = nodeLinesLow[randomIndex];
+//            toggleLineColorRec(lineHigh, lineLow);
+//        }
+//    }
+//}
+
+void CANSim::setAllLinesToWhite()
+{
+    dom = false;
+    rec = false;
+
+    // Only the lines coloured since the last reset need repainting
+    QVector<QGraphicsLineItem*> lines;
+    lines.swap(litLines);
+    for (QGraphicsLineItem* line : lines) {
+        changeLineColor(line, Qt::white);
+    }
+
+	for (NodeConfigWidget* node : nodeWidgets) {
+        node->clearReceivedMessage();
+	}
+}
+
+//void CANSim::resetLinesAndToggleColor()
+//{
+//    //necessary
+//    setAllLinesToWhite();
+//
+//    if (pendingMessagesTable->rowCount() == 0) {
+//        simulationTimer->stop();  // Stop the simulation timer when no more messages are pending
+//        return;  // Exit the function to prevent further toggling
+//    }
+//
+//    //added for dem
+//    toggleCount++;
+//    if (toggleCount % 4 == 0) {
+//        int rowCount = pendingMessagesTable->rowCount();
+//
+//        if (rowCount > 0) {
+//            // Select a random pending message to mark as sent
+//            int randomRow = QRandomGenerator::global()->bounded(rowCount);
+//
+//            // Retrieve the message details from the selected row
+//            int nodeId = pendingMessagesTable->item(randomRow, 0)->text().toInt();
+//            int messageId = pendingMessagesTable->item(randomRow, 1)->text().toInt();
+//            bool errorDetected = QRandomGenerator::global()->bounded(2);
+//
+//            // Move the message to "Sent Messages" table
+//            //markMessageAsSent(nodeId, messageId, errorDetected);
+//        }
+//    }
+//
+//    QTimer::singleShot(500, this, &CANSim::toggleRandomLineColor); 
+//}
+
+void CANSim::openSendMessageDialog(int senderNodeId, Node* node) {
+    QVector<int> availableNodes;
+    for (auto nodeItem : scene->items()) {
+        NodeConfigWidget* node = dynamic_cast<NodeConfigWidget*>(nodeItem);
+        if (node) {
+            availableNodes.append(node->getNodeId());
+        }
+    }
+
+    MessageDialog* dialog = new MessageDialog(senderNodeId, availableNodes, node, this);
+
+    connect(dialog, &MessageDialog::messageReady, this, [this](int senderNodeId, int messageId, QVector<int> targetNodeIds) {
+        messageList.append(qMakePair(senderNodeId, messageId));
+    });
+
+    dialog->exec();
+}
+
+void CANSim::addNode(Node* node, bool error) {
+    if (error){
+		node->setError(true);
+    }
+    else {
+        node->setError(false);
+    }
+    node->setNodeActive(true);
+    nodesInSim.push_back(node);
+}
+
+std::vector<Node*>&CANSim::getNodes() {
+    return nodesInSim;
+}
+
+Node* CANSim::findNodeById(int id) {
+    for (auto nodePtr : nodesInSim) { 
+        if (nodePtr->getNodeId() == id) {  
+            return nodePtr; 
+        }
+    }
+    return nullptr;
+}
+
+std::vector<Message> CANSim::collectAllMessages() const {
+    std::vector<Message> allMessages;
+
+    for (Node* node : nodesInSim) {
+        const auto& messagesAndRounds = node->getMessagesToBeSent();
+
+        for (const auto& roundMessagePair : messagesAndRounds) {
+            const Message* msg = roundMessagePair;
+            if (msg) {
+                allMessages.push_back(*msg);
+            }
+        }
+    }
+
+    return allMessages;
+}
+
+bool CANSim::getRandomBool() {
+    std::random_device rd;  
+    std::mt19937 gen(rd()); 
+    std::uniform_int_distribution<> dist(0, 1); 
+    return dist(gen);
+}
+
+//void CANSim::printNodesAndRounds() {
+//    // Iterate through each node in the simulation
+//    for (Node* node : nodesInSim) {
+//        // Print the node ID in debug output
+//        qDebug() << "Node ID:" << node->getNodeId();
+//
+//        // Get the nodesAndRounds map for this node
+//        const std::map<int, std::vector<int>>& nodesAndRounds = node->getNodesAndRounds();
+//
+//        // Iterate through the map (rounds -> nodes)
+//        for (auto it = nodesAndRounds.begin(); it != nodesAndRounds.end(); ++it) {
+//            int second = it->first;  // The round (second)
+//            const std::vector<int>& nodeIds = it->second;  // List of node IDs in this round
+//
+//            // Print the second (round) and node IDs in debug output
+//            QString nodeIdsString = "Nodes -> ";
+//            for (int id : nodeIds) {
+//                nodeIdsString += QString::number(id) + " ";
+//            }
+//
+//            qDebug() << "  Second" << second << ":" << nodeIdsString;
+//        }
+//    }
 //}
\ No newline at end of file
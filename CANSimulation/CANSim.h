@@ -1,82 +1,152 @@
-#ifndef CAN_SIM_H
-#define CAN_SIM_H
-
-#include <QMainWindow>
-#include <QGraphicsScene>
-#include <QGraphicsView>
-#include <QPushButton>
-#include <QGraphicsLineItem>
-#include <QTimer>
-#include <QVector>
-#include <QTableWidget>
-#include <QLabel>
-#include <QVBoxLayout>
-
-#include "NodeConfigWidget.h"
-#include "Node.h"
-#include "CANBus.h"
-
-class CANSim : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    explicit CANSim(QWidget* parent = nullptr);
-    ~CANSim();
-
-    QList<QPair<int, int>> messageList;
-    std::vector<Node*> nodesInSim;
-    CANBus* canBus;
-
-    void markMessageAsSent(int nodeId, uint16_t messageId, int round);
-    void setAllLinesToWhite();
-    void toggleLineColorDom(QGraphicsLineItem* canl, QGraphicsLineItem* canh); 
-    void toggleLineColorRec(QGraphicsLineItem* canl, QGraphicsLineItem* canh); 
-
-public slots:
-    void openSendMessageDialog(int nodeId, Node* node);
-
-private:
-    void changeLineColor(QGraphicsLineItem* line, const QColor& color);
-    void updateCANBusLines();
-    void createMessagePanel();
-    void addPendingMessage(int nodeId, uint16_t messageId, int round);
-	void processPendingMessages(); 
-    void addNode(Node* node, bool error);
-    std::vector<Node*>& getNodes();
-    Node* findNodeById(int id);
-    std::vector<Message> collectAllMessages() const;
-    void initializeCustomConfiguration();
-    void processSimulation();
-    void createWelcomeScreen();
-    void selectPredefinedScenario();
-    void setupPredefinedScenario(int scenario);
-	void addPredefinedNode(int nodeId, const std::map<int, int>& messageAndFreq, bool error);
-    void startPredefinedSimulation();
-    bool getRandomBool();
-
-    QGraphicsView* graphicsView;                  
-    QGraphicsScene* scene;                        
-    QPushButton* startSimButton;                  
-    QPushButton* addNodeButton;                   
-    QGraphicsTextItem* canBusLabel; 
-	QVector<NodeConfigWidget*> nodeWidgets;
-    QVector<QGraphicsLineItem*> canLines;         
-    QVector<QGraphicsLineItem*> nodeLinesHigh;   
-    QVector<QGraphicsLineItem*> nodeLinesLow;     
-    QTimer* simulationTimer;                     
-    QTableWidget* pendingMessagesTable;   
-    QTableWidget* sentMessagesTable;
-    QGraphicsTextItem* roundLabel;
-    QGraphicsTextItem* bitPositionLabel;
-    QVBoxLayout* layout;
-    int nextXPosition;                           
-    bool simulationStarted;                   
-    bool dom = false;
-    bool rec = false;
-    bool addMessage = true;
-    int stepCounter;
-    int roundCount;
-};
-
+#ifndef CAN_SIM_H
+#define CAN_SIM_H
+
+#include <QMainWindow>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QPushButton>
+#include <QGraphicsLineItem>
+#include <QTimer>
+#include <QVector>
+#include <QHash>
+#include <QTableView>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QProgressBar>
+#include <QComboBox>
+#include <QSlider>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+
+#include "NodeConfigWidget.h"
+#include "Node.h"
+#include "CANBus.h"
+#include "Scenario.h"
+#include "ResponseTimeAnalysis.h"
+#include "SimulationWorker.h"
+#include "ReplayIndex.h"
+
+class CounterExporter;
+class MonitorNode;
+class MessageTableModel;
+class BitTrace;
+class BusTimelineWidget;
+class LogViewer;
+class NodeGroupItem;
+class TopologyView;
+struct NetworkDefinition;
+
+class CANSim : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit CANSim(QWidget* parent = nullptr);
+    ~CANSim();
+
+    QList<QPair<int, int>> messageList;
+    std::vector<Node*> nodesInSim;
+    CANBus* canBus;
+
+    void markMessageAsSent(int nodeId, uint16_t messageId, int round);
+    void markMessageAsPending(int nodeId, uint16_t messageId, int round);
+    void setAllLinesToWhite();
+    void toggleLineColorDom(QGraphicsLineItem* canl, QGraphicsLineItem* canh); 
+    void toggleLineColorRec(QGraphicsLineItem* canl, QGraphicsLineItem* canh); 
+
+public slots:
+    void openSendMessageDialog(int nodeId, Node* node);
+
+private:
+    void changeLineColor(QGraphicsLineItem* line, const QColor& color);
+    void showLineColors(const QHash<QGraphicsLineItem*, QRgb>& colors);  // colours exactly these lines, the rest white
+    void placeNode(NodeConfigWidget* widget);
+    void updateCANBusLines();
+    void setBusColor(const QColor& high, const QColor& low);
+    void createMessagePanel();
+    void addPendingMessage(int nodeId, uint16_t messageId, int round);
+    QTableView* createMessageTable(MessageTableModel* model);
+	void processPendingMessages(); 
+    void addNode(Node* node, bool error);
+    std::vector<Node*>& getNodes();
+    Node* findNodeById(int id);
+    std::vector<Message> collectAllMessages() const;
+    void initializeCustomConfiguration();
+    void analyzeResponseTimes();
+    void startSimulation();
+    void processSimulation();
+    void createReplayControls();
+    void setReplaySpeed(double speed);
+    void setReplayPaused(bool paused);
+    // Takes rounds from the worker until the index covers the position and the round, or the worker
+    // has none ready. True once the worker has finished and every round is indexed.
+    bool indexReplayRounds(size_t position, int round = -1);
+    void advanceReplay();
+    void moveReplayTo(size_t position);
+    void showReplayPosition(size_t position);
+    void completeReplay();
+    void createWelcomeScreen();
+    void selectPredefinedScenario();
+    void setupPredefinedScenario(int scenario);
+    void selectScenarioFile();
+    void selectDbcFile();
+    void setupScenario(const ScenarioDefinition& scenario);
+    void setupNetwork(const NetworkDefinition& network);
+    void showBusTimeline(const ScenarioDefinition& scenario);
+    void showBitTrace(BitTrace&& trace, uint32_t bitRate);
+    void addLogButton();
+    void showLogViewer();
+	void addPredefinedNode(const ScenarioNode& definition, int networkSize);
+    void startPredefinedSimulation();
+    bool getRandomBool();
+
+    TopologyView* graphicsView;                  
+    QGraphicsScene* scene;                        
+    QPushButton* startSimButton;                  
+    QPushButton* addNodeButton;                   
+    QGraphicsTextItem* canBusLabel; 
+	QVector<NodeConfigWidget*> nodeWidgets;
+    QVector<QGraphicsLineItem*> canLines;         
+    QVector<QGraphicsLineItem*> nodeLinesHigh;   
+    QVector<QGraphicsLineItem*> nodeLinesLow;     
+    QVector<QGraphicsLineItem*> busLinesHigh;     // one segment per row of nodes
+    QVector<QGraphicsLineItem*> busLinesLow;
+    QGraphicsLineItem* busTrunkHigh = nullptr;   // joins the rows once there is more than one
+    QGraphicsLineItem* busTrunkLow = nullptr;
+    QVector<NodeGroupItem*> nodeGroups;          // one aggregate per row for the zoomed out view
+    QHash<QGraphicsLineItem*, QRgb> lineColors;  // colour each line was last given
+    QVector<QGraphicsLineItem*> litLines;         // lines that are not white, reset by setAllLinesToWhite
+    QTimer* simulationTimer;                     
+    QTimer* progressTimer;
+    QProgressBar* simulationProgress;
+    SimulationWorker* simulationWorker = nullptr;
+    CounterExporter* counterExporter = nullptr;
+    std::vector<MonitorNode*> monitors;          // passive nodes of the scenario, fed by canBus
+    QTableView* pendingMessagesTable;   
+    QTableView* sentMessagesTable;
+    MessageTableModel* pendingMessagesModel;
+    MessageTableModel* sentMessagesModel;
+    BusTimelineWidget* busTimeline = nullptr;
+    LogViewer* logViewer = nullptr;
+    QGraphicsTextItem* roundLabel;
+    QGraphicsTextItem* bitPositionLabel;
+    QVBoxLayout* layout;
+    bool simulationStarted;                   
+    int scenarioRounds = 60;
+    std::vector<ResponseTimeAnalysis::Result> responseTimeBounds;
+    bool dom = false;
+    bool rec = false;
+    bool addMessage = true;
+    ReplayIndex replayIndex;                    // rounds received from the worker so far
+    size_t replayPosition = 0;                  // positions shown so far, the last one is on screen
+    size_t replayStepsPerTick = 1;
+    bool replayPaused = false;
+    bool replayComplete = false;
+    QPushButton* playButton;
+    QComboBox* speedBox;
+    QSlider* replaySlider;
+    QSpinBox* seekRoundBox;
+    QDoubleSpinBox* seekTimeBox;
+};
+
 #endif
\ No newline at end of file
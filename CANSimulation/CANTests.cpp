@@ -0,0 +1,1343 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BitLevelBus.h"
+#include "BitSlicedBus.h"
+#include "BitTrace.h"
+#include "CANBus.h"
+#include "DbcImporter.h"
+#include "ErrorCheck.h"
+#include "ErrorConfinement.h"
+#include "FrameFilter.h"
+#include "LatencyHistogram.h"
+#include "LogIndex.h"
+#include "LogRecord.h"
+#include "Network.h"
+#include "Node.h"
+#include "PeriodicScheduler.h"
+#include "ResponseTimeAnalysis.h"
+#include "RunTrace.h"
+#include "RunTraceQuery.h"
+#include "Scenario.h"
+#include "ScenarioFile.h"
+#include "SignalCodec.h"
+#include "SimulationCheckpoint.h"
+#include "SimulationStatistics.h"
+#include "TimerWheel.h"
+#include "TraceReader.h"
+#include "WhatIfSimulator.h"
+#include "WorkloadGenerator.h"
+
+// Regression checks of the simulation engines. Runs every check, or the ones named on the
+// command line, and exits with 1 when any of them failed.
+//
+//   CANTests [<check>...]
+
+static int failures = 0;
+
+static void expect(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "    " << what << "\n";
+        failures++;
+    }
+}
+
+static std::string describe(const SimulationStatistics& statistics)
+{
+    std::string text = std::to_string(statistics.rounds) + " rounds, " + std::to_string(statistics.framesDelivered) +
+        " delivered, " + std::to_string(statistics.failedTransmissions) + " failed, " +
+        std::to_string(statistics.droppedFrames) + " dropped";
+
+    for (size_t i = 0; i < statistics.TEC.size(); ++i) {
+        text += ", node " + std::to_string(i + 1) + " " + std::to_string(statistics.TEC[i]) + "/" +
+            std::to_string(statistics.REC[i]) + (statistics.nodeActive[i] ? "" : " disabled") +
+            (statistics.nodeError[i] ? " error" : "");
+    }
+    return text;
+}
+
+// The nodes of a scenario on a bus of their own, set up the way SimulationWorker does
+struct ScenarioRun {
+    CANBus bus;
+    std::vector<std::unique_ptr<Node>> nodes;
+
+    explicit ScenarioRun(const ScenarioDefinition& scenario)
+        : bus(nullptr, nullptr, CANBus::Logging::Off)
+    {
+        bus.bitStuffingVisible = false;
+
+        int networkSize = getNetworkSize(scenario);
+        for (const ScenarioNode& definition : scenario.nodes) {
+            nodes.emplace_back(new Node(definition.nodeId, &bus));
+            nodes.back()->setError(definition.error);
+            nodes.back()->setNodeActive(true);
+            scheduleScenarioNode(nodes.back().get(), definition, networkSize);
+            bus.nodes.push_back(nodes.back().get());
+        }
+        for (const Node* node : bus.nodes) {
+            for (const Message* message : node->getMessagesToBeSent()) {
+                bus.pendingMessages.push_back(*message);
+            }
+        }
+    }
+
+    // One pass of the round loop of SimulationWorker, false once the run is over
+    bool step(int rounds)
+    {
+        bool success = bus.arbitrate();
+        bus.arbitrationSteps.clear();
+        bus.winners.clear();
+
+        bool messagesPending = bus.hasPendingMessages();
+        if (success)
+            bus.incrementRound();
+
+        return messagesPending && bus.getRound() <= rounds;
+    }
+};
+
+static SimulationStatistics simulate(const ScenarioDefinition& scenario)
+{
+    ScenarioRun run(scenario);
+    while (run.step(scenario.rounds)) {
+    }
+    return run.bus.getStatistics();
+}
+
+// A run restored from a checkpoint taken at round 21 has to end exactly like the run it was
+// taken from, and no cut short snapshot may restore
+static void checkpointRestoresRun()
+{
+    const int CHECKPOINT_ROUND = 21;
+    ScenarioDefinition scenario = getPredefinedScenario(3);
+
+    ScenarioRun uninterrupted(scenario);
+    bool running = true;
+    while (running && uninterrupted.bus.getRound() < CHECKPOINT_ROUND) {
+        running = uninterrupted.step(scenario.rounds);
+    }
+    expect(running, "scenario 3 ended before round " + std::to_string(CHECKPOINT_ROUND));
+
+    std::vector<uint8_t> snapshot = SimulationCheckpoint::capture(uninterrupted.bus);
+    while (running) {
+        running = uninterrupted.step(scenario.rounds);
+    }
+
+    ScenarioRun restored(scenario);
+    SimulationCheckpoint::apply(restored.bus, snapshot);
+    expect(restored.bus.getRound() == CHECKPOINT_ROUND, "restored at round " + std::to_string(restored.bus.getRound()));
+    while (restored.step(scenario.rounds)) {
+    }
+
+    std::string actual = describe(restored.bus.getStatistics());
+    std::string expected = describe(uninterrupted.bus.getStatistics());
+    expect(actual == expected, "restored run: " + actual + ", uninterrupted run: " + expected);
+    expect(SimulationCheckpoint::capture(restored.bus) == SimulationCheckpoint::capture(uninterrupted.bus),
+        "the final snapshots differ, metrics or counters of the restored run are not the same");
+
+    for (size_t length = 0; length < snapshot.size(); ++length) {
+        ScenarioRun scratch(scenario);
+        std::vector<uint8_t> truncated(snapshot.begin(), snapshot.begin() + length);
+        try {
+            SimulationCheckpoint::apply(scratch.bus, truncated);
+            expect(false, "a snapshot cut to " + std::to_string(length) + " of " + std::to_string(snapshot.size()) +
+                " bytes restored");
+            return;
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+}
+
+// Counter thresholds of a single node, then a transmitter whose frames nobody acknowledges:
+// error active for 15 ACK errors, error passive from the 16th on, and once passive it has to
+// suspend for 8 bit times after its own error frames before it retransmits
+static void errorConfinementStates()
+{
+    typedef ErrorConfinement::State State;
+
+    ErrorConfinement transmitter;
+    for (int i = 0; i < 15; ++i) {
+        transmitter.transmitError();
+    }
+    expect(transmitter.getState() == State::ErrorActive, "error passive at TEC " + std::to_string(transmitter.getTEC()));
+    transmitter.transmitError();
+    expect(transmitter.getState() == State::ErrorPassive, "not error passive at TEC " + std::to_string(transmitter.getTEC()));
+    transmitter.transmitSuccess();
+    expect(transmitter.getState() == State::ErrorActive, "still error passive at TEC " + std::to_string(transmitter.getTEC()));
+
+    ErrorConfinement receiver;
+    for (int i = 0; i < ErrorConfinement::PASSIVE_THRESHOLD; ++i) {
+        receiver.receiveError();
+    }
+    expect(receiver.getState() == State::ErrorPassive, "not error passive at REC " + std::to_string(receiver.getREC()));
+    receiver.receiveSuccess();
+    expect(receiver.getState() == State::ErrorActive && receiver.getREC() == 119,
+        "a reception while passive leaves REC at " + std::to_string(receiver.getREC()));
+
+    ErrorConfinement busOff;
+    for (int i = 0; i < 32; ++i) {
+        busOff.transmitError();
+    }
+    expect(busOff.getState() == State::BusOff, "not bus-off at TEC " + std::to_string(busOff.getTEC()));
+    busOff.receiveSuccess();
+    bool recovered = false;
+    for (int i = 1; i < ErrorConfinement::RECOVERY_SEQUENCES; ++i) {
+        recovered |= busOff.recessiveSequence();
+    }
+    expect(!recovered && busOff.getState() == State::BusOff, "recovered before 128 recessive sequences");
+    expect(busOff.recessiveSequence() && busOff.getState() == State::ErrorActive && busOff.getTEC() == 0 && busOff.getREC() == 0,
+        "not error active with cleared counters after 128 recessive sequences");
+
+    BitLevelBus bus(2);
+    BitTrace trace(2);
+    bus.setTrace(&trace);
+    BitLevelBus::FaultProfile deaf;
+    deaf.ackDisabled = true;
+    bus.setFaultProfile(1, deaf);
+    bus.queueFrame(0, 0x123, { 1, 2 }, 0);
+    bus.run(3000);
+
+    const ErrorConfinement& sender = bus.getConfinement(0);
+    expect(sender.getState() == State::ErrorPassive && sender.getTEC() == ErrorConfinement::PASSIVE_THRESHOLD,
+        "sender ends at TEC " + std::to_string(sender.getTEC()) + ", an error-passive sender does not count ACK errors");
+
+    const std::vector<BitTrace::Span>& errorFrames = trace.getSpans(BitTrace::SpanKind::ErrorFrame);
+    const std::vector<BitTrace::Span>& frames = trace.getSpans(BitTrace::SpanKind::Frame);
+    expect(errorFrames.size() > 20, std::to_string(errorFrames.size()) + " error frames");
+    for (size_t i = 0; i < errorFrames.size(); ++i) {
+        size_t next = trace.firstSpanAfter(BitTrace::SpanKind::Frame, errorFrames[i].end);
+        if (next == frames.size()) {
+            break;
+        }
+
+        // Intermission, plus suspend transmission once the 16th error made the sender passive
+        uint64_t expected = i < 15 ? 3 : 11;
+        uint64_t gap = frames[next].begin - errorFrames[i].end;
+        expect(gap == expected, "error frame " + std::to_string(i + 1) + " is followed by the retransmission after " +
+            std::to_string(gap) + " bit times instead of " + std::to_string(expected));
+    }
+}
+
+// Percentiles of random latencies from 0 to MAX_VALUE against the sorted values: never below the
+// exact value, at most 1/32 above it and exact below SUB_BUCKETS. Two halves merged have to
+// answer exactly like a histogram that recorded everything
+static void histogramPercentilesAndMerge()
+{
+    std::mt19937_64 random(28);
+    std::vector<uint64_t> values;
+    LatencyHistogram all;
+    LatencyHistogram halves[2];
+
+    expect(all.valueAtPercentile(50.0) == 0 && all.getMin() == 0, "an empty histogram does not answer 0");
+
+    for (int i = 0; i < 100000; ++i) {
+        int magnitude = static_cast<int>(random() % (LatencyHistogram::MAGNITUDE_BITS + 1));
+        uint64_t value = magnitude == 0 ? 0 : random() % (1ULL << magnitude);
+        values.push_back(value);
+        all.record(value);
+        halves[i % 2].record(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    LatencyHistogram merged = halves[0];
+    merged.merge(halves[1]);
+    expect(merged.getCount() == all.getCount() && merged.getMin() == all.getMin() && merged.getMax() == all.getMax() &&
+        merged.getMean() == all.getMean(), "merged count, min, max or mean differ from the full histogram");
+    expect(all.getMin() == values.front() && all.getMax() == values.back(), "min or max are not the recorded extremes");
+
+    for (double percentile : { 0.0, 1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 100.0 }) {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size()));
+        uint64_t exact = values[std::max<size_t>(rank, 1) - 1];
+        uint64_t value = all.valueAtPercentile(percentile);
+
+        bool close = exact < LatencyHistogram::SUB_BUCKETS ? value == exact : value >= exact && value - exact <= exact / 32;
+        expect(close, "percentile " + std::to_string(percentile) + ": " + std::to_string(value) + ", exact " +
+            std::to_string(exact));
+        expect(merged.valueAtPercentile(percentile) == value, "percentile " + std::to_string(percentile) + " merged: " +
+            std::to_string(merged.valueAtPercentile(percentile)) + ", full histogram: " + std::to_string(value));
+    }
+}
+
+// A small DBC file with the statements the importer reads, between ones it has to skip,
+// including a comment whose string runs over several lines and looks like a message
+static void dbcSampleImports()
+{
+    static const char SAMPLE[] = R"(VERSION ""
+
+NS_ :
+    CM_
+    BA_DEF_
+    SIG_VALTYPE_
+
+BS_:
+
+BU_: ECU Gateway
+
+BO_ 100 EngineData: 8 ECU
+ SG_ Speed : 0|16@1+ (0.01,0) [0|655.35] "km/h" Gateway
+ SG_ Temperature : 23|8@0- (1,-40) [-40|215] "degC" Gateway,ECU
+
+BO_ 2147484672 Diagnostics: 8 Vector__XXX
+ SG_ Page M : 0|8@1+ (1,0) [0|255] "" ECU
+ SG_ Counter m1 : 8|16@1+ (1,0) [0|65535] "" ECU
+ SG_ Value m2 : 8|32@1- (1,0) [-1E+3|1E+3] "V" ECU
+
+CM_ BO_ 100 "Sent by the engine ECU.
+BO_ 200 NotAMessage: 8 ECU
+ SG_ NotASignal : 0|8@1+ (1,0) [0|1] """;
+BA_DEF_ BO_ "GenMsgCycleTime" INT 0 65535;
+BA_DEF_DEF_ "GenMsgCycleTime" 100;
+BA_ "GenMsgCycleTime" BO_ 100 10;
+SIG_VALTYPE_ 2147484672 Value : 1;
+)";
+
+    std::istringstream in(SAMPLE);
+    NetworkDefinition network = DbcImporter::parse(in);
+
+    expect(network.nodes == std::vector<std::string>({ "ECU", "Gateway" }), std::to_string(network.nodes.size()) + " nodes");
+    expect(network.messages.size() == 2, std::to_string(network.messages.size()) + " messages");
+    if (network.messages.size() != 2) {
+        return;
+    }
+
+    const MessageDefinition* engine = network.findMessage(100);
+    expect(engine && engine->name == "EngineData" && engine->dataLength == 8 && engine->transmitter == 0 &&
+        !engine->extended && engine->cycleTime == 10 && engine->signalDefinitions.size() == 2, "EngineData is not as written");
+    if (engine && engine->signalDefinitions.size() == 2) {
+        const SignalDefinition& speed = engine->signalDefinitions[0];
+        expect(speed.startBit == 0 && speed.length == 16 && speed.byteOrder == SignalDefinition::ByteOrder::Intel &&
+            !speed.isSigned && speed.factor == 0.01 && speed.maximum == 655.35 && speed.unit == "km/h", "Speed is not as written");
+        const SignalDefinition& temperature = engine->signalDefinitions[1];
+        expect(temperature.startBit == 23 && temperature.length == 8 &&
+            temperature.byteOrder == SignalDefinition::ByteOrder::Motorola && temperature.isSigned &&
+            temperature.offset == -40.0 && temperature.minimum == -40.0, "Temperature is not as written");
+    }
+
+    // Extended identifiers are written with bit 31 set
+    const MessageDefinition* diagnostics = network.findMessage(0x80000400);
+    expect(diagnostics && diagnostics->extended && diagnostics->id == 0x400 && diagnostics->transmitter == -1 &&
+        diagnostics->cycleTime == 100 && diagnostics->signalDefinitions.size() == 3,
+        "Diagnostics is not as written, or did not get the default cycle time");
+    if (diagnostics && diagnostics->signalDefinitions.size() == 3) {
+        const std::vector<SignalDefinition>& layout = diagnostics->signalDefinitions;
+        expect(layout[0].multiplexer && layout[0].multiplexValue == -1, "Page is not the multiplexer");
+        expect(!layout[1].multiplexer && layout[1].multiplexValue == 1, "Counter is not multiplexed on 1");
+        expect(layout[2].multiplexValue == 2 && layout[2].valueType == SignalDefinition::ValueType::Float &&
+            layout[2].minimum == -1000.0, "Value is not a float multiplexed on 2");
+    }
+
+    struct Broken {
+        const char* text;
+        const char* error;
+    };
+    static const Broken BROKEN[] = {
+        { "BU_: ECU\n SG_ Speed : 0|16@1+ (1,0) [0|1] \"\" ECU\n", "DBC line 2: signal outside of a message" },
+        { "BO_ 100 A: 8 ECU\nBO_ 100 B: 8 ECU\n", "DBC line 2: duplicate message identifier 100" },
+        { "BO_ 100 A: 8 ECU\n SG_ Speed : 0|16@2+ (1,0) [0|1] \"\" ECU\n", "DBC line 2: invalid byte order or sign for signal Speed" },
+        { "CM_ \"never closed\n", "DBC line 1: unterminated string" },
+    };
+    for (const Broken& broken : BROKEN) {
+        std::istringstream brokenIn(broken.text);
+        std::string error = "no error";
+        try {
+            DbcImporter::parse(brokenIn);
+        }
+        catch (const std::invalid_argument& e) {
+            error = e.what();
+        }
+        expect(error == broken.error, "\"" + error + "\" instead of \"" + broken.error + "\"");
+    }
+}
+
+// Frames of a text trace written to a file of its own, the way TraceReader gets them
+static std::vector<TraceFrame> readTrace(const std::string& text, TraceReader::Format& format, TraceReader::Statistics& statistics)
+{
+    static const char PATH[] = "CANTests_trace.tmp";
+    {
+        std::ofstream file(PATH, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::vector<TraceFrame> frames;
+    {
+        TraceReader reader(PATH);
+        TraceFrame frame;
+        while (reader.next(frame)) {
+            frames.push_back(frame);
+        }
+        format = reader.getFormat();
+        statistics = reader.getStatistics();
+    }
+    std::remove(PATH);
+    return frames;
+}
+
+static std::string describe(const TraceFrame& frame)
+{
+    std::string text = std::to_string(frame.timestamp) + " " + std::to_string(frame.channel) + " " +
+        std::to_string(frame.id) + (frame.extended ? "x" : "") + (frame.remote ? " r" : " d") + std::to_string(frame.length);
+    for (int i = 0; i < frame.length && !frame.remote; ++i) {
+        text += " " + std::to_string(frame.data[i]);
+    }
+    return text;
+}
+
+// candump -l and -t lines and Vector ASC lines with hex and decimal identifiers and absolute
+// and relative timestamps; CAN FD, events and error frames are skipped, broken frames counted
+static void traceLinesParse()
+{
+    struct Trace {
+        const char* name;
+        const char* text;
+        TraceReader::Format format;
+        std::vector<std::string> frames;
+        uint64_t malformed;
+    };
+    const Trace TRACES[] = {
+        { "candump",
+            "(1436509052.249713) can0 123#1122\n"
+            "(1436509052.250000) can1 12345678#DEADBEEF\r\n"
+            "(1436509052.250100) can0 7FF#R\n"
+            "(1436509052.250200) can0 123##1112233\n"
+            "(1436509052.250300) can0 1X3#11\n"
+            "(1436509052.250400) can0  321   [3]  01 02 0A\n"
+            "(1436509052.250500) can1  321   [2]  remote",
+            TraceReader::Format::Candump,
+            { "1436509052249713 0 291 d2 17 34", "1436509052250000 1 305419896x d4 222 173 190 239", "1436509052250100 0 2047 r0",
+                "1436509052250400 0 801 d3 1 2 10", "1436509052250500 1 801 r2" },
+            1 },
+        { "ASC",
+            "date Mon Oct 19 10:00:00.000 am 2026\n"
+            "base hex  timestamps absolute\n"
+            "Begin Triggerblock Mon Oct 19 10:00:00.000 am 2026\n"
+            "   0.015991 1  123             Rx   d 8 01 02 03 04 05 06 07 08\n"
+            "   0.020000 2  1ABCDEFx        Tx   d 2 AA BB\n"
+            "   0.030000 1  100             Rx   r 0\n"
+            "   0.040000 CAN 1 Status:chip status error active\n"
+            "   0.050000 1  ErrorFrame\n"
+            "   0.060000 1  200             Rx   d 2 01\n"
+            "End TriggerBlock\n",
+            TraceReader::Format::Asc,
+            { "15991 1 291 d8 1 2 3 4 5 6 7 8", "20000 2 28036591x d2 170 187", "30000 1 256 r0" },
+            1 },
+        { "ASC relative",
+            "base dec  timestamps relative\n"
+            "   0.500000 1  291             Rx   d 1 FF\n"
+            "   0.250000 1  292             Rx   d 1 01\n",
+            TraceReader::Format::Asc,
+            { "500000 1 291 d1 255", "750000 1 292 d1 1" },
+            0 },
+    };
+
+    for (const Trace& trace : TRACES) {
+        TraceReader::Format format;
+        TraceReader::Statistics statistics;
+        std::vector<TraceFrame> frames = readTrace(trace.text, format, statistics);
+
+        expect(format == trace.format, std::string(trace.name) + ": read in the other format");
+        std::vector<std::string> actual;
+        for (const TraceFrame& frame : frames) {
+            actual.push_back(describe(frame));
+        }
+        for (size_t i = 0; i < std::max(actual.size(), trace.frames.size()); ++i) {
+            std::string got = i < actual.size() ? actual[i] : "nothing";
+            std::string wanted = i < trace.frames.size() ? trace.frames[i] : "nothing";
+            expect(got == wanted, std::string(trace.name) + " frame " + std::to_string(i + 1) + ": " + got + " instead of " + wanted);
+        }
+        expect(statistics.frames == trace.frames.size() && statistics.malformedLines == trace.malformed,
+            std::string(trace.name) + ": " + std::to_string(statistics.malformedLines) + " malformed lines instead of " +
+            std::to_string(trace.malformed));
+    }
+}
+
+// Everything a generated scenario sets, as text, so two of them compare in one go
+static std::string describe(const ScenarioDefinition& scenario)
+{
+    std::string text;
+    for (const ScenarioNode& node : scenario.nodes) {
+        text += "node " + std::to_string(node.nodeId) + " " + std::to_string(node.transmitBitErrorRate) + "/" +
+            std::to_string(node.receiveBitErrorRate) + ":";
+        for (const ScenarioMessage& message : node.periodicMessages) {
+            text += " " + std::to_string(message.id) + "/" + std::to_string(message.dataLength) + "/" +
+                std::to_string(message.period) + "/" + std::to_string(message.offset) + "/" + std::to_string(message.jitter);
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+static std::vector<std::string> generateFrames(WorkloadGenerator& generator)
+{
+    std::vector<std::string> frames;
+    TraceFrame frame;
+    while (generator.next(frame)) {
+        frames.push_back(describe(frame));
+    }
+    return frames;
+}
+
+// The same profile and seed give the same scenario and the same frames, also after a restart;
+// another seed gives other ones
+static void workloadDeterministicPerSeed()
+{
+    WorkloadGenerator::Profile profile;
+    profile.seed = 38;
+    profile.busLoad = 0.6;
+    profile.duration = 200.0;
+    profile.nodes = 12;
+    profile.idAssignment = WorkloadGenerator::IdAssignment::Random;
+    profile.jitter = 0.2;
+    profile.burstProbability = 0.05;
+    profile.faultyNodes = 0.25;
+    profile.transmitBitErrorRate = 1e-5;
+    profile.receiveBitErrorRate = 1e-6;
+
+    WorkloadGenerator first(profile);
+    WorkloadGenerator second(profile);
+    std::vector<std::string> frames = generateFrames(first);
+
+    expect(!frames.empty(), "no frames generated");
+    expect(describe(first.getScenario()) == describe(second.getScenario()) && first.getExpectedLoad() == second.getExpectedLoad(),
+        "the same seed gives different scenarios");
+    expect(generateFrames(second) == frames, "the same seed gives different frames");
+
+    first.restart();
+    expect(generateFrames(first) == frames, "a restarted generator gives different frames");
+
+    profile.seed++;
+    WorkloadGenerator other(profile);
+    expect(describe(other.getScenario()) != describe(first.getScenario()) && generateFrames(other) != frames,
+        "another seed gives the same workload");
+}
+
+// Waits for the indexing thread to reach the given number of lines
+static bool waitForLines(const LogIndex& index, uint64_t lines)
+{
+    for (int attempt = 0; attempt < 1000 && index.getLineCount() < lines; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return index.getLineCount() == lines;
+}
+
+// Offsets, text and line of every offset of a log of random lines, some with CRLF, one
+// longer than a line is read, across read windows and with a last line the simulation is
+// still writing: it is indexed once its newline is appended, together with the new lines
+static void logIndexLineOffsets()
+{
+    static const char PATH[] = "CANTests_log.tmp";
+    std::mt19937 random(47);
+    std::vector<std::string> lines;
+    std::vector<uint64_t> offsets;
+    std::string text;
+
+    auto addLines = [&](int count) {
+        for (int i = 0; i < count; ++i) {
+            std::string line = "ROUND " + std::to_string(lines.size()) + " " + std::string(random() % 120, 'a' + random() % 26);
+            if (lines.size() == 1000) {
+                line += std::string(2 * LogIndex::MAX_LINE_LENGTH, 'x');
+            }
+            offsets.push_back(text.size());
+            lines.push_back(line);
+            text += line + (random() % 4 == 0 ? "\r\n" : "\n");
+        }
+    };
+
+    const std::string unfinished = "ROUND unfinished";
+    addLines(20000);
+    {
+        std::ofstream file(PATH, std::ios::binary | std::ios::trunc);
+        file << text << unfinished;
+    }
+
+    {
+        LogIndex index(PATH, 10);
+        expect(waitForLines(index, lines.size()), std::to_string(index.getLineCount()) + " lines indexed instead of " +
+            std::to_string(lines.size()));
+
+        // The log grows with the rest of the partial line and more lines
+        size_t written = text.size() + unfinished.size();
+        offsets.push_back(text.size());
+        lines.push_back(unfinished + " and finished");
+        text += lines.back() + "\n";
+        addLines(500);
+        {
+            std::ofstream file(PATH, std::ios::binary | std::ios::app);
+            file << text.substr(written);
+        }
+        expect(waitForLines(index, lines.size()), std::to_string(index.getLineCount()) + " lines indexed after appending instead of " +
+            std::to_string(lines.size()));
+        expect(index.getIndexedBytes() == text.size(), std::to_string(index.getIndexedBytes()) + " bytes indexed instead of " +
+            std::to_string(text.size()));
+
+        int wrong = 0;
+        for (uint64_t line = 0; line < lines.size() && wrong < 5; ++line) {
+            std::string expected = lines[line].substr(0, LogIndex::MAX_LINE_LENGTH);
+            uint64_t offset = index.offsetOfLine(line);
+            uint64_t inside = offsets[line] + random() % (lines[line].size() + 1);
+            bool right = offset == offsets[line] && index.readLine(line) == expected && index.lineOfOffset(inside) == line;
+            expect(right, "line " + std::to_string(line) + " at offset " + std::to_string(offset) + " instead of " +
+                std::to_string(offsets[line]) + ", or read or found by its offset wrongly");
+            wrong += right ? 0 : 1;
+        }
+        expect(index.offsetOfLine(lines.size()) == text.size(), "the offset after the last line is not the end of the log");
+    }
+    std::remove(PATH);
+}
+
+// Random conditions of one to three columns over a trace of two sessions of random rounds:
+// whichever rows the planner reads, the results have to be those of testing every row
+static void runTraceQueryResults()
+{
+    typedef RunTraceQuery::Column Column;
+    typedef RunTraceQuery::Comparison Comparison;
+    std::mt19937 random(49);
+
+    RunTrace trace;
+    for (int session = 0; session < 2; ++session) {
+        trace.add(LogRecord(LogRecord::Type::Session, "2026-10-19 10:00:00"));
+        for (int round = 1; round <= 300; ++round) {
+            trace.add(LogRecord(LogRecord::Type::Round, round));
+            trace.add(LogRecord(LogRecord::Type::ContendersHeader));
+
+            int winnerNode = 0;
+            int winnerId = 0;
+            int contenders = 1 + random() % 4;
+            for (int i = 0; i < contenders; ++i) {
+                int node = 1 + random() % 6;
+                int id = 1 + random() % 40;
+                trace.add(LogRecord(LogRecord::Type::Contender, id, node, round));
+                if (i == 0 || id < winnerId) {
+                    winnerNode = node;
+                    winnerId = id;
+                }
+            }
+            trace.add(LogRecord(LogRecord::Type::Blank));
+            trace.add(LogRecord(LogRecord::Type::Winner, winnerId, winnerNode, round));
+
+            bool received = false;
+            for (int node = 1; node <= 6; ++node) {
+                int outcome = node == winnerNode ? 0 : random() % 4;
+                if (outcome == 1 || outcome == 2) {
+                    trace.add(LogRecord(outcome == 1 ? LogRecord::Type::Received : LogRecord::Type::CrcFailed, node));
+                    received |= outcome == 1;
+                }
+            }
+            if (!received) {
+                trace.add(LogRecord(LogRecord::Type::NoReceivers));
+            }
+
+            trace.add(LogRecord(LogRecord::Type::CountersHeader));
+            for (int node = 1; node <= 6; ++node) {
+                trace.add(LogRecord(LogRecord::Type::NodeCounters, node, random() % 130, random() % 130));
+            }
+        }
+    }
+    trace.finish();
+
+    RunTraceQuery all(trace);
+    uint64_t rowCount = trace.getRowCount();
+    expect(rowCount > 0 && all.count() == rowCount, std::to_string(all.count()) + " rows without conditions instead of " +
+        std::to_string(rowCount));
+    if (rowCount == 0) {
+        return;
+    }
+
+    for (int queryIndex = 0; queryIndex < 5000; ++queryIndex) {
+        struct Condition {
+            Column column;
+            Comparison comparison;
+            int64_t value;
+        };
+        std::vector<Condition> conditions;
+        RunTraceQuery query(trace);
+        std::string text;
+
+        int conditionCount = 1 + random() % 3;
+        for (int i = 0; i < conditionCount; ++i) {
+            // Values near those of a random row, so conditions select something most of the time
+            Column column = static_cast<Column>(random() % 8);
+            Comparison comparison = static_cast<Comparison>(random() % 6);
+            int64_t value = all.value(random() % rowCount, column) + static_cast<int>(random() % 3) - 1;
+            conditions.push_back({ column, comparison, value });
+            query.where(column, comparison, value);
+            text += " " + std::to_string(static_cast<int>(column)) + "/" + std::to_string(static_cast<int>(comparison)) + "/" +
+                std::to_string(value);
+        }
+
+        std::vector<uint64_t> expected;
+        for (uint64_t row = 0; row < rowCount; ++row) {
+            bool match = true;
+            for (const Condition& condition : conditions) {
+                int64_t value = all.value(row, condition.column);
+                switch (condition.comparison) {
+                case Comparison::Equal: match &= value == condition.value; break;
+                case Comparison::NotEqual: match &= value != condition.value; break;
+                case Comparison::Less: match &= value < condition.value; break;
+                case Comparison::LessEqual: match &= value <= condition.value; break;
+                case Comparison::Greater: match &= value > condition.value; break;
+                case Comparison::GreaterEqual: match &= value >= condition.value; break;
+                }
+            }
+            if (match) {
+                expected.push_back(row);
+            }
+        }
+
+        RunTraceQuery::Aggregate tec = query.aggregate(Column::Tec);
+        int64_t tecSum = 0;
+        std::map<int64_t, uint64_t> nodes;
+        for (uint64_t row : expected) {
+            tecSum += all.value(row, Column::Tec);
+            nodes[all.value(row, Column::Node)]++;
+        }
+
+        bool right = query.count() == expected.size() && query.rows(expected.size() + 1) == expected &&
+            query.first() == (expected.empty() ? RunTrace::NONE : expected.front()) &&
+            query.last() == (expected.empty() ? RunTrace::NONE : expected.back()) &&
+            tec.count == expected.size() && tec.sum == tecSum && query.groupBy(Column::Node) == nodes;
+        expect(right, "conditions" + text + ": " + std::to_string(query.count()) + " rows instead of " +
+            std::to_string(expected.size()) + ", or other rows, aggregate or groups");
+        if (!right) {
+            return;
+        }
+    }
+}
+
+// The filter error for an expression, or "no error"
+static std::string filterError(const std::string& expression)
+{
+    try {
+        FrameFilter filter(expression);
+    }
+    catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+    return "no error";
+}
+
+// Random frames through the examples of the filter language, a mix of the test groups and the
+// register program, against the same conditions written in C++; then the errors, including the
+// shift counts past the width and the limits of the program
+static void frameFilterExpressions()
+{
+    using Values = const int32_t*;
+    struct Case {
+        const char* expression;
+        bool (*expected)(Values v);
+    };
+    static const Case CASES[] = {
+        { "id in 0x100..0x1FF && data[0] & 0x80",
+            [](Values v) { return v[FrameFilter::Id] >= 0x100 && v[FrameFilter::Id] <= 0x1FF && (v[FrameFilter::Data0] & 0x80) != 0; } },
+        { "sender == 5 && error", [](Values v) { return v[FrameFilter::Sender] == 5 && v[FrameFilter::Error] != 0; } },
+        { "data[0] & 0x80 == 0x80", [](Values v) { return (v[FrameFilter::Data0] & 0x80) == 0x80; } },
+        { "!(sender == 5) && dlc >= 2 || receivers & 0x4",
+            [](Values v) { return (v[FrameFilter::Sender] != 5 && v[FrameFilter::Dlc] >= 2) || (v[FrameFilter::Receivers] & 0x4) != 0; } },
+        { "data[0] | data[1] ^ 0x0F == 0xFF",
+            [](Values v) { return ((v[FrameFilter::Data0] | v[FrameFilter::Data0 + 1]) ^ 0x0F) == 0xFF; } },
+        { "id >> 4 & 0xF == dlc || -data[2] < -200",
+            [](Values v) { return ((v[FrameFilter::Id] >> 4) & 0xF) == v[FrameFilter::Dlc] || -v[FrameFilter::Data0 + 2] < -200; } },
+        { "~id & 0x700 == 0 && !delivered",
+            [](Values v) { return (~v[FrameFilter::Id] & 0x700) == 0 && v[FrameFilter::Delivered] == 0; } },
+        // Counts from the data reach past 31: shifted out, or filled with the sign
+        { "data[0] << data[1] == 0",
+            [](Values v) { return v[FrameFilter::Data0 + 1] >= 32 ? true : (v[FrameFilter::Data0] << v[FrameFilter::Data0 + 1]) == 0; } },
+        { "-id >> data[1] == -1",
+            [](Values v) { return v[FrameFilter::Id] > 0 && (v[FrameFilter::Data0 + 1] >= 32 || -v[FrameFilter::Id] >> v[FrameFilter::Data0 + 1] == -1); } },
+    };
+
+    std::mt19937 random(50);
+    std::vector<FrameFilter::Frame> frames(4000);
+    for (FrameFilter::Frame& frame : frames) {
+        int32_t* values = frame.values;
+        values[FrameFilter::Id] = std::uniform_int_distribution<int32_t>(0, 0x7FF)(random);
+        values[FrameFilter::Sender] = std::uniform_int_distribution<int32_t>(1, 8)(random);
+        values[FrameFilter::Dlc] = std::uniform_int_distribution<int32_t>(0, 8)(random);
+        values[FrameFilter::Delivered] = random() % 2;
+        values[FrameFilter::Error] = random() % 2;
+        values[FrameFilter::Receivers] = random() % 256;
+        for (int i = 0; i < values[FrameFilter::Dlc]; ++i) {
+            values[FrameFilter::Data0 + i] = random() % 256;
+        }
+        values[FrameFilter::Data0 + 1] %= 48;
+    }
+
+    for (const Case& filterCase : CASES) {
+        FrameFilter filter(filterCase.expression);
+        int wrong = 0;
+        for (const FrameFilter::Frame& frame : frames) {
+            wrong += filter.matches(frame) != filterCase.expected(frame.values);
+        }
+        expect(wrong == 0, std::string(filterCase.expression) + " decided " + std::to_string(wrong) + " frames wrongly");
+    }
+
+    struct Broken {
+        std::string expression;
+        std::string error;
+    };
+    std::string manyConstants = "data[0]";
+    for (int i = 1; i <= 300; ++i) {
+        manyConstants += " ^ " + std::to_string(i);
+    }
+    std::string deep = "data[0]";
+    for (int i = 40; i >= 1; --i) {
+        deep = "(data[0] ^ " + std::to_string(i) + ") ^ (" + deep + ")";
+    }
+    const Broken BROKEN[] = {
+        { "", "Filter \"\": the expression is empty at column 1" },
+        { "id ==", "Filter \"id ==\": the expression ends early at column 6" },
+        { "sender == 5 && bogus", "Filter \"sender == 5 && bogus\": unknown field \"bogus\" at column 16" },
+        { "1 < id < 3", "Filter \"1 < id < 3\": comparisons cannot be chained, join them with && at column 8" },
+        { "id in dlc..8", "Filter \"id in dlc..8\": range bounds must be constants at column 7" },
+        { "data[8] == 0", "Filter \"data[8] == 0\": data takes an index from 0 to 7 at column 6" },
+        { "id << 32", "Filter \"id << 32\": shift counts go from 0 to 31 at column 7" },
+        { "id >> -1 == 0", "Filter \"id >> -1 == 0\": shift counts go from 0 to 31 at column 7" },
+        { "id >> (16 | 32) == 0", "Filter \"id >> (16 | 32) == 0\": shift counts go from 0 to 31 at column 7" },
+        { manyConstants, "Filter is too large: more than 256 different constants, the limit, reached at column " +
+            std::to_string(manyConstants.find(" ^ 257") + 4) },
+        { deep, "Filter is too large: more than 32 intermediate results, the limit, reached at column " +
+            std::to_string(deep.find("data[0] ^ 33)") + 1) },
+    };
+    for (const Broken& broken : BROKEN) {
+        std::string error = filterError(broken.expression);
+        expect(error == broken.error, "\"" + error.substr(0, 200) + "\" instead of \"" + broken.error.substr(0, 200) + "\"");
+    }
+
+    expect(filterError("id << 31 == 0 && id >> 0 == id") == "no error", "shift counts of 0 and 31 rejected");
+}
+
+// Every lane of the bit-sliced engine has to end like the scalar engine does with the
+// faulty nodes of that lane, for the predefined scenarios and a network too large for the
+// receivers to fit the identifier, with and without random faults
+static void lanesMatchScalarEngine()
+{
+    std::vector<std::pair<std::string, ScenarioDefinition>> scenarios;
+    for (int predefined = 1; predefined <= 3; ++predefined) {
+        scenarios.emplace_back("scenario " + std::to_string(predefined), getPredefinedScenario(predefined));
+    }
+
+    ScenarioDefinition large;
+    large.rounds = 60;
+    for (int id = 1; id <= 20; ++id) {
+        ScenarioNode node;
+        node.nodeId = id;
+        node.error = id % 7 == 0;
+        node.messageAndFreq[id % 20 + 1] = 6 + id % 4;
+        node.messageAndFreq[(id + 8) % 20 + 1] = 3;
+        large.nodes.push_back(node);
+    }
+    scenarios.emplace_back("20 nodes", large);
+
+    int compared = 0;
+    for (const auto& named : scenarios) {
+        const std::string& name = named.first;
+        const ScenarioDefinition& scenario = named.second;
+
+        for (double errorProbability : { 0.0, 0.4 }) {
+            BitSlicedBus::Options options;
+            options.maxRound = scenario.rounds;
+            options.errorProbability = errorProbability;
+
+            // More seeds than lanes, so a second, partly filled batch runs as well
+            std::vector<uint64_t> seeds(BitSlicedBus::LANES + 36);
+            for (size_t i = 0; i < seeds.size(); ++i) {
+                seeds[i] = i * 7 + 1;
+            }
+
+            std::vector<SimulationStatistics> lanes = BitSlicedBus(scenario, options).run(seeds);
+            expect(lanes.size() == seeds.size(), name + ": " +
+                std::to_string(lanes.size()) + " results for " + std::to_string(seeds.size()) + " seeds");
+
+            for (const SimulationStatistics& lane : lanes) {
+                ScenarioDefinition faults = scenario;
+                for (ScenarioNode& node : faults.nodes) {
+                    node.error = lane.nodeError[node.nodeId - 1];
+                }
+
+                std::string actual = describe(lane);
+                std::string expected = describe(simulate(faults));
+                expect(actual == expected, name + " seed " + std::to_string(lane.seed) +
+                    ": " + actual + ", scalar engine: " + expected);
+                compared++;
+            }
+        }
+    }
+
+    expect(compared > 0, "no lanes compared");
+}
+
+// A node that sends an identifier in a single round gives a stream with an infinite period.
+// Its bound has to be the finite response time of that one release, not 0 * infinity.
+static void responseTimeOfSingleRelease()
+{
+    Node node(2, nullptr);
+    node.addNodesAndRound(10, 3);
+
+    ResponseTimeAnalysis alone;
+    alone.addScenarioNode(node, 1.0, 10.0);
+    std::vector<ResponseTimeAnalysis::Result> results = alone.analyze();
+
+    expect(results.size() == 1, std::to_string(results.size()) + " streams for one identifier");
+    if (!results.empty()) {
+        expect(std::isinf(alone.getStreams().front().period), "a single release has a finite period");
+        expect(results.front().responseTime == 10.0, "alone on the bus, bound " + std::to_string(results.front().responseTime) +
+            " instead of 10");
+        expect(results.front().instances == 1 && results.front().schedulable, "a single release is checked once and met");
+    }
+
+    // Between a periodic stream of higher priority and a longer one of lower priority: blocked
+    // for 20, then the periodic frame released 1 bit after the start of the wait, then itself
+    const double NEVER = std::numeric_limits<double>::infinity();
+    ResponseTimeAnalysis mixed;
+    mixed.addStream({ 0, 0x001, 100.0, 0.0, 10.0, 0.0 });
+    mixed.addStream({ 1, 0x002, NEVER, 0.0, 10.0, 0.0 });
+    mixed.addStream({ 2, 0x003, 200.0, 0.0, 20.0, 0.0 });
+    results = mixed.analyze();
+
+    expect(results.size() == 3 && results[1].id == 0x002, "streams are not sorted by identifier");
+    if (results.size() == 3) {
+        expect(results[1].responseTime == 40.0, "between other streams, bound " + std::to_string(results[1].responseTime) +
+            " instead of 40");
+        expect(results[1].instances == 1 && results[1].schedulable, "the single release is checked once and met");
+        // The one-shot frame interferes with the lower priority stream once
+        expect(results[2].responseTime == 40.0, "lowest priority bound " + std::to_string(results[2].responseTime) +
+            " instead of 40");
+    }
+}
+
+// The iteration passes the deadline at a queueing delay of 2 while the fixed point is 5, so
+// there is no bound to report, in particular not the response time of 3 that delay gives
+static void responseTimePastDeadlineUnbounded()
+{
+    ResponseTimeAnalysis overloaded(1.0, false);
+    overloaded.addStream({ 0, 0x001, 1.2, 0.0, 1.0, 0.0 });
+    overloaded.addStream({ 1, 0x002, 100.0, 0.0, 1.0, 2.5 });
+    std::vector<ResponseTimeAnalysis::Result> results = overloaded.analyze();
+
+    expect(results.size() == 2, std::to_string(results.size()) + " streams for two identifiers");
+    if (results.size() == 2) {
+        expect(results[0].schedulable && results[0].responseTime == 1.0, "highest priority bound " +
+            std::to_string(results[0].responseTime) + " instead of 1");
+        expect(std::isinf(results[1].responseTime) && !results[1].schedulable, "past its deadline, bound " +
+            std::to_string(results[1].responseTime) + " instead of none");
+    }
+}
+
+// Random schedule, cancel and advance operations, from the next tick to far beyond the range of the
+// top level: the wheel has to expire exactly what a sorted list of the pending timers does
+static void timerWheelMatchesSortedReference()
+{
+    std::mt19937_64 random(31);
+    TimerWheel wheel(1000);
+
+    // Ordered by expiry tick, then by scheduling order; a timer in the past expires on the next tick
+    std::map<std::pair<uint64_t, uint64_t>, std::pair<int, TimerWheel::Expired>> reference;
+    std::map<int, std::pair<uint64_t, uint64_t>> live;
+    uint64_t scheduled = 0;
+
+    auto distance = [&random]() -> uint64_t {
+        int kind = random() % 20;
+        if (kind < 6) {
+            return random() % 64;
+        }
+        if (kind < 12) {
+            return random() % 4096;
+        }
+        if (kind < 19) {
+            return random() % (1ULL << 24);
+        }
+        return random() % (1ULL << 32);
+    };
+
+    std::vector<TimerWheel::Expired> expired;
+    int fired = 0;
+    for (int operation = 0; operation < 200000; ++operation) {
+        int kind = random() % 10;
+        if (kind < 5) {
+            uint64_t time = random() % 20 == 0 ? wheel.getTime() - random() % 100 : wheel.getTime() + distance();
+            int payload = static_cast<int>(random() % 1000000);
+            int handle = wheel.schedule(time, payload);
+
+            std::pair<uint64_t, uint64_t> key(std::max(time, wheel.getTime()), scheduled++);
+            reference[key] = { handle, { payload, time } };
+            live[handle] = key;
+        }
+        else if (kind < 7) {
+            if (live.empty()) {
+                continue;
+            }
+            auto handle = live.begin();
+            std::advance(handle, random() % live.size());
+            wheel.cancel(handle->first);
+            reference.erase(handle->second);
+            live.erase(handle);
+        }
+        else {
+            uint64_t time = wheel.getTime() - 1 + distance() / (kind == 9 ? 1 : 256);
+
+            expired.clear();
+            wheel.advance(time, expired);
+
+            std::vector<TimerWheel::Expired> expected;
+            while (!reference.empty() && reference.begin()->first.first <= time) {
+                expected.push_back(reference.begin()->second.second);
+                live.erase(reference.begin()->second.first);
+                reference.erase(reference.begin());
+            }
+
+            bool same = expired.size() == expected.size();
+            for (size_t i = 0; same && i < expired.size(); ++i) {
+                same = expired[i].payload == expected[i].payload && expired[i].time == expected[i].time;
+            }
+            expect(same, "operation " + std::to_string(operation) + ": advance to " + std::to_string(time) + " expired " +
+                std::to_string(expired.size()) + " timers, the reference " + std::to_string(expected.size()));
+            if (!same) {
+                return;
+            }
+            fired += static_cast<int>(expired.size());
+        }
+
+        if (wheel.getPendingCount() != reference.size()) {
+            expect(false, "operation " + std::to_string(operation) + ": " + std::to_string(wheel.getPendingCount()) +
+                " timers pending, the reference has " + std::to_string(reference.size()));
+            return;
+        }
+    }
+
+    expect(fired > 0, "no timer expired");
+}
+
+// Random scenarios changed one setting at a time, every resumed run has to end exactly
+// where a run of the changed scenario from round 0 does
+static void whatIfMatchesFreshRun()
+{
+    static const int FREQUENCIES[] = { 1, 2, 3, 4, 5, 6, 10, 12, 15, 20, 30 };
+    std::mt19937 random(7);
+
+    auto frequency = [&random]() { return FREQUENCIES[random() % (sizeof(FREQUENCIES) / sizeof(FREQUENCIES[0]))]; };
+
+    int resumed = 0;
+    for (int scenarioIndex = 0; scenarioIndex < 100; ++scenarioIndex) {
+        ScenarioDefinition scenario;
+        int nodeCount = 2 + random() % 5;
+
+        for (int id = 1; id <= nodeCount; ++id) {
+            ScenarioNode node;
+            node.nodeId = id;
+            node.error = random() % 5 == 0;
+            int targets = random() % 3;
+            for (int i = 0; i < targets; ++i) {
+                int target = 1 + random() % nodeCount;
+                if (target != id) {
+                    node.messageAndFreq[target] = frequency();
+                }
+            }
+            scenario.nodes.push_back(node);
+        }
+
+        WhatIfSimulator simulator;
+        simulator.run(scenario);
+
+        for (int change = 0; change < 6; ++change) {
+            int index = random() % nodeCount;
+            ScenarioNode& node = scenario.nodes[index];
+
+            int kind = random() % 3;
+            if (kind == 0) {
+                node.error = !node.error;
+            }
+            else if (kind == 1 && !node.messageAndFreq.empty()) {
+                node.messageAndFreq.begin()->second = frequency();
+            }
+            else {
+                int target = 1 + random() % nodeCount;
+                if (target != index + 1) {
+                    node.messageAndFreq[target] = frequency();
+                }
+            }
+
+            WhatIfSimulator::Result result = simulator.run(scenario);
+            WhatIfSimulator::Result fresh = WhatIfSimulator().run(scenario);
+            resumed += result.resumedRound > 0 ? 1 : 0;
+
+            std::string actual = describe(result.statistics);
+            std::string expected = describe(fresh.statistics);
+            expect(actual == expected, "scenario " + std::to_string(scenarioIndex) + " change " + std::to_string(change) +
+                " resumed at round " + std::to_string(result.resumedRound) + ": " + actual + ", fresh run: " + expected);
+        }
+    }
+
+    // The check means nothing if no run ever resumed
+    expect(resumed > 0, "no run resumed from a checkpoint");
+}
+
+static std::string hex(const uint8_t* payload)
+{
+    static const char DIGITS[] = "0123456789ABCDEF";
+    std::string text;
+    for (size_t i = 0; i < SignalCodec::PAYLOAD_SIZE; ++i) {
+        text += DIGITS[payload[i] >> 4];
+        text += DIGITS[payload[i] & 0xF];
+    }
+    return text;
+}
+
+static SignalDefinition signal(SignalDefinition::ByteOrder byteOrder, int startBit, int length, bool isSigned)
+{
+    SignalDefinition definition;
+    definition.name = "signal";
+    definition.startBit = startBit;
+    definition.length = length;
+    definition.byteOrder = byteOrder;
+    definition.isSigned = isSigned;
+    return definition;
+}
+
+// Signals of both byte orders at odd start bits, written into payloads of random bytes: each
+// has to read back the value written and leave every bit outside it as it was
+static void signalsRoundTrip()
+{
+    // Layouts worked out by hand from the DBC numbering, so the codec is not only checked against itself
+    struct Layout {
+        SignalDefinition::ByteOrder byteOrder;
+        int startBit;
+        int length;
+        uint64_t raw;
+        uint8_t payload[8];
+    };
+    static const Layout LAYOUTS[] = {
+        { SignalDefinition::ByteOrder::Intel, 3, 12, 0xABC, { 0xE0, 0x55 } },
+        { SignalDefinition::ByteOrder::Intel, 13, 5, 0x15, { 0x00, 0xA0, 0x02 } },
+        { SignalDefinition::ByteOrder::Motorola, 5, 12, 0xABC, { 0x2A, 0xF0 } },
+        { SignalDefinition::ByteOrder::Motorola, 19, 9, 0x1FF, { 0x00, 0x00, 0x0F, 0xF8 } },
+    };
+
+    for (const Layout& layout : LAYOUTS) {
+        MessageDefinition message;
+        message.dataLength = 8;
+        message.signalDefinitions.push_back(signal(layout.byteOrder, layout.startBit, layout.length, false));
+        SignalCodec codec(message);
+
+        uint8_t payload[8] = {};
+        codec.encodeRaw(0, layout.raw, payload);
+        expect(std::memcmp(payload, layout.payload, sizeof(payload)) == 0, "start bit " + std::to_string(layout.startBit) +
+            " length " + std::to_string(layout.length) + " encodes to " + hex(payload) + " instead of " + hex(layout.payload));
+        expect(codec.decodeRaw(0, layout.payload) == layout.raw, "start bit " + std::to_string(layout.startBit) +
+            " decodes to " + std::to_string(codec.decodeRaw(0, layout.payload)));
+    }
+
+    std::mt19937_64 random(11);
+    int checked = 0;
+
+    for (auto byteOrder : { SignalDefinition::ByteOrder::Intel, SignalDefinition::ByteOrder::Motorola }) {
+        const char* order = byteOrder == SignalDefinition::ByteOrder::Intel ? "Intel" : "Motorola";
+
+        for (int startBit = 1; startBit < 64; startBit += 2) {
+            for (int length : { 1, 3, 7, 9, 16, 23, 31 }) {
+                for (bool isSigned : { false, true }) {
+                    MessageDefinition message;
+                    message.dataLength = 8;
+                    message.signalDefinitions.push_back(signal(byteOrder, startBit, length, isSigned));
+                    message.signalDefinitions.back().factor = 0.5;
+                    message.signalDefinitions.back().offset = -40.0;
+
+                    std::unique_ptr<SignalCodec> codec;
+                    try {
+                        codec.reset(new SignalCodec(message));
+                    }
+                    catch (const std::invalid_argument&) {
+                        continue;       // runs past the end of the payload
+                    }
+
+                    uint8_t before[8];
+                    uint8_t after[8];
+                    for (uint8_t& byte : before) {
+                        byte = static_cast<uint8_t>(random());
+                    }
+                    std::memcpy(after, before, sizeof(after));
+
+                    uint64_t mask = (uint64_t(1) << length) - 1;
+                    uint64_t raw = random() & mask;
+                    codec->encodeRaw(0, raw, after);
+
+                    std::string what = std::string(order) + " start bit " + std::to_string(startBit) + " length " +
+                        std::to_string(length) + (isSigned ? " signed" : "");
+                    expect(codec->decodeRaw(0, after) == raw, what + ": raw value does not read back");
+
+                    // Writing back the old value has to give the old payload, so no other bit moved
+                    codec->encodeRaw(0, codec->decodeRaw(0, before), after);
+                    expect(std::memcmp(before, after, sizeof(after)) == 0, what + ": " + hex(before) + " became " + hex(after));
+
+                    // Physical values on the raw grid survive encode and decode exactly
+                    int64_t value = isSigned ? static_cast<int64_t>(raw << (64 - length)) >> (64 - length) : static_cast<int64_t>(raw);
+                    double physicalValue = value * 0.5 - 40.0;
+                    codec->encode(0, physicalValue, after);
+                    expect(codec->decode(0, after) == physicalValue, what + ": " + std::to_string(physicalValue) +
+                        " decodes to " + std::to_string(codec->decode(0, after)));
+                    checked++;
+                }
+            }
+        }
+    }
+
+    expect(checked > 500, "only " + std::to_string(checked) + " layouts fit the payload");
+
+    // Scheduled DBC messages carry their signals at the value nearest to 0: raw 40 for a
+    // temperature with an offset of -40, the multiplexed signal the multiplexer selects only
+    NetworkDefinition network;
+    network.nodes = { "ECU" };
+    MessageDefinition message;
+    message.id = 0x123;
+    message.dataLength = 2;
+    message.transmitter = 0;
+    message.cycleTime = 10;
+    message.signalDefinitions.push_back(signal(SignalDefinition::ByteOrder::Intel, 1, 7, false));
+    message.signalDefinitions.back().offset = -40.0;
+    message.signalDefinitions.back().minimum = -40.0;
+    message.signalDefinitions.back().maximum = 87.0;
+    message.signalDefinitions.push_back(signal(SignalDefinition::ByteOrder::Intel, 0, 1, false));
+    message.signalDefinitions.back().multiplexer = true;
+    message.signalDefinitions.push_back(signal(SignalDefinition::ByteOrder::Motorola, 12, 5, false));
+    message.signalDefinitions.back().multiplexValue = 0;
+    message.signalDefinitions.back().minimum = 3.0;
+    message.signalDefinitions.back().maximum = 20.0;
+    message.signalDefinitions.push_back(signal(SignalDefinition::ByteOrder::Motorola, 12, 5, false));
+    message.signalDefinitions.back().multiplexValue = 1;
+    message.signalDefinitions.back().minimum = 31.0;
+    message.signalDefinitions.back().maximum = 31.0;
+    network.messages.push_back(message);
+
+    PeriodicScheduler scheduler;
+    expect(scheduleNetwork(scheduler, network) == 1, "the message was not scheduled");
+    if (scheduler.getStreamCount() == 1) {
+        std::vector<uint8_t> data = scheduler.getMessage(0).data;
+        bool expected = data == std::vector<uint8_t>({ 0x50, 0x03 });
+        data.resize(SignalCodec::PAYLOAD_SIZE);
+        expect(expected, "scheduled payload " + hex(data.data()) + " instead of 5003");
+    }
+}
+
+// A faulty sender's CRC has to fail at every healthy receiver, also for the payloads whose
+// valid CRC is 0, the value a simulated error used to send
+static void corruptedCrcNeverValid()
+{
+    static const std::string POLYNOMIAL = "1100000000000010";     // the generator of Node
+    ErrorCheck errorCheck;
+    std::mt19937 random(3);
+
+    int validZero = 0;
+    for (int i = 0; i < 200000; ++i) {
+        std::vector<uint8_t> data(random() % 9);
+        for (uint8_t& byte : data) {
+            byte = static_cast<uint8_t>(random());
+        }
+        Message message(static_cast<uint16_t>(random() & 0x7FF), data, 1);
+
+        uint16_t valid = errorCheck.calculateCRC(message, POLYNOMIAL, false);
+        uint16_t corrupted = errorCheck.calculateCRC(message, POLYNOMIAL, true);
+        validZero += valid == 0 ? 1 : 0;
+        if (corrupted == valid) {
+            expect(false, "identifier " + std::to_string(message.getId()) + " with a corrupted CRC passes as valid");
+            return;
+        }
+        expect(corrupted == errorCheck.calculateCRC(message, POLYNOMIAL, true), "two faulty nodes disagree on a CRC");
+    }
+
+    expect(validZero > 0, "no payload with a valid CRC of 0 was tried");
+}
+
+// Scenario files may list their nodes in any order, but the engines index nodes by id, so
+// the ids have to run from 1 to N
+static void scenarioNodeIdsRunFrom1()
+{
+    try {
+        parseScenario(R"({ "version": 1, "nodes": [ { "id": 1 }, { "id": 2 }, { "id": 20 } ] })");
+        expect(false, "node ids 1, 2 and 20 were accepted");
+    }
+    catch (const std::invalid_argument& error) {
+        expect(std::string(error.what()).find("node 3 is missing") != std::string::npos,
+            std::string("sparse ids rejected with: ") + error.what());
+    }
+
+    ScenarioDefinition scenario = parseScenario(
+        R"({ "version": 1, "nodes": [ { "id": 2, "messagesPerMinute": { "1": 5 } }, { "id": 1, "error": true } ] })");
+    expect(scenario.nodes.size() == 2 && scenario.nodes[0].nodeId == 1 && scenario.nodes[1].nodeId == 2,
+        "nodes listed as 2, 1 are not put in id order");
+    if (scenario.nodes.size() == 2) {
+        expect(scenario.nodes[0].error && !scenario.nodes[1].error, "the error flag moved to another node");
+        expect(scenario.nodes[1].messageAndFreq == std::map<int, int>{ { 1, 5 } }, "the targets moved to another node");
+    }
+}
+
+struct Check {
+    const char* name;
+    void (*run)();
+};
+
+static const Check CHECKS[] = {
+    { "checkpoint-restores-run", checkpointRestoresRun },
+    { "corrupted-crc-never-valid", corruptedCrcNeverValid },
+    { "dbc-sample-imports", dbcSampleImports },
+    { "error-confinement-states", errorConfinementStates },
+    { "frame-filter-expressions", frameFilterExpressions },
+    { "histogram-percentiles-and-merge", histogramPercentilesAndMerge },
+    { "lanes-match-scalar-engine", lanesMatchScalarEngine },
+    { "log-index-line-offsets", logIndexLineOffsets },
+    { "response-time-of-single-release", responseTimeOfSingleRelease },
+    { "response-time-past-deadline-unbounded", responseTimePastDeadlineUnbounded },
+    { "run-trace-query-results", runTraceQueryResults },
+    { "scenario-node-ids-run-from-1", scenarioNodeIdsRunFrom1 },
+    { "signals-round-trip", signalsRoundTrip },
+    { "timer-wheel-matches-sorted-reference", timerWheelMatchesSortedReference },
+    { "trace-lines-parse", traceLinesParse },
+    { "whatif-matches-fresh-run", whatIfMatchesFreshRun },
+    { "workload-deterministic-per-seed", workloadDeterministicPerSeed },
+};
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> selected(argv + 1, argv + argc);
+    int failed = 0;
+    int run = 0;
+
+    for (const Check& check : CHECKS) {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), check.name) == selected.end()) {
+            continue;
+        }
+
+        int before = failures;
+        try {
+            check.run();
+        }
+        catch (const std::exception& e) {
+            expect(false, std::string("threw: ") + e.what());
+        }
+
+        run++;
+        failed += failures != before ? 1 : 0;
+        std::cout << (failures != before ? "FAIL " : "ok   ") << check.name << "\n";
+    }
+
+    if (run == 0) {
+        std::cerr << "No such check\n";
+        return 2;
+    }
+
+    std::cout << run - failed << " of " << run << " checks passed\n";
+    return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,714 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BinaryLogReader.h"
+#include "BinaryLogWriter.h"
+#include "BitLevelBus.h"
+#include "BitSlicedBus.h"
+#include "DbcImporter.h"
+#include "LogRecord.h"
+#include "RunTrace.h"
+#include "RunTraceQuery.h"
+#include "ScenarioFile.h"
+#include "SimulationStatistics.h"
+#include "TraceReader.h"
+#include "TraceReplayer.h"
+#include "WhatIfSimulator.h"
+#include "WorkloadGenerator.h"
+
+// Command line companion of the simulator for working with its output offline.
+//
+//   CANTools render <log>... [-o <file>]    binary logs as the text log would have been
+//   CANTools stats <log>...                 records and sizes of binary logs
+//   CANTools index <log>... -o <trace>      run trace of binary or text logs for queries
+//   CANTools query <trace|log>... [<column><op><value>]... [<action>]
+//   CANTools whatif <scenario>...           runs scenario files, each resuming from the one before
+//   CANTools sweep <scenario> [runs] [fault probability] [-o <file>]
+//                                           runs of a scenario with random faulty nodes, 64 at a time
+//   CANTools replay <trace> [-c <channel>] [-n <dbc>]
+//                                           candump or ASC trace through the bit-level bus
+//   CANTools stress [load] [milliseconds] [seed] [faulty share]
+//                                           generated workload through the bit-level bus
+//
+// A directory stands for all the binary logs in it, oldest first. Query columns are
+// session, round, type, node, id, other, tec and rec, compared with = != < <= > >=.
+// Types are won, lost, received, crc-error, retransmit, counters and disabled, -1 is no
+// identifier. The action is count, first, last, list [N] (the default, 100 rows),
+// group <column> or stats <column>. For example, the rounds where 0x104 lost to 0x006:
+//
+//   CANTools query run.cantrace type=lost id=0x104 other=0x006 group round
+//
+// A replay sends every frame from the node the DBC names as its transmitter. Without one, a
+// single node sends them all and a second one acknowledges. Traces recorded on more than one
+// channel need the channel to replay: the ASC channel number, or for candump the interface
+// numbered from 0 in the order they first appear. A stress run replays a generated workload
+// of 16 nodes the same way, by default half the bus for a second, faulty nodes with one bit
+// in 10000 sent or sampled wrong.
+
+static void printUsage()
+{
+    std::cerr << "Usage:\n"
+        << "  CANTools render <log>... [-o <file>]\n"
+        << "  CANTools stats <log>...\n"
+        << "  CANTools index <log>... -o <trace>\n"
+        << "  CANTools query <trace|log>... [<column><op><value>]... [count | first | last | list [N] | group <column> | stats <column>]\n"
+        << "  CANTools whatif <scenario>...\n"
+        << "  CANTools sweep <scenario> [runs] [fault probability] [-o <file>]\n"
+        << "  CANTools replay <trace> [-c <channel>] [-n <dbc>]\n"
+        << "  CANTools stress [load] [milliseconds] [seed] [faulty share]\n";
+}
+
+static std::vector<std::string> expandLogs(const std::vector<std::string>& arguments)
+{
+    std::vector<std::string> logs;
+
+    for (const auto& argument : arguments) {
+        if (!std::filesystem::is_directory(argument)) {
+            logs.push_back(argument);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (const auto& entry : std::filesystem::directory_iterator(argument)) {
+            if (entry.is_regular_file() && entry.path().extension() == BinaryLogWriter::EXTENSION) {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        logs.insert(logs.end(), found.begin(), found.end());
+    }
+    return logs;
+}
+
+static void warnIfTruncated(const BinaryLogReader& reader, const std::string& path)
+{
+    if (reader.isTruncated()) {
+        std::cerr << path << ": last block is incomplete and was skipped\n";
+    }
+}
+
+static bool isBinaryLog(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(BinaryLogWriter::MAGIC)] = {};
+    file.read(magic, sizeof(magic));
+    return std::memcmp(magic, BinaryLogWriter::MAGIC, sizeof(magic)) == 0;
+}
+
+// Records of binary logs as written and of text logs as parsed back from their lines
+static void readRecords(const std::vector<std::string>& logs, const std::function<void(const LogRecord&)>& handle)
+{
+    LogRecord record;
+
+    for (const auto& path : logs) {
+        if (isBinaryLog(path)) {
+            BinaryLogReader reader(path);
+            while (reader.next(record)) {
+                handle(record);
+            }
+            warnIfTruncated(reader, path);
+            continue;
+        }
+
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::invalid_argument("Cannot open file: " + path);
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            handle(LogRecord::parse(line));
+        }
+    }
+}
+
+static void buildTrace(const std::vector<std::string>& logs, RunTrace& trace)
+{
+    readRecords(logs, [&trace](const LogRecord& record) { trace.add(record); });
+    trace.finish();
+}
+
+static int render(const std::vector<std::string>& logs, std::ostream& out)
+{
+    std::string text;
+    LogRecord record;
+
+    for (const auto& path : logs) {
+        BinaryLogReader reader(path);
+        while (reader.next(record)) {
+            text += record.render();
+            text += '\n';
+            if (text.size() >= 1024 * 1024) {
+                out << text;
+                text.clear();
+            }
+        }
+        warnIfTruncated(reader, path);
+    }
+
+    out << text;
+    out.flush();
+    return out ? 0 : 1;
+}
+
+static int stats(const std::vector<std::string>& logs)
+{
+    uint64_t totalRecords = 0;
+    uint64_t totalText = 0;
+    uint64_t totalSize = 0;
+    LogRecord record;
+
+    for (const auto& path : logs) {
+        BinaryLogReader reader(path);
+        uint64_t records = 0;
+        uint64_t text = 0;
+        while (reader.next(record)) {
+            ++records;
+            text += record.render().size() + 1;
+        }
+        warnIfTruncated(reader, path);
+
+        uint64_t size = std::filesystem::file_size(path);
+        std::cout << path << ": " << records << " records in " << reader.getBlockCount() << " blocks, "
+            << size << " bytes, " << text << " bytes as text\n";
+
+        totalRecords += records;
+        totalText += text;
+        totalSize += size;
+    }
+
+    if (logs.size() > 1) {
+        std::cout << "total: " << totalRecords << " records, " << totalSize << " bytes, " << totalText << " bytes as text\n";
+    }
+    if (totalSize > 0) {
+        char ratio[32];
+        std::snprintf(ratio, sizeof(ratio), "%.1f", static_cast<double>(totalText) / totalSize);
+        std::cout << "text is " << ratio << " times the binary size\n";
+    }
+    return 0;
+}
+
+static int indexLogs(const std::vector<std::string>& logs, const std::string& outputPath)
+{
+    if (outputPath.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    RunTrace trace;
+    buildTrace(logs, trace);
+    trace.save(outputPath);
+    std::cout << trace.getRowCount() << " events in " << trace.getSessionCount() << " sessions written to " << outputPath << "\n";
+    return 0;
+}
+
+static bool parseValue(RunTraceQuery::Column column, const std::string& text, int64_t& value)
+{
+    if (column == RunTraceQuery::Column::Type) {
+        for (int type = 0; type < RunTrace::EVENT_TYPES; ++type) {
+            if (text == RunTrace::typeName(static_cast<RunTrace::EventType>(type))) {
+                value = type;
+                return true;
+            }
+        }
+    }
+
+    try {
+        size_t used = 0;
+        bool hex = text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+        value = hex ? std::stoll(text.substr(2), &used, 16) : std::stoll(text, &used, 10);
+        return used == (hex ? text.size() - 2 : text.size());
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+// "column<op>value", false when it is not a condition
+static bool parseCondition(const std::string& text, RunTraceQuery& query)
+{
+    size_t split = text.find_first_of("!<>=");
+    if (split == std::string::npos || split == 0) {
+        return false;
+    }
+
+    static const std::pair<const char*, RunTraceQuery::Comparison> OPERATORS[] = {
+        { "!=", RunTraceQuery::Comparison::NotEqual }, { "<=", RunTraceQuery::Comparison::LessEqual },
+        { ">=", RunTraceQuery::Comparison::GreaterEqual }, { "=", RunTraceQuery::Comparison::Equal },
+        { "<", RunTraceQuery::Comparison::Less }, { ">", RunTraceQuery::Comparison::Greater },
+    };
+
+    RunTraceQuery::Column column;
+    if (!RunTraceQuery::parseColumn(text.substr(0, split), column)) {
+        throw std::invalid_argument("Unknown column in: " + text);
+    }
+
+    for (const auto& op : OPERATORS) {
+        size_t length = std::strlen(op.first);
+        if (text.compare(split, length, op.first) == 0) {
+            int64_t value = 0;
+            if (!parseValue(column, text.substr(split + length), value)) {
+                throw std::invalid_argument("Invalid value in: " + text);
+            }
+            query.where(column, op.second, value);
+            return true;
+        }
+    }
+    throw std::invalid_argument("Invalid comparison in: " + text);
+}
+
+static std::string formatValue(RunTraceQuery::Column column, int64_t value)
+{
+    char text[32];
+
+    switch (column) {
+    case RunTraceQuery::Column::Type:
+        return RunTrace::typeName(static_cast<RunTrace::EventType>(value));
+    case RunTraceQuery::Column::Id:
+    case RunTraceQuery::Column::Other:
+        if (value < 0) {
+            return "-";
+        }
+        std::snprintf(text, sizeof(text), "0x%03llX", static_cast<unsigned long long>(value));
+        return text;
+    default:
+        return std::to_string(value);
+    }
+}
+
+static void printRow(const RunTraceQuery& query, uint64_t row)
+{
+    static const RunTraceQuery::Column COLUMNS[] = {
+        RunTraceQuery::Column::Session, RunTraceQuery::Column::Round, RunTraceQuery::Column::Type, RunTraceQuery::Column::Node,
+        RunTraceQuery::Column::Id, RunTraceQuery::Column::Other,
+    };
+
+    std::string values[6];
+    for (int i = 0; i < 6; ++i) {
+        values[i] = formatValue(COLUMNS[i], query.value(row, COLUMNS[i]));
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%7s %9s  %-10s %4s  %5s  %5s", values[0].c_str(), values[1].c_str(), values[2].c_str(),
+        values[3].c_str(), values[4].c_str(), values[5].c_str());
+    std::cout << line;
+
+    // Error counters only mean something on the rows that carry them
+    RunTrace::EventType type = static_cast<RunTrace::EventType>(query.value(row, RunTraceQuery::Column::Type));
+    if (type == RunTrace::EventType::Counters || type == RunTrace::EventType::Disabled) {
+        std::cout << "  TEC " << query.value(row, RunTraceQuery::Column::Tec) << "  REC " << query.value(row, RunTraceQuery::Column::Rec);
+    }
+    std::cout << "\n";
+}
+
+static int runQuery(const std::vector<std::string>& arguments)
+{
+    std::vector<std::string> inputs;
+    size_t i = 0;
+    for (; i < arguments.size() && arguments[i].find_first_of("!<>=") == std::string::npos; ++i) {
+        bool action = arguments[i] == "count" || arguments[i] == "first" || arguments[i] == "last" || arguments[i] == "list" ||
+            arguments[i] == "group" || arguments[i] == "stats";
+        if (action && !inputs.empty()) {
+            break;
+        }
+        inputs.push_back(arguments[i]);
+    }
+
+    std::vector<std::string> logs = expandLogs(inputs);
+    if (logs.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    RunTrace trace;
+    if (logs.size() == 1 && std::filesystem::path(logs[0]).extension() == RunTrace::EXTENSION) {
+        trace.load(logs[0]);
+    }
+    else {
+        buildTrace(logs, trace);
+    }
+
+    RunTraceQuery query(trace);
+    for (; i < arguments.size() && parseCondition(arguments[i], query); ++i) {
+    }
+
+    std::string action = i < arguments.size() ? arguments[i++] : "list";
+    RunTraceQuery::Column column = RunTraceQuery::Column::Round;
+    if ((action == "group" || action == "stats") && (i >= arguments.size() || !RunTraceQuery::parseColumn(arguments[i++], column))) {
+        throw std::invalid_argument(action + " needs a column");
+    }
+    size_t limit = 100;
+    if (action == "list" && i < arguments.size()) {
+        limit = std::stoul(arguments[i++]);
+    }
+    if (i < arguments.size()) {
+        throw std::invalid_argument("Unexpected argument: " + arguments[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (action == "count") {
+        std::cout << query.count() << "\n";
+    }
+    else if (action == "first" || action == "last" || action == "list") {
+        std::vector<uint64_t> rows;
+        if (action == "list") {
+            rows = query.rows(limit);
+        }
+        else {
+            uint64_t row = action == "first" ? query.first() : query.last();
+            if (row != RunTrace::NONE) {
+                rows.push_back(row);
+            }
+        }
+
+        std::cout << "session     round  type       node     id  other\n";
+        for (uint64_t row : rows) {
+            printRow(query, row);
+        }
+    }
+    else if (action == "group") {
+        for (const auto& group : query.groupBy(column)) {
+            std::cout << formatValue(column, group.first) << "\t" << group.second << "\n";
+        }
+    }
+    else if (action == "stats") {
+        RunTraceQuery::Aggregate aggregate = query.aggregate(column);
+        std::cout << "count " << aggregate.count;
+        if (aggregate.count > 0) {
+            std::cout << "  min " << aggregate.min << "  max " << aggregate.max << "  mean "
+                << static_cast<double>(aggregate.sum) / aggregate.count;
+        }
+        std::cout << "\n";
+    }
+    else {
+        throw std::invalid_argument("Unknown action: " + action);
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << trace.getRowCount() << " events, query took " << elapsed.count() << " ms\n";
+    return 0;
+}
+
+static void printStatistics(const SimulationStatistics& statistics)
+{
+    std::cout << "  " << statistics.rounds << " rounds, " << statistics.framesDelivered << " delivered, "
+        << statistics.failedTransmissions << " failed, " << statistics.droppedFrames << " dropped\n";
+
+    for (size_t i = 0; i < statistics.TEC.size(); ++i) {
+        std::cout << "  node " << i + 1 << "  TEC " << statistics.TEC[i] << "  REC " << statistics.REC[i]
+            << (statistics.nodeActive[i] ? "" : "  disabled") << "\n";
+    }
+}
+
+// A base scenario followed by its variants: each variant only simulates the rounds after
+// the last checkpoint it shares with the scenario before it
+static int whatIf(const std::vector<std::string>& paths)
+{
+    if (paths.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    WhatIfSimulator simulator;
+    for (const auto& path : paths) {
+        ScenarioDefinition scenario = loadScenarioFile(QString::fromStdString(path));
+
+        auto start = std::chrono::steady_clock::now();
+        WhatIfSimulator::Result result = simulator.run(scenario);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << path << ": resumed at round " << result.resumedRound << ", simulated " << result.simulatedRounds
+            << " rounds in " << elapsed.count() << " ms\n";
+        printStatistics(result.statistics);
+    }
+    return 0;
+}
+
+// Every run gets its own seed, which decides the nodes that are faulty besides the ones the
+// scenario marks. The CSV has one row per run, the summary the share of runs each node
+// ended up disabled in.
+static int sweep(const std::vector<std::string>& arguments, const std::string& outputPath)
+{
+    if (arguments.empty() || arguments.size() > 3) {
+        printUsage();
+        return 2;
+    }
+
+    ScenarioDefinition scenario = loadScenarioFile(QString::fromStdString(arguments[0]));
+    int runs = arguments.size() > 1 ? std::stoi(arguments[1]) : BitSlicedBus::LANES;
+    BitSlicedBus::Options options;
+    options.maxRound = scenario.rounds;
+    options.errorProbability = arguments.size() > 2 ? std::stod(arguments[2]) : 0.0;
+
+    if (runs < 1) {
+        throw std::invalid_argument("Runs must be at least 1");
+    }
+    if (options.errorProbability < 0.0 || options.errorProbability > 1.0) {
+        throw std::invalid_argument("Fault probability must be between 0 and 1");
+    }
+
+    std::vector<uint64_t> seeds(runs);
+    for (int i = 0; i < runs; ++i) {
+        seeds[i] = i + 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SimulationStatistics> results = BitSlicedBus(scenario, options).run(seeds);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!outputPath.empty()) {
+        std::ofstream output(outputPath);
+        if (!output.is_open()) {
+            std::cerr << "Cannot open file: " << outputPath << "\n";
+            return 1;
+        }
+
+        output << "seed,rounds,delivered,failed,dropped";
+        for (size_t i = 0; i < results.front().TEC.size(); ++i) {
+            output << ",tec" << i + 1 << ",rec" << i + 1 << ",active" << i + 1 << ",error" << i + 1;
+        }
+        output << "\n";
+
+        for (const SimulationStatistics& result : results) {
+            output << result.seed << "," << result.rounds << "," << result.framesDelivered << "," << result.failedTransmissions
+                << "," << result.droppedFrames;
+            for (size_t i = 0; i < result.TEC.size(); ++i) {
+                output << "," << result.TEC[i] << "," << result.REC[i] << "," << result.nodeActive[i] << "," << result.nodeError[i];
+            }
+            output << "\n";
+        }
+    }
+
+    double delivered = 0;
+    double failed = 0;
+    double dropped = 0;
+    std::vector<int> disabled(results.front().nodeActive.size(), 0);
+    for (const SimulationStatistics& result : results) {
+        delivered += result.framesDelivered;
+        failed += result.failedTransmissions;
+        dropped += result.droppedFrames;
+        for (size_t i = 0; i < disabled.size(); ++i) {
+            disabled[i] += result.nodeActive[i] ? 0 : 1;
+        }
+    }
+
+    std::cout << runs << " runs in " << elapsed.count() << " ms, per run " << delivered / runs << " delivered, "
+        << failed / runs << " failed, " << dropped / runs << " dropped\n";
+    for (size_t i = 0; i < disabled.size(); ++i) {
+        std::cout << "  node " << i + 1 << " disabled in " << 100.0 * disabled[i] / runs << "% of runs\n";
+    }
+    return 0;
+}
+
+static void printBusStatistics(const BitLevelBus& bus, const std::vector<std::string>& names, uint32_t bitRate)
+{
+    static const char* STATES[] = { "error active", "error passive", "bus off" };
+    const BitLevelBus::BusStatistics& busStatistics = bus.getBusStatistics();
+
+    std::cout << "  " << busStatistics.bitTimes * 1000.0 / bitRate << " ms on the bus, load "
+        << (busStatistics.bitTimes > 0 ? static_cast<double>(busStatistics.frameBits) / busStatistics.bitTimes : 0.0) << "\n";
+
+    for (int node = 0; node < bus.getNodeCount(); ++node) {
+        const BitLevelBus::NodeStatistics& statistics = bus.getStatistics(node);
+        const ErrorConfinement& confinement = bus.getConfinement(node);
+        std::cout << "  " << names[node] << "  sent " << statistics.framesTransmitted << "  received " << statistics.framesReceived
+            << "  retransmitted " << statistics.retransmissions << "  TEC " << confinement.getTEC() << "  REC "
+            << confinement.getREC() << "  " << STATES[static_cast<int>(confinement.getState())] << "\n";
+    }
+}
+
+static int replay(const std::vector<std::string>& arguments)
+{
+    std::string tracePath;
+    std::string dbcPath;
+    int channel = -1;
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (arguments[i] == "-c" && i + 1 < arguments.size()) {
+            channel = std::stoi(arguments[++i]);
+            if (channel < 0) {
+                throw std::invalid_argument("Channel must not be negative");
+            }
+        }
+        else if (arguments[i] == "-n" && i + 1 < arguments.size()) {
+            dbcPath = arguments[++i];
+        }
+        else if (tracePath.empty()) {
+            tracePath = arguments[i];
+        }
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (tracePath.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    NetworkDefinition network;
+    if (!dbcPath.empty()) {
+        network = DbcImporter::load(dbcPath);
+    }
+    if (network.nodes.empty()) {
+        network.nodes = { "sender", "receiver" };
+    }
+
+    const uint32_t bitRate = ScenarioDefinition().bitRate;
+    TraceReader reader(tracePath);
+    BitLevelBus bus(static_cast<int>(network.nodes.size()));
+    TraceReplayer replayer(reader, bus, bitRate);
+    replayer.assignNodes(network);
+    if (channel >= 0) {
+        replayer.setChannel(channel);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    replayer.run(bitRate);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    const TraceReplayer::Statistics& statistics = replayer.getStatistics();
+    std::cout << tracePath << ": " << statistics.framesReplayed << " frames replayed in " << elapsed.count() << " ms, "
+        << statistics.framesSkipped << " extended or remote skipped, " << statistics.otherChannelFrames
+        << " on other channels, " << statistics.lateFrames << " out of order\n";
+    if (reader.getStatistics().malformedLines > 0) {
+        std::cerr << reader.getStatistics().malformedLines << " malformed lines skipped\n";
+    }
+    printBusStatistics(bus, network.nodes, bitRate);
+    return 0;
+}
+
+static int stress(const std::vector<std::string>& arguments)
+{
+    if (arguments.size() > 4) {
+        printUsage();
+        return 2;
+    }
+
+    WorkloadGenerator::Profile profile;
+    profile.busLoad = arguments.size() > 0 ? std::stod(arguments[0]) : profile.busLoad;
+    profile.duration = arguments.size() > 1 ? std::stod(arguments[1]) : profile.duration;
+    profile.seed = arguments.size() > 2 ? std::stoull(arguments[2]) : profile.seed;
+    profile.faultyNodes = arguments.size() > 3 ? std::stod(arguments[3]) : profile.faultyNodes;
+    profile.transmitBitErrorRate = 0.0001;
+    profile.receiveBitErrorRate = 0.0001;
+
+    WorkloadGenerator generator(profile);
+    const ScenarioDefinition& scenario = generator.getScenario();
+
+    BitLevelBus bus(profile.nodes, profile.seed);
+    std::vector<std::string> names;
+    for (const ScenarioNode& node : scenario.nodes) {
+        BitLevelBus::FaultProfile faults;
+        faults.transmitBitErrorRate = node.transmitBitErrorRate;
+        faults.receiveBitErrorRate = node.receiveBitErrorRate;
+        bus.setFaultProfile(node.nodeId - 1, faults);
+        names.push_back("node " + std::to_string(node.nodeId) + (node.transmitBitErrorRate > 0.0 ? " (faulty)" : ""));
+    }
+
+    TraceReplayer replayer(generator, bus, profile.bitRate);
+    replayer.assignNodes(scenario);
+
+    auto start = std::chrono::steady_clock::now();
+    replayer.run(profile.bitRate);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    const TraceReplayer::Statistics& statistics = replayer.getStatistics();
+    std::cout << "seed " << profile.seed << ": " << statistics.framesReplayed << " frames replayed in " << elapsed.count()
+        << " ms, " << statistics.framesReplayed / std::max(elapsed.count(), 1.0) << " per ms, expected load "
+        << generator.getExpectedLoad() << "\n";
+    printBusStatistics(bus, names, profile.bitRate);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // A stress run is the only command that needs no input
+    if (argc < 2 || (argc < 3 && std::strcmp(argv[1], "stress") != 0)) {
+        printUsage();
+        return 2;
+    }
+
+    std::string command = argv[1];
+    std::vector<std::string> arguments;
+    std::string outputPath;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "-o" && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            arguments.push_back(argument);
+        }
+    }
+
+    try {
+        if (command == "query") {
+            return runQuery(arguments);
+        }
+
+        if (command == "whatif") {
+            return whatIf(arguments);
+        }
+
+        if (command == "sweep") {
+            return sweep(arguments, outputPath);
+        }
+
+        if (command == "replay") {
+            return replay(arguments);
+        }
+
+        if (command == "stress") {
+            return stress(arguments);
+        }
+
+        std::vector<std::string> logs = expandLogs(arguments);
+        if (logs.empty()) {
+            std::cerr << "No binary logs found\n";
+            return 1;
+        }
+
+        if (command == "render") {
+            if (outputPath.empty()) {
+                return render(logs, std::cout);
+            }
+
+            std::ofstream output(outputPath);
+            if (!output.is_open()) {
+                std::cerr << "Cannot open file: " << outputPath << "\n";
+                return 1;
+            }
+            return render(logs, output);
+        }
+
+        if (command == "stats") {
+            return stats(logs);
+        }
+
+        if (command == "index") {
+            return indexLogs(logs, outputPath);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    printUsage();
+    return 2;
+}
\ No newline at end of file
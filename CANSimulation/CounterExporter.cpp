@@ -0,0 +1,175 @@
+#include "CounterExporter.h"
+
+#include <cstdio>
+#include <fstream>
+
+CounterExporter::CounterExporter(const BusCounters& counters, const std::string& path, Format format, std::chrono::milliseconds interval)
+    : counters(counters), path(path), format(format), interval(interval), running(false), headerWritten(false)
+{
+    startTime = std::chrono::steady_clock::now();
+    previousTime = startTime;
+    previous = counters.snapshot();
+}
+
+CounterExporter::~CounterExporter()
+{
+    stop();
+}
+
+void CounterExporter::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+
+    running = true;
+    startTime = std::chrono::steady_clock::now();
+    previousTime = startTime;
+    previous = counters.snapshot();
+    worker = std::thread(&CounterExporter::exportLoop, this);
+}
+
+void CounterExporter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+
+    wakeUp.notify_all();
+    worker.join();
+
+    // Leave the final totals behind for whoever reads the file after the run
+    exportNow();
+}
+
+void CounterExporter::exportLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (running) {
+        wakeUp.wait_for(lock, interval, [this]() { return !running; });
+        if (!running) {
+            break;
+        }
+
+        lock.unlock();
+        exportNow();
+        lock.lock();
+    }
+}
+
+bool CounterExporter::exportNow()
+{
+    BusCounters::Snapshot snapshot = counters.snapshot();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(now - previousTime).count();
+    double framesPerWallSecond = seconds > 0.0 ? (snapshot.frames - previous.frames) / seconds : 0.0;
+    double bitsPerWallSecond = seconds > 0.0 ? (snapshot.bits - previous.bits) / seconds : 0.0;
+    double elapsed = std::chrono::duration<double>(now - startTime).count();
+
+    previous = snapshot;
+    previousTime = now;
+
+    if (format == Format::Prometheus) {
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            writePrometheus(file, snapshot, framesPerWallSecond, bitsPerWallSecond);
+        }
+
+        std::remove(path.c_str());
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+
+    std::ofstream file(path, headerWritten ? std::ios::app : std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    if (!headerWritten) {
+        file << "elapsed_s,metric,node,value\n";
+        headerWritten = true;
+    }
+    writeCsvRow(file, snapshot, framesPerWallSecond, bitsPerWallSecond, elapsed);
+    return true;
+}
+
+static double stuffOverhead(const BusCounters::Snapshot& snapshot)
+{
+    uint64_t payloadBits = snapshot.bits - snapshot.stuffBits;
+    return payloadBits ? static_cast<double>(snapshot.stuffBits) / payloadBits : 0.0;
+}
+
+static double busLoad(const BusCounters::Snapshot& snapshot)
+{
+    return static_cast<double>(snapshot.bits) / snapshot.busTime;
+}
+
+void CounterExporter::writePrometheus(std::ostream& out, const BusCounters::Snapshot& snapshot, double framesPerWallSecond, double bitsPerWallSecond)
+{
+    out << "# TYPE can_frames_total counter\n";
+    out << "can_frames_total " << snapshot.frames << "\n";
+    out << "# TYPE can_bits_total counter\n";
+    out << "can_bits_total " << snapshot.bits << "\n";
+    out << "# TYPE can_stuff_bits_total counter\n";
+    out << "can_stuff_bits_total " << snapshot.stuffBits << "\n";
+    out << "# TYPE can_error_frames_total counter\n";
+    out << "can_error_frames_total " << snapshot.errorFrames << "\n";
+    // Engines that do not track bus time have no load to report
+    if (snapshot.busTime > 0) {
+        out << "# TYPE can_bus_time_bits_total counter\n";
+        out << "can_bus_time_bits_total " << snapshot.busTime << "\n";
+    }
+    out << "# HELP can_wallclock_frames_per_second Frames per second of wall-clock time since the last export\n";
+    out << "# TYPE can_wallclock_frames_per_second gauge\n";
+    out << "can_wallclock_frames_per_second " << framesPerWallSecond << "\n";
+    out << "# HELP can_wallclock_bits_per_second Bits per second of wall-clock time since the last export\n";
+    out << "# TYPE can_wallclock_bits_per_second gauge\n";
+    out << "can_wallclock_bits_per_second " << bitsPerWallSecond << "\n";
+    out << "# TYPE can_stuff_bit_overhead gauge\n";
+    out << "can_stuff_bit_overhead " << stuffOverhead(snapshot) << "\n";
+    if (snapshot.busTime > 0) {
+        out << "# TYPE can_bus_load gauge\n";
+        out << "can_bus_load " << busLoad(snapshot) << "\n";
+    }
+
+    out << "# TYPE can_node_tx_frames_total counter\n";
+    for (size_t i = 0; i < snapshot.txFrames.size(); ++i) {
+        out << "can_node_tx_frames_total{node=\"" << i + 1 << "\"} " << snapshot.txFrames[i] << "\n";
+    }
+    out << "# TYPE can_node_rx_frames_total counter\n";
+    for (size_t i = 0; i < snapshot.rxFrames.size(); ++i) {
+        out << "can_node_rx_frames_total{node=\"" << i + 1 << "\"} " << snapshot.rxFrames[i] << "\n";
+    }
+}
+
+void CounterExporter::writeCsvRow(std::ostream& out, const BusCounters::Snapshot& snapshot, double framesPerWallSecond, double bitsPerWallSecond, double elapsedSeconds)
+{
+    out << elapsedSeconds << ",frames,," << snapshot.frames << "\n";
+    out << elapsedSeconds << ",bits,," << snapshot.bits << "\n";
+    out << elapsedSeconds << ",stuff_bits,," << snapshot.stuffBits << "\n";
+    out << elapsedSeconds << ",error_frames,," << snapshot.errorFrames << "\n";
+    if (snapshot.busTime > 0) {
+        out << elapsedSeconds << ",bus_time_bits,," << snapshot.busTime << "\n";
+    }
+    out << elapsedSeconds << ",wallclock_frames_per_second,," << framesPerWallSecond << "\n";
+    out << elapsedSeconds << ",wallclock_bits_per_second,," << bitsPerWallSecond << "\n";
+    out << elapsedSeconds << ",stuff_bit_overhead,," << stuffOverhead(snapshot) << "\n";
+    if (snapshot.busTime > 0) {
+        out << elapsedSeconds << ",bus_load,," << busLoad(snapshot) << "\n";
+    }
+
+    for (size_t i = 0; i < snapshot.txFrames.size(); ++i) {
+        out << elapsedSeconds << ",tx_frames," << i + 1 << "," << snapshot.txFrames[i] << "\n";
+        out << elapsedSeconds << ",rx_frames," << i + 1 << "," << snapshot.rxFrames[i] << "\n";
+    }
+}
\ No newline at end of file
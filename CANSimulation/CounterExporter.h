@@ -0,0 +1,52 @@
+#ifndef COUNTER_EXPORTER_H
+#define COUNTER_EXPORTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "BusCounters.h"
+
+// Writes snapshots of a BusCounters to a local file at a fixed interval on its own thread.
+// Prometheus output replaces the file each time (textfile collector style), CSV appends a row.
+// The frame and bit rates are per second of wall-clock time between two exports, not of
+// simulated bus time; the bus load is the simulated one.
+class CounterExporter {
+public:
+    enum class Format { Prometheus, Csv };
+
+    CounterExporter(const BusCounters& counters, const std::string& path, Format format, std::chrono::milliseconds interval);
+    ~CounterExporter();
+
+    void start();
+    void stop();        // joins the exporter thread, then writes the final totals
+
+    static void writePrometheus(std::ostream& out, const BusCounters::Snapshot& snapshot, double framesPerWallSecond, double bitsPerWallSecond);
+    static void writeCsvRow(std::ostream& out, const BusCounters::Snapshot& snapshot, double framesPerWallSecond, double bitsPerWallSecond, double elapsedSeconds);
+
+private:
+    void exportLoop();
+
+    // Only called from the exporter thread, or by stop() once that thread has ended
+    bool exportNow();
+
+    const BusCounters& counters;
+    std::string path;
+    Format format;
+    std::chrono::milliseconds interval;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool running;
+
+    bool headerWritten;
+    BusCounters::Snapshot previous;
+    std::chrono::steady_clock::time_point previousTime;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif
\ No newline at end of file
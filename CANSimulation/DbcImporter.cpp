@@ -0,0 +1,423 @@
+#include "DbcImporter.h"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+static const size_t CHUNK_SIZE = 1 << 20;
+static const uint32_t EXTENDED_FLAG = 0x80000000u;
+static const char* const NO_TRANSMITTER = "Vector__XXX";
+static const char* const CYCLE_TIME_ATTRIBUTE = "GenMsgCycleTime";
+
+namespace {
+
+    // Forward-only view over one line; every read skips leading blanks first
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        void skipSpace()
+        {
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                ++p;
+            }
+        }
+
+        bool atEnd()
+        {
+            skipSpace();
+            return p >= end;
+        }
+
+        bool expect(char c)
+        {
+            skipSpace();
+            if (p < end && *p == c) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+
+        // Identifier, keyword or node name: stops at blanks and DBC punctuation
+        std::string_view word()
+        {
+            skipSpace();
+            const char* start = p;
+            while (p < end && !std::strchr(" \t:|@(),[];\"", *p)) {
+                ++p;
+            }
+            return std::string_view(start, p - start);
+        }
+
+        template <typename T>
+        bool integer(T& value)
+        {
+            skipSpace();
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) {
+                return false;
+            }
+            p = result.ptr;
+            return true;
+        }
+
+        bool number(double& value)
+        {
+            skipSpace();
+            if (p < end && *p == '+') {
+                ++p;
+            }
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) {
+                return false;
+            }
+            p = result.ptr;
+            return true;
+        }
+
+        bool quoted(std::string& value)
+        {
+            if (!expect('"')) {
+                return false;
+            }
+            const char* start = p;
+            while (p < end && *p != '"') {
+                p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+            }
+            if (p >= end) {
+                return false;
+            }
+            value.assign(start, p - start);
+            ++p;
+            return true;
+        }
+    };
+
+}
+
+DbcImporter::DbcImporter(NetworkDefinition& network)
+    : network(network), currentMessage(-1), defaultCycleTime(0), inString(false), lineNumber(0)
+{
+}
+
+NetworkDefinition DbcImporter::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::invalid_argument("Cannot open DBC file: " + path);
+    }
+    return parse(file);
+}
+
+NetworkDefinition DbcImporter::parse(std::istream& in)
+{
+    NetworkDefinition network;
+    DbcImporter importer(network);
+    importer.read(in);
+    importer.finish();
+    return network;
+}
+
+void DbcImporter::read(std::istream& in)
+{
+    std::vector<char> chunk(CHUNK_SIZE);
+    std::string partial;
+
+    while (in) {
+        in.read(chunk.data(), chunk.size());
+        size_t count = static_cast<size_t>(in.gcount());
+        if (count == 0) {
+            break;
+        }
+
+        const char* p = chunk.data();
+        const char* end = p + count;
+        while (p < end) {
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!newline) {
+                partial.append(p, end);
+                break;
+            }
+
+            if (partial.empty()) {
+                parseLine(p, newline);
+            }
+            else {
+                partial.append(p, newline);
+                parseLine(partial.data(), partial.data() + partial.size());
+                partial.clear();
+            }
+            p = newline + 1;
+        }
+    }
+
+    if (!partial.empty()) {
+        parseLine(partial.data(), partial.data() + partial.size());
+    }
+}
+
+void DbcImporter::parseLine(const char* begin, const char* end)
+{
+    ++lineNumber;
+    if (end > begin && end[-1] == '\r') {
+        --end;
+    }
+
+    // Continuation of a comment or value table string that spans lines
+    if (inString) {
+        skipStrings(begin, end);
+        return;
+    }
+
+    Cursor cursor{ begin, end };
+    std::string_view keyword = cursor.word();
+    // The NS_ section lists bare keywords, one per line
+    if (keyword.empty() || cursor.atEnd()) {
+        return;
+    }
+
+    if (keyword == "SG_") {
+        parseSignal(cursor.p, end);
+        return;
+    }
+
+    // Signals belong to the BO_ statement directly above them
+    currentMessage = -1;
+
+    if (keyword == "BO_") {
+        parseMessage(cursor.p, end);
+    }
+    else if (keyword == "BU_") {
+        parseNodes(cursor.p, end);
+    }
+    else if (keyword == "BA_") {
+        parseAttribute(cursor.p, end);
+    }
+    else if (keyword == "BA_DEF_DEF_") {
+        parseAttributeDefault(cursor.p, end);
+    }
+    else if (keyword == "SIG_VALTYPE_") {
+        parseValueType(cursor.p, end);
+    }
+    else {
+        skipStrings(cursor.p, end);
+    }
+}
+
+void DbcImporter::parseNodes(const char* begin, const char* end)
+{
+    Cursor cursor{ begin, end };
+    if (!cursor.expect(':')) {
+        fail("expected ':' after BU_");
+    }
+    while (!cursor.atEnd()) {
+        std::string_view name = cursor.word();
+        if (name.empty()) {
+            fail("unexpected character in node list");
+        }
+        nodeIndex(std::string(name));
+    }
+}
+
+void DbcImporter::parseMessage(const char* begin, const char* end)
+{
+    Cursor cursor{ begin, end };
+    uint32_t rawId = 0;
+    if (!cursor.integer(rawId)) {
+        fail("expected message identifier");
+    }
+
+    MessageDefinition message;
+    message.extended = (rawId & EXTENDED_FLAG) != 0;
+    message.id = rawId & ~EXTENDED_FLAG;
+    message.name = std::string(cursor.word());
+    message.cycleTime = -1;
+
+    if (message.name.empty() || !cursor.expect(':')) {
+        fail("expected message name followed by ':'");
+    }
+    if (!cursor.integer(message.dataLength) || message.dataLength < 0) {
+        fail("expected data length");
+    }
+
+    std::string_view transmitter = cursor.word();
+    if (!transmitter.empty() && transmitter != NO_TRANSMITTER) {
+        message.transmitter = nodeIndex(std::string(transmitter));
+    }
+
+    if (!network.messageIndex.emplace(rawId, network.messages.size()).second) {
+        fail("duplicate message identifier " + std::to_string(message.id));
+    }
+
+    currentMessage = static_cast<int>(network.messages.size());
+    network.messages.push_back(std::move(message));
+}
+
+void DbcImporter::parseSignal(const char* begin, const char* end)
+{
+    if (currentMessage < 0) {
+        fail("signal outside of a message");
+    }
+
+    Cursor cursor{ begin, end };
+    SignalDefinition signal;
+    signal.name = std::string(cursor.word());
+    if (signal.name.empty()) {
+        fail("expected signal name");
+    }
+
+    // Optional multiplex indicator: "M" for the multiplexer, "m<n>" for a multiplexed signal
+    std::string_view multiplex = cursor.word();
+    if (!multiplex.empty()) {
+        if (multiplex.back() == 'M') {
+            signal.multiplexer = true;
+            multiplex.remove_suffix(1);
+        }
+        if (!multiplex.empty()) {
+            if (multiplex.front() != 'm' ||
+                std::from_chars(multiplex.data() + 1, multiplex.data() + multiplex.size(), signal.multiplexValue).ec != std::errc()) {
+                fail("invalid multiplex indicator for signal " + signal.name);
+            }
+        }
+    }
+
+    if (!cursor.expect(':') ||
+        !cursor.integer(signal.startBit) || !cursor.expect('|') ||
+        !cursor.integer(signal.length) || !cursor.expect('@')) {
+        fail("invalid bit layout for signal " + signal.name);
+    }
+
+    if (cursor.p + 2 > end || (cursor.p[0] != '0' && cursor.p[0] != '1') || (cursor.p[1] != '+' && cursor.p[1] != '-')) {
+        fail("invalid byte order or sign for signal " + signal.name);
+    }
+    signal.byteOrder = cursor.p[0] == '1' ? SignalDefinition::ByteOrder::Intel : SignalDefinition::ByteOrder::Motorola;
+    signal.isSigned = cursor.p[1] == '-';
+    cursor.p += 2;
+
+    if (!cursor.expect('(') || !cursor.number(signal.factor) || !cursor.expect(',') ||
+        !cursor.number(signal.offset) || !cursor.expect(')')) {
+        fail("invalid factor and offset for signal " + signal.name);
+    }
+    if (!cursor.expect('[') || !cursor.number(signal.minimum) || !cursor.expect('|') ||
+        !cursor.number(signal.maximum) || !cursor.expect(']')) {
+        fail("invalid range for signal " + signal.name);
+    }
+    if (!cursor.quoted(signal.unit)) {
+        fail("invalid unit for signal " + signal.name);
+    }
+
+    if (signal.length <= 0 || signal.length > 64) {
+        fail("invalid length for signal " + signal.name);
+    }
+
+    // Receivers are not needed by the simulator
+    network.messages[currentMessage].signalDefinitions.push_back(std::move(signal));
+}
+
+void DbcImporter::parseAttribute(const char* begin, const char* end)
+{
+    Cursor cursor{ begin, end };
+    std::string name;
+    if (!cursor.quoted(name) || name != CYCLE_TIME_ATTRIBUTE || cursor.word() != "BO_") {
+        skipStrings(begin, end);
+        return;
+    }
+
+    uint32_t rawId = 0;
+    int cycleTime = 0;
+    if (!cursor.integer(rawId) || !cursor.integer(cycleTime)) {
+        fail("invalid GenMsgCycleTime value");
+    }
+
+    auto found = network.messageIndex.find(rawId);
+    if (found == network.messageIndex.end()) {
+        fail("GenMsgCycleTime for unknown message " + std::to_string(rawId & ~EXTENDED_FLAG));
+    }
+    network.messages[found->second].cycleTime = cycleTime;
+}
+
+void DbcImporter::parseAttributeDefault(const char* begin, const char* end)
+{
+    Cursor cursor{ begin, end };
+    std::string name;
+    if (!cursor.quoted(name) || name != CYCLE_TIME_ATTRIBUTE) {
+        skipStrings(begin, end);
+        return;
+    }
+
+    if (!cursor.integer(defaultCycleTime)) {
+        fail("invalid GenMsgCycleTime default");
+    }
+}
+
+void DbcImporter::parseValueType(const char* begin, const char* end)
+{
+    Cursor cursor{ begin, end };
+    uint32_t rawId = 0;
+    if (!cursor.integer(rawId)) {
+        fail("expected message identifier in SIG_VALTYPE_");
+    }
+    std::string_view name = cursor.word();
+    int type = 0;
+    if (name.empty() || !cursor.expect(':') || !cursor.integer(type)) {
+        fail("invalid SIG_VALTYPE_ statement");
+    }
+
+    auto found = network.messageIndex.find(rawId);
+    if (found == network.messageIndex.end()) {
+        fail("SIG_VALTYPE_ for unknown message " + std::to_string(rawId & ~EXTENDED_FLAG));
+    }
+
+    for (SignalDefinition& signal : network.messages[found->second].signalDefinitions) {
+        if (signal.name == name) {
+            signal.valueType = type == 1 ? SignalDefinition::ValueType::Float
+                : type == 2 ? SignalDefinition::ValueType::Double
+                : SignalDefinition::ValueType::Integer;
+            return;
+        }
+    }
+    fail("SIG_VALTYPE_ for unknown signal " + std::string(name));
+}
+
+void DbcImporter::skipStrings(const char* begin, const char* end)
+{
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == '\\' && inString) {
+            ++p;
+        }
+        else if (*p == '"') {
+            inString = !inString;
+        }
+    }
+}
+
+void DbcImporter::finish()
+{
+    if (inString) {
+        fail("unterminated string");
+    }
+
+    for (MessageDefinition& message : network.messages) {
+        if (message.cycleTime < 0) {
+            message.cycleTime = defaultCycleTime;
+        }
+    }
+}
+
+int DbcImporter::nodeIndex(const std::string& name)
+{
+    auto inserted = nodeIndices.emplace(name, static_cast<int>(network.nodes.size()));
+    if (inserted.second) {
+        network.nodes.push_back(name);
+    }
+    return inserted.first->second;
+}
+
+void DbcImporter::fail(const std::string& reason) const
+{
+    throw std::invalid_argument("DBC line " + std::to_string(lineNumber) + ": " + reason);
+}
\ No newline at end of file
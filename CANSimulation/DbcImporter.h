@@ -0,0 +1,44 @@
+#ifndef DBC_IMPORTER_H
+#define DBC_IMPORTER_H
+
+#include <istream>
+#include <string>
+#include <unordered_map>
+
+#include "Network.h"
+
+// Reads a DBC network description in one pass over fixed-size chunks and fills a
+// NetworkDefinition directly, statement by statement, without a syntax tree. Nodes (BU_),
+// messages (BO_), signals (SG_), float signal types (SIG_VALTYPE_) and the GenMsgCycleTime
+// attribute are imported, every other statement is skipped including multi-line strings.
+class DbcImporter {
+public:
+    static NetworkDefinition load(const std::string& path);
+    static NetworkDefinition parse(std::istream& in);
+
+private:
+    explicit DbcImporter(NetworkDefinition& network);
+
+    void read(std::istream& in);
+    void parseLine(const char* begin, const char* end);
+    void parseNodes(const char* begin, const char* end);
+    void parseMessage(const char* begin, const char* end);
+    void parseSignal(const char* begin, const char* end);
+    void parseAttribute(const char* begin, const char* end);
+    void parseAttributeDefault(const char* begin, const char* end);
+    void parseValueType(const char* begin, const char* end);
+    void skipStrings(const char* begin, const char* end);
+    void finish();
+
+    int nodeIndex(const std::string& name);
+    [[noreturn]] void fail(const std::string& reason) const;
+
+    NetworkDefinition& network;
+    std::unordered_map<std::string, int> nodeIndices;
+    int currentMessage;
+    int defaultCycleTime;
+    bool inString;
+    size_t lineNumber;
+};
+
+#endif
\ No newline at end of file
@@ -1,23 +1,27 @@
-#ifndef ERRORCHECK_H
-#define ERRORCHECK_H
-
-#include "Message.h"
-
-#include <string>
-
-class ErrorCheck {
-public:
-    uint16_t calculateCRC(Message& message, const std::string& generatorPolynomial, bool simulateError);
-
-    std::string applyBitStuffing(const Message& message, bool simulateError);
-
-    std::string applyBitStuffingToId(uint16_t messaegId);
-
-    Message* removeBitStuffing(const std::string& stuffedMessage, bool simulateError);
-
-    uint16_t extractStuffedId(const std::string& stuffedString);
-
-    uint16_t binaryStringToUint16(const std::string& binaryString);
-};
-
+#ifndef ERRORCHECK_H
+#define ERRORCHECK_H
+
+#include "Message.h"
+
+#include <string>
+#include <vector>
+
+class ErrorCheck {
+public:
+    uint16_t calculateCRC(Message& message, const std::string& generatorPolynomial, bool simulateError);
+
+    std::string applyBitStuffing(const Message& message, bool simulateError);
+
+    std::string applyBitStuffingToId(uint16_t messaegId);
+
+    Message* removeBitStuffing(const std::string& stuffedMessage, bool simulateError);
+
+    uint16_t extractStuffedId(const std::string& stuffedString);
+
+    uint16_t binaryStringToUint16(const std::string& binaryString);
+
+    // ISO 11898 CRC-15 over unstuffed frame bits (one bit per element, SOF through data field)
+    uint16_t calculateCRC15(const std::vector<uint8_t>& bits, size_t count);
+};
+
 #endif
\ No newline at end of file
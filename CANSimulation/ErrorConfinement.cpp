@@ -0,0 +1,72 @@
+#include "ErrorConfinement.h"
+
+void ErrorConfinement::transmitError()
+{
+    TEC += 8;
+    updateState();
+}
+
+void ErrorConfinement::receiveError()
+{
+    REC += 1;
+    updateState();
+}
+
+void ErrorConfinement::severeReceiveError()
+{
+    REC += 8;
+    updateState();
+}
+
+void ErrorConfinement::transmitSuccess()
+{
+    if (TEC > 0) TEC--;
+    updateState();
+}
+
+void ErrorConfinement::receiveSuccess()
+{
+    // An error-passive receiver drops back into the 119..127 range
+    if (REC > PASSIVE_THRESHOLD - 1) {
+        REC = PASSIVE_THRESHOLD - 9;
+    }
+    else if (REC > 0) {
+        REC--;
+    }
+    updateState();
+}
+
+bool ErrorConfinement::recessiveSequence()
+{
+    if (state != State::BusOff) {
+        return false;
+    }
+
+    if (++recoverySequences < RECOVERY_SEQUENCES) {
+        return false;
+    }
+
+    TEC = 0;
+    REC = 0;
+    recoverySequences = 0;
+    state = State::ErrorActive;
+    return true;
+}
+
+void ErrorConfinement::updateState()
+{
+    if (state == State::BusOff) {
+        return;
+    }
+
+    if (TEC >= BUS_OFF_THRESHOLD) {
+        state = State::BusOff;
+        recoverySequences = 0;
+    }
+    else if (TEC >= PASSIVE_THRESHOLD || REC >= PASSIVE_THRESHOLD) {
+        state = State::ErrorPassive;
+    }
+    else {
+        state = State::ErrorActive;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef ERROR_CONFINEMENT_H
+#define ERROR_CONFINEMENT_H
+
+// ISO 11898 fault confinement of a single node: error counters and the
+// error-active / error-passive / bus-off state they select
+class ErrorConfinement {
+public:
+    enum class State { ErrorActive, ErrorPassive, BusOff };
+
+    static const int PASSIVE_THRESHOLD = 128;
+    static const int BUS_OFF_THRESHOLD = 256;
+    static const int RECOVERY_SEQUENCES = 128;     // occurrences of 11 consecutive recessive bits
+
+    void transmitError();               // TEC + 8
+    void receiveError();                // REC + 1
+    void severeReceiveError();          // REC + 8
+    void transmitSuccess();
+    void receiveSuccess();
+
+    // Counts a sequence of 11 recessive bits while bus-off, returns true once the node has recovered
+    bool recessiveSequence();
+
+    State getState() const { return state; }
+    int getTEC() const { return TEC; }
+    int getREC() const { return REC; }
+
+private:
+    void updateState();
+
+    int TEC = 0;
+    int REC = 0;
+    int recoverySequences = 0;
+    State state = State::ErrorActive;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,752 @@
+#include "FrameFilter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+static const int NAMED_FIELDS = FrameFilter::Data0;
+static const char* const FIELD_NAMES[NAMED_FIELDS] = { "id", "sender", "dlc", "round", "delivered", "error", "crcErrors", "receivers" };
+static const int MAX_NESTING = 64;
+static const int SHIFT_BITS = 32;
+
+// Parses the expression into a tree, folds what is constant and turns it into tests or a program
+class FrameFilter::Compiler {
+public:
+    explicit Compiler(FrameFilter& filter)
+        : filter(filter), text(filter.expression), position(0), nesting(0), temporaries(0), maxTemporaries(0)
+    {
+    }
+
+    void compile();
+
+private:
+    enum class Token { End, Number, Name, Operator };
+
+    struct Node {
+        enum class Kind { Constant, Field, Unary, Binary, Range };
+
+        Node(Kind kind, Op op, int32_t value = 0, int32_t high = 0)
+            : kind(kind), op(op), value(value), high(high)
+        {
+        }
+
+        Node(Kind kind, Op op, std::unique_ptr<Node> left, std::unique_ptr<Node> right = nullptr)
+            : kind(kind), op(op), left(std::move(left)), right(std::move(right))
+        {
+        }
+
+        Kind kind;
+        Op op;
+        size_t column = 0;      // where the text of the node starts, for errors found after parsing
+        int32_t value = 0;
+        int32_t high = 0;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+    using NodePtr = std::unique_ptr<Node>;
+
+    [[noreturn]] void fail(const std::string& reason) const;
+    [[noreturn]] void tooLarge(const char* what, int limit, size_t column) const;
+    void next();
+    bool isOperator(const char* op) const { return token == Token::Operator && tokenText == op; }
+    bool isName(const char* name) const { return token == Token::Name && tokenText == name; }
+    void expect(const char* op);
+
+    NodePtr parseOr();
+    NodePtr parseAnd();
+    NodePtr parseComparison();
+    NodePtr parseBitOr();
+    NodePtr parseBitAnd();
+    NodePtr parseShift();
+    NodePtr parseUnary();
+    NodePtr parsePrimary();
+    int32_t parseConstant(const char* what);
+
+    static NodePtr constant(int32_t value, size_t column);
+    static NodePtr toBool(NodePtr node);
+    static NodePtr unary(Op op, NodePtr operand);
+    static NodePtr binary(Op op, NodePtr left, NodePtr right);
+    static NodePtr logical(Op op, NodePtr left, NodePtr right);
+    static bool isBoolean(const Node& node);
+
+    bool collectGroups(const Node& node);
+    bool collectTests(const Node& node);
+    static bool makeTest(const Node& node, Test& test);
+    static bool maskedField(const Node& node, Test& test);
+
+    void collectConstants(const Node& node);
+    Operand generate(const Node& node);
+    Operand allocate();
+    void release(Operand operand);
+
+    FrameFilter& filter;
+    const std::string& text;
+    size_t position;
+    Token token = Token::End;
+    std::string tokenText;
+    int64_t tokenNumber = 0;
+    size_t tokenColumn = 0;
+    int nesting;
+    int temporaries;
+    int maxTemporaries;
+};
+
+// Counts from frame fields can be anything; past the width every bit is shifted out, as if the
+// value were wider, instead of the count wrapping around
+static int32_t shiftLeft(int32_t value, int32_t count)
+{
+    uint32_t bits = static_cast<uint32_t>(count);
+    return bits < SHIFT_BITS ? static_cast<int32_t>(static_cast<uint32_t>(value) << bits) : 0;
+}
+
+static int32_t shiftRight(int32_t value, int32_t count)
+{
+    uint32_t bits = static_cast<uint32_t>(count);
+    return value >> (bits < SHIFT_BITS ? bits : SHIFT_BITS - 1);
+}
+
+static int32_t negate(int32_t value)
+{
+    return static_cast<int32_t>(0u - static_cast<uint32_t>(value));
+}
+
+static bool inRange(int32_t value, int32_t low, int32_t high)
+{
+    // One comparison, values below low wrap around past high
+    return static_cast<uint32_t>(value) - static_cast<uint32_t>(low) <= static_cast<uint32_t>(high) - static_cast<uint32_t>(low);
+}
+
+FrameFilter::FrameFilter(const std::string& expression)
+    : expression(expression), testsOnly(false), result{ Fields, 0 }
+{
+    Compiler(*this).compile();
+}
+
+bool FrameFilter::matches(const Frame& frame) const
+{
+    if (testsOnly) {
+        bool matched = false;
+        size_t i = 0;
+        for (uint32_t end : groupEnds) {
+            bool passed = true;
+            for (; i < end; ++i) {
+                const Test& test = tests[i];
+                passed &= inRange(frame.values[test.field] & test.mask, test.low, test.high) != test.negate;
+            }
+            matched |= passed;
+        }
+        return matched;
+    }
+
+    int32_t temporaries[MAX_TEMPORARIES];
+    const int32_t* banks[3] = { frame.values, constants.data(), temporaries };
+
+    for (const Instruction& instruction : program) {
+        int32_t left = banks[instruction.left.bank][instruction.left.index];
+        int32_t right = banks[instruction.right.bank][instruction.right.index];
+        int32_t& target = temporaries[instruction.target];
+
+        switch (instruction.op) {
+        case Op::Or: target = left | right; break;
+        case Op::Xor: target = left ^ right; break;
+        case Op::And: target = left & right; break;
+        case Op::ShiftLeft: target = shiftLeft(left, right); break;
+        case Op::ShiftRight: target = shiftRight(left, right); break;
+        case Op::Equal: target = left == right; break;
+        case Op::NotEqual: target = left != right; break;
+        case Op::Less: target = left < right; break;
+        case Op::LessEqual: target = left <= right; break;
+        case Op::Greater: target = left > right; break;
+        case Op::GreaterEqual: target = left >= right; break;
+        case Op::LogicalAnd: target = (left != 0) & (right != 0); break;
+        case Op::LogicalOr: target = (left != 0) | (right != 0); break;
+        case Op::Not: target = left == 0; break;
+        case Op::Complement: target = ~left; break;
+        case Op::Negate: target = negate(left); break;
+        case Op::InRange: target = inRange(left, instruction.low, instruction.high); break;
+        }
+    }
+    return banks[result.bank][result.index] != 0;
+}
+
+void FrameFilter::Compiler::compile()
+{
+    next();
+    if (token == Token::End) {
+        fail("the expression is empty");
+    }
+
+    NodePtr root = parseOr();
+    if (token != Token::End) {
+        fail("unexpected \"" + tokenText + "\"");
+    }
+
+    if (root->kind == Node::Kind::Constant) {
+        // An empty group always passes
+        filter.testsOnly = true;
+        if (root->value != 0) {
+            filter.groupEnds.push_back(0);
+        }
+        return;
+    }
+    if (collectGroups(*root)) {
+        filter.testsOnly = true;
+        return;
+    }
+    filter.tests.clear();
+    filter.groupEnds.clear();
+
+    collectConstants(*root);
+    filter.result = generate(*root);
+}
+
+void FrameFilter::Compiler::fail(const std::string& reason) const
+{
+    throw std::invalid_argument("Filter \"" + text + "\": " + reason + " at column " + std::to_string(tokenColumn));
+}
+
+void FrameFilter::Compiler::tooLarge(const char* what, int limit, size_t column) const
+{
+    // Without the expression, which is long when this happens
+    throw std::invalid_argument("Filter is too large: more than " + std::to_string(limit) + " " + what +
+        ", the limit, reached at column " + std::to_string(column));
+}
+
+void FrameFilter::Compiler::next()
+{
+    static const char* const OPERATORS[] = {
+        "||", "&&", "==", "!=", "<=", ">=", "<<", ">>", "..",
+        "<", ">", "|", "^", "&", "!", "~", "-", "(", ")", "[", "]"
+    };
+
+    while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+        ++position;
+    }
+    tokenColumn = position + 1;
+    tokenText.clear();
+
+    if (position == text.size()) {
+        token = Token::End;
+        return;
+    }
+
+    char c = text[position];
+    if (std::isdigit(static_cast<unsigned char>(c))) {
+        int base = 10;
+        if (c == '0' && position + 1 < text.size() && (text[position + 1] == 'x' || text[position + 1] == 'X')) {
+            base = 16;
+        }
+        else if (c == '0' && position + 1 < text.size() && (text[position + 1] == 'b' || text[position + 1] == 'B')) {
+            base = 2;
+        }
+        size_t start = position;
+        position += base == 10 ? 0 : 2;
+
+        tokenNumber = 0;
+        size_t digits = 0;
+        while (position < text.size() && std::isalnum(static_cast<unsigned char>(text[position]))) {
+            char digit = static_cast<char>(std::tolower(static_cast<unsigned char>(text[position])));
+            int digitValue = std::isdigit(static_cast<unsigned char>(digit)) ? digit - '0' : digit - 'a' + 10;
+            if (digitValue >= base) {
+                tokenText = text.substr(start, position + 1 - start);
+                fail("\"" + tokenText + "\" is not a number");
+            }
+            tokenNumber = tokenNumber * base + digitValue;
+            if (tokenNumber > INT32_MAX) {
+                fail("number out of range");
+            }
+            ++position;
+            ++digits;
+        }
+        tokenText = text.substr(start, position - start);
+        if (digits == 0 && base != 10) {
+            fail("\"" + tokenText + "\" is not a number");
+        }
+        token = Token::Number;
+        return;
+    }
+
+    if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+        size_t start = position;
+        while (position < text.size() && (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_')) {
+            ++position;
+        }
+        tokenText = text.substr(start, position - start);
+        token = Token::Name;
+        return;
+    }
+
+    for (const char* op : OPERATORS) {
+        size_t length = std::char_traits<char>::length(op);
+        if (text.compare(position, length, op) == 0) {
+            tokenText = op;
+            position += length;
+            token = Token::Operator;
+            return;
+        }
+    }
+
+    tokenText = std::string(1, c);
+    fail("unexpected \"" + tokenText + "\"");
+}
+
+void FrameFilter::Compiler::expect(const char* op)
+{
+    if (!isOperator(op)) {
+        fail(std::string("expected \"") + op + "\"" + (token == Token::End ? "" : " instead of \"" + tokenText + "\""));
+    }
+    next();
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseOr()
+{
+    NodePtr left = parseAnd();
+    while (isOperator("||")) {
+        next();
+        left = logical(Op::LogicalOr, std::move(left), parseAnd());
+    }
+    return left;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseAnd()
+{
+    NodePtr left = parseComparison();
+    while (isOperator("&&")) {
+        next();
+        left = logical(Op::LogicalAnd, std::move(left), parseComparison());
+    }
+    return left;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseComparison()
+{
+    static const std::pair<const char*, Op> COMPARISONS[] = {
+        { "==", Op::Equal }, { "!=", Op::NotEqual }, { "<", Op::Less },
+        { "<=", Op::LessEqual }, { ">", Op::Greater }, { ">=", Op::GreaterEqual }
+    };
+    auto comparison = [this]() {
+        for (const auto& entry : COMPARISONS) {
+            if (isOperator(entry.first)) {
+                return &entry;
+            }
+        }
+        return static_cast<const std::pair<const char*, Op>*>(nullptr);
+    };
+
+    NodePtr left = parseBitOr();
+
+    if (isName("in")) {
+        next();
+        int32_t low = parseConstant("range bounds");
+        expect("..");
+        int32_t high = parseConstant("range bounds");
+
+        if (left->kind == Node::Kind::Constant || low > high) {
+            left = constant(low <= high && inRange(left->value, low, high), left->column);
+        }
+        else {
+            NodePtr range(new Node(Node::Kind::Range, Op::InRange, low, high));
+            range->column = left->column;
+            range->left = std::move(left);
+            left = std::move(range);
+        }
+    }
+    else if (auto entry = comparison()) {
+        next();
+        left = binary(entry->second, std::move(left), parseBitOr());
+    }
+    else {
+        return left;
+    }
+
+    if (comparison() || isName("in")) {
+        fail("comparisons cannot be chained, join them with &&");
+    }
+    return left;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseBitOr()
+{
+    NodePtr left = parseBitAnd();
+    while (isOperator("|") || isOperator("^")) {
+        Op op = isOperator("|") ? Op::Or : Op::Xor;
+        next();
+        left = binary(op, std::move(left), parseBitAnd());
+    }
+    return left;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseBitAnd()
+{
+    NodePtr left = parseShift();
+    while (isOperator("&")) {
+        next();
+        left = binary(Op::And, std::move(left), parseShift());
+    }
+    return left;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseShift()
+{
+    NodePtr left = parseUnary();
+    while (isOperator("<<") || isOperator(">>")) {
+        Op op = isOperator("<<") ? Op::ShiftLeft : Op::ShiftRight;
+        next();
+        size_t column = tokenColumn;
+        NodePtr count = parseUnary();
+        if (count->kind == Node::Kind::Constant && static_cast<uint32_t>(count->value) >= SHIFT_BITS) {
+            tokenColumn = column;
+            fail("shift counts go from 0 to " + std::to_string(SHIFT_BITS - 1));
+        }
+        left = binary(op, std::move(left), std::move(count));
+    }
+    return left;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parseUnary()
+{
+    Op op;
+    if (isOperator("!")) {
+        op = Op::Not;
+    }
+    else if (isOperator("~")) {
+        op = Op::Complement;
+    }
+    else if (isOperator("-")) {
+        op = Op::Negate;
+    }
+    else {
+        return parsePrimary();
+    }
+
+    if (++nesting > MAX_NESTING) {
+        fail("the expression is nested too deeply");
+    }
+    size_t column = tokenColumn;
+    next();
+    NodePtr operand = unary(op, parseUnary());
+    operand->column = column;
+    --nesting;
+    return operand;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::parsePrimary()
+{
+    size_t column = tokenColumn;
+    if (token == Token::Number) {
+        int32_t value = static_cast<int32_t>(tokenNumber);
+        next();
+        return constant(value, column);
+    }
+
+    if (isOperator("(")) {
+        if (++nesting > MAX_NESTING) {
+            fail("the expression is nested too deeply");
+        }
+        next();
+        NodePtr inner = parseOr();
+        expect(")");
+        --nesting;
+        return inner;
+    }
+
+    if (token != Token::Name) {
+        fail(token == Token::End ? "the expression ends early" : "unexpected \"" + tokenText + "\"");
+    }
+
+    if (tokenText == "true" || tokenText == "false") {
+        bool value = tokenText == "true";
+        next();
+        return constant(value, column);
+    }
+
+    int field = -1;
+    if (tokenText == "data") {
+        next();
+        expect("[");
+        if (token != Token::Number || tokenNumber > 7) {
+            fail("data takes an index from 0 to 7");
+        }
+        field = Data0 + static_cast<int>(tokenNumber);
+        next();
+        expect("]");
+    }
+    else {
+        for (int i = 0; i < NAMED_FIELDS; ++i) {
+            if (tokenText == FIELD_NAMES[i]) {
+                field = i;
+            }
+        }
+        if (field < 0) {
+            fail("unknown field \"" + tokenText + "\"");
+        }
+        next();
+    }
+
+    NodePtr node(new Node(Node::Kind::Field, Op::Or, field));
+    node->column = column;
+    return node;
+}
+
+int32_t FrameFilter::Compiler::parseConstant(const char* what)
+{
+    size_t column = tokenColumn;
+    NodePtr node = parseBitOr();
+    if (node->kind != Node::Kind::Constant) {
+        tokenColumn = column;
+        fail(std::string(what) + " must be constants");
+    }
+    return node->value;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::constant(int32_t value, size_t column)
+{
+    NodePtr node(new Node(Node::Kind::Constant, Op::Or, value));
+    node->column = column;
+    return node;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::toBool(NodePtr node)
+{
+    if (isBoolean(*node)) {
+        return node;
+    }
+    size_t column = node->column;
+    return binary(Op::NotEqual, std::move(node), constant(0, column));
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::unary(Op op, NodePtr operand)
+{
+    if (operand->kind == Node::Kind::Constant) {
+        int32_t value = operand->value;
+        switch (op) {
+        case Op::Not: return constant(!value, operand->column);
+        case Op::Complement: return constant(~value, operand->column);
+        default: return constant(negate(value), operand->column);
+        }
+    }
+
+    return NodePtr(new Node(Node::Kind::Unary, op, std::move(operand)));
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::binary(Op op, NodePtr left, NodePtr right)
+{
+    size_t column = left->column;
+    if (left->kind == Node::Kind::Constant && right->kind == Node::Kind::Constant) {
+        int32_t a = left->value;
+        int32_t b = right->value;
+        switch (op) {
+        case Op::Or: return constant(a | b, column);
+        case Op::Xor: return constant(a ^ b, column);
+        case Op::And: return constant(a & b, column);
+        case Op::ShiftLeft: return constant(shiftLeft(a, b), column);
+        case Op::ShiftRight: return constant(shiftRight(a, b), column);
+        case Op::Equal: return constant(a == b, column);
+        case Op::NotEqual: return constant(a != b, column);
+        case Op::Less: return constant(a < b, column);
+        case Op::LessEqual: return constant(a <= b, column);
+        case Op::Greater: return constant(a > b, column);
+        case Op::GreaterEqual: return constant(a >= b, column);
+        case Op::LogicalAnd: return constant(a != 0 && b != 0, column);
+        default: return constant(a != 0 || b != 0, column);
+        }
+    }
+
+    NodePtr node(new Node(Node::Kind::Binary, op, std::move(left), std::move(right)));
+    node->column = column;
+    return node;
+}
+
+FrameFilter::Compiler::NodePtr FrameFilter::Compiler::logical(Op op, NodePtr left, NodePtr right)
+{
+    // A constant side decides the result or drops out
+    bool isAnd = op == Op::LogicalAnd;
+    if (left->kind == Node::Kind::Constant) {
+        return (left->value != 0) == isAnd ? toBool(std::move(right)) : constant(!isAnd, left->column);
+    }
+    if (right->kind == Node::Kind::Constant) {
+        return (right->value != 0) == isAnd ? toBool(std::move(left)) : constant(!isAnd, left->column);
+    }
+    return binary(op, std::move(left), std::move(right));
+}
+
+bool FrameFilter::Compiler::isBoolean(const Node& node)
+{
+    switch (node.kind) {
+    case Node::Kind::Constant: return node.value == 0 || node.value == 1;
+    case Node::Kind::Field: return false;
+    case Node::Kind::Unary: return node.op == Op::Not;
+    case Node::Kind::Binary: return node.op >= Op::Equal && node.op <= Op::LogicalOr;
+    default: return true;
+    }
+}
+
+bool FrameFilter::Compiler::collectGroups(const Node& node)
+{
+    if (node.kind == Node::Kind::Binary && node.op == Op::LogicalOr) {
+        return collectGroups(*node.left) && collectGroups(*node.right);
+    }
+    if (!collectTests(node)) {
+        return false;
+    }
+    filter.groupEnds.push_back(static_cast<uint32_t>(filter.tests.size()));
+    return true;
+}
+
+bool FrameFilter::Compiler::collectTests(const Node& node)
+{
+    if (node.kind == Node::Kind::Binary && node.op == Op::LogicalAnd) {
+        return collectTests(*node.left) && collectTests(*node.right);
+    }
+
+    Test test;
+    if (!makeTest(node, test)) {
+        return false;
+    }
+    filter.tests.push_back(test);
+    return true;
+}
+
+bool FrameFilter::Compiler::makeTest(const Node& node, Test& test)
+{
+    if (node.kind == Node::Kind::Unary && node.op == Op::Not) {
+        if (!makeTest(*node.left, test)) {
+            return false;
+        }
+        test.negate = !test.negate;
+        return true;
+    }
+
+    if (node.kind == Node::Kind::Range) {
+        test.low = node.value;
+        test.high = node.high;
+        return maskedField(*node.left, test);
+    }
+
+    if (node.kind == Node::Kind::Binary && node.op >= Op::Equal && node.op <= Op::GreaterEqual &&
+        (node.left->kind == Node::Kind::Constant || node.right->kind == Node::Kind::Constant)) {
+        // With the constant on the right
+        Op op = node.op;
+        const Node* value = node.left.get();
+        int32_t bound = node.right->value;
+        if (node.left->kind == Node::Kind::Constant) {
+            value = node.right.get();
+            bound = node.left->value;
+            switch (op) {
+            case Op::Less: op = Op::Greater; break;
+            case Op::LessEqual: op = Op::GreaterEqual; break;
+            case Op::Greater: op = Op::Less; break;
+            case Op::GreaterEqual: op = Op::LessEqual; break;
+            default: break;
+            }
+        }
+        if (!maskedField(*value, test)) {
+            return false;
+        }
+
+        // The comparisons with no value on one side can never pass: a negated full range
+        test.low = INT32_MIN;
+        test.high = INT32_MAX;
+        switch (op) {
+        case Op::Equal: test.low = test.high = bound; break;
+        case Op::NotEqual: test.low = test.high = bound; test.negate = true; break;
+        case Op::Less: test.negate = bound == INT32_MIN; test.high = bound == INT32_MIN ? INT32_MAX : bound - 1; break;
+        case Op::LessEqual: test.high = bound; break;
+        case Op::Greater: test.negate = bound == INT32_MAX; test.low = bound == INT32_MAX ? INT32_MIN : bound + 1; break;
+        default: test.low = bound; break;
+        }
+        return true;
+    }
+
+    // A value on its own passes when it is not 0
+    if (maskedField(node, test)) {
+        test.low = test.high = 0;
+        test.negate = true;
+        return true;
+    }
+    return false;
+}
+
+bool FrameFilter::Compiler::maskedField(const Node& node, Test& test)
+{
+    test.negate = false;
+    test.mask = -1;
+
+    const Node* field = &node;
+    if (node.kind == Node::Kind::Binary && node.op == Op::And) {
+        if (node.left->kind == Node::Kind::Field && node.right->kind == Node::Kind::Constant) {
+            field = node.left.get();
+            test.mask = node.right->value;
+        }
+        else if (node.right->kind == Node::Kind::Field && node.left->kind == Node::Kind::Constant) {
+            field = node.right.get();
+            test.mask = node.left->value;
+        }
+    }
+    if (field->kind != Node::Kind::Field) {
+        return false;
+    }
+
+    test.field = static_cast<uint8_t>(field->value);
+    return true;
+}
+
+void FrameFilter::Compiler::collectConstants(const Node& node)
+{
+    std::vector<int32_t>& constants = filter.constants;
+    if (node.kind == Node::Kind::Constant && std::find(constants.begin(), constants.end(), node.value) == constants.end()) {
+        if (static_cast<int>(constants.size()) == MAX_CONSTANTS) {
+            tooLarge("different constants", MAX_CONSTANTS, node.column);
+        }
+        constants.push_back(node.value);
+    }
+    if (node.left) {
+        collectConstants(*node.left);
+    }
+    if (node.right) {
+        collectConstants(*node.right);
+    }
+}
+
+FrameFilter::Operand FrameFilter::Compiler::allocate()
+{
+    // Results are freed in the reverse order they were made, so they are used like a stack
+    maxTemporaries = std::max(maxTemporaries, ++temporaries);
+    return Operand{ Temporaries, static_cast<uint8_t>(temporaries - 1) };
+}
+
+void FrameFilter::Compiler::release(Operand operand)
+{
+    if (operand.bank == Temporaries) {
+        --temporaries;
+    }
+}
+
+FrameFilter::Operand FrameFilter::Compiler::generate(const Node& node)
+{
+    std::vector<int32_t>& constants = filter.constants;
+    switch (node.kind) {
+    case Node::Kind::Constant:
+        return Operand{ Constants, static_cast<uint8_t>(std::find(constants.begin(), constants.end(), node.value) - constants.begin()) };
+    case Node::Kind::Field:
+        return Operand{ Fields, static_cast<uint8_t>(node.value) };
+    default:
+        break;
+    }
+
+    Operand left = generate(*node.left);
+    Operand right = node.right ? generate(*node.right) : left;
+    if (node.right) {
+        release(right);
+    }
+    release(left);
+
+    Operand target = allocate();
+    if (maxTemporaries > MAX_TEMPORARIES) {
+        tooLarge("intermediate results", MAX_TEMPORARIES, node.column);
+    }
+    filter.program.push_back(Instruction{ node.op, target.index, left, right, node.value, node.high });
+    return target;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef FRAME_FILTER_H
+#define FRAME_FILTER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A filter expression over the frames the bus delivers, compiled once into a short register
+// program so testing a frame is a handful of array operations and no allocation.
+//
+//   id in 0x100..0x1FF && data[0] & 0x80
+//   sender == 5 && error
+//
+// Operators from lowest to highest precedence: ||, &&, comparisons (== != < <= > >= and
+// "in lo..hi" with constant bounds), | and ^, &, << and >>, unary ! ~ -. Bitwise operators
+// bind tighter than comparisons, so "data[0] & 0x80 == 0x80" tests the masked byte. Constant
+// shift counts go from 0 to 31; a count read from a field past that shifts every bit out.
+//
+// Most filters are tests of single fields joined with && and ||. Those compile to groups of
+// range tests on masked fields, any group passing matches the frame, and are checked in one
+// loop without dispatch. Other expressions run as a register program. Nothing has side
+// effects, so && and || evaluate both sides: neither form has jumps, and the evaluator runs
+// the same steps for every frame whatever traffic the bus carries.
+class FrameFilter {
+public:
+    enum Field {
+        Id,
+        Sender,             // node id
+        Dlc,
+        Round,              // round the frame won arbitration in
+        Delivered,          // acknowledged and removed from the pending messages
+        Error,              // a receiver failed the CRC or nobody acknowledged it
+        CrcErrors,          // receivers that failed the CRC
+        Receivers,          // bit i is set when node i + 1 accepted the frame, nodes 1 to RECEIVER_BITS
+        Data0,              // data[0] to data[7], 0 past the data length
+        FIELD_COUNT = Data0 + 8
+    };
+
+    static constexpr int RECEIVER_BITS = 31;
+
+    struct Frame {
+        int32_t values[FIELD_COUNT] = {};
+    };
+
+    // Throws std::invalid_argument with the column of the first error
+    explicit FrameFilter(const std::string& expression);
+
+    bool matches(const Frame& frame) const;
+
+    const std::string& getExpression() const { return expression; }
+    size_t getInstructionCount() const { return testsOnly ? tests.size() : program.size(); }
+
+private:
+    enum class Op : uint8_t {
+        Or, Xor, And, ShiftLeft, ShiftRight,
+        Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual,
+        LogicalAnd, LogicalOr,
+        Not, Complement, Negate,
+        InRange,            // left from low to high, inclusive
+    };
+
+    // Operands are read from the fields of the frame, the constants or the intermediate
+    // results, whichever bank the compiler placed them in
+    enum Bank : uint8_t { Fields, Constants, Temporaries };
+
+    struct Operand {
+        Bank bank;
+        uint8_t index;
+    };
+
+    struct Instruction {
+        Op op;
+        uint8_t target;     // intermediate result
+        Operand left;
+        Operand right;
+        int32_t low;
+        int32_t high;
+    };
+
+    // Passes when the masked field is from low to high, or is not when negated
+    struct Test {
+        uint8_t field;
+        bool negate;
+        int32_t mask;
+        int32_t low;
+        int32_t high;
+    };
+
+    static constexpr int MAX_CONSTANTS = 256;
+    static constexpr int MAX_TEMPORARIES = 32;
+
+    class Compiler;
+
+    std::string expression;
+    bool testsOnly;
+    std::vector<Test> tests;
+    std::vector<uint32_t> groupEnds;    // a group is the tests from the end of the previous one
+    std::vector<Instruction> program;
+    std::vector<int32_t> constants;
+    Operand result;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <cstdint>
+
+struct TraceFrame {
+    uint64_t timestamp;                 // microseconds, as recorded
+    int channel;                        // ASC channel number, or candump interface in order of appearance
+    uint32_t id;
+    bool extended;
+    bool remote;
+    uint8_t length;
+    uint8_t data[8];
+};
+
+// Stream of timestamped frames, produced one at a time so the whole stream never has to be in memory
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // False once the stream is exhausted; frames come in timestamp order
+    virtual bool next(TraceFrame& frame) = 0;
+};
+
+#endif
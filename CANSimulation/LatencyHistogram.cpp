@@ -0,0 +1,99 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int highestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+LatencyHistogram::LatencyHistogram()
+    : buckets(BUCKET_COUNT, 0), count(0), sum(0), min(UINT64_MAX), max(0)
+{
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value)
+{
+    if (value < SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+
+    value = std::min(value, MAX_VALUE);
+    int shift = highestBit(value) - (SUB_BUCKET_BITS - 1);
+    int subBucket = static_cast<int>(value >> shift) - SUB_BUCKETS / 2;
+
+    return SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + subBucket;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+
+    int offset = index - SUB_BUCKETS;
+    int shift = offset / (SUB_BUCKETS / 2) + 1;
+    uint64_t subBucket = offset % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value)
+{
+    buckets[bucketIndex(value)]++;
+    count++;
+    sum += value;
+    if (value < min) min = value;
+    if (value > max) max = value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+    sum = 0;
+    min = UINT64_MAX;
+    max = 0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+    target = std::max<uint64_t>(1, std::min(target, count));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), max);
+        }
+    }
+
+    return max;
+}
\ No newline at end of file
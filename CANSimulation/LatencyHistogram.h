@@ -0,0 +1,45 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+// Fixed-memory log-linear histogram in the style of HdrHistogram. Values below
+// SUB_BUCKETS are exact; above that every power of two is split into SUB_BUCKETS / 2
+// linear buckets, so the relative error stays under 1/32 up to MAX_VALUE.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 6;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAGNITUDE_BITS = 40;
+    static constexpr uint64_t MAX_VALUE = (1ULL << MAGNITUDE_BITS) - 1;
+    static const int BUCKET_COUNT = SUB_BUCKETS + (MAGNITUDE_BITS - SUB_BUCKET_BITS) * (SUB_BUCKETS / 2);
+
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t getCount() const { return count; }
+    uint64_t getMin() const { return count ? min : 0; }
+    uint64_t getMax() const { return max; }
+    double getMean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+    // Highest value equivalent to the bucket holding the given percentile (0..100)
+    uint64_t valueAtPercentile(double percentile) const;
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+
+private:
+    friend class SimulationCheckpoint;
+
+    std::vector<uint64_t> buckets;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+};
+
+#endif
\ No newline at end of file
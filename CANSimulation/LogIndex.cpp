@@ -0,0 +1,687 @@
+#include "LogIndex.h"
+
+#include <algorithm>
+#include <bitset>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static const size_t WINDOW_SIZE = 256 * MappedFile::ALIGNMENT;
+static const size_t READ_WINDOW = 16 * MappedFile::ALIGNMENT;
+static const int ID_BITS = 11;
+
+static_assert(LogIndex::CHECKPOINT_LINES == 64, "a match mask word covers one checkpoint of lines");
+
+static int lowestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+static int countBits(uint64_t value)
+{
+    return static_cast<int>(std::bitset<64>(value).count());
+}
+
+static char foldCase(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+namespace {
+
+    struct FoldedHash {
+        size_t operator()(char c) const { return std::hash<char>()(foldCase(c)); }
+    };
+
+    struct FoldedEqual {
+        bool operator()(char a, char b) const { return foldCase(a) == foldCase(b); }
+    };
+
+}
+
+static bool startsWith(const char*& p, const char* end, const char* prefix)
+{
+    size_t length = std::strlen(prefix);
+    if (static_cast<size_t>(end - p) < length || std::memcmp(p, prefix, length) != 0) {
+        return false;
+    }
+    p += length;
+    return true;
+}
+
+// Moves p past text, false if the line does not contain it
+static bool skipPast(const char*& p, const char* end, const char* text)
+{
+    const char* found = std::search(p, end, text, text + std::strlen(text));
+    if (found == end) {
+        return false;
+    }
+    p = found + std::strlen(text);
+    return true;
+}
+
+static int number(const char*& p, const char* end)
+{
+    while (p < end && *p == ' ') {
+        ++p;
+    }
+
+    int value = 0;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return -1;
+    }
+    p = result.ptr;
+    return value;
+}
+
+// Identifiers are logged as 11 binary digits, with stuff bits when bit stuffing is shown
+static int binaryId(const char*& p, const char* end)
+{
+    while (p < end && *p == ' ') {
+        ++p;
+    }
+
+    const char* first = p;
+    while (p < end && (*p == '0' || *p == '1')) {
+        ++p;
+    }
+
+    bool stuffed = p - first > ID_BITS;
+    int id = 0;
+    int bits = 0;
+    int consecutive = 0;
+    char last = ' ';
+
+    for (const char* bit = first; bit < p && bits < ID_BITS; ++bit) {
+        id = (id << 1) | (*bit - '0');
+        ++bits;
+
+        // Mirrors ErrorCheck::applyBitStuffingToId, after five equal bits comes a stuff bit
+        consecutive = *bit == last ? consecutive + 1 : 1;
+        last = *bit;
+        if (stuffed && consecutive == 5) {
+            ++bit;
+            consecutive = 0;
+        }
+    }
+
+    return bits == ID_BITS ? id : -1;
+}
+
+static int roundOf(const char* p, const char* end)
+{
+    while (p < end && *p == ' ') {
+        ++p;
+    }
+    return startsWith(p, end, "ROUND:") ? number(p, end) : -1;
+}
+
+LogIndex::LogIndex(const std::string& path, int pollInterval)
+    : path(path), pollInterval(pollInterval), lineCount(0), indexedBytes(0), filterGeneration(0),
+    matchCount(0), filteredLines(0), fileSize(0), generation(0), stopping(false),
+    readerView(nullptr), readerOffset(0), readerLength(0), readerGeneration(0)
+{
+    worker = std::thread(&LogIndex::run, this);
+}
+
+LogIndex::~LogIndex()
+{
+    stopping.store(true, std::memory_order_relaxed);
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void LogIndex::setFilter(const Filter& newFilter)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    filter = newFilter;
+    filterGeneration++;
+    matchMasks.clear();
+    matchesBefore.clear();
+    matchCount = 0;
+    filteredLines = 0;
+}
+
+LogIndex::Filter LogIndex::getFilter() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return filter;
+}
+
+uint64_t LogIndex::getLineCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return lineCount;
+}
+
+uint64_t LogIndex::getIndexedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return indexedBytes;
+}
+
+uint64_t LogIndex::getRowCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return filter.isActive() ? matchCount : lineCount;
+}
+
+uint64_t LogIndex::getFilteredLines() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return filter.isActive() ? filteredLines : lineCount;
+}
+
+uint64_t LogIndex::lineOfRow(uint64_t row) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!filter.isActive()) {
+        return row < lineCount ? row : NONE;
+    }
+    if (row >= matchCount) {
+        return NONE;
+    }
+
+    // The last word with at most row matches before it holds the match
+    size_t word = std::upper_bound(matchesBefore.begin(), matchesBefore.end(), row) - matchesBefore.begin() - 1;
+    uint64_t mask = matchMasks[word];
+    for (uint64_t skip = row - matchesBefore[word]; skip > 0; --skip) {
+        mask &= mask - 1;
+    }
+    return word * CHECKPOINT_LINES + lowestBit(mask);
+}
+
+uint64_t LogIndex::rowAtLine(uint64_t line) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!filter.isActive()) {
+        return std::min(line, lineCount);
+    }
+    if (line >= filteredLines) {
+        return matchCount;
+    }
+
+    size_t word = static_cast<size_t>(line / CHECKPOINT_LINES);
+    uint64_t below = (uint64_t(1) << (line % CHECKPOINT_LINES)) - 1;
+    return matchesBefore[word] + countBits(matchMasks[word] & below);
+}
+
+uint64_t LogIndex::rowOfLine(uint64_t line) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!filter.isActive()) {
+            return line < lineCount ? line : NONE;
+        }
+        if (line >= filteredLines || !((matchMasks[line / CHECKPOINT_LINES] >> (line % CHECKPOINT_LINES)) & 1)) {
+            return NONE;
+        }
+    }
+    return rowAtLine(line);
+}
+
+uint64_t LogIndex::findRound(int round, uint64_t fromLine) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto from = std::lower_bound(roundMarks.begin(), roundMarks.end(), fromLine,
+        [](const RoundMark& mark, uint64_t line) { return mark.line < line; });
+    auto isRound = [round](const RoundMark& mark) { return mark.round == round; };
+
+    auto found = std::find_if(from, roundMarks.end(), isRound);
+    if (found == roundMarks.end()) {
+        found = std::find_if(roundMarks.begin(), from, isRound);
+        if (found == from) {
+            return NONE;
+        }
+    }
+    return found->line;
+}
+
+LogIndex::LineInfo LogIndex::classify(const char* begin, const char* end, LineInfo& context)
+{
+    const char* p = begin;
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+
+    LineInfo info;
+
+    if (startsWith(p, end, "ROUND:")) {
+        info.type = EventType::Round;
+        info.round = number(p, end);
+        context = LineInfo();
+    }
+    else if (startsWith(p, end, "-----") || startsWith(p, end, "CANBus initialized")) {
+        info.type = EventType::Session;
+        context = LineInfo();
+    }
+    else if (startsWith(p, end, "- message:")) {
+        info.type = EventType::Arbitration;
+        info.messageId = binaryId(p, end);
+        if (skipPast(p, end, "sender ID:")) {
+            info.nodeId = std::max(0, number(p, end));
+        }
+    }
+    else if (startsWith(p, end, "Arbitrating") || startsWith(p, end, "Messages still in the race") ||
+        startsWith(p, end, "No more contenders")) {
+        info.type = EventType::Arbitration;
+    }
+    else if (startsWith(p, end, "Winner")) {
+        info.type = EventType::Transmission;
+        info.messageId = binaryId(p, end);
+        if (skipPast(p, end, "sender ID:")) {
+            info.nodeId = std::max(0, number(p, end));
+        }
+        context = info;
+    }
+    else if (startsWith(p, end, "!!!") || startsWith(p, end, "Stuffed Message:") || startsWith(p, end, "CRC:") ||
+        startsWith(p, end, "Winning message was received")) {
+        info.type = EventType::Transmission;
+        info.nodeId = context.nodeId;
+        info.messageId = context.messageId;
+    }
+    else if (startsWith(p, end, "- ack bit was set")) {
+        info.type = EventType::Reception;
+        info.messageId = context.messageId;
+        if (skipPast(p, end, "node:")) {
+            info.nodeId = std::max(0, number(p, end));
+        }
+    }
+    else if (startsWith(p, end, "CRC check failed for Node")) {
+        info.type = EventType::Error;
+        info.nodeId = std::max(0, number(p, end));
+        info.messageId = context.messageId;
+    }
+    else if (startsWith(p, end, "Message was not received")) {
+        info.type = EventType::Error;
+        info.messageId = context.messageId;
+    }
+    else if (startsWith(p, end, "No nodes received the winning message")) {
+        info.type = EventType::Error;
+        info.nodeId = context.nodeId;
+        info.messageId = context.messageId;
+    }
+    else if (startsWith(p, end, "Node ")) {
+        info.nodeId = std::max(0, number(p, end));
+        if (startsWith(p, end, " received the message")) {
+            info.type = EventType::Reception;
+            info.messageId = context.messageId;
+        }
+        else {
+            // Disabled, or a counter reached its limit
+            info.type = EventType::Error;
+        }
+    }
+    else if (startsWith(p, end, "NODE ERROR COUNTERS")) {
+        info.type = EventType::Counters;
+        context = LineInfo();
+    }
+    else if (startsWith(p, end, "- node")) {
+        info.type = EventType::Counters;
+        info.nodeId = std::max(0, number(p, end));
+    }
+    else if (startsWith(p, end, "WCRT bound for ID")) {
+        info.messageId = number(p, end);
+    }
+
+    return info;
+}
+
+bool LogIndex::matches(const Filter& filter, const LineInfo& info)
+{
+    if (!((filter.eventTypes >> static_cast<int>(info.type)) & 1)) {
+        return false;
+    }
+
+    // Round and session lines keep the log readable under node and identifier filters
+    if (info.type == EventType::Round || info.type == EventType::Session) {
+        return true;
+    }
+
+    return (filter.nodeId == 0 || info.nodeId == filter.nodeId) &&
+        (filter.messageId < 0 || info.messageId == filter.messageId);
+}
+
+void LogIndex::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    checkpoints.clear();
+    roundMarks.clear();
+    lineCount = 0;
+    indexedBytes = 0;
+    filterGeneration++;
+    matchMasks.clear();
+    matchesBefore.clear();
+    matchCount = 0;
+    filteredLines = 0;
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogIndex::run()
+{
+    MappedFile file;
+    Cursor indexCursor;
+    Cursor filterCursor;
+    Filter scanFilter;
+    unsigned scanFilterGeneration = 0;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        bool progressed = false;
+
+        try {
+            if (!file.isOpen()) {
+                file.open(path);
+            }
+
+            uint64_t size = file.refresh();
+            fileSize.store(size, std::memory_order_relaxed);
+
+            // A shorter file is a new log, the old lines are gone
+            if (size < indexCursor.offset) {
+                reset();
+                indexCursor = Cursor();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (scanFilterGeneration != filterGeneration) {
+                    scanFilterGeneration = filterGeneration;
+                    scanFilter = filter;
+                    filterCursor = Cursor();
+                }
+            }
+
+            bool filtering = scanFilter.isActive();
+            if (filtering && filterCursor.offset < indexCursor.offset) {
+                progressed = scan(file, filterCursor, indexCursor.offset, false, true, scanFilter, scanFilterGeneration);
+            }
+            else if (indexCursor.offset < size) {
+                // Once the filter has caught up it runs along with the indexing
+                progressed = scan(file, indexCursor, size, true, filtering, scanFilter, scanFilterGeneration);
+                filterCursor = indexCursor;
+            }
+        }
+        catch (const std::invalid_argument&) {
+            // The log does not exist yet or could not be read, try again at the next poll
+            file.close();
+        }
+
+        if (progressed) {
+            continue;
+        }
+
+        for (int waited = 0; waited < pollInterval && !stopping.load(std::memory_order_relaxed); waited += 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+bool LogIndex::scan(MappedFile& file, Cursor& cursor, uint64_t end, bool indexing, bool filtering,
+    const Filter& scanFilter, unsigned scanFilterGeneration)
+{
+    uint64_t windowOffset = cursor.offset - cursor.offset % MappedFile::ALIGNMENT;
+    size_t length = static_cast<size_t>(std::min<uint64_t>(WINDOW_SIZE, end - windowOffset));
+    const char* window = file.map(windowOffset, length);
+    const char* p = window + (cursor.offset - windowOffset);
+    const char* limit = window + length;
+
+    uint64_t firstLine = cursor.line;
+    std::vector<uint64_t> newCheckpoints;
+    std::vector<RoundMark> newRounds;
+    std::vector<uint64_t> masks;            // words from firstLine / CHECKPOINT_LINES on
+    uint64_t newMatches = 0;
+
+    auto addLine = [&](const char* begin, const char* lineEnd, uint64_t nextOffset) {
+        if (indexing && cursor.line % CHECKPOINT_LINES == 0) {
+            newCheckpoints.push_back(cursor.offset);
+        }
+
+        if (lineEnd > begin && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+
+        int round = -1;
+        if (filtering) {
+            LineInfo info = classify(begin, lineEnd, cursor.context);
+            round = info.round;
+
+            if (matches(scanFilter, info)) {
+                size_t word = static_cast<size_t>(cursor.line / CHECKPOINT_LINES - firstLine / CHECKPOINT_LINES);
+                masks.resize(word + 1, 0);
+                masks[word] |= uint64_t(1) << (cursor.line % CHECKPOINT_LINES);
+                newMatches++;
+            }
+        }
+        else if (indexing) {
+            round = roundOf(begin, lineEnd);
+        }
+
+        if (indexing && round >= 0) {
+            newRounds.push_back({ cursor.line, round });
+        }
+
+        cursor.line++;
+        cursor.offset = nextOffset;
+    };
+
+    while (p < limit) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', limit - p));
+        if (!newline) {
+            break;
+        }
+        addLine(p, newline, windowOffset + (newline - window) + 1);
+        p = newline + 1;
+    }
+
+    // A line longer than a whole window: look for its end in the following windows and
+    // classify it by what fits, the rest of it is never needed for the index
+    if (cursor.line == firstLine && length == WINDOW_SIZE) {
+        std::string start(p, std::min<size_t>(limit - p, MAX_LINE_LENGTH));
+        uint64_t next = windowOffset + length;
+
+        while (next < end) {
+            size_t nextLength = static_cast<size_t>(std::min<uint64_t>(WINDOW_SIZE, end - next));
+            const char* nextWindow = file.map(next, nextLength);
+            const char* newline = static_cast<const char*>(std::memchr(nextWindow, '\n', nextLength));
+            if (newline) {
+                addLine(start.data(), start.data() + start.size(), next + (newline - nextWindow) + 1);
+                break;
+            }
+            next += nextLength;
+        }
+    }
+
+    if (cursor.line == firstLine) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (indexing) {
+        checkpoints.insert(checkpoints.end(), newCheckpoints.begin(), newCheckpoints.end());
+        roundMarks.insert(roundMarks.end(), newRounds.begin(), newRounds.end());
+        lineCount = cursor.line;
+        indexedBytes = cursor.offset;
+    }
+
+    // Matches of a filter that was replaced in the meantime are dropped
+    if (filtering && scanFilterGeneration == filterGeneration) {
+        size_t firstWord = static_cast<size_t>(firstLine / CHECKPOINT_LINES);
+        size_t lastWord = static_cast<size_t>((cursor.line - 1) / CHECKPOINT_LINES);
+        masks.resize(lastWord - firstWord + 1, 0);
+
+        for (size_t i = 0; i < masks.size(); ++i) {
+            size_t word = firstWord + i;
+            if (word == matchMasks.size()) {
+                matchesBefore.push_back(word == 0 ? 0 : matchesBefore[word - 1] + countBits(matchMasks[word - 1]));
+                matchMasks.push_back(0);
+            }
+            matchMasks[word] |= masks[i];
+        }
+
+        matchCount += newMatches;
+        filteredLines = cursor.line;
+    }
+
+    return true;
+}
+
+const char* LogIndex::readerWindow(uint64_t offset, uint64_t end, size_t& length)
+{
+    unsigned current = generation.load(std::memory_order_relaxed);
+    if (readerGeneration != current) {
+        reader.close();
+        readerLength = 0;
+        readerGeneration = current;
+    }
+
+    uint64_t needed = std::min(end, offset + MAX_LINE_LENGTH + 1);
+    if (!reader.isOpen() || offset < readerOffset || needed > readerOffset + readerLength) {
+        if (!reader.isOpen()) {
+            reader.open(path);
+        }
+        if (end > reader.size()) {
+            reader.refresh();
+        }
+
+        readerLength = 0;
+        readerOffset = offset - offset % MappedFile::ALIGNMENT;
+        size_t windowLength = static_cast<size_t>(std::min<uint64_t>(READ_WINDOW, reader.size() - readerOffset));
+        readerView = reader.map(readerOffset, windowLength);
+        readerLength = windowLength;
+    }
+
+    length = static_cast<size_t>(std::min(readerOffset + readerLength, end) - offset);
+    return readerView + (offset - readerOffset);
+}
+
+uint64_t LogIndex::lineEnd(uint64_t offset, uint64_t end)
+{
+    while (offset < end) {
+        size_t length;
+        const char* p = readerWindow(offset, end, length);
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', length));
+        if (newline) {
+            return offset + (newline - p) + 1;
+        }
+        offset += length;
+    }
+    return end;
+}
+
+uint64_t LogIndex::offsetOfLine(uint64_t line)
+{
+    uint64_t offset;
+    uint64_t end;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (line >= lineCount) {
+            return indexedBytes;
+        }
+        offset = checkpoints[line / CHECKPOINT_LINES];
+        end = indexedBytes;
+    }
+
+    for (uint64_t skip = line % CHECKPOINT_LINES; skip > 0; --skip) {
+        offset = lineEnd(offset, end);
+    }
+    return offset;
+}
+
+std::string LogIndex::readLine(uint64_t line)
+{
+    uint64_t end = getIndexedBytes();
+    uint64_t offset = offsetOfLine(line);
+    if (offset >= end) {
+        return std::string();
+    }
+
+    size_t length;
+    const char* p = readerWindow(offset, end, length);
+    length = std::min(length, MAX_LINE_LENGTH);
+
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', length));
+    const char* lineEnd = newline ? newline : p + length;
+    if (lineEnd > p && lineEnd[-1] == '\r') {
+        --lineEnd;
+    }
+    return std::string(p, lineEnd);
+}
+
+uint64_t LogIndex::lineOfOffset(uint64_t offset)
+{
+    uint64_t line;
+    uint64_t lineStart;
+    uint64_t end;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (checkpoints.empty()) {
+            return 0;
+        }
+
+        size_t checkpoint = std::upper_bound(checkpoints.begin(), checkpoints.end(), offset) - checkpoints.begin() - 1;
+        line = static_cast<uint64_t>(checkpoint) * CHECKPOINT_LINES;
+        lineStart = checkpoints[checkpoint];
+        end = indexedBytes;
+    }
+
+    for (uint64_t next = lineEnd(lineStart, end); next <= offset && next < end; next = lineEnd(next, end)) {
+        line++;
+    }
+    return line;
+}
+
+uint64_t LogIndex::find(const std::string& text, bool caseSensitive, uint64_t& offset, uint64_t limit)
+{
+    if (caseSensitive) {
+        std::boyer_moore_horspool_searcher<std::string::const_iterator> searcher(text.begin(), text.end());
+        return findWith(searcher, text.size(), offset, limit);
+    }
+
+    std::boyer_moore_horspool_searcher<std::string::const_iterator, FoldedHash, FoldedEqual> searcher(text.begin(), text.end());
+    return findWith(searcher, text.size(), offset, limit);
+}
+
+template <typename Searcher>
+uint64_t LogIndex::findWith(const Searcher& searcher, size_t textLength, uint64_t& offset, uint64_t limit)
+{
+    uint64_t end = getIndexedBytes();
+    uint64_t stop = std::min(end, offset + limit);
+
+    while (textLength > 0 && offset < stop && end - offset >= textLength) {
+        size_t length;
+        const char* p = readerWindow(offset, end, length);
+
+        const char* found = std::search(p, p + length, searcher);
+        if (found != p + length) {
+            uint64_t match = offset + (found - p);
+            offset = match + 1;
+            return match;
+        }
+
+        // The next window starts early enough to find a match across the boundary
+        offset += std::max<size_t>(1, length - std::min(length, textLength - 1));
+    }
+
+    offset = std::max(offset, std::min(stop, end));
+    return NONE;
+}
\ No newline at end of file
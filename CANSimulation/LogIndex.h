@@ -0,0 +1,141 @@
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+
+// Line index of the simulation log, built on a background thread that maps the file one
+// window at a time. Only the offset of every CHECKPOINT_LINES-th line, where each round
+// starts and one bit per line for the current filter are kept, so a log of several GB
+// opens at once and needs a few MB of index. Once the end is reached the thread keeps
+// polling the file and indexes lines as the simulation appends them.
+//
+// The counts and the row lookups can be used from any thread, reading lines and searching
+// only from the viewer's.
+class LogIndex {
+public:
+    enum class EventType { Session, Round, Arbitration, Transmission, Reception, Error, Counters, Other };
+
+    static constexpr uint64_t NONE = UINT64_MAX;
+    static constexpr unsigned ALL_EVENTS = 0xFF;
+    static constexpr int CHECKPOINT_LINES = 64;
+    static constexpr size_t MAX_LINE_LENGTH = 4096; // longer lines are cut when read
+
+    struct Filter {
+        int nodeId = 0;                             // 0 for every node
+        int messageId = -1;                         // -1 for every identifier
+        unsigned eventTypes = ALL_EVENTS;           // bit per EventType
+
+        bool isActive() const { return nodeId != 0 || messageId >= 0 || eventTypes != ALL_EVENTS; }
+    };
+
+    // Node and identifier a log line is about, if any. Lines following a winner (CRC,
+    // receptions, acknowledgements) belong to the winning frame.
+    struct LineInfo {
+        EventType type = EventType::Other;
+        int nodeId = 0;
+        int messageId = -1;
+        int round = -1;                             // ROUND lines only
+    };
+
+    struct RoundMark {
+        uint64_t line;
+        int round;
+    };
+
+    explicit LogIndex(const std::string& path, int pollInterval = 250);
+    ~LogIndex();
+
+    LogIndex(const LogIndex&) = delete;
+    LogIndex& operator=(const LogIndex&) = delete;
+
+    // Lines are matched again from the start of the log in the background
+    void setFilter(const Filter& newFilter);
+    Filter getFilter() const;
+
+    uint64_t getLineCount() const;
+    uint64_t getIndexedBytes() const;
+    uint64_t getFileSize() const { return fileSize.load(std::memory_order_relaxed); }
+
+    // Increases when the log was truncated or replaced and indexing started over
+    unsigned getGeneration() const { return generation.load(std::memory_order_relaxed); }
+
+    // Rows are the lines matching the filter, every line when no filter is set
+    uint64_t getRowCount() const;
+    uint64_t lineOfRow(uint64_t row) const;
+
+    // Row of the first matching line at or after line, the row count if there is none yet
+    uint64_t rowAtLine(uint64_t line) const;
+
+    // NONE if the line does not match or the filter has not reached it yet
+    uint64_t rowOfLine(uint64_t line) const;
+
+    // Lines the filter has been checked against so far
+    uint64_t getFilteredLines() const;
+
+    // First line of the given round at or after fromLine, wrapping around, NONE if not logged
+    uint64_t findRound(int round, uint64_t fromLine) const;
+
+    std::string readLine(uint64_t line);
+    uint64_t offsetOfLine(uint64_t line);
+    uint64_t lineOfOffset(uint64_t offset);
+
+    // Searches the indexed lines for text from offset on and scans at most limit bytes.
+    // Returns the offset of the match or NONE, offset is left where to continue.
+    uint64_t find(const std::string& text, bool caseSensitive, uint64_t& offset, uint64_t limit);
+
+    static LineInfo classify(const char* begin, const char* end, LineInfo& context);
+    static bool matches(const Filter& filter, const LineInfo& info);
+
+private:
+    struct Cursor {
+        uint64_t line = 0;
+        uint64_t offset = 0;
+        LineInfo context;
+    };
+
+    void run();
+    bool scan(MappedFile& file, Cursor& cursor, uint64_t end, bool indexing, bool filtering,
+        const Filter& scanFilter, unsigned scanFilterGeneration);
+    void reset();
+
+    template <typename Searcher>
+    uint64_t findWith(const Searcher& searcher, size_t textLength, uint64_t& offset, uint64_t limit);
+    const char* readerWindow(uint64_t offset, uint64_t end, size_t& length);
+    uint64_t lineEnd(uint64_t offset, uint64_t end);
+
+    std::string path;
+    int pollInterval;
+
+    mutable std::mutex mutex;
+    std::vector<uint64_t> checkpoints;          // offset of every CHECKPOINT_LINES-th line
+    std::vector<RoundMark> roundMarks;
+    uint64_t lineCount;
+    uint64_t indexedBytes;                      // end of the last complete line
+    Filter filter;
+    unsigned filterGeneration;
+    std::vector<uint64_t> matchMasks;           // bit per line, CHECKPOINT_LINES lines per word
+    std::vector<uint64_t> matchesBefore;        // matching lines before each word
+    uint64_t matchCount;
+    uint64_t filteredLines;
+
+    std::atomic<uint64_t> fileSize;
+    std::atomic<unsigned> generation;
+    std::atomic<bool> stopping;
+    std::thread worker;
+
+    MappedFile reader;
+    const char* readerView;
+    uint64_t readerOffset;
+    size_t readerLength;
+    unsigned readerGeneration;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "LogRecord.h"
+
+#include <iterator>
+
+// How each type renders, in Type order. %d is a number, %i an 11-bit identifier and %r a
+// 16-bit CRC in binary, %s free text and %t a string of bits. The same fields in the same
+// order make up the binary form.
+static const char* const FORMATS[] = {
+    "%s",
+    "-----------------------",
+    "CANBus initialized at: %s",
+    "No messages to transmit.",
+    "No messages for the current round: %d",
+    "ROUND: %d",
+    "  Arbitrating at bit position: %d",
+    "      Messages still in the race at the beginning: ",
+    "Node %d is disabled. It will not participate in the arbitration.",
+    "         - message: %i, sender ID: %d, initial round: %d",
+    "         - message: %t, sender ID: %d, initial round: %d",
+    " ",
+    "No more contenders at bit position %d",
+    "!!!",
+    "Winner %i, sender ID: %d, initial round: %d",
+    "Stuffed Message: %t",
+    "CRC: %r",
+    "Node %d received the message, CRC verification was valid.",
+    " - ack bit was set to valid by node: %d",
+    "CRC check failed for Node %d. Message was not received.",
+    "Message was not received.",
+    "No nodes received the winning message. Adding it back to the pending messages.",
+    "Winning message was received by at least one node. Removing it from the pending messages.",
+    "NODE ERROR COUNTERS :",
+    "- node %d  TEC: %d  REC: %d",
+    "Node %d has reached the maximum TEC value. It will be disabled.",
+    "Node %d has reached the maximum REC value. It will be disabled.",
+};
+
+static_assert(std::size(FORMATS) == static_cast<size_t>(LogRecord::Type::RecLimit) + 1, "one format per record type");
+
+static void appendBinary(std::string& out, unsigned value, int bits)
+{
+    for (int i = bits - 1; i >= 0; --i) {
+        out += ((value >> i) & 1) ? '1' : '0';
+    }
+}
+
+static void writeVarint(std::string& out, uint32_t value)
+{
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+static bool readVarint(const char*& p, const char* end, uint32_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Small negative numbers stay small: 0, -1, 1, -2 ... become 0, 1, 2, 3 ...
+static uint32_t zigzag(int value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int unzigzag(uint32_t value)
+{
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+static bool isBits(const std::string& text)
+{
+    return text.find_first_not_of("01") == std::string::npos;
+}
+
+LogRecord::LogRecord(Type type, int first, int second, int third)
+    : type(type), values{ first, second, third }
+{
+}
+
+LogRecord::LogRecord(Type type, const std::string& text, int first, int second)
+    : type(type), values{ first, second, 0 }, text(text)
+{
+}
+
+std::string LogRecord::render() const
+{
+    std::string line;
+    int value = 0;
+
+    for (const char* f = FORMATS[static_cast<int>(type)]; *f; ++f) {
+        if (*f != '%') {
+            line += *f;
+            continue;
+        }
+
+        switch (*++f) {
+        case 'd': line += std::to_string(values[value++]); break;
+        case 'i': appendBinary(line, values[value++], 11); break;
+        case 'r': appendBinary(line, values[value++], 16); break;
+        default: line += text; break;
+        }
+    }
+    return line;
+}
+
+LogRecord LogRecord::parse(const std::string& line)
+{
+    for (size_t type = 1; type < std::size(FORMATS); ++type) {
+        LogRecord record(static_cast<Type>(type));
+        // Rendering again rules out lines that only look alike, such as numbers with leading zeros
+        if (record.scan(line) && record.render() == line) {
+            return record;
+        }
+    }
+    return LogRecord(Type::Text, line);
+}
+
+bool LogRecord::scan(const std::string& line)
+{
+    size_t i = 0;
+    int value = 0;
+
+    for (const char* f = FORMATS[static_cast<int>(type)]; *f; ++f) {
+        if (*f != '%') {
+            if (i >= line.size() || line[i] != *f) {
+                return false;
+            }
+            ++i;
+            continue;
+        }
+
+        switch (*++f) {
+        case 'd': {
+            size_t start = i;
+            if (i < line.size() && line[i] == '-') {
+                ++i;
+            }
+            size_t digits = i;
+            while (i < line.size() && line[i] >= '0' && line[i] <= '9' && i - digits < 9) {
+                ++i;
+            }
+            if (i == digits) {
+                return false;
+            }
+            values[value++] = std::stoi(line.substr(start, i - start));
+            break;
+        }
+        case 'i':
+        case 'r': {
+            size_t bits = *f == 'i' ? 11 : 16;
+            if (line.size() - i < bits || !isBits(line.substr(i, bits))) {
+                return false;
+            }
+            values[value++] = std::stoi(line.substr(i, bits), nullptr, 2);
+            i += bits;
+            break;
+        }
+        case 't': {
+            size_t start = i;
+            while (i < line.size() && (line[i] == '0' || line[i] == '1')) {
+                ++i;
+            }
+            text = line.substr(start, i - start);
+            break;
+        }
+        default:
+            // Free text runs to the end of the line
+            text = line.substr(i);
+            i = line.size();
+            break;
+        }
+    }
+    return i == line.size();
+}
+
+void LogRecord::encode(std::string& out) const
+{
+    const char* format = FORMATS[static_cast<int>(type)];
+
+    // Bits that are not all bits go in as the line they render to
+    for (const char* f = format; *f; ++f) {
+        if (f[0] == '%' && f[1] == 't' && !isBits(text)) {
+            LogRecord(Type::Text, render()).encode(out);
+            return;
+        }
+    }
+
+    out += static_cast<char>(type);
+    int value = 0;
+
+    for (const char* f = format; *f; ++f) {
+        if (*f != '%') {
+            continue;
+        }
+
+        switch (*++f) {
+        case 's':
+            writeVarint(out, static_cast<uint32_t>(text.size()));
+            out += text;
+            break;
+        case 't': {
+            writeVarint(out, static_cast<uint32_t>(text.size()));
+            uint8_t byte = 0;
+            for (size_t i = 0; i < text.size(); ++i) {
+                byte = static_cast<uint8_t>(byte << 1 | (text[i] == '1'));
+                if (i % 8 == 7 || i + 1 == text.size()) {
+                    out += static_cast<char>(byte << (7 - i % 8));
+                    byte = 0;
+                }
+            }
+            break;
+        }
+        default:
+            writeVarint(out, zigzag(values[value++]));
+            break;
+        }
+    }
+}
+
+bool LogRecord::decode(const char*& p, const char* end, LogRecord& record)
+{
+    if (p >= end || static_cast<uint8_t>(*p) >= std::size(FORMATS)) {
+        return false;
+    }
+
+    record.type = static_cast<Type>(*p++);
+    record.text.clear();
+    int value = 0;
+
+    for (const char* f = FORMATS[static_cast<int>(record.type)]; *f; ++f) {
+        if (*f != '%') {
+            continue;
+        }
+
+        uint32_t number = 0;
+        if (!readVarint(p, end, number)) {
+            return false;
+        }
+
+        switch (*++f) {
+        case 's':
+            if (number > static_cast<size_t>(end - p)) {
+                return false;
+            }
+            record.text.assign(p, number);
+            p += number;
+            break;
+        case 't':
+            if ((number + 7) / 8 > static_cast<size_t>(end - p)) {
+                return false;
+            }
+            record.text.resize(number);
+            for (uint32_t i = 0; i < number; ++i) {
+                record.text[i] = (static_cast<uint8_t>(p[i / 8]) >> (7 - i % 8)) & 1 ? '1' : '0';
+            }
+            p += (number + 7) / 8;
+            break;
+        default:
+            record.values[value++] = unzigzag(number);
+            break;
+        }
+    }
+    return true;
+}
\ No newline at end of file
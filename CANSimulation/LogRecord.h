@@ -0,0 +1,68 @@
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <cstdint>
+#include <string>
+
+// One line of the simulation log: its type and the values that vary. The text log renders
+// records as they are written, binary logs store them encoded and render them on demand
+// into the same text.
+class LogRecord {
+public:
+    enum class Type : uint8_t {
+        Text,                   // free text
+        Separator,
+        Session,                // time the bus was created
+        NoMessages,
+        NoMessagesInRound,      // round
+        Round,                  // round
+        ArbitrationBit,         // bit position
+        ContendersHeader,
+        DisabledContender,      // node
+        Contender,              // identifier, sender, initial round
+        StuffedContender,       // stuffed identifier bits, sender, initial round
+        Blank,
+        NoMoreContenders,       // bit position
+        WinnerMark,
+        Winner,                 // identifier, sender, initial round
+        StuffedFrame,           // frame bits
+        Crc,                    // CRC
+        Received,               // node
+        AckSet,                 // node
+        CrcFailed,              // node
+        NotReceived,
+        NoReceivers,
+        Delivered,
+        CountersHeader,
+        NodeCounters,           // node, TEC, REC
+        TecLimit,               // node
+        RecLimit,               // node
+    };
+
+    LogRecord() = default;
+    LogRecord(Type type, int first = 0, int second = 0, int third = 0);
+    // For types with free text or bits the values follow the text
+    LogRecord(Type type, const std::string& text, int first = 0, int second = 0);
+
+    Type getType() const { return type; }
+    int getValue(int index) const { return values[index]; }
+    const std::string& getText() const { return text; }
+
+    std::string render() const;
+    // The record a rendered line came from, free text when no type renders to it
+    static LogRecord parse(const std::string& line);
+
+    // Appends the record in binary. Bits are packed eight to a byte, numbers are varints.
+    void encode(std::string& out) const;
+    // Reads one record and moves p past it, false when the bytes are not a valid record
+    static bool decode(const char*& p, const char* end, LogRecord& record);
+
+private:
+    bool scan(const std::string& line);
+
+    Type type = Type::Text;
+    int values[3] = { 0, 0, 0 };
+    std::string text;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "LogView.h"
+
+#include <algorithm>
+#include <string>
+
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QTimer>
+#include <QVector>
+
+static const int TEXT_MARGIN = 6;
+
+LogView::LogView(LogIndex* index, QWidget* parent)
+    : QAbstractScrollArea(parent), index(index), rowCount(0), firstRow(0), scrollUnit(1), updatingScrollBar(false),
+    widestLine(0), highlightLine(LogIndex::NONE), highlightCaseSensitive(false)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    QFontMetrics metrics(font());
+    lineHeight = std::max(1, metrics.height());
+    charWidth = std::max(1, metrics.horizontalAdvance('0'));
+
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+}
+
+int LogView::visibleRows() const
+{
+    return std::max(1, viewport()->height() / lineHeight);
+}
+
+int LogView::gutterWidth() const
+{
+    int digits = static_cast<int>(std::to_string(std::max<uint64_t>(index->getLineCount(), 1)).size());
+    return digits * charWidth + 2 * TEXT_MARGIN;
+}
+
+uint64_t LogView::lastFirstRow() const
+{
+    uint64_t visible = static_cast<uint64_t>(visibleRows());
+    return rowCount > visible ? rowCount - visible : 0;
+}
+
+void LogView::refresh()
+{
+    uint64_t rows = index->getRowCount();
+    if (rows == rowCount) {
+        return;
+    }
+
+    bool following = firstRow >= lastFirstRow();
+    rowCount = rows;
+    if (following || firstRow > lastFirstRow()) {
+        firstRow = lastFirstRow();
+    }
+
+    updateScrollBars();
+    viewport()->update();
+}
+
+void LogView::scrollToRow(uint64_t row)
+{
+    // A third of the page above the row keeps some context in view
+    uint64_t above = static_cast<uint64_t>(visibleRows() / 3);
+    firstRow = std::min(row > above ? row - above : 0, lastFirstRow());
+
+    updateScrollBars();
+    viewport()->update();
+}
+
+void LogView::setHighlight(uint64_t line, const QString& text, bool caseSensitive)
+{
+    highlightLine = line;
+    highlightText = text;
+    highlightCaseSensitive = caseSensitive;
+    viewport()->update();
+}
+
+void LogView::updateScrollBars()
+{
+    updatingScrollBar = true;
+
+    scrollUnit = std::max<uint64_t>(1, rowCount >> 30);
+    QScrollBar* vertical = verticalScrollBar();
+    vertical->setRange(0, static_cast<int>(lastFirstRow() / scrollUnit));
+    vertical->setPageStep(std::max(1, static_cast<int>(visibleRows() / scrollUnit)));
+    vertical->setSingleStep(1);
+    vertical->setValue(static_cast<int>(firstRow / scrollUnit));
+
+    int textWidth = gutterWidth() + widestLine * charWidth + 2 * TEXT_MARGIN;
+    QScrollBar* horizontal = horizontalScrollBar();
+    horizontal->setRange(0, std::max(0, textWidth - viewport()->width()));
+    horizontal->setPageStep(viewport()->width());
+    horizontal->setSingleStep(charWidth);
+
+    updatingScrollBar = false;
+}
+
+void LogView::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx);
+
+    if (dy != 0 && !updatingScrollBar) {
+        QScrollBar* vertical = verticalScrollBar();
+        firstRow = vertical->value() == vertical->maximum() ? lastFirstRow() : static_cast<uint64_t>(vertical->value()) * scrollUnit;
+    }
+    viewport()->update();
+}
+
+void LogView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    firstRow = std::min(firstRow, lastFirstRow());
+    updateScrollBars();
+}
+
+void LogView::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), palette().base());
+
+    if (rowCount == 0) {
+        painter.setPen(palette().text().color());
+        painter.drawText(viewport()->rect(), Qt::AlignCenter, "No log lines");
+        return;
+    }
+
+    int width = viewport()->width();
+    int gutter = gutterWidth();
+    int textX = gutter + TEXT_MARGIN - horizontalScrollBar()->value();
+    int ascent = QFontMetrics(font()).ascent();
+    int widest = widestLine;
+    QVector<uint64_t> lines;
+
+    painter.setClipRect(gutter, 0, width - gutter, viewport()->height());
+    for (int i = 0; i <= visibleRows() && firstRow + i < rowCount; ++i) {
+        uint64_t line = index->lineOfRow(firstRow + i);
+        if (line == LogIndex::NONE) {
+            break;
+        }
+        lines.append(line);
+
+        std::string bytes = index->readLine(line);
+        QString text = QString::fromLatin1(bytes.data(), static_cast<int>(bytes.size()));
+        widest = std::max(widest, static_cast<int>(text.size()));
+        int top = i * lineHeight;
+
+        if (line == highlightLine) {
+            painter.fillRect(gutter, top, width - gutter, lineHeight, palette().alternateBase());
+
+            Qt::CaseSensitivity sensitivity = highlightCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+            int column = highlightText.isEmpty() ? -1 : static_cast<int>(text.indexOf(highlightText, 0, sensitivity));
+            if (column >= 0) {
+                painter.fillRect(textX + column * charWidth, top, static_cast<int>(highlightText.size()) * charWidth, lineHeight,
+                    palette().highlight());
+            }
+        }
+
+        painter.setPen(palette().text().color());
+        painter.drawText(textX, top + ascent, text);
+    }
+    painter.setClipping(false);
+
+    painter.fillRect(0, 0, gutter, viewport()->height(), palette().window());
+    painter.setPen(palette().windowText().color());
+    for (int i = 0; i < lines.size(); ++i) {
+        painter.drawText(QRect(0, i * lineHeight, gutter - TEXT_MARGIN, lineHeight), Qt::AlignRight | Qt::AlignVCenter,
+            QString::number(lines[i] + 1));
+    }
+
+    // The scroll range follows the longest line seen, changed once painting is done
+    if (widest > widestLine) {
+        widestLine = widest;
+        QTimer::singleShot(0, this, [this]() { updateScrollBars(); });
+    }
+}
\ No newline at end of file
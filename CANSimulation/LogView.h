@@ -0,0 +1,54 @@
+#ifndef LOG_VIEW_H
+#define LOG_VIEW_H
+
+#include <cstdint>
+
+#include <QAbstractScrollArea>
+#include <QPainter>
+#include <QString>
+
+#include "LogIndex.h"
+
+// Rows of a LogIndex with their line numbers. Only the rows on screen are read from the
+// mapped log when painting, so the view costs the same for any log size. While the last
+// row is on screen the view follows the log as lines are appended.
+class LogView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit LogView(LogIndex* index, QWidget* parent = nullptr);
+
+    // Picks up the rows indexed since the last call
+    void refresh();
+
+    void scrollToRow(uint64_t row);
+    uint64_t getFirstRow() const { return firstRow; }
+
+    // Marks a line and the text found in it, LogIndex::NONE clears the mark
+    void setHighlight(uint64_t line, const QString& text, bool caseSensitive);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    void updateScrollBars();
+    int visibleRows() const;
+    int gutterWidth() const;
+    uint64_t lastFirstRow() const;
+
+    LogIndex* index;
+    uint64_t rowCount;
+    uint64_t firstRow;
+    uint64_t scrollUnit;            // rows per scroll bar step, so any row count fits an int range
+    bool updatingScrollBar;
+    int lineHeight;
+    int charWidth;
+    int widestLine;                 // longest line painted so far, in characters
+    uint64_t highlightLine;
+    QString highlightText;
+    bool highlightCaseSensitive;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "LogViewer.h"
+
+#include <string>
+#include <utility>
+
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+static const int POLL_INTERVAL = 200;
+static const uint64_t SEARCH_SLICE = 8 * 1024 * 1024;      // bytes searched per pass of the event loop
+static const int MAX_ID = 0x7FF;
+
+static int percent(uint64_t part, uint64_t whole)
+{
+    return whole == 0 ? 100 : static_cast<int>(part * 100 / whole);
+}
+
+LogViewer::LogViewer(const QString& path, QWidget* parent)
+    : QWidget(parent), index(new LogIndex(path.toStdString())), generation(0), anchorLine(LogIndex::NONE),
+    searchCaseSensitive(false), searchOffset(0), searchStart(0), searchWrapped(false), matchOffset(LogIndex::NONE)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    nodeBox = new QSpinBox(this);
+    nodeBox->setRange(0, 255);
+    nodeBox->setSpecialValueText("Any");
+    idEdit = new QLineEdit(this);
+    idEdit->setPlaceholderText("Any, e.g. 0x1A4");
+    idEdit->setMaximumWidth(120);
+
+    eventBox = new QComboBox(this);
+    eventBox->addItem("All events", LogIndex::ALL_EVENTS);
+    const std::pair<const char*, LogIndex::EventType> events[] = {
+        { "Rounds", LogIndex::EventType::Round },
+        { "Arbitration", LogIndex::EventType::Arbitration },
+        { "Transmission", LogIndex::EventType::Transmission },
+        { "Reception", LogIndex::EventType::Reception },
+        { "Errors", LogIndex::EventType::Error },
+        { "Error counters", LogIndex::EventType::Counters },
+        { "Session", LogIndex::EventType::Session },
+        { "Other", LogIndex::EventType::Other },
+    };
+    for (const auto& event : events) {
+        eventBox->addItem(event.first, 1u << static_cast<int>(event.second));
+    }
+
+    roundBox = new QSpinBox(this);
+    roundBox->setRange(0, 1000000000);
+    QPushButton* roundButton = new QPushButton("Go to Round", this);
+
+    filterLayout->addWidget(new QLabel("Node", this));
+    filterLayout->addWidget(nodeBox);
+    filterLayout->addWidget(new QLabel("ID", this));
+    filterLayout->addWidget(idEdit);
+    filterLayout->addWidget(eventBox);
+    filterLayout->addStretch();
+    filterLayout->addWidget(roundBox);
+    filterLayout->addWidget(roundButton);
+    layout->addLayout(filterLayout);
+
+    QHBoxLayout* searchLayout = new QHBoxLayout();
+    searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText("Search");
+    searchEdit->setClearButtonEnabled(true);
+    caseBox = new QCheckBox("Match case", this);
+    QPushButton* nextButton = new QPushButton("Find Next", this);
+    searchLayout->addWidget(searchEdit);
+    searchLayout->addWidget(caseBox);
+    searchLayout->addWidget(nextButton);
+    layout->addLayout(searchLayout);
+
+    view = new LogView(index, this);
+    layout->addWidget(view);
+
+    statusLabel = new QLabel(this);
+    layout->addWidget(statusLabel);
+
+    connect(nodeBox, &QSpinBox::valueChanged, this, &LogViewer::applyFilter);
+    connect(idEdit, &QLineEdit::editingFinished, this, &LogViewer::applyFilter);
+    connect(eventBox, &QComboBox::currentIndexChanged, this, &LogViewer::applyFilter);
+    connect(roundButton, &QPushButton::clicked, this, &LogViewer::goToRound);
+    connect(searchEdit, &QLineEdit::textChanged, this, [this]() { startSearch(false); });
+    connect(searchEdit, &QLineEdit::returnPressed, this, [this]() { startSearch(true); });
+    connect(nextButton, &QPushButton::clicked, this, [this]() { startSearch(true); });
+    connect(caseBox, &QCheckBox::toggled, this, [this]() { startSearch(false); });
+
+    searchTimer = new QTimer(this);
+    connect(searchTimer, &QTimer::timeout, this, &LogViewer::continueSearch);
+
+    pollTimer = new QTimer(this);
+    connect(pollTimer, &QTimer::timeout, this, &LogViewer::poll);
+    pollTimer->start(POLL_INTERVAL);
+
+    updateStatus();
+}
+
+LogViewer::~LogViewer()
+{
+    delete view;
+    delete index;
+}
+
+void LogViewer::applyFilter()
+{
+    LogIndex::Filter filter;
+    filter.nodeId = nodeBox->value();
+    filter.eventTypes = eventBox->currentData().toUInt();
+
+    QString idText = idEdit->text().trimmed();
+    if (!idText.isEmpty()) {
+        bool valid = false;
+        int id = idText.startsWith("0x", Qt::CaseInsensitive) ? idText.mid(2).toInt(&valid, 16) : idText.toInt(&valid, 10);
+        if (!valid || id < 0 || id > MAX_ID) {
+            message = "Identifiers are 0 to 2047, decimal or 0x hexadecimal";
+            updateStatus();
+            return;
+        }
+        filter.messageId = id;
+    }
+
+    LogIndex::Filter current = index->getFilter();
+    if (filter.nodeId == current.nodeId && filter.messageId == current.messageId && filter.eventTypes == current.eventTypes) {
+        return;
+    }
+
+    // The line at the top stays in view once the new filter has got that far
+    anchorLine = index->lineOfRow(view->getFirstRow());
+    index->setFilter(filter);
+    message.clear();
+
+    view->refresh();
+    view->viewport()->update();
+    updateStatus();
+}
+
+void LogViewer::goToRound()
+{
+    int round = roundBox->value();
+    uint64_t top = index->lineOfRow(view->getFirstRow());
+    uint64_t line = index->findRound(round, top == LogIndex::NONE ? 0 : top + 1);
+
+    if (line == LogIndex::NONE) {
+        message = QString("Round %1 is not in the log").arg(round);
+    }
+    else {
+        if (line < index->getFilteredLines()) {
+            view->scrollToRow(index->rowAtLine(line));
+        }
+        else {
+            anchorLine = line;
+        }
+        message = QString("Round %1 at line %2").arg(round).arg(line + 1);
+    }
+    updateStatus();
+}
+
+void LogViewer::startSearch(bool next)
+{
+    searchText = searchEdit->text();
+    searchCaseSensitive = caseBox->isChecked();
+    searchTimer->stop();
+
+    if (searchText.isEmpty()) {
+        matchOffset = LogIndex::NONE;
+        view->setHighlight(LogIndex::NONE, QString(), false);
+        message.clear();
+        updateStatus();
+        return;
+    }
+
+    // Typing on keeps the current match while it still matches, Find Next moves past it
+    if (matchOffset != LogIndex::NONE) {
+        searchStart = next ? matchOffset + 1 : matchOffset;
+    }
+    else {
+        uint64_t top = index->lineOfRow(view->getFirstRow());
+        searchStart = top == LogIndex::NONE ? 0 : index->offsetOfLine(top);
+    }
+
+    searchOffset = searchStart;
+    searchWrapped = false;
+    searchTimer->start(0);
+}
+
+void LogViewer::continueSearch()
+{
+    std::string text = searchText.toStdString();
+    uint64_t end = index->getIndexedBytes();
+
+    uint64_t match = index->find(text, searchCaseSensitive, searchOffset, SEARCH_SLICE);
+    if (match != LogIndex::NONE && !(searchWrapped && match >= searchStart)) {
+        uint64_t line = index->lineOfOffset(match);
+        uint64_t row = index->rowOfLine(line);
+
+        if (row == LogIndex::NONE) {
+            // Filtered out, or the filter has not reached the line yet and the match is tried again
+            bool waiting = line >= index->getFilteredLines();
+            if (waiting) {
+                searchOffset = match;
+            }
+            searchTimer->start(waiting ? POLL_INTERVAL : 0);
+            return;
+        }
+
+        searchTimer->stop();
+        matchOffset = match;
+        view->setHighlight(line, searchText, searchCaseSensitive);
+        view->scrollToRow(row);
+        message = QString("Found at line %1").arg(line + 1);
+        updateStatus();
+        return;
+    }
+
+    if (searchOffset >= end && !searchWrapped) {
+        searchWrapped = true;
+        searchOffset = 0;
+    }
+
+    if (searchWrapped && searchOffset >= searchStart) {
+        searchTimer->stop();
+        matchOffset = LogIndex::NONE;
+        view->setHighlight(LogIndex::NONE, QString(), false);
+        message = QString("\"%1\" not found").arg(searchText);
+        updateStatus();
+        return;
+    }
+
+    uint64_t searched = searchWrapped ? end - searchStart + searchOffset : searchOffset - searchStart;
+    message = QString("Searching %1%").arg(percent(searched, end));
+    searchTimer->start(0);
+    updateStatus();
+}
+
+void LogViewer::poll()
+{
+    // A log that was started over has none of the old positions
+    unsigned current = index->getGeneration();
+    if (current != generation) {
+        generation = current;
+        anchorLine = LogIndex::NONE;
+        matchOffset = LogIndex::NONE;
+        searchTimer->stop();
+        view->setHighlight(LogIndex::NONE, QString(), false);
+    }
+
+    view->refresh();
+
+    if (anchorLine != LogIndex::NONE && index->getFilteredLines() > anchorLine) {
+        view->scrollToRow(index->rowAtLine(anchorLine));
+        anchorLine = LogIndex::NONE;
+    }
+
+    updateStatus();
+}
+
+void LogViewer::updateStatus()
+{
+    uint64_t lines = index->getLineCount();
+    uint64_t indexed = index->getIndexedBytes();
+    uint64_t size = index->getFileSize();
+
+    QString status = QString("%1 lines").arg(lines);
+    if (indexed < size) {
+        status += QString(", indexing %1%").arg(percent(indexed, size));
+    }
+
+    if (index->getFilter().isActive()) {
+        status += QString(", %1 matching").arg(index->getRowCount());
+
+        uint64_t filtered = index->getFilteredLines();
+        if (filtered < lines) {
+            status += QString(", filtering %1%").arg(percent(filtered, lines));
+        }
+    }
+
+    if (!message.isEmpty()) {
+        status += " - " + message;
+    }
+    statusLabel->setText(status);
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef LOG_VIEWER_H
+#define LOG_VIEWER_H
+
+#include <cstdint>
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QString>
+#include <QTimer>
+#include <QWidget>
+
+#include "LogIndex.h"
+#include "LogView.h"
+
+// Built-in viewer of the simulation log: filters by node, identifier and event type, jumps
+// to rounds and searches as you type. Indexing, filtering and search all proceed in the
+// background or in slices, so the window stays responsive on logs of any size and keeps
+// showing lines as the simulation appends them.
+class LogViewer : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit LogViewer(const QString& path, QWidget* parent = nullptr);
+    ~LogViewer();
+
+private:
+    void applyFilter();
+    void goToRound();
+    void startSearch(bool next);
+    void continueSearch();
+    void poll();
+    void updateStatus();
+
+    LogIndex* index;
+    LogView* view;
+    QSpinBox* nodeBox;
+    QLineEdit* idEdit;
+    QComboBox* eventBox;
+    QSpinBox* roundBox;
+    QLineEdit* searchEdit;
+    QCheckBox* caseBox;
+    QLabel* statusLabel;
+    QTimer* pollTimer;
+    QTimer* searchTimer;
+
+    unsigned generation;
+    uint64_t anchorLine;            // top line to return to once a new filter has reached it
+    QString searchText;
+    bool searchCaseSensitive;
+    uint64_t searchOffset;          // where the next search slice starts
+    uint64_t searchStart;           // the search gives up after wrapping around to here
+    bool searchWrapped;
+    uint64_t matchOffset;
+    QString message;                // result of the last search or jump, shown with the counts
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+#ifdef _WIN32
+    : file(INVALID_HANDLE_VALUE), mapping(nullptr),
+#else
+    : descriptor(-1),
+#endif
+    opened(false), fileSize(0), view(nullptr), viewLength(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length > 0 ? length : 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], length);
+
+    // Logs are read while the simulation still appends to them and may be rotated away
+    file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::invalid_argument("Cannot open file: " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        throw std::invalid_argument("Cannot read the size of file: " + path);
+    }
+    fileSize = static_cast<uint64_t>(size.QuadPart);
+
+    // Empty files cannot be mapped, there is nothing to read from them anyway
+    if (fileSize > 0) {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            close();
+            throw std::invalid_argument("Cannot map file: " + path);
+        }
+    }
+#else
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::invalid_argument("Cannot open file: " + path);
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        close();
+        throw std::invalid_argument("Cannot read the size of file: " + path);
+    }
+    fileSize = static_cast<uint64_t>(status.st_size);
+#endif
+
+    opened = true;
+}
+
+void MappedFile::close()
+{
+    unmap();
+
+#ifdef _WIN32
+    if (mapping) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+#endif
+
+    opened = false;
+    fileSize = 0;
+}
+
+uint64_t MappedFile::refresh()
+{
+    if (!opened) {
+        throw std::invalid_argument("File is not open");
+    }
+
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        throw std::invalid_argument("Cannot read the size of the file");
+    }
+    uint64_t newSize = static_cast<uint64_t>(size.QuadPart);
+#else
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        throw std::invalid_argument("Cannot read the size of the file");
+    }
+    uint64_t newSize = static_cast<uint64_t>(status.st_size);
+#endif
+
+    if (newSize == fileSize) {
+        return fileSize;
+    }
+
+    unmap();
+    fileSize = newSize;
+
+#ifdef _WIN32
+    // A mapping object keeps the size the file had when it was created
+    if (mapping) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+    }
+    if (fileSize > 0) {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            throw std::invalid_argument("Cannot map the file");
+        }
+    }
+#endif
+
+    return fileSize;
+}
+
+const char* MappedFile::map(uint64_t offset, size_t length)
+{
+    if (!opened) {
+        throw std::invalid_argument("File is not open");
+    }
+    if (offset % ALIGNMENT != 0 || length == 0 || offset + length > fileSize) {
+        throw std::invalid_argument("Invalid mapping window");
+    }
+
+    unmap();
+
+#ifdef _WIN32
+    view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32),
+        static_cast<DWORD>(offset & 0xFFFFFFFF), length);
+    if (!view) {
+        throw std::invalid_argument("Cannot map file window");
+    }
+#else
+    view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, static_cast<off_t>(offset));
+    if (view == MAP_FAILED) {
+        view = nullptr;
+        throw std::invalid_argument("Cannot map file window");
+    }
+    madvise(view, length, MADV_SEQUENTIAL);
+#endif
+
+    viewLength = length;
+    return static_cast<const char*>(view);
+}
+
+void MappedFile::unmap()
+{
+    if (!view) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap(view, viewLength);
+#endif
+
+    view = nullptr;
+    viewLength = 0;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a file through a single movable window, so files of any
+// size can be scanned with a fixed amount of address space
+class MappedFile {
+public:
+    // Window offsets must be multiples of this (the Windows allocation granularity)
+    static const size_t ALIGNMENT = 64 * 1024;
+
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void open(const std::string& path);
+    void close();
+
+    // Picks up a change in size of a file that is still being written, the current
+    // window has to be mapped again when the size changed
+    uint64_t refresh();
+
+    // Unmaps the previous window and maps length bytes starting at offset
+    const char* map(uint64_t offset, size_t length);
+
+    uint64_t size() const { return fileSize; }
+    bool isOpen() const { return opened; }
+
+private:
+    void unmap();
+
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#else
+    int descriptor;
+#endif
+    bool opened;
+    uint64_t fileSize;
+    void* view;
+    size_t viewLength;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "MessageTableModel.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <QTimer>
+
+static const uint64_t CANCELLED = UINT64_MAX;
+static const int FLUSH_INTERVAL = 16;           // milliseconds, one display frame at 60 Hz
+static const size_t MAX_REMOVED_RANGES = 32;    // beyond this a reset is cheaper for the views
+
+MessageTableModel::MessageTableModel(QObject* parent)
+    : QAbstractTableModel(parent), flushScheduled(false)
+{
+}
+
+uint64_t MessageTableModel::key(int nodeId, uint16_t id, int round)
+{
+    return (static_cast<uint64_t>(static_cast<uint16_t>(nodeId)) << 48) |
+        (static_cast<uint64_t>(static_cast<uint32_t>(round)) << 16) | id;
+}
+
+bool MessageTableModel::contains(int nodeId, uint16_t id, int round) const
+{
+    uint64_t frame = key(nodeId, id, round);
+    return rowOf.count(frame) != 0 || addedAt.count(frame) != 0;
+}
+
+bool MessageTableModel::addMessage(int nodeId, uint16_t id, int round)
+{
+    if (contains(nodeId, id, round)) {
+        return false;
+    }
+
+    uint64_t frame = key(nodeId, id, round);
+    addedAt[frame] = added.size();
+    added.push_back(frame);
+    scheduleFlush();
+    return true;
+}
+
+bool MessageTableModel::removeMessage(int nodeId, uint16_t id, int round)
+{
+    uint64_t frame = key(nodeId, id, round);
+
+    auto queued = addedAt.find(frame);
+    if (queued != addedAt.end()) {
+        added[queued->second] = CANCELLED;
+        addedAt.erase(queued);
+        return true;
+    }
+
+    auto listed = rowOf.find(frame);
+    if (listed == rowOf.end()) {
+        return false;
+    }
+
+    removedRows.push_back(listed->second);
+    rowOf.erase(listed);
+    scheduleFlush();
+    return true;
+}
+
+void MessageTableModel::scheduleFlush()
+{
+    if (!flushScheduled) {
+        flushScheduled = true;
+        QTimer::singleShot(FLUSH_INTERVAL, this, [this]() { flush(); });
+    }
+}
+
+void MessageTableModel::flush()
+{
+    flushScheduled = false;
+    applyRemovals();
+    applyAdditions();
+}
+
+void MessageTableModel::applyRemovals()
+{
+    if (removedRows.empty()) {
+        return;
+    }
+
+    std::sort(removedRows.begin(), removedRows.end(), std::greater<int>());
+    int firstChanged = removedRows.back();
+
+    // Contiguous runs, last one first so earlier row numbers stay valid
+    std::vector<std::pair<int, int>> ranges;
+    for (int row : removedRows) {
+        if (!ranges.empty() && ranges.back().first == row + 1) {
+            ranges.back().first = row;
+        }
+        else {
+            ranges.push_back({ row, row });
+        }
+    }
+    removedRows.clear();
+
+    if (ranges.size() > MAX_REMOVED_RANGES) {
+        beginResetModel();
+        for (const auto& range : ranges) {
+            nodeIds.erase(nodeIds.begin() + range.first, nodeIds.begin() + range.second + 1);
+            ids.erase(ids.begin() + range.first, ids.begin() + range.second + 1);
+            rounds.erase(rounds.begin() + range.first, rounds.begin() + range.second + 1);
+        }
+        endResetModel();
+    }
+    else {
+        for (const auto& range : ranges) {
+            beginRemoveRows(QModelIndex(), range.first, range.second);
+            nodeIds.erase(nodeIds.begin() + range.first, nodeIds.begin() + range.second + 1);
+            ids.erase(ids.begin() + range.first, ids.begin() + range.second + 1);
+            rounds.erase(rounds.begin() + range.first, rounds.begin() + range.second + 1);
+            endRemoveRows();
+        }
+    }
+
+    // Rows before the first removal kept their numbers
+    for (int row = firstChanged; row < static_cast<int>(nodeIds.size()); ++row) {
+        rowOf[key(nodeIds[row], ids[row], rounds[row])] = row;
+    }
+}
+
+void MessageTableModel::applyAdditions()
+{
+    added.erase(std::remove(added.begin(), added.end(), CANCELLED), added.end());
+    addedAt.clear();
+    if (added.empty()) {
+        return;
+    }
+
+    int first = static_cast<int>(nodeIds.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+    for (uint64_t frame : added) {
+        rowOf[frame] = static_cast<int>(nodeIds.size());
+        nodeIds.push_back(static_cast<int>(static_cast<int16_t>(frame >> 48)));
+        rounds.push_back(static_cast<int>(static_cast<uint32_t>(frame >> 16)));
+        ids.push_back(static_cast<uint16_t>(frame & 0xFFFF));
+    }
+    endInsertRows();
+
+    added.clear();
+}
+
+int MessageTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(nodeIds.size());
+}
+
+int MessageTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant MessageTableModel::data(const QModelIndex& index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= static_cast<int>(nodeIds.size())) {
+        return QVariant();
+    }
+
+    switch (index.column()) {
+    case NodeColumn:
+        return nodeIds[index.row()];
+    case IdColumn:
+        return QString::number(ids[index.row()], 2).rightJustified(11, '0');
+    case RoundColumn:
+        return rounds[index.row()];
+    default:
+        return QVariant();
+    }
+}
+
+QVariant MessageTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case NodeColumn:
+        return QString("Node ID");
+    case IdColumn:
+        return QString("Message ID");
+    case RoundColumn:
+        return QString("Initial Round");
+    default:
+        return QVariant();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef MESSAGE_TABLE_MODEL_H
+#define MESSAGE_TABLE_MODEL_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <QAbstractTableModel>
+
+// Frames shown in the message panel, one row per (node, ID, round). Columns are stored
+// separately and text is only made for the rows a view draws. Additions and removals
+// are collected and applied together on the next display frame, so a replay tick that
+// moves a frame between tables costs one hash lookup and at most one view update.
+class MessageTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { NodeColumn, IdColumn, RoundColumn, ColumnCount };
+
+    explicit MessageTableModel(QObject* parent = nullptr);
+
+    // False if the frame is already listed
+    bool addMessage(int nodeId, uint16_t id, int round);
+
+    // False if the frame is not listed
+    bool removeMessage(int nodeId, uint16_t id, int round);
+
+    bool contains(int nodeId, uint16_t id, int round) const;
+
+    // Applies the queued changes now instead of on the next display frame
+    void flush();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    static uint64_t key(int nodeId, uint16_t id, int round);
+
+    void scheduleFlush();
+    void applyRemovals();
+    void applyAdditions();
+
+    std::vector<int> nodeIds;
+    std::vector<uint16_t> ids;
+    std::vector<int> rounds;
+    std::unordered_map<uint64_t, int> rowOf;       // key -> row of a listed frame
+
+    std::vector<int> removedRows;
+    std::vector<uint64_t> added;                    // keys queued for the end of the table
+    std::unordered_map<uint64_t, size_t> addedAt;   // key -> position in added while still queued
+    bool flushScheduled;
+};
+
+#endif
\ No newline at end of file
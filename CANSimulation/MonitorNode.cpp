@@ -0,0 +1,73 @@
+#include "MonitorNode.h"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+MonitorNode::MonitorNode(const std::string& name, const std::string& filter, size_t capacity)
+    : name(name), filter(filter), capacity(capacity), framesSeen(0), framesMatched(0), next(0)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("Monitor " + name + " needs room for at least one frame");
+    }
+}
+
+void MonitorNode::observe(const FrameFilter::Frame& frame)
+{
+    // Only the simulation thread writes the counts, so they are stored without a locked add
+    framesSeen.store(framesSeen.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (!filter.matches(frame)) {
+        return;
+    }
+    framesMatched.store(framesMatched.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (captured.size() < capacity) {
+        captured.push_back(frame);
+        return;
+    }
+    captured[next] = frame;
+    next = (next + 1) % capacity;
+}
+
+std::vector<FrameFilter::Frame> MonitorNode::getCapturedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<FrameFilter::Frame> frames(captured.begin() + next, captured.end());
+    frames.insert(frames.end(), captured.begin(), captured.begin() + next);
+    return frames;
+}
+
+bool MonitorNode::exportCsv(const std::string& path) const
+{
+    std::ofstream file(path);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    writeCsv(file);
+    return true;
+}
+
+void MonitorNode::writeCsv(std::ostream& out) const
+{
+    out << "round,id,sender,dlc,data,delivered,error,crc_errors,receivers\n";
+
+    for (const FrameFilter::Frame& frame : getCapturedFrames()) {
+        const int32_t* values = frame.values;
+        out << values[FrameFilter::Round] << ",0x" << std::hex << std::uppercase << std::setfill('0')
+            << std::setw(3) << values[FrameFilter::Id] << std::dec << "," << values[FrameFilter::Sender] << ","
+            << values[FrameFilter::Dlc] << ",";
+
+        out << std::hex;
+        for (int i = 0; i < values[FrameFilter::Dlc] && i < 8; ++i) {
+            out << std::setw(2) << values[FrameFilter::Data0 + i];
+        }
+        out << std::dec << std::nouppercase << std::setfill(' ');
+
+        out << "," << values[FrameFilter::Delivered] << "," << values[FrameFilter::Error] << ","
+            << values[FrameFilter::CrcErrors] << ",0x" << std::hex << std::setfill('0') << std::setw(2)
+            << values[FrameFilter::Receivers] << std::dec << std::setfill(' ') << "\n";
+    }
+}
\ No newline at end of file
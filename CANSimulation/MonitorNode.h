@@ -0,0 +1,52 @@
+#ifndef MONITOR_NODE_H
+#define MONITOR_NODE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "FrameFilter.h"
+
+// A passive node that sees every frame the bus delivers and keeps the latest ones its filter
+// matches. It never acknowledges or sends, so watching does not change the run. Observed
+// from the simulation thread, the counts and captured frames can be read while it runs.
+class MonitorNode {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1000;
+
+    // Throws std::invalid_argument when the filter does not compile
+    MonitorNode(const std::string& name, const std::string& filter, size_t capacity = DEFAULT_CAPACITY);
+
+    MonitorNode(const MonitorNode&) = delete;
+    MonitorNode& operator=(const MonitorNode&) = delete;
+
+    void observe(const FrameFilter::Frame& frame);
+
+    const std::string& getName() const { return name; }
+    const FrameFilter& getFilter() const { return filter; }
+    uint64_t getFramesSeen() const { return framesSeen.load(std::memory_order_relaxed); }
+    uint64_t getFramesMatched() const { return framesMatched.load(std::memory_order_relaxed); }
+
+    // Oldest first
+    std::vector<FrameFilter::Frame> getCapturedFrames() const;
+
+    bool exportCsv(const std::string& path) const;
+    void writeCsv(std::ostream& out) const;
+
+private:
+    std::string name;
+    FrameFilter filter;
+    size_t capacity;
+
+    std::atomic<uint64_t> framesSeen;
+    std::atomic<uint64_t> framesMatched;
+
+    mutable std::mutex mutex;
+    std::vector<FrameFilter::Frame> captured;   // ring once full, oldest at next
+    size_t next;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Layout of one signal inside a frame payload, as a DBC file describes it
+struct SignalDefinition {
+    enum class ByteOrder { Intel, Motorola };
+    enum class ValueType { Integer, Float, Double };
+
+    std::string name;
+    int startBit = 0;                   // DBC numbering: LSB for Intel, MSB for Motorola
+    int length = 0;
+    ByteOrder byteOrder = ByteOrder::Intel;
+    bool isSigned = false;
+    ValueType valueType = ValueType::Integer;
+    double factor = 1.0;
+    double offset = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    std::string unit;
+    int multiplexValue = -1;            // -1 if the signal is always present
+    bool multiplexer = false;
+};
+
+struct MessageDefinition {
+    uint32_t id = 0;
+    bool extended = false;
+    std::string name;
+    int dataLength = 0;
+    int transmitter = -1;               // index into NetworkDefinition::nodes, -1 if no node sends it
+    int cycleTime = 0;                  // milliseconds, 0 if the message is not periodic
+    std::vector<SignalDefinition> signalDefinitions;
+};
+
+struct NetworkDefinition {
+    std::vector<std::string> nodes;
+    std::vector<MessageDefinition> messages;
+
+    // Extended identifiers are looked up with bit 31 set, as DBC files write them
+    const MessageDefinition* findMessage(uint32_t id) const
+    {
+        auto found = messageIndex.find(id);
+        return found == messageIndex.end() ? nullptr : &messages[found->second];
+    }
+
+    std::unordered_map<uint32_t, size_t> messageIndex;
+};
+
+#endif
\ No newline at end of file
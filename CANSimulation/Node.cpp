@@ -1,120 +1,174 @@
-#include "Node.h"
-
-#include <iostream>
-#include <bitset>
-
-#include "CANBus.h"
-#include "ErrorCheck.h"
-
-Node::Node(int id, CANBus* bus) : nodeId(id), canBus(bus) {}
-
-bool Node::receiveMessage(Message& msg) 
-{
-	uint16_t crc = msg.getCRC();
-    int round = msg.getRound();
-	uint16_t id = msg.getId();
-    //qDebug() << "Initial CRC: " << crc;
-
-    Message* message = errorCheck->removeBitStuffing(msg.toString(), nodeError);
-	message->setCRC(crc);
-    message->setRound(round);
-	message->setId(id);
-
-    bool check = false;
-
-	//qDebug() << "NODE ERROR:" << nodeError;
-	uint16_t validCRC = errorCheck->calculateCRC(msg, polynomial, nodeError);
-    if (validCRC == crc)
-    {
-        check = true;
-		receivedMessages.push_back(message);
-        //qDebug() << "Node " << nodeId << "GOT HERE AND PUSHED!" << message->getId() << " " << message->getRound();
-    }
-	//qDebug() << "Valid CRC: " << check;
-
-    return check;
-}
-
-std::string Node::sendNextMessage()
-{
-    if (!messagesToBeSent.empty()) {
-        Message* message = messagesToBeSent.front();
-
-        std::string msgString = errorCheck->applyBitStuffing(*message, nodeError);
-
-        return msgString;
-    }
-}
-
-void Node::removeMessage()
-{
-	if (!messagesToBeSent.empty()) {
-		messagesToBeSent.erase(messagesToBeSent.begin());
-	}
-}
-
-void Node::addNodesAndRound(int round, int nodeId) {
-    nodesAndRounds[round].push_back(nodeId);
-}
-
-std::vector<uint8_t> generateRandomData(size_t size) {
-    std::vector<uint8_t> data(size);
-    std::srand(std::time(nullptr)); 
-
-    for (size_t i = 0; i < size; ++i) {
-        data[i] = std::rand() % 256; 
-    }
-
-    return data;
-}
-
-void Node::generate11BitID() {
-
-    int senderBits = nodeId - 1;
-
-    for (auto& roundEntry : nodesAndRounds) {
-        int round = roundEntry.first;
-        const std::vector<int>& receiverNodeIds = roundEntry.second;
-
-        int receiverBits = 0;
-        for (int receiverId : receiverNodeIds) {
-            receiverBits |= (1 << (receiverId - 1));
-        }
-
-        int identifier = (senderBits << 8) | receiverBits;
-
-        std::vector<uint8_t> randomData = generateRandomData(8);
-
-        Message* message = new Message(identifier, randomData, round, false);
-        message->setSenderId(nodeId);
-
-        uint16_t crc;
-        if (nodeError) {
-            //qDebug() << "GOT HERE!!";
-            crc = 0b0000000000000000;
-        }
-        else {
-            crc = errorCheck->calculateCRC(*message, polynomial, nodeError);
-        }
-
-        message->setCRC(crc);
-   
-		//qDebug() << "Node " << nodeId << " generated message with ID: " << identifier << " and CRC: " << message->getCRC();
-
-        auto it = std::remove_if(messagesToBeSent.begin(), messagesToBeSent.end(), [&](Message* existingMessage) {
-            int bitDifference = existingMessage->getId() ^ identifier;
-            if (((std::bitset<16>(bitDifference).count() == 1) || (std::bitset<16>(bitDifference).count() == 0)) && (existingMessage->getRound() == round)) {
-                qDebug() << "Node " << nodeId << " removed message with ID: " << existingMessage->getId();
-                delete existingMessage;
-                return true;
-            }
-            return false;
-            });
-        messagesToBeSent.erase(it, messagesToBeSent.end());
-
-        messagesToBeSent.push_back(message); 
-    }
-}
-
-int Node::getNodeId() const { return nodeId; }
+#include "Node.h"
+
+#include <iostream>
+#include <algorithm>
+
+#include "CANBus.h"
+#include "ErrorCheck.h"
+
+Node::Node(int id, CANBus* bus) : nodeId(id), canBus(bus) {}
+
+bool Node::receiveMessage(Message& msg) 
+{
+	uint16_t crc = msg.getCRC();
+    int round = msg.getRound();
+	uint16_t id = msg.getId();
+    //qDebug() << "Initial CRC: " << crc;
+
+    Message* message = errorCheck->removeBitStuffing(msg.toString(), nodeError);
+	message->setCRC(crc);
+    message->setRound(round);
+	message->setId(id);
+
+    bool check = false;
+
+	//qDebug() << "NODE ERROR:" << nodeError;
+	uint16_t validCRC = errorCheck->calculateCRC(msg, polynomial, nodeError);
+    if (validCRC == crc)
+    {
+        check = true;
+		receivedMessages.push_back(message);
+        //qDebug() << "Node " << nodeId << "GOT HERE AND PUSHED!" << message->getId() << " " << message->getRound();
+    }
+	//qDebug() << "Valid CRC: " << check;
+
+    return check;
+}
+
+std::string Node::sendNextMessage()
+{
+    if (!messagesToBeSent.empty()) {
+        Message* message = messagesToBeSent.front();
+
+        std::string msgString = errorCheck->applyBitStuffing(*message, nodeError);
+
+        return msgString;
+    }
+}
+
+static uint64_t messageKey(uint16_t id, int round)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(round)) << 16) | id;
+}
+
+void Node::removeMessage()
+{
+	if (!messagesToBeSent.empty()) {
+		messageIndex.erase(messageKey(messagesToBeSent.front()->getId(), messagesToBeSent.front()->getRound()));
+		messagesToBeSent.erase(messagesToBeSent.begin());
+	}
+}
+
+void Node::setNetworkSize(int size)
+{
+    if (size == networkSize) {
+        return;
+    }
+
+    // Frames are only replaced by ones with a similar identifier, so a new layout starts over
+    for (Message* message : messagesToBeSent) {
+        delete message;
+    }
+    messagesToBeSent.clear();
+    messageIndex.clear();
+    for (const auto& roundEntry : nodesAndRounds) {
+        dirtyRounds.insert(roundEntry.first);
+    }
+    networkSize = size;
+}
+
+uint16_t Node::frameIdentifier(int senderId, const std::vector<int>& receiverIds, int networkSize)
+{
+    if (networkSize > COMPACT_NETWORK_SIZE) {
+        return static_cast<uint16_t>(senderId);
+    }
+
+    int receiverBits = 0;
+    for (int receiverId : receiverIds) {
+        if (receiverId >= 1 && receiverId <= COMPACT_NETWORK_SIZE) {
+            receiverBits |= (1 << (receiverId - 1));
+        }
+    }
+    return static_cast<uint16_t>(((senderId - 1) << 8) | receiverBits);
+}
+
+void Node::addNodesAndRound(int round, int nodeId) {
+    nodesAndRounds[round].push_back(nodeId);
+    dirtyRounds.insert(round);
+}
+
+std::vector<uint8_t> generateRandomData(size_t size) {
+    std::vector<uint8_t> data(size);
+
+    // Seeding once per run, reseeding on every frame cost a clock read each time
+    static bool seeded = false;
+    if (!seeded) {
+        std::srand(static_cast<unsigned>(std::time(nullptr)));
+        seeded = true;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = std::rand() % 256; 
+    }
+
+    return data;
+}
+
+void Node::generate11BitID() {
+
+    // The CRC of every queued frame depends on the error flag, so a change regenerates them all
+    if (nodeError != generatedWithError) {
+        for (const auto& roundEntry : nodesAndRounds) {
+            dirtyRounds.insert(roundEntry.first);
+        }
+        generatedWithError = nodeError;
+    }
+
+    for (int round : dirtyRounds) {
+        std::vector<int> receiverNodeIds = nodesAndRounds[round];
+        std::sort(receiverNodeIds.begin(), receiverNodeIds.end());
+        receiverNodeIds.erase(std::unique(receiverNodeIds.begin(), receiverNodeIds.end()), receiverNodeIds.end());
+
+        int identifier = frameIdentifier(nodeId, receiverNodeIds, networkSize);
+
+        std::vector<uint8_t> randomData = generateRandomData(8);
+
+        Message* message = new Message(identifier, randomData, round, false);
+        message->setSenderId(nodeId);
+        message->setReceivers(receiverNodeIds);
+
+        uint16_t crc = errorCheck->calculateCRC(*message, polynomial, nodeError);
+
+        message->setCRC(crc);
+   
+		//qDebug() << "Node " << nodeId << " generated message with ID: " << identifier << " and CRC: " << message->getCRC();
+
+        // Frames of the same round whose ID is equal or one bit away are replaced
+        for (int bit = -1; bit < 16; ++bit) {
+            uint16_t candidate = static_cast<uint16_t>(bit < 0 ? identifier : identifier ^ (1 << bit));
+            auto found = messageIndex.find(messageKey(candidate, round));
+            if (found == messageIndex.end()) {
+                continue;
+            }
+
+            Message* existingMessage = found->second;
+            messageIndex.erase(found);
+
+            auto roundBegin = std::lower_bound(messagesToBeSent.begin(), messagesToBeSent.end(), round,
+                [](const Message* existing, int value) { return existing->getRound() < value; });
+            messagesToBeSent.erase(std::find(roundBegin, messagesToBeSent.end(), existingMessage));
+            delete existingMessage;
+        }
+
+        // Queue stays ordered by round, the order a full regeneration produced
+        auto position = std::upper_bound(messagesToBeSent.begin(), messagesToBeSent.end(), round,
+            [](int value, const Message* existing) { return value < existing->getRound(); });
+        messagesToBeSent.insert(position, message);
+        messageIndex[messageKey(message->getId(), round)] = message;
+    }
+
+    dirtyRounds.clear();
+}
+
+int Node::getNodeId() const { return nodeId; }
 std::vector<Message*>& Node::getReceivedMessages() { return receivedMessages; }
\ No newline at end of file
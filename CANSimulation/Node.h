@@ -1,52 +1,76 @@
-#ifndef NODE_H
-#define NODE_H
-
-#include <queue>
-#include <vector>
-#include <map>
-
-#include "Message.h"
-#include "ErrorCheck.h"
-
-class CANBus;
-
-class Node {
-
-public:
-    Node(int id, CANBus* canBus);
-
-    bool receiveMessage(Message& msg);
-    std::string sendNextMessage();
-    void removeMessage();
-    void addNodesAndRound(int round, int nodeId);
-    bool isQueueEmpty() const { return messagesToBeSent.empty(); };
-    int getNodeId() const;
-    std::vector<Message*>& getReceivedMessages();
-    std::map<int, std::vector<int>> getNodesAndRounds() const { return nodesAndRounds; }
-    std::vector <Message*> getMessagesToBeSent() const { return messagesToBeSent; }
-    void generate11BitID();
-	void incrREC() { REC++; }
-	void incrTEC() { TEC++; }
-	int getREC() const { return REC; }
-	int getTEC() const { return TEC; }
-	void decrementTEC() { if (TEC > 0) TEC--; }
-	void decrementREC() { if (REC > 0) REC--; }
-	void setError(bool val) { nodeError = val; }
-	void setNodeActive(bool val) { nodeActive = val; }
-
-    std::vector<Message*> receivedMessages;
-    int REC = 0;
-    int TEC = 0;
-    bool nodeActive;
-    bool nodeError;
-
-private:
-    int nodeId;
-    std::vector <Message*> messagesToBeSent;
-    std::map<int, std::vector<int>> nodesAndRounds;
-    CANBus* canBus;
-    ErrorCheck* errorCheck = new ErrorCheck();
-    std::string polynomial = "1100000000000010";
-};
-
+#ifndef NODE_H
+#define NODE_H
+
+#include <queue>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+#include "Message.h"
+#include "ErrorCheck.h"
+#include "TransmitQueue.h"
+
+class CANBus;
+
+class Node {
+
+public:
+    // Networks up to this size keep the receivers in the identifier, larger ones in the frame
+    static constexpr int COMPACT_NETWORK_SIZE = 8;
+    static constexpr int MAX_NODES = 0x7FF;
+
+    Node(int id, CANBus* canBus);
+
+    // Identifier of a frame of the round-based engine. Up to COMPACT_NETWORK_SIZE nodes, the
+    // sender goes in the top three bits and each receiver sets one of the eight below. Larger
+    // networks use the sender's id alone, so lower node ids still win arbitration and 0 is
+    // left for rounds without a winner.
+    static uint16_t frameIdentifier(int senderId, const std::vector<int>& receiverIds, int networkSize);
+
+    bool receiveMessage(Message& msg);
+    std::string sendNextMessage();
+    void removeMessage();
+    void addNodesAndRound(int round, int nodeId);
+    bool isQueueEmpty() const { return messagesToBeSent.empty(); };
+    int getNodeId() const;
+    std::vector<Message*>& getReceivedMessages();
+    std::map<int, std::vector<int>> getNodesAndRounds() const { return nodesAndRounds; }
+    std::vector <Message*> getMessagesToBeSent() const { return messagesToBeSent; }
+    void generate11BitID();
+	void incrREC() { REC++; }
+	void incrTEC() { TEC++; }
+	int getREC() const { return REC; }
+	int getTEC() const { return TEC; }
+	void decrementTEC() { if (TEC > 0) TEC--; }
+	void decrementREC() { if (REC > 0) REC--; }
+	void setError(bool val) { nodeError = val; }
+	void setNodeActive(bool val) { nodeActive = val; }
+	void setMailboxes(int count, TransmitQueue::Order order) { transmitQueue.configure(count, order); }
+    // Highest node id on the bus; a change generates every frame again with the new identifiers
+    void setNetworkSize(int size);
+    int getNetworkSize() const { return networkSize; }
+
+    std::vector<Message*> receivedMessages;
+    int REC = 0;
+    int TEC = 0;
+    bool nodeActive;
+    bool nodeError;
+    TransmitQueue transmitQueue;    // released frames; unlimited mailboxes unless configured
+
+private:
+    friend class SimulationCheckpoint;
+
+    int nodeId;
+    std::vector <Message*> messagesToBeSent;
+    std::map<int, std::vector<int>> nodesAndRounds;
+    std::set<int> dirtyRounds;                              // rounds whose frame has to be (re)generated
+    std::unordered_map<uint64_t, Message*> messageIndex;    // (round, ID) -> queued frame
+    bool generatedWithError = false;
+    int networkSize = COMPACT_NETWORK_SIZE;
+    CANBus* canBus;
+    ErrorCheck* errorCheck = new ErrorCheck();
+    std::string polynomial = "1100000000000010";
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "NodeGroupItem.h"
+
+#include <QFont>
+
+#include "CANBus.h"
+
+NodeGroupItem::NodeGroupItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+{
+}
+
+void NodeGroupItem::addNode(NodeConfigWidget* node)
+{
+    nodes.append(node);
+    updateArea();
+}
+
+QVariant NodeGroupItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if (change == ItemVisibleChange && value.toBool()) {
+        updateArea();
+    }
+    return QGraphicsItem::itemChange(change, value);
+}
+
+void NodeGroupItem::updateArea()
+{
+    QRectF nodesArea;
+    for (NodeConfigWidget* node : nodes) {
+        nodesArea = nodesArea.united(node->mapRectToScene(node->boundingRect()));
+    }
+    if (nodesArea != area) {
+        prepareGeometryChange();
+        area = nodesArea;
+    }
+}
+
+QRectF NodeGroupItem::boundingRect() const
+{
+    return area.adjusted(-10, -60, 10, 10);
+}
+
+void NodeGroupItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if (nodes.isEmpty()) {
+        return;
+    }
+
+    painter->setPen(QPen(Qt::white, 0));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(area.adjusted(-10, -10, 10, 10));
+
+    painter->setFont(QFont("Arial", 40, QFont::Bold));
+    painter->drawText(QRectF(area.left(), area.top() - 60, area.width(), 50), Qt::AlignLeft | Qt::AlignVCenter,
+        QString("Nodes %1-%2").arg(nodes.front()->getNodeId()).arg(nodes.back()->getNodeId()));
+
+    painter->setPen(Qt::NoPen);
+    for (NodeConfigWidget* node : nodes) {
+        QColor color = Qt::lightGray;
+        if (!node->isNodeActive()) {
+            color = Qt::red;
+        }
+        else if (node->getTECCount() >= CANBus::TEC_LIMIT || node->getRECCount() >= CANBus::REC_LIMIT) {
+            color = QColor(255, 165, 0);
+        }
+        else if (node->messageReceived) {
+            color = Qt::blue;
+        }
+
+        painter->setBrush(color);
+        painter->drawRect(node->mapRectToScene(node->boundingRect()));
+    }
+}
\ No newline at end of file
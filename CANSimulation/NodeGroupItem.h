@@ -0,0 +1,33 @@
+#ifndef NODE_GROUP_ITEM_H
+#define NODE_GROUP_ITEM_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QVector>
+
+#include "NodeConfigWidget.h"
+
+// Aggregate of one row of nodes for a zoomed out topology view: a frame around the row
+// with its node range and one block per node coloured by its state, drawn as a single item.
+class NodeGroupItem : public QGraphicsItem {
+public:
+    explicit NodeGroupItem(QGraphicsItem* parent = nullptr);
+
+    void addNode(NodeConfigWidget* node);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private:
+    // The nodes can be dragged while the detailed view shows them, so the frame is measured again
+    // whenever the group is about to be shown
+    void updateArea();
+
+    QVector<NodeConfigWidget*> nodes;
+    QRectF area;
+};
+
+#endif
\ No newline at end of file
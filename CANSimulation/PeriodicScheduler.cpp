@@ -0,0 +1,77 @@
+#include "PeriodicScheduler.h"
+
+#include <stdexcept>
+#include <string>
+
+PeriodicScheduler::PeriodicScheduler(uint64_t seed)
+    : generator(seed)
+{
+}
+
+int PeriodicScheduler::addMessage(const PeriodicMessage& message)
+{
+    if (message.period == 0) {
+        throw std::invalid_argument("Period of ID " + std::to_string(message.id) + " must be positive");
+    }
+    if (message.jitter >= message.period) {
+        throw std::invalid_argument("Jitter of ID " + std::to_string(message.id) + " must be shorter than its period");
+    }
+
+    Stream stream;
+    stream.message = message;
+    stream.active = true;
+    streams.push_back(stream);
+
+    int index = static_cast<int>(streams.size()) - 1;
+    scheduleNext(index);
+    return index;
+}
+
+void PeriodicScheduler::removeMessage(int stream)
+{
+    if (stream < 0 || stream >= static_cast<int>(streams.size()) || !streams[stream].active) {
+        return;
+    }
+
+    wheel.cancel(streams[stream].timer);
+    streams[stream].active = false;
+}
+
+void PeriodicScheduler::removeNode(int node)
+{
+    for (size_t i = 0; i < streams.size(); ++i) {
+        if (streams[i].message.node == node) {
+            removeMessage(static_cast<int>(i));
+        }
+    }
+}
+
+void PeriodicScheduler::scheduleNext(int stream)
+{
+    Stream& entry = streams[stream];
+    const PeriodicMessage& message = entry.message;
+
+    uint64_t time = message.offset + entry.nextIndex * message.period;
+    if (message.jitter > 0) {
+        time += std::uniform_int_distribution<uint64_t>(0, message.jitter)(generator);
+    }
+
+    entry.timer = wheel.schedule(time, stream);
+}
+
+void PeriodicScheduler::releaseUntil(uint64_t time, std::vector<Release>& releases)
+{
+    // One tick at a time, so a release that is rescheduled inside the window fires in this call too
+    for (uint64_t next = wheel.nextEventTime(); next <= time; next = wheel.nextEventTime()) {
+        expired.clear();
+        wheel.advance(next, expired);
+
+        for (const TimerWheel::Expired& timer : expired) {
+            Stream& stream = streams[timer.payload];
+            releases.push_back({ timer.payload, stream.message.node, stream.message.id, timer.time, stream.nextIndex });
+
+            stream.nextIndex++;
+            scheduleNext(timer.payload);
+        }
+    }
+}
\ No newline at end of file
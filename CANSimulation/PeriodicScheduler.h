@@ -0,0 +1,63 @@
+#ifndef PERIODIC_SCHEDULER_H
+#define PERIODIC_SCHEDULER_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "TimerWheel.h"
+
+// Periodic transmit schedule of the nodes on a bus, in microseconds. Each stream
+// keeps exactly one pending release in the timer wheel and schedules the next one
+// when it fires, so memory does not depend on how long the simulation runs.
+class PeriodicScheduler {
+public:
+    struct PeriodicMessage {
+        int node;                       // index of the sending node, 0 based
+        uint16_t id;
+        std::vector<uint8_t> data;
+        uint64_t period;
+        uint64_t offset;                // phase of the first release
+        uint64_t jitter;                // each release is delayed by up to this much
+    };
+
+    struct Release {
+        int stream;
+        int node;
+        uint16_t id;
+        uint64_t time;
+        uint64_t index;                 // how many releases of the stream came before
+    };
+
+    explicit PeriodicScheduler(uint64_t seed = 0);
+
+    static uint64_t milliseconds(double value) { return static_cast<uint64_t>(value * 1000.0 + 0.5); }
+
+    int addMessage(const PeriodicMessage& message);
+    void removeMessage(int stream);
+    void removeNode(int node);
+
+    // Appends every release up to and including time, in release order
+    void releaseUntil(uint64_t time, std::vector<Release>& releases);
+    uint64_t nextReleaseTime() const { return wheel.nextEventTime(); }
+
+    const PeriodicMessage& getMessage(int stream) const { return streams[stream].message; }
+    size_t getStreamCount() const { return streams.size(); }
+
+private:
+    struct Stream {
+        PeriodicMessage message;
+        uint64_t nextIndex = 0;
+        int timer = -1;
+        bool active = false;
+    };
+
+    void scheduleNext(int stream);
+
+    std::vector<Stream> streams;
+    TimerWheel wheel;
+    std::vector<TimerWheel::Expired> expired;
+    std::mt19937_64 generator;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "ReplayIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+void ReplayIndex::append(SimulationWorker::Round round)
+{
+    int number = round.round;
+    if (number < getRoundCount()) {
+        return;
+    }
+    extendTo(number - 1);
+
+    size_t first = roundAt.size();
+    size_t delivered = NONE;
+    if (round.winner.getId() != 0) {
+        for (size_t i = 0; i < round.steps.size(); ++i) {
+            if (round.steps[i].bitPosition == 0) {
+                delivered = first + i;
+                break;
+            }
+        }
+    }
+
+    firstPosition.push_back(first);
+    delivery.push_back(delivered);
+    roundAt.insert(roundAt.end(), std::max<size_t>(1, round.steps.size()), static_cast<uint32_t>(number));
+    rounds.push_back(std::move(round));
+}
+
+void ReplayIndex::extendTo(int round)
+{
+    while (getRoundCount() <= round) {
+        SimulationWorker::Round empty;
+        empty.round = getRoundCount();
+
+        firstPosition.push_back(roundAt.size());
+        delivery.push_back(NONE);
+        roundAt.push_back(static_cast<uint32_t>(empty.round));
+        rounds.push_back(std::move(empty));
+    }
+}
+
+size_t ReplayIndex::stepOf(size_t position) const
+{
+    int round = roundOf(position);
+    return rounds[round].steps.empty() ? NONE : position - firstPosition[round];
+}
+
+size_t ReplayIndex::positionOfRound(int round) const
+{
+    if (round < 0) {
+        return 0;
+    }
+    return round < getRoundCount() ? firstPosition[round] : size();
+}
+
+size_t ReplayIndex::positionAtTime(double seconds) const
+{
+    double whole = std::floor(std::max(seconds, 0.0));
+    int round = static_cast<int>(std::min(whole, static_cast<double>(getRoundCount())));
+    size_t first = positionOfRound(round);
+    if (round >= getRoundCount()) {
+        return first;
+    }
+
+    size_t positions = positionOfRound(round + 1) - first;
+    return first + std::min(positions - 1, static_cast<size_t>((seconds - whole) * positions));
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef REPLAY_INDEX_H
+#define REPLAY_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SimulationWorker.h"
+
+// Rounds streamed from a SimulationWorker, kept so the replay can seek. Every arbitration
+// step is one replay position and a round without arbitration takes a single position, so
+// the timeline has no gaps. Both directions are indexed, round to first position and
+// position to round, so seeking to a round, a time or a position is O(1). A round keeps
+// only what the view draws, the contender bits of each step and the node counters, so the
+// index stays small next to the bounded queue it is filled from.
+class ReplayIndex {
+public:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    // Rounds arrive in increasing order, the ones skipped in between are added empty
+    void append(SimulationWorker::Round round);
+
+    // Adds empty rounds up to and including the given one
+    void extendTo(int round);
+
+    size_t size() const { return roundAt.size(); }
+    int getRoundCount() const { return static_cast<int>(rounds.size()); }
+
+    const SimulationWorker::Round& getRound(int round) const { return rounds[round]; }
+    int roundOf(size_t position) const { return static_cast<int>(roundAt[position]); }
+
+    // Step of the round shown at a position, NONE for a round without arbitration
+    size_t stepOf(size_t position) const;
+
+    // First position of a round, size() for rounds not indexed yet
+    size_t positionOfRound(int round) const;
+
+    // A round lasts one second of scenario time, its steps are spread evenly over it
+    size_t positionAtTime(double seconds) const;
+
+    // Position of the step that delivers the winner of a round, NONE if nothing was sent
+    size_t deliveryPosition(int round) const { return delivery[round]; }
+
+private:
+    std::vector<SimulationWorker::Round> rounds;    // by round number
+    std::vector<size_t> firstPosition;              // by round number
+    std::vector<size_t> delivery;                   // by round number
+    std::vector<uint32_t> roundAt;                  // by position
+};
+
+#endif
\ No newline at end of file
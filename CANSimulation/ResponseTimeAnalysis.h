@@ -0,0 +1,76 @@
+#ifndef RESPONSE_TIME_ANALYSIS_H
+#define RESPONSE_TIME_ANALYSIS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "TimingMetrics.h"
+
+class Node;
+
+// Worst-case response time analysis for CAN (Davis, Burns, Bril, Lukkien 2007, the
+// revision of Tindell's analysis): non-preemptive blocking by the longest lower
+// priority frame, queueing jitter, worst-case stuff bits and every instance in the
+// level-m busy period. Bounds are fault free and in the unit of the stream periods.
+class ResponseTimeAnalysis {
+public:
+    struct Stream {
+        int node;                       // index of the sending node, 0 based
+        uint16_t id;
+        double period;                  // minimum inter-arrival time
+        double jitter;                  // queueing jitter
+        double transmissionTime;
+        double deadline;                // 0 means implicit (equal to the period)
+    };
+
+    struct Result {
+        int node;
+        uint16_t id;
+        double transmissionTime;
+        double blocking;
+        // Infinity when there is no bound: the busy period does not end, or an instance
+        // passed its deadline before the iteration converged
+        double responseTime;
+        double deadline;
+        int instances;                  // instances in the busy period that were checked
+        bool schedulable;
+    };
+
+    struct Comparison {
+        Result bound;
+        uint64_t observedCount;
+        double observedMax;
+        bool boundHolds;
+    };
+
+    // bitTime is the length of one bit in the unit of the periods. Without blocking
+    // every frame starts on a slot boundary, which is how CANBus advances its rounds.
+    explicit ResponseTimeAnalysis(double bitTime = 1.0, bool blocking = true);
+
+    void addStream(const Stream& stream);
+    void addScenarioNode(const Node& node, double roundLength, double transmissionTime);
+    const std::vector<Stream>& getStreams() const { return streams; }
+    void clear() { streams.clear(); }
+
+    std::vector<Result> analyze() const;
+
+    // Longest base format frame with dataLength bytes including worst-case stuffing and the interframe space
+    static int worstCaseFrameBits(int dataLength);
+
+    // observedUnit converts the metrics' time unit to the unit of the analysis
+    static std::vector<Comparison> compare(const std::vector<Result>& results, const TimingMetrics& metrics, double observedUnit = 1.0);
+    static void writeCsv(std::ostream& out, const std::vector<Comparison>& comparisons);
+    static bool exportCsv(const std::string& path, const std::vector<Comparison>& comparisons);
+
+private:
+    double busyPeriod(size_t index, double blocking) const;
+    double queueingDelay(size_t index, double blocking, int instance, double start) const;
+
+    std::vector<Stream> streams;        // kept sorted by identifier, highest priority first
+    double bitTime;
+    bool blocking;
+};
+
+#endif
\ No newline at end of file
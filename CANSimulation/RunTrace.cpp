@@ -0,0 +1,396 @@
+#include "RunTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+static const char MAGIC[8] = { 'C', 'A', 'N', 'T', 'R', 'C', '1', '\n' };
+static const int ID_BITS = 11;
+
+struct TraceHeader {
+    char magic[8];
+    uint64_t rows;
+    uint64_t sessions;
+    uint64_t rounds;
+    uint64_t idRows;
+};
+
+// Sections of a trace file after the header, each starting on an 8 byte boundary
+enum Section {
+    RoundColumn, TypeColumn, NodeColumn, IdColumn, OtherColumn, TecColumn, RecColumn,
+    SessionRows, SessionRounds, RoundStarts, IdOffsets, IdRows, NodeOffsets, NodeRows, TypeOffsets, TypeRows,
+    SECTION_COUNT
+};
+
+struct TraceLayout {
+    uint64_t offsets[SECTION_COUNT];
+    uint64_t size;
+};
+
+static TraceLayout layoutOf(const TraceHeader& header)
+{
+    const uint64_t sizes[SECTION_COUNT] = {
+        4 * header.rows, header.rows, header.rows, 2 * header.rows, 2 * header.rows, 4 * header.rows, 4 * header.rows,
+        4 * (header.sessions + 1), 4 * (header.sessions + 1), 8 * header.rounds,
+        4 * (RunTrace::ID_COUNT + 1), 4 * header.idRows, 4 * (RunTrace::NODE_COUNT + 1), 4 * header.rows,
+        4 * (RunTrace::EVENT_TYPES + 1), 4 * header.rows,
+    };
+
+    TraceLayout layout;
+    uint64_t offset = sizeof(TraceHeader);
+    for (int i = 0; i < SECTION_COUNT; ++i) {
+        layout.offsets[i] = offset;
+        offset = (offset + sizes[i] + 7) / 8 * 8;
+    }
+    layout.size = offset;
+    return layout;
+}
+
+// Undoes ErrorCheck::applyBitStuffingToId, -1 when the bits are not a stuffed identifier
+static int destuffId(const std::string& bits)
+{
+    int id = 0;
+    int count = 0;
+    int consecutive = 0;
+    char last = ' ';
+
+    for (size_t i = 0; i < bits.size() && count < ID_BITS; ++i) {
+        char bit = bits[i];
+        id = id << 1 | (bit == '1');
+        ++count;
+
+        // The stuff bit after five equal bits is skipped and not counted
+        if (bit == last) {
+            if (++consecutive == 5) {
+                ++i;
+                consecutive = 0;
+            }
+        }
+        else {
+            consecutive = 1;
+        }
+        last = bit;
+    }
+    return count == ID_BITS ? id : -1;
+}
+
+// Rows of each key in increasing order, keys outside [0, keyCount) are left out
+template <typename Key>
+static void buildPostings(const std::vector<Key>& keys, int keyCount, uint32_t* offsets, uint32_t* rows)
+{
+    std::fill(offsets, offsets + keyCount + 1, 0);
+    for (Key key : keys) {
+        if (key < keyCount) {
+            ++offsets[key + 1];
+        }
+    }
+    for (int key = 0; key < keyCount; ++key) {
+        offsets[key + 1] += offsets[key];
+    }
+
+    std::vector<uint32_t> next(offsets, offsets + keyCount);
+    for (size_t row = 0; row < keys.size(); ++row) {
+        if (keys[row] < keyCount) {
+            rows[next[keys[row]]++] = static_cast<uint32_t>(row);
+        }
+    }
+}
+
+RunTrace::RunTrace()
+    : rowCount(0), sessionCount(0), roundCount(0), rounds(nullptr), types(nullptr), nodes(nullptr), ids(nullptr),
+    others(nullptr), tecs(nullptr), recs(nullptr), sessionRows(nullptr), sessionRounds(nullptr), roundStarts(nullptr),
+    idOffsets(nullptr), idRows(nullptr), nodeOffsets(nullptr), nodeRows(nullptr), typeOffsets(nullptr), typeRows(nullptr),
+    currentRound(0), listingContenders(false), contendersTaken(false), winnerNode(0), winnerId(NO_ID),
+    lastTec(NODE_COUNT, 0), lastRec(NODE_COUNT, 0)
+{
+}
+
+void RunTrace::add(const LogRecord& record)
+{
+    switch (record.getType()) {
+    case LogRecord::Type::Session:
+        endRound();
+        columns.sessionRows.push_back(static_cast<uint32_t>(columns.rounds.size()));
+        columns.sessionRounds.push_back(static_cast<uint32_t>(columns.roundStarts.size()));
+        currentRound = 0;
+        break;
+    case LogRecord::Type::Round:
+        endRound();
+        currentRound = record.getValue(0);
+        break;
+    case LogRecord::Type::ContendersHeader:
+        listingContenders = !contendersTaken;
+        break;
+    case LogRecord::Type::Contender:
+        if (listingContenders) {
+            contenders.push_back({ record.getValue(1), record.getValue(0) });
+        }
+        break;
+    case LogRecord::Type::StuffedContender:
+        if (listingContenders) {
+            contenders.push_back({ record.getValue(0), destuffId(record.getText()) });
+        }
+        break;
+    case LogRecord::Type::Blank:
+        if (listingContenders) {
+            listingContenders = false;
+            contendersTaken = true;
+        }
+        break;
+    case LogRecord::Type::Winner: {
+        winnerId = record.getValue(0);
+        winnerNode = record.getValue(1);
+        append(EventType::Won, winnerNode, winnerId, NO_ID);
+
+        bool winnerSeen = false;
+        for (const auto& contender : contenders) {
+            if (!winnerSeen && contender.node == winnerNode && contender.id == winnerId) {
+                winnerSeen = true;
+                continue;
+            }
+            append(EventType::Lost, contender.node, contender.id, winnerId);
+        }
+        contenders.clear();
+        break;
+    }
+    case LogRecord::Type::Received:
+        append(EventType::Received, record.getValue(0), winnerId, winnerNode);
+        break;
+    case LogRecord::Type::CrcFailed:
+        append(EventType::CrcError, record.getValue(0), winnerId, winnerNode);
+        break;
+    case LogRecord::Type::NoReceivers:
+        append(EventType::Retransmit, winnerNode, winnerId, NO_ID);
+        break;
+    case LogRecord::Type::NodeCounters: {
+        int node = record.getValue(0);
+        if (node >= 0 && node < NODE_COUNT) {
+            lastTec[node] = record.getValue(1);
+            lastRec[node] = record.getValue(2);
+        }
+        append(EventType::Counters, node, NO_ID, NO_ID, record.getValue(1), record.getValue(2));
+        break;
+    }
+    case LogRecord::Type::TecLimit:
+    case LogRecord::Type::RecLimit: {
+        int node = record.getValue(0);
+        bool known = node >= 0 && node < NODE_COUNT;
+        append(EventType::Disabled, node, NO_ID, NO_ID, known ? lastTec[node] : 0, known ? lastRec[node] : 0);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void RunTrace::endRound()
+{
+    // Contenders of a round without a winner lost to nobody
+    for (const auto& contender : contenders) {
+        append(EventType::Lost, contender.node, contender.id, NO_ID);
+    }
+    contenders.clear();
+    listingContenders = false;
+    contendersTaken = false;
+    winnerNode = 0;
+    winnerId = NO_ID;
+}
+
+void RunTrace::append(EventType type, int node, int id, int other, int tec, int rec)
+{
+    if (columns.rounds.size() >= MAX_ROWS) {
+        throw std::invalid_argument("The trace has more than " + std::to_string(MAX_ROWS) + " events");
+    }
+
+    // Events before the first session header start one of their own
+    if (columns.sessionRows.empty()) {
+        columns.sessionRows.push_back(0);
+        columns.sessionRounds.push_back(0);
+    }
+
+    uint32_t row = static_cast<uint32_t>(columns.rounds.size());
+    bool sessionStart = columns.sessionRows.back() == row;
+    if (sessionStart || columns.roundStarts.empty() || columns.roundStarts.back().round != currentRound) {
+        columns.roundStarts.push_back({ currentRound, row });
+    }
+
+    columns.rounds.push_back(currentRound);
+    columns.types.push_back(static_cast<uint8_t>(type));
+    columns.nodes.push_back(static_cast<uint8_t>(std::clamp(node, 0, NODE_COUNT - 1)));
+    columns.ids.push_back(id >= 0 && id < ID_COUNT ? static_cast<uint16_t>(id) : NO_ID);
+    columns.others.push_back(other >= 0 && other < ID_COUNT ? static_cast<uint16_t>(other) : NO_ID);
+    columns.tecs.push_back(tec);
+    columns.recs.push_back(rec);
+}
+
+void RunTrace::finish()
+{
+    endRound();
+
+    TraceHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.rows = columns.rounds.size();
+    header.sessions = columns.sessionRows.size();
+    header.rounds = columns.roundStarts.size();
+    header.idRows = std::count_if(columns.ids.begin(), columns.ids.end(), [](uint16_t id) { return id != NO_ID; });
+
+    TraceLayout layout = layoutOf(header);
+    image.assign(layout.size, 0);
+    char* data = image.data();
+
+    auto copy = [&](Section section, const auto& column) {
+        if (!column.empty()) {
+            std::memcpy(data + layout.offsets[section], column.data(), column.size() * sizeof(column[0]));
+        }
+    };
+
+    columns.sessionRows.push_back(static_cast<uint32_t>(header.rows));
+    columns.sessionRounds.push_back(static_cast<uint32_t>(header.rounds));
+
+    std::memcpy(data, &header, sizeof(header));
+    copy(RoundColumn, columns.rounds);
+    copy(TypeColumn, columns.types);
+    copy(NodeColumn, columns.nodes);
+    copy(IdColumn, columns.ids);
+    copy(OtherColumn, columns.others);
+    copy(TecColumn, columns.tecs);
+    copy(RecColumn, columns.recs);
+    copy(SessionRows, columns.sessionRows);
+    copy(SessionRounds, columns.sessionRounds);
+    copy(RoundStarts, columns.roundStarts);
+
+    auto at = [&](Section section) { return reinterpret_cast<uint32_t*>(data + layout.offsets[section]); };
+    buildPostings(columns.ids, ID_COUNT, at(IdOffsets), at(IdRows));
+    buildPostings(columns.nodes, NODE_COUNT, at(NodeOffsets), at(NodeRows));
+    buildPostings(columns.types, EVENT_TYPES, at(TypeOffsets), at(TypeRows));
+
+    columns = Columns();
+    attach(image.data(), image.size());
+}
+
+void RunTrace::save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::invalid_argument("Cannot open file: " + path);
+    }
+
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!out) {
+        throw std::invalid_argument("Cannot write file: " + path);
+    }
+}
+
+void RunTrace::load(const std::string& path)
+{
+    file.open(path);
+    if (file.size() < sizeof(TraceHeader)) {
+        throw std::invalid_argument("Not a run trace: " + path);
+    }
+
+    const char* data = file.map(0, static_cast<size_t>(file.size()));
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::invalid_argument("Not a run trace: " + path);
+    }
+
+    image.clear();
+    attach(data, file.size());
+}
+
+void RunTrace::attach(const char* data, uint64_t size)
+{
+    TraceHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    TraceLayout layout = layoutOf(header);
+    if (layout.size != size || header.rows > MAX_ROWS) {
+        throw std::invalid_argument("The run trace is damaged");
+    }
+
+    auto at = [&](Section section) { return data + layout.offsets[section]; };
+    rounds = reinterpret_cast<const int32_t*>(at(RoundColumn));
+    types = reinterpret_cast<const uint8_t*>(at(TypeColumn));
+    nodes = reinterpret_cast<const uint8_t*>(at(NodeColumn));
+    ids = reinterpret_cast<const uint16_t*>(at(IdColumn));
+    others = reinterpret_cast<const uint16_t*>(at(OtherColumn));
+    tecs = reinterpret_cast<const int32_t*>(at(TecColumn));
+    recs = reinterpret_cast<const int32_t*>(at(RecColumn));
+    sessionRows = reinterpret_cast<const uint32_t*>(at(SessionRows));
+    sessionRounds = reinterpret_cast<const uint32_t*>(at(SessionRounds));
+    roundStarts = reinterpret_cast<const Round*>(at(RoundStarts));
+    idOffsets = reinterpret_cast<const uint32_t*>(at(IdOffsets));
+    idRows = reinterpret_cast<const uint32_t*>(at(IdRows));
+    nodeOffsets = reinterpret_cast<const uint32_t*>(at(NodeOffsets));
+    nodeRows = reinterpret_cast<const uint32_t*>(at(NodeRows));
+    typeOffsets = reinterpret_cast<const uint32_t*>(at(TypeOffsets));
+    typeRows = reinterpret_cast<const uint32_t*>(at(TypeRows));
+
+    rowCount = header.rows;
+    sessionCount = header.sessions;
+    roundCount = header.rounds;
+}
+
+uint64_t RunTrace::session(uint64_t row) const
+{
+    return std::upper_bound(sessionRows, sessionRows + sessionCount, row) - sessionRows - 1;
+}
+
+uint64_t RunTrace::sessionBegin(uint64_t session) const
+{
+    return sessionRows[std::min(session, sessionCount)];
+}
+
+uint64_t RunTrace::sessionEnd(uint64_t session) const
+{
+    return sessionRows[std::min(session + 1, sessionCount)];
+}
+
+RunTrace::Postings RunTrace::rowsOfId(uint16_t id) const
+{
+    Postings postings;
+    if (id < ID_COUNT) {
+        postings.begin = idRows + idOffsets[id];
+        postings.end = idRows + idOffsets[id + 1];
+    }
+    return postings;
+}
+
+RunTrace::Postings RunTrace::rowsOfNode(uint8_t node) const
+{
+    return { nodeRows + nodeOffsets[node], nodeRows + nodeOffsets[node + 1] };
+}
+
+RunTrace::Postings RunTrace::rowsOfType(EventType type) const
+{
+    int index = static_cast<int>(type);
+    return { typeRows + typeOffsets[index], typeRows + typeOffsets[index + 1] };
+}
+
+void RunTrace::roundRanges(int32_t first, int32_t last, std::vector<std::pair<uint64_t, uint64_t>>& ranges) const
+{
+    for (uint64_t session = 0; session < sessionCount; ++session) {
+        const Round* begin = roundStarts + sessionRounds[session];
+        const Round* end = roundStarts + sessionRounds[session + 1];
+
+        // Rounds only go up within a session
+        const Round* round = std::lower_bound(begin, end, first, [](const Round& entry, int32_t value) { return entry.round < value; });
+        for (; round < end && round->round <= last; ++round) {
+            uint64_t rangeBegin = round->row;
+            uint64_t rangeEnd = round + 1 < end ? round[1].row : sessionRows[session + 1];
+
+            if (!ranges.empty() && ranges.back().second == rangeBegin) {
+                ranges.back().second = rangeEnd;
+            }
+            else {
+                ranges.emplace_back(rangeBegin, rangeEnd);
+            }
+        }
+    }
+}
+
+const char* RunTrace::typeName(EventType type)
+{
+    static const char* const NAMES[EVENT_TYPES] = { "won", "lost", "received", "crc-error", "retransmit", "counters", "disabled" };
+    return NAMES[static_cast<int>(type)];
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#ifndef RUN_TRACE_H
+#define RUN_TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LogRecord.h"
+#include "MappedFile.h"
+
+// The events of simulation runs in columns, one row per event in log order, with posting
+// lists of the rows of every identifier, node and event type and the first row of every
+// round. Built from log records and saved as one file that is memory mapped to query, so
+// opening a trace of any size costs nothing and only the columns a query reads are paged in.
+class RunTrace {
+public:
+    enum class EventType : uint8_t {
+        Won,                // node sent id and won arbitration
+        Lost,               // node's id lost arbitration to other
+        Received,           // node received id from other
+        CrcError,           // node rejected id from other
+        Retransmit,         // nobody received id from node, it stays pending
+        Counters,           // node's error counters after the round
+        Disabled,           // node reached an error counter limit
+    };
+
+    static constexpr int EVENT_TYPES = 7;
+    static constexpr int ID_COUNT = 2048;
+    static constexpr int NODE_COUNT = 256;
+    static constexpr uint16_t NO_ID = 0xFFFF;
+    static constexpr uint64_t NONE = UINT64_MAX;
+    static constexpr const char* EXTENSION = ".cantrace";
+
+    // Rows are numbered in 32 bits to keep the posting lists small
+    static constexpr uint64_t MAX_ROWS = UINT32_MAX;
+
+    // A list of rows in increasing order
+    struct Postings {
+        const uint32_t* begin = nullptr;
+        const uint32_t* end = nullptr;
+        uint64_t size() const { return end - begin; }
+    };
+
+    RunTrace();
+
+    RunTrace(const RunTrace&) = delete;
+    RunTrace& operator=(const RunTrace&) = delete;
+
+    // Building: records in log order, then finish() before querying or saving
+    void add(const LogRecord& record);
+    void finish();
+
+    void save(const std::string& path) const;
+    void load(const std::string& path);
+
+    uint64_t getRowCount() const { return rowCount; }
+    uint64_t getSessionCount() const { return sessionCount; }
+
+    int32_t round(uint64_t row) const { return rounds[row]; }
+    EventType type(uint64_t row) const { return static_cast<EventType>(types[row]); }
+    uint8_t node(uint64_t row) const { return nodes[row]; }
+    uint16_t id(uint64_t row) const { return ids[row]; }
+    uint16_t other(uint64_t row) const { return others[row]; }
+    int32_t tec(uint64_t row) const { return tecs[row]; }
+    int32_t rec(uint64_t row) const { return recs[row]; }
+    uint64_t session(uint64_t row) const;
+
+    // Rows of sessions first to last, inclusive
+    uint64_t sessionBegin(uint64_t session) const;
+    uint64_t sessionEnd(uint64_t session) const;
+
+    Postings rowsOfId(uint16_t id) const;
+    Postings rowsOfNode(uint8_t node) const;
+    Postings rowsOfType(EventType type) const;
+
+    // Appends the [begin, end) row ranges of rounds first to last of every session
+    void roundRanges(int32_t first, int32_t last, std::vector<std::pair<uint64_t, uint64_t>>& ranges) const;
+
+    static const char* typeName(EventType type);
+
+private:
+    struct Round {
+        int32_t round;
+        uint32_t row;
+    };
+
+    void append(EventType type, int node, int id, int other, int tec = 0, int rec = 0);
+    void endRound();
+    void attach(const char* data, uint64_t size);
+
+    uint64_t rowCount;
+    uint64_t sessionCount;
+    uint64_t roundCount;
+
+    // Views of the columns and indexes, in the image built by finish() or the mapped file
+    const int32_t* rounds;
+    const uint8_t* types;
+    const uint8_t* nodes;
+    const uint16_t* ids;
+    const uint16_t* others;
+    const int32_t* tecs;
+    const int32_t* recs;
+    const uint32_t* sessionRows;        // first row of each session, then the row count
+    const uint32_t* sessionRounds;      // first round entry of each session, then the round count
+    const Round* roundStarts;
+    const uint32_t* idOffsets;          // idRows[idOffsets[id], idOffsets[id + 1]) are the rows of id
+    const uint32_t* idRows;
+    const uint32_t* nodeOffsets;
+    const uint32_t* nodeRows;
+    const uint32_t* typeOffsets;
+    const uint32_t* typeRows;
+
+    std::vector<char> image;
+    MappedFile file;
+
+    // Building state
+    struct Columns {
+        std::vector<int32_t> rounds;
+        std::vector<uint8_t> types;
+        std::vector<uint8_t> nodes;
+        std::vector<uint16_t> ids;
+        std::vector<uint16_t> others;
+        std::vector<int32_t> tecs;
+        std::vector<int32_t> recs;
+        std::vector<uint32_t> sessionRows;
+        std::vector<uint32_t> sessionRounds;
+        std::vector<Round> roundStarts;
+    };
+    struct Contender {
+        int node;
+        int id;
+    };
+
+    Columns columns;
+    int currentRound;
+    bool listingContenders;             // only the first listing of a round has every contender
+    bool contendersTaken;
+    std::vector<Contender> contenders;
+    int winnerNode;
+    int winnerId;
+    std::vector<int> lastTec;
+    std::vector<int> lastRec;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "RunTraceQuery.h"
+
+#include <algorithm>
+#include <utility>
+
+static const int COLUMN_COUNT = 8;
+static const size_t CHUNK_ROWS = 4096;
+static const char* const COLUMN_NAMES[COLUMN_COUNT] = { "session", "round", "type", "node", "id", "other", "tec", "rec" };
+
+RunTraceQuery::RunTraceQuery(const RunTrace& trace)
+    : trace(trace), empty(false)
+{
+}
+
+RunTraceQuery& RunTraceQuery::where(Column column, Comparison comparison, int64_t value)
+{
+    Range& range = ranges[static_cast<int>(column)];
+
+    switch (comparison) {
+    case Comparison::Equal: range.min = std::max(range.min, value); range.max = std::min(range.max, value); break;
+    case Comparison::NotEqual: range.excluded.push_back(value); break;
+    case Comparison::Less: range.max = std::min(range.max, value == INT64_MIN ? value : value - 1); empty |= value == INT64_MIN; break;
+    case Comparison::LessEqual: range.max = std::min(range.max, value); break;
+    case Comparison::Greater: range.min = std::max(range.min, value == INT64_MAX ? value : value + 1); empty |= value == INT64_MAX; break;
+    case Comparison::GreaterEqual: range.min = std::max(range.min, value); break;
+    }
+
+    empty |= range.min > range.max;
+    return *this;
+}
+
+int64_t RunTraceQuery::value(uint64_t row, Column column) const
+{
+    switch (column) {
+    case Column::Session: return static_cast<int64_t>(trace.session(row));
+    case Column::Round: return trace.round(row);
+    case Column::Type: return static_cast<int64_t>(trace.type(row));
+    case Column::Node: return trace.node(row);
+    case Column::Id: return trace.id(row) == RunTrace::NO_ID ? -1 : trace.id(row);
+    case Column::Other: return trace.other(row) == RunTrace::NO_ID ? -1 : trace.other(row);
+    case Column::Tec: return trace.tec(row);
+    case Column::Rec: return trace.rec(row);
+    }
+    return 0;
+}
+
+bool RunTraceQuery::testsColumn(Column column) const
+{
+    const Range& range = ranges[static_cast<int>(column)];
+    bool bounded = range.min != INT64_MIN || range.max != INT64_MAX;
+
+    // Session bounds become the rows scanned, only exclusions are tested per row
+    return column == Column::Session ? !range.excluded.empty() : bounded || !range.excluded.empty();
+}
+
+template <typename Get>
+static size_t keepRows(uint32_t* rows, size_t count, int64_t min, int64_t max, const std::vector<int64_t>& excluded, Get get)
+{
+    size_t kept = 0;
+
+    if (excluded.empty()) {
+        // Without branches, so the loop runs at the speed of reading the column
+        for (size_t i = 0; i < count; ++i) {
+            int64_t value = get(rows[i]);
+            rows[kept] = rows[i];
+            kept += value >= min && value <= max;
+        }
+        return kept;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        int64_t value = get(rows[i]);
+        if (value >= min && value <= max && std::find(excluded.begin(), excluded.end(), value) == excluded.end()) {
+            rows[kept++] = rows[i];
+        }
+    }
+    return kept;
+}
+
+size_t RunTraceQuery::keep(Column column, uint32_t* rows, size_t count) const
+{
+    const Range& range = ranges[static_cast<int>(column)];
+    auto keepBy = [&](auto get) { return keepRows(rows, count, range.min, range.max, range.excluded, get); };
+
+    switch (column) {
+    case Column::Round: return keepBy([this](uint32_t row) { return trace.round(row); });
+    case Column::Type: return keepBy([this](uint32_t row) { return static_cast<int>(trace.type(row)); });
+    case Column::Node: return keepBy([this](uint32_t row) { return trace.node(row); });
+    case Column::Id: return keepBy([this](uint32_t row) { return trace.id(row) == RunTrace::NO_ID ? -1 : trace.id(row); });
+    case Column::Other: return keepBy([this](uint32_t row) { return trace.other(row) == RunTrace::NO_ID ? -1 : trace.other(row); });
+    case Column::Tec: return keepBy([this](uint32_t row) { return trace.tec(row); });
+    case Column::Rec: return keepBy([this](uint32_t row) { return trace.rec(row); });
+    case Column::Session: {
+        // Rows come in order, the session is only looked up again past its last row
+        uint64_t session = 0;
+        uint64_t sessionBegin = 1;
+        uint64_t sessionEnd = 0;
+        return keepBy([&](uint32_t row) {
+            if (row < sessionBegin || row >= sessionEnd) {
+                session = trace.session(row);
+                sessionBegin = trace.sessionBegin(session);
+                sessionEnd = trace.sessionEnd(session);
+            }
+            return static_cast<int64_t>(session);
+            });
+    }
+    }
+    return count;
+}
+
+bool RunTraceQuery::makePlan(Plan& plan) const
+{
+    uint64_t sessions = trace.getSessionCount();
+    const Range& sessionRange = ranges[static_cast<int>(Column::Session)];
+    const Range& roundRange = ranges[static_cast<int>(Column::Round)];
+    if (empty || sessions == 0 || sessionRange.max < 0 || sessionRange.min >= static_cast<int64_t>(sessions) ||
+        roundRange.min > INT32_MAX || roundRange.max < INT32_MIN) {
+        return false;
+    }
+
+    uint64_t begin = trace.sessionBegin(static_cast<uint64_t>(std::max<int64_t>(sessionRange.min, 0)));
+    uint64_t end = trace.sessionEnd(static_cast<uint64_t>(std::min<int64_t>(sessionRange.max, sessions - 1)));
+
+    // The smallest posting list of an equality, cut to the session rows
+    auto consider = [&](Column column, int64_t limit, auto rowsOf) {
+        const Range& range = ranges[static_cast<int>(column)];
+        if (range.min != range.max || range.min < 0 || range.min >= limit) {
+            return;
+        }
+
+        RunTrace::Postings candidate = rowsOf(range.min);
+        candidate.begin = std::lower_bound(candidate.begin, candidate.end, static_cast<uint32_t>(begin));
+        candidate.end = std::lower_bound(candidate.begin, candidate.end, end);
+        if (!plan.usePostings || candidate.size() < plan.postings.size()) {
+            plan.postings = candidate;
+            plan.usePostings = true;
+        }
+    };
+    consider(Column::Id, RunTrace::ID_COUNT, [this](int64_t id) { return trace.rowsOfId(static_cast<uint16_t>(id)); });
+    consider(Column::Node, RunTrace::NODE_COUNT, [this](int64_t node) { return trace.rowsOfNode(static_cast<uint8_t>(node)); });
+    consider(Column::Type, RunTrace::EVENT_TYPES,
+        [this](int64_t type) { return trace.rowsOfType(static_cast<RunTrace::EventType>(type)); });
+
+    // Or the rows of a range of rounds
+    if (roundRange.min != INT64_MIN || roundRange.max != INT64_MAX) {
+        trace.roundRanges(static_cast<int32_t>(std::max<int64_t>(roundRange.min, INT32_MIN)),
+            static_cast<int32_t>(std::min<int64_t>(roundRange.max, INT32_MAX)), plan.ranges);
+    }
+    else {
+        plan.ranges.emplace_back(begin, end);
+    }
+
+    for (auto& range : plan.ranges) {
+        range.first = std::max(range.first, begin);
+        range.second = std::max(range.first, std::min(range.second, end));
+        plan.rangeRows += range.second - range.first;
+    }
+
+    // Whichever has fewer rows, the other conditions are tested on them
+    plan.usePostings = plan.usePostings && plan.postings.size() <= plan.rangeRows;
+    for (int i = 0; i < COLUMN_COUNT; ++i) {
+        if (testsColumn(static_cast<Column>(i))) {
+            plan.tested[plan.testedCount++] = static_cast<Column>(i);
+        }
+    }
+    return true;
+}
+
+template <typename Visit>
+void RunTraceQuery::scan(Visit visit) const
+{
+    Plan plan;
+    if (!makePlan(plan)) {
+        return;
+    }
+
+    // Rows go through the conditions a chunk and a column at a time
+    std::vector<uint32_t> rows(CHUNK_ROWS);
+    auto filter = [&](size_t count) {
+        for (int i = 0; i < plan.testedCount && count > 0; ++i) {
+            count = keep(plan.tested[i], rows.data(), count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (!visit(rows[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (plan.usePostings) {
+        for (const uint32_t* chunk = plan.postings.begin; chunk < plan.postings.end; chunk += CHUNK_ROWS) {
+            size_t count = std::min<size_t>(CHUNK_ROWS, plan.postings.end - chunk);
+            std::copy(chunk, chunk + count, rows.begin());
+            if (!filter(count)) {
+                return;
+            }
+        }
+        return;
+    }
+
+    for (const auto& range : plan.ranges) {
+        for (uint64_t chunk = range.first; chunk < range.second; chunk += CHUNK_ROWS) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(CHUNK_ROWS, range.second - chunk));
+            for (size_t i = 0; i < count; ++i) {
+                rows[i] = static_cast<uint32_t>(chunk + i);
+            }
+            if (!filter(count)) {
+                return;
+            }
+        }
+    }
+}
+
+uint64_t RunTraceQuery::count() const
+{
+    // Without conditions left to test every row of the plan matches
+    Plan plan;
+    if (!makePlan(plan)) {
+        return 0;
+    }
+    if (plan.testedCount == 0) {
+        return plan.usePostings ? plan.postings.size() : plan.rangeRows;
+    }
+
+    uint64_t matched = 0;
+    scan([&matched](uint64_t) { ++matched; return true; });
+    return matched;
+}
+
+uint64_t RunTraceQuery::first() const
+{
+    uint64_t found = RunTrace::NONE;
+    scan([&found](uint64_t row) { found = row; return false; });
+    return found;
+}
+
+uint64_t RunTraceQuery::last() const
+{
+    uint64_t found = RunTrace::NONE;
+    scan([&found](uint64_t row) { found = row; return true; });
+    return found;
+}
+
+std::vector<uint64_t> RunTraceQuery::rows(size_t limit) const
+{
+    std::vector<uint64_t> found;
+    if (limit == 0) {
+        return found;
+    }
+
+    scan([&found, limit](uint64_t row) { found.push_back(row); return found.size() < limit; });
+    return found;
+}
+
+RunTraceQuery::Aggregate RunTraceQuery::aggregate(Column column) const
+{
+    Aggregate result;
+    scan([&](uint64_t row) {
+        int64_t current = value(row, column);
+        result.min = result.count == 0 ? current : std::min(result.min, current);
+        result.max = result.count == 0 ? current : std::max(result.max, current);
+        result.sum += current;
+        ++result.count;
+        return true;
+        });
+    return result;
+}
+
+std::map<int64_t, uint64_t> RunTraceQuery::groupBy(Column column) const
+{
+    std::map<int64_t, uint64_t> groups;
+
+    // Columns of few values are counted in an array, -1 (no identifier) at the front
+    if (column == Column::Type || column == Column::Node || column == Column::Id || column == Column::Other) {
+        std::vector<uint64_t> counts(RunTrace::ID_COUNT + 1, 0);
+        scan([&](uint64_t row) { ++counts[value(row, column) + 1]; return true; });
+
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i] > 0) {
+                groups[static_cast<int64_t>(i) - 1] = counts[i];
+            }
+        }
+        return groups;
+    }
+
+    // Matching rows tend to come in runs of one session or round, so the last group is kept at hand
+    uint64_t* last = nullptr;
+    int64_t lastKey = 0;
+    scan([&](uint64_t row) {
+        int64_t key = value(row, column);
+        if (last == nullptr || key != lastKey) {
+            last = &groups[key];
+            lastKey = key;
+        }
+        ++*last;
+        return true;
+        });
+    return groups;
+}
+
+bool RunTraceQuery::parseColumn(const std::string& name, Column& column)
+{
+    for (int i = 0; i < COLUMN_COUNT; ++i) {
+        if (name == COLUMN_NAMES[i]) {
+            column = static_cast<Column>(i);
+            return true;
+        }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef RUN_TRACE_QUERY_H
+#define RUN_TRACE_QUERY_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "RunTrace.h"
+
+// Filters and aggregates over a RunTrace. Conditions are combined with "and". An equality
+// on id, node or type reads that posting list, a session condition narrows the rows to
+// those sessions and a round range reads only those rounds, whichever touches the fewest
+// rows. Only the remaining rows are tested against the columns.
+class RunTraceQuery {
+public:
+    enum class Column { Session, Round, Type, Node, Id, Other, Tec, Rec };
+    enum class Comparison { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+    struct Aggregate {
+        uint64_t count = 0;
+        int64_t min = 0;
+        int64_t max = 0;
+        int64_t sum = 0;
+    };
+
+    explicit RunTraceQuery(const RunTrace& trace);
+
+    RunTraceQuery& where(Column column, Comparison comparison, int64_t value);
+
+    uint64_t count() const;
+    uint64_t first() const;
+    uint64_t last() const;
+    std::vector<uint64_t> rows(size_t limit) const;
+    Aggregate aggregate(Column column) const;
+    // Matching rows per value of the column
+    std::map<int64_t, uint64_t> groupBy(Column column) const;
+
+    int64_t value(uint64_t row, Column column) const;
+
+    // Parses the column names used on the command line, false when the name is unknown
+    static bool parseColumn(const std::string& name, Column& column);
+
+private:
+    struct Range {
+        int64_t min = INT64_MIN;
+        int64_t max = INT64_MAX;
+        std::vector<int64_t> excluded;
+    };
+
+    // Where the rows to test come from and the columns to test them on
+    struct Plan {
+        bool usePostings = false;
+        RunTrace::Postings postings;
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        uint64_t rangeRows = 0;
+        Column tested[8];
+        int testedCount = 0;
+    };
+
+    // False when no row can match
+    bool makePlan(Plan& plan) const;
+    // Calls visit with matching rows in order until it returns false
+    template <typename Visit>
+    void scan(Visit visit) const;
+    // Moves the rows that meet the conditions on column to the front, returns how many
+    size_t keep(Column column, uint32_t* rows, size_t count) const;
+    bool testsColumn(Column column) const;
+
+    const RunTrace& trace;
+    Range ranges[8];                // conditions of each column
+    bool empty;                     // conditions that no row can meet
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "Scenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "BitLevelBus.h"
+#include "Network.h"
+#include "Node.h"
+#include "PeriodicScheduler.h"
+#include "SignalCodec.h"
+
+int getNetworkSize(const ScenarioDefinition& scenario)
+{
+    int size = 0;
+    for (const ScenarioNode& definition : scenario.nodes) {
+        size = std::max(size, definition.nodeId);
+        if (!definition.messageAndFreq.empty()) {
+            size = std::max(size, definition.messageAndFreq.rbegin()->first);
+        }
+    }
+    return size;
+}
+
+void scheduleScenarioNode(Node* node, const ScenarioNode& definition, int networkSize)
+{
+    node->setNetworkSize(networkSize);
+
+    for (const auto& target : definition.messageAndFreq) {
+        int targetId = target.first;
+        int frequency = target.second;
+
+        int interval = 60 / frequency;
+        for (int sec = 0; sec < 60; sec += interval) {
+            node->addNodesAndRound(sec, targetId);
+        }
+
+        node->generate11BitID();
+    }
+}
+
+void scheduleScenarioNode(PeriodicScheduler& scheduler, const ScenarioNode& definition, int networkSize, uint64_t offset)
+{
+    for (const auto& target : definition.messageAndFreq) {
+        PeriodicScheduler::PeriodicMessage message;
+        message.node = definition.nodeId - 1;
+        message.id = Node::frameIdentifier(definition.nodeId, { target.first }, networkSize);
+        message.data = std::vector<uint8_t>(8, 0);
+        message.period = 60000000ULL / target.second;
+        message.offset = offset;
+        message.jitter = 0;
+
+        scheduler.addMessage(message);
+    }
+}
+
+// Every signal at the value of its range nearest to 0, encoded with the layout of the DBC.
+// Multiplexed signals are encoded after the others, and only those the multiplexer selects,
+// so they do not overwrite the bits of the signals that are present.
+static std::vector<uint8_t> initialPayload(const MessageDefinition& definition)
+{
+    SignalCodec codec(definition);
+    std::vector<uint8_t> data(std::min(definition.dataLength, 8), 0);
+
+    auto initialValue = [](const SignalDefinition& signal) {
+        return signal.maximum > signal.minimum ? std::min(std::max(0.0, signal.minimum), signal.maximum) : 0.0;
+    };
+
+    for (size_t i = 0; i < definition.signalDefinitions.size(); ++i) {
+        if (definition.signalDefinitions[i].multiplexValue < 0) {
+            codec.encode(static_cast<int>(i), initialValue(definition.signalDefinitions[i]), data);
+        }
+    }
+    for (size_t i = 0; i < definition.signalDefinitions.size(); ++i) {
+        if (definition.signalDefinitions[i].multiplexValue >= 0 && !std::isnan(codec.decode(static_cast<int>(i), data))) {
+            codec.encode(static_cast<int>(i), initialValue(definition.signalDefinitions[i]), data);
+        }
+    }
+    return data;
+}
+
+int scheduleNetwork(PeriodicScheduler& scheduler, const NetworkDefinition& network)
+{
+    int scheduled = 0;
+
+    for (const MessageDefinition& definition : network.messages) {
+        if (definition.cycleTime <= 0 || definition.transmitter < 0 || definition.extended || definition.id > 0x7FF) {
+            continue;
+        }
+
+        PeriodicScheduler::PeriodicMessage message;
+        message.node = definition.transmitter;
+        message.id = static_cast<uint16_t>(definition.id);
+        message.data = initialPayload(definition);
+        message.period = PeriodicScheduler::milliseconds(definition.cycleTime);
+        message.offset = 0;
+        message.jitter = 0;
+
+        scheduler.addMessage(message);
+        scheduled++;
+    }
+
+    return scheduled;
+}
+
+void applyScenario(BitLevelBus& bus, PeriodicScheduler& scheduler, const ScenarioDefinition& scenario)
+{
+    for (const ScenarioNode& definition : scenario.nodes) {
+        int node = definition.nodeId - 1;
+        if (node < 0 || node >= bus.getNodeCount()) {
+            throw std::invalid_argument("Scenario node " + std::to_string(definition.nodeId) + " does not exist on the bus");
+        }
+
+        BitLevelBus::FaultProfile faults;
+        faults.transmitBitErrorRate = definition.transmitBitErrorRate;
+        faults.receiveBitErrorRate = definition.receiveBitErrorRate;
+        faults.ackDisabled = definition.ackDisabled;
+        bus.setFaultProfile(node, faults);
+        bus.setMailboxes(node, definition.mailboxes, TransmitQueue::Order::Fifo);
+
+        for (const ScenarioMessage& periodic : definition.periodicMessages) {
+            PeriodicScheduler::PeriodicMessage message;
+            message.node = node;
+            message.id = periodic.id;
+            message.data = std::vector<uint8_t>(periodic.dataLength, 0);
+            message.period = PeriodicScheduler::milliseconds(periodic.period);
+            message.offset = PeriodicScheduler::milliseconds(periodic.offset);
+            message.jitter = PeriodicScheduler::milliseconds(periodic.jitter);
+
+            scheduler.addMessage(message);
+        }
+    }
+}
\ No newline at end of file
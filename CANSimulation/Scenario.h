@@ -0,0 +1,71 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class BitLevelBus;
+class Node;
+class PeriodicScheduler;
+struct NetworkDefinition;
+
+// Periodic frame of the bit-level engine, times in milliseconds
+struct ScenarioMessage {
+    uint16_t id;
+    int dataLength;
+    double period;
+    double offset;
+    double jitter;
+};
+
+struct ScenarioNode {
+    int nodeId;
+    std::map<int, int> messageAndFreq;      // target node id -> messages per minute
+    bool error;
+
+    // Bit-level engine only
+    double transmitBitErrorRate = 0.0;
+    double receiveBitErrorRate = 0.0;
+    bool ackDisabled = false;
+    int mailboxes = 1;
+    std::vector<ScenarioMessage> periodicMessages;
+};
+
+// Passive node of the round-based engine that keeps the frames matching a FrameFilter expression
+struct ScenarioMonitor {
+    std::string name;
+    std::string filter;
+    int capacity = 1000;                    // latest matching frames kept
+};
+
+struct ScenarioDefinition {
+    std::string name;
+    uint32_t bitRate = 500000;
+    int rounds = 60;                        // run length of the round-based engine
+    double duration = 1000.0;               // run length of the bit-level engine, milliseconds
+    std::vector<ScenarioNode> nodes;
+    std::vector<ScenarioMonitor> monitors;
+};
+
+// Highest node id the scenario sends from or to, the network size of its frame identifiers
+int getNetworkSize(const ScenarioDefinition& scenario);
+
+// Expands the per-minute frequencies of a scenario node into rounds and generates its messages
+void scheduleScenarioNode(Node* node, const ScenarioNode& definition, int networkSize);
+
+// Adds the targets of a scenario node to a periodic scheduler instead, one identifier per target
+// in networks of up to 8 nodes and one per sender in larger ones
+void scheduleScenarioNode(PeriodicScheduler& scheduler, const ScenarioNode& definition, int networkSize, uint64_t offset = 0);
+
+// Adds every periodic base-format message of an imported network to a scheduler, returns how many were added.
+// Payloads hold each signal at the value of its range nearest to 0; throws std::invalid_argument
+// when a signal layout does not fit its message.
+int scheduleNetwork(PeriodicScheduler& scheduler, const NetworkDefinition& network);
+
+// Sets up fault profiles, mailboxes and periodic messages of a scenario on a bit-level bus;
+// node ids map to bus node ids - 1
+void applyScenario(BitLevelBus& bus, PeriodicScheduler& scheduler, const ScenarioDefinition& scenario);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "ScenarioFile.h"
+
+#include <algorithm>
+#include <climits>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+#include "FrameFilter.h"
+#include "Node.h"
+
+static const int FORMAT_VERSION = 1;
+
+[[noreturn]] static void invalidField(const std::string& context, const QString& key, const std::string& reason)
+{
+    throw std::invalid_argument("Scenario " + context + "\"" + key.toStdString() + "\" " + reason);
+}
+
+static double number(const QJsonObject& object, const QString& key, double fallback, const std::string& context)
+{
+    QJsonValue value = object.value(key);
+    if (value.isUndefined()) {
+        return fallback;
+    }
+    if (!value.isDouble()) {
+        invalidField(context, key, "must be a number");
+    }
+    return value.toDouble();
+}
+
+static int integer(const QJsonObject& object, const QString& key, int fallback, const std::string& context)
+{
+    double value = number(object, key, fallback, context);
+    if (value < INT_MIN || value > INT_MAX || value != static_cast<int>(value)) {
+        invalidField(context, key, "must be an integer");
+    }
+    return static_cast<int>(value);
+}
+
+static bool boolean(const QJsonObject& object, const QString& key, bool fallback, const std::string& context)
+{
+    QJsonValue value = object.value(key);
+    if (value.isUndefined()) {
+        return fallback;
+    }
+    if (!value.isBool()) {
+        invalidField(context, key, "must be true or false");
+    }
+    return value.toBool();
+}
+
+static ScenarioMessage parsePeriodicMessage(const QJsonValue& value, const std::string& context)
+{
+    if (!value.isObject()) {
+        throw std::invalid_argument("Scenario " + context + "periodic messages must be objects");
+    }
+    QJsonObject object = value.toObject();
+
+    if (!object.contains("id") || !object.contains("periodMs")) {
+        throw std::invalid_argument("Scenario " + context + "periodic messages need \"id\" and \"periodMs\"");
+    }
+
+    ScenarioMessage message;
+    int id = integer(object, "id", 0, context);
+    message.dataLength = integer(object, "dlc", 8, context);
+    message.period = number(object, "periodMs", 0.0, context);
+    message.offset = number(object, "offsetMs", 0.0, context);
+    message.jitter = number(object, "jitterMs", 0.0, context);
+
+    if (id < 0 || id > 0x7FF) {
+        invalidField(context, "id", "must be an 11-bit identifier");
+    }
+    if (message.dataLength < 0 || message.dataLength > 8) {
+        invalidField(context, "dlc", "must be between 0 and 8");
+    }
+    if (message.period <= 0.0) {
+        invalidField(context, "periodMs", "must be positive");
+    }
+    if (message.offset < 0.0) {
+        invalidField(context, "offsetMs", "cannot be negative");
+    }
+    if (message.jitter < 0.0 || message.jitter >= message.period) {
+        invalidField(context, "jitterMs", "must be at least 0 and shorter than the period");
+    }
+
+    message.id = static_cast<uint16_t>(id);
+    return message;
+}
+
+static ScenarioNode parseNode(const QJsonValue& value, size_t index)
+{
+    std::string context = "node " + std::to_string(index) + ": ";
+    if (!value.isObject()) {
+        throw std::invalid_argument("Scenario " + context + "must be an object");
+    }
+    QJsonObject object = value.toObject();
+
+    if (!object.contains("id")) {
+        throw std::invalid_argument("Scenario " + context + "missing \"id\"");
+    }
+
+    ScenarioNode node;
+    node.nodeId = integer(object, "id", 0, context);
+    node.error = boolean(object, "error", false, context);
+    node.mailboxes = integer(object, "mailboxes", 1, context);
+
+    if (node.nodeId < 1 || node.nodeId > Node::MAX_NODES) {
+        invalidField(context, "id", "must be between 1 and " + std::to_string(Node::MAX_NODES));
+    }
+    if (node.mailboxes < 0) {
+        invalidField(context, "mailboxes", "cannot be negative");
+    }
+    context = "node " + std::to_string(node.nodeId) + ": ";
+
+    if (object.contains("messagesPerMinute") && !object.value("messagesPerMinute").isObject()) {
+        invalidField(context, "messagesPerMinute", "must map target node ids to frequencies");
+    }
+    if (object.contains("faults") && !object.value("faults").isObject()) {
+        invalidField(context, "faults", "must be an object");
+    }
+    if (object.contains("periodic") && !object.value("periodic").isArray()) {
+        invalidField(context, "periodic", "must be an array");
+    }
+
+    QJsonObject frequencies = object.value("messagesPerMinute").toObject();
+    for (auto it = frequencies.begin(); it != frequencies.end(); ++it) {
+        bool valid = false;
+        int target = it.key().toInt(&valid);
+        double frequency = it.value().toDouble(-1.0);
+        if (!valid || target < 1 || target > Node::MAX_NODES) {
+            invalidField(context, it.key(), "is not a target node id between 1 and " + std::to_string(Node::MAX_NODES));
+        }
+        if (frequency != static_cast<int>(frequency) || frequency < 1 || frequency > 60) {
+            invalidField(context, it.key(), "must send between 1 and 60 messages per minute");
+        }
+        node.messageAndFreq[target] = static_cast<int>(frequency);
+    }
+
+    if (object.contains("faults")) {
+        QJsonObject faults = object.value("faults").toObject();
+        node.transmitBitErrorRate = number(faults, "transmitBitErrorRate", 0.0, context);
+        node.receiveBitErrorRate = number(faults, "receiveBitErrorRate", 0.0, context);
+        node.ackDisabled = boolean(faults, "ackDisabled", false, context);
+
+        if (node.transmitBitErrorRate < 0.0 || node.transmitBitErrorRate > 1.0) {
+            invalidField(context, "transmitBitErrorRate", "must be a probability");
+        }
+        if (node.receiveBitErrorRate < 0.0 || node.receiveBitErrorRate > 1.0) {
+            invalidField(context, "receiveBitErrorRate", "must be a probability");
+        }
+    }
+
+    QJsonArray periodic = object.value("periodic").toArray();
+    node.periodicMessages.reserve(periodic.size());
+    for (const QJsonValue& message : periodic) {
+        node.periodicMessages.push_back(parsePeriodicMessage(message, context));
+    }
+
+    return node;
+}
+
+static ScenarioMonitor parseMonitor(const QJsonValue& value, size_t index)
+{
+    std::string context = "monitor " + std::to_string(index) + ": ";
+    if (!value.isObject()) {
+        throw std::invalid_argument("Scenario " + context + "must be an object");
+    }
+    QJsonObject object = value.toObject();
+
+    if (!object.value("name").isString() || !object.value("filter").isString()) {
+        throw std::invalid_argument("Scenario " + context + "needs a \"name\" and a \"filter\"");
+    }
+
+    ScenarioMonitor monitor;
+    monitor.name = object.value("name").toString().toStdString();
+    monitor.filter = object.value("filter").toString().toStdString();
+    monitor.capacity = integer(object, "capacity", monitor.capacity, context);
+
+    context = "monitor " + monitor.name + ": ";
+    // The name goes into the file the captured frames are exported to
+    if (monitor.name.empty() || monitor.name.find_first_not_of(
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-") != std::string::npos) {
+        invalidField(context, "name", "must be letters, digits, - and _");
+    }
+    if (monitor.capacity < 1) {
+        invalidField(context, "capacity", "must be at least 1");
+    }
+
+    // Compiled here only to report a bad expression when the file is loaded
+    try {
+        FrameFilter filter(monitor.filter);
+    }
+    catch (const std::invalid_argument& error) {
+        throw std::invalid_argument("Scenario " + context + error.what());
+    }
+
+    return monitor;
+}
+
+ScenarioDefinition parseScenario(const QByteArray& json)
+{
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError) {
+        throw std::invalid_argument("Scenario is not valid JSON at offset " + std::to_string(error.offset) + ": " +
+            error.errorString().toStdString());
+    }
+    if (!document.isObject()) {
+        throw std::invalid_argument("Scenario must be a JSON object");
+    }
+
+    QJsonObject root = document.object();
+    if (integer(root, "version", 0, "") != FORMAT_VERSION) {
+        throw std::invalid_argument("Unsupported scenario version, expected " + std::to_string(FORMAT_VERSION));
+    }
+
+    ScenarioDefinition scenario;
+    scenario.name = root.value("name").toString().toStdString();
+    double bitRate = number(root, "bitRate", scenario.bitRate, "");
+    scenario.rounds = integer(root, "rounds", scenario.rounds, "");
+    scenario.duration = number(root, "durationMs", scenario.duration, "");
+
+    if (bitRate <= 0 || bitRate > 8000000 || bitRate != static_cast<uint32_t>(bitRate)) {
+        invalidField("", "bitRate", "must be a whole number of bits per second");
+    }
+    if (scenario.rounds < 1) {
+        invalidField("", "rounds", "must be at least 1");
+    }
+    if (scenario.duration <= 0.0) {
+        invalidField("", "durationMs", "must be positive");
+    }
+    scenario.bitRate = static_cast<uint32_t>(bitRate);
+
+    QJsonValue nodes = root.value("nodes");
+    if (!nodes.isArray()) {
+        throw std::invalid_argument("Scenario needs a \"nodes\" array");
+    }
+
+    QJsonArray nodeArray = nodes.toArray();
+    scenario.nodes.reserve(nodeArray.size());
+
+    std::set<int> nodeIds;
+    std::set<uint16_t> periodicIds;
+    for (qsizetype i = 0; i < nodeArray.size(); ++i) {
+        ScenarioNode node = parseNode(nodeArray.at(i), static_cast<size_t>(i));
+
+        if (!nodeIds.insert(node.nodeId).second) {
+            throw std::invalid_argument("Scenario node id " + std::to_string(node.nodeId) + " is used twice");
+        }
+        for (const ScenarioMessage& message : node.periodicMessages) {
+            if (!periodicIds.insert(message.id).second) {
+                throw std::invalid_argument("Scenario identifier " + std::to_string(message.id) + " is sent by more than one stream");
+            }
+        }
+
+        scenario.nodes.push_back(std::move(node));
+    }
+
+    // The engines index their nodes by id, so the file may list them in any order but without gaps
+    std::stable_sort(scenario.nodes.begin(), scenario.nodes.end(),
+        [](const ScenarioNode& a, const ScenarioNode& b) { return a.nodeId < b.nodeId; });
+    for (size_t i = 0; i < scenario.nodes.size(); ++i) {
+        if (scenario.nodes[i].nodeId != static_cast<int>(i) + 1) {
+            throw std::invalid_argument("Scenario node ids must run from 1 to " + std::to_string(scenario.nodes.size()) +
+                " without gaps, node " + std::to_string(i + 1) + " is missing");
+        }
+    }
+
+    for (const ScenarioNode& node : scenario.nodes) {
+        for (const auto& target : node.messageAndFreq) {
+            if (!nodeIds.count(target.first)) {
+                throw std::invalid_argument("Scenario node " + std::to_string(node.nodeId) + " sends to missing node " +
+                    std::to_string(target.first));
+            }
+        }
+    }
+
+    QJsonValue monitors = root.value("monitors");
+    if (!monitors.isUndefined() && !monitors.isArray()) {
+        throw std::invalid_argument("Scenario \"monitors\" must be an array");
+    }
+
+    QJsonArray monitorArray = monitors.toArray();
+    std::set<std::string> monitorNames;
+    for (qsizetype i = 0; i < monitorArray.size(); ++i) {
+        ScenarioMonitor monitor = parseMonitor(monitorArray.at(i), static_cast<size_t>(i));
+        if (!monitorNames.insert(monitor.name).second) {
+            throw std::invalid_argument("Scenario monitor name " + monitor.name + " is used twice");
+        }
+        scenario.monitors.push_back(std::move(monitor));
+    }
+
+    return scenario;
+}
+
+ScenarioDefinition loadScenarioFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::invalid_argument("Cannot open scenario file: " + path.toStdString());
+    }
+    return parseScenario(file.readAll());
+}
+
+QByteArray serializeScenario(const ScenarioDefinition& scenario)
+{
+    QJsonObject root;
+    root["version"] = FORMAT_VERSION;
+
+    // Fields that keep their default value are left out so files stay short and diff well
+    const ScenarioDefinition defaults;
+    if (!scenario.name.empty()) {
+        root["name"] = QString::fromStdString(scenario.name);
+    }
+    if (scenario.bitRate != defaults.bitRate) {
+        root["bitRate"] = static_cast<double>(scenario.bitRate);
+    }
+    if (scenario.rounds != defaults.rounds) {
+        root["rounds"] = scenario.rounds;
+    }
+    if (scenario.duration != defaults.duration) {
+        root["durationMs"] = scenario.duration;
+    }
+
+    QJsonArray nodes;
+    for (const ScenarioNode& node : scenario.nodes) {
+        QJsonObject object;
+        object["id"] = node.nodeId;
+        if (node.error) {
+            object["error"] = true;
+        }
+
+        if (!node.messageAndFreq.empty()) {
+            QJsonObject frequencies;
+            for (const auto& target : node.messageAndFreq) {
+                frequencies[QString::number(target.first)] = target.second;
+            }
+            object["messagesPerMinute"] = frequencies;
+        }
+
+        if (node.transmitBitErrorRate > 0.0 || node.receiveBitErrorRate > 0.0 || node.ackDisabled) {
+            QJsonObject faults;
+            faults["transmitBitErrorRate"] = node.transmitBitErrorRate;
+            faults["receiveBitErrorRate"] = node.receiveBitErrorRate;
+            faults["ackDisabled"] = node.ackDisabled;
+            object["faults"] = faults;
+        }
+
+        if (node.mailboxes != 1) {
+            object["mailboxes"] = node.mailboxes;
+        }
+
+        if (!node.periodicMessages.empty()) {
+            QJsonArray periodic;
+            for (const ScenarioMessage& message : node.periodicMessages) {
+                QJsonObject entry;
+                entry["id"] = message.id;
+                entry["dlc"] = message.dataLength;
+                entry["periodMs"] = message.period;
+                if (message.offset > 0.0) {
+                    entry["offsetMs"] = message.offset;
+                }
+                if (message.jitter > 0.0) {
+                    entry["jitterMs"] = message.jitter;
+                }
+                periodic.append(entry);
+            }
+            object["periodic"] = periodic;
+        }
+
+        nodes.append(object);
+    }
+    root["nodes"] = nodes;
+
+    if (!scenario.monitors.empty()) {
+        QJsonArray monitors;
+        for (const ScenarioMonitor& monitor : scenario.monitors) {
+            QJsonObject object;
+            object["name"] = QString::fromStdString(monitor.name);
+            object["filter"] = QString::fromStdString(monitor.filter);
+            if (monitor.capacity != ScenarioMonitor().capacity) {
+                object["capacity"] = monitor.capacity;
+            }
+            monitors.append(object);
+        }
+        root["monitors"] = monitors;
+    }
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+void saveScenarioFile(const ScenarioDefinition& scenario, const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::invalid_argument("Cannot write scenario file: " + path.toStdString());
+    }
+    file.write(serializeScenario(scenario));
+}
+
+ScenarioDefinition getPredefinedScenario(int scenario)
+{
+    return loadScenarioFile(QString(":/CANSim/scenarios/scenario%1.json").arg(scenario));
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef SCENARIO_FILE_H
+#define SCENARIO_FILE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "Scenario.h"
+
+// JSON scenario files, so scenarios can be kept under version control next to the
+// regression runs that use them. Loading goes straight to a ScenarioDefinition and
+// throws std::invalid_argument naming the offending field.
+ScenarioDefinition parseScenario(const QByteArray& json);
+ScenarioDefinition loadScenarioFile(const QString& path);
+
+QByteArray serializeScenario(const ScenarioDefinition& scenario);
+void saveScenarioFile(const ScenarioDefinition& scenario, const QString& path);
+
+// The predefined scenarios are scenario files embedded in the application resources
+ScenarioDefinition getPredefinedScenario(int scenario);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "SignalCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+static uint64_t byteSwap(uint64_t value)
+{
+#ifdef _MSC_VER
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+// Host byte order is little endian on every platform the simulator targets
+static uint64_t loadLittleEndian(const uint8_t* payload)
+{
+    uint64_t word;
+    std::memcpy(&word, payload, sizeof(word));
+    return word;
+}
+
+static void storeLittleEndian(uint64_t word, uint8_t* payload)
+{
+    std::memcpy(payload, &word, sizeof(word));
+}
+
+SignalCodec::SignalCodec(const MessageDefinition& message)
+    : dataLength(message.dataLength)
+{
+    int multiplexer = -1;
+
+    for (const SignalDefinition& signal : message.signalDefinitions) {
+        if (signal.length <= 0 || signal.length > 64) {
+            throw std::invalid_argument("Invalid length for signal " + signal.name);
+        }
+        if ((signal.valueType == SignalDefinition::ValueType::Float && signal.length != 32) ||
+            (signal.valueType == SignalDefinition::ValueType::Double && signal.length != 64)) {
+            throw std::invalid_argument("Floating point signal " + signal.name + " must be 32 or 64 bits long");
+        }
+
+        Operation operation;
+        operation.bigEndian = signal.byteOrder == SignalDefinition::ByteOrder::Motorola;
+        operation.length = signal.length;
+        operation.mask = signal.length == 64 ? UINT64_MAX : (uint64_t(1) << signal.length) - 1;
+        operation.isSigned = signal.isSigned;
+        operation.valueType = signal.valueType;
+        operation.factor = signal.factor;
+        operation.offset = signal.offset;
+        operation.multiplexer = -1;
+        operation.multiplexValue = signal.multiplexValue < 0 ? 0 : static_cast<uint64_t>(signal.multiplexValue);
+
+        if (operation.bigEndian) {
+            // DBC numbers Motorola signals by their most significant bit, counted within each byte
+            int msb = (7 - signal.startBit / 8) * 8 + signal.startBit % 8;
+            operation.shift = msb - signal.length + 1;
+        }
+        else {
+            operation.shift = signal.startBit;
+        }
+
+        if (signal.startBit < 0 || signal.startBit >= 64 || operation.shift < 0 || operation.shift + signal.length > 64) {
+            throw std::invalid_argument("Signal " + signal.name + " does not fit in the payload");
+        }
+
+        if (signal.multiplexer) {
+            multiplexer = static_cast<int>(operations.size());
+        }
+
+        operations.push_back(operation);
+        names.push_back(signal.name);
+    }
+
+    // The multiplexer may be listed after the signals it selects
+    for (size_t i = 0; i < operations.size(); ++i) {
+        if (message.signalDefinitions[i].multiplexValue >= 0) {
+            if (multiplexer < 0) {
+                throw std::invalid_argument("Multiplexed signal " + names[i] + " without a multiplexer");
+            }
+            operations[i].multiplexer = multiplexer;
+        }
+    }
+}
+
+int SignalCodec::indexOf(const std::string& name) const
+{
+    auto found = std::find(names.begin(), names.end(), name);
+    return found == names.end() ? -1 : static_cast<int>(found - names.begin());
+}
+
+uint64_t SignalCodec::load(const Operation& operation, const uint8_t* payload)
+{
+    uint64_t word = loadLittleEndian(payload);
+    if (operation.bigEndian) {
+        word = byteSwap(word);
+    }
+    return (word >> operation.shift) & operation.mask;
+}
+
+double SignalCodec::physical(const Operation& operation, uint64_t raw)
+{
+    switch (operation.valueType) {
+    case SignalDefinition::ValueType::Float: {
+        float value;
+        uint32_t bits = static_cast<uint32_t>(raw);
+        std::memcpy(&value, &bits, sizeof(value));
+        return value * operation.factor + operation.offset;
+    }
+    case SignalDefinition::ValueType::Double: {
+        double value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return value * operation.factor + operation.offset;
+    }
+    default:
+        break;
+    }
+
+    if (operation.isSigned && operation.length < 64) {
+        int unused = 64 - operation.length;
+        int64_t value = static_cast<int64_t>(raw << unused) >> unused;
+        return static_cast<double>(value) * operation.factor + operation.offset;
+    }
+    if (operation.isSigned) {
+        return static_cast<double>(static_cast<int64_t>(raw)) * operation.factor + operation.offset;
+    }
+    return static_cast<double>(raw) * operation.factor + operation.offset;
+}
+
+bool SignalCodec::present(const Operation& operation, const uint8_t* payload) const
+{
+    return operation.multiplexer < 0 || load(operations[operation.multiplexer], payload) == operation.multiplexValue;
+}
+
+uint64_t SignalCodec::decodeRaw(int signal, const uint8_t* payload) const
+{
+    return load(operations[signal], payload);
+}
+
+void SignalCodec::encodeRaw(int signal, uint64_t raw, uint8_t* payload) const
+{
+    const Operation& operation = operations[signal];
+    uint64_t word = loadLittleEndian(payload);
+    if (operation.bigEndian) {
+        word = byteSwap(word);
+    }
+
+    word &= ~(operation.mask << operation.shift);
+    word |= (raw & operation.mask) << operation.shift;
+
+    storeLittleEndian(operation.bigEndian ? byteSwap(word) : word, payload);
+}
+
+double SignalCodec::decode(int signal, const uint8_t* payload) const
+{
+    const Operation& operation = operations[signal];
+    if (!present(operation, payload)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return physical(operation, load(operation, payload));
+}
+
+void SignalCodec::encode(int signal, double value, uint8_t* payload) const
+{
+    const Operation& operation = operations[signal];
+    double scaled = (value - operation.offset) / operation.factor;
+    uint64_t raw;
+
+    switch (operation.valueType) {
+    case SignalDefinition::ValueType::Float: {
+        float single = static_cast<float>(scaled);
+        uint32_t bits;
+        std::memcpy(&bits, &single, sizeof(bits));
+        raw = bits;
+        break;
+    }
+    case SignalDefinition::ValueType::Double:
+        std::memcpy(&raw, &scaled, sizeof(raw));
+        break;
+    default: {
+        // Out of range values saturate instead of wrapping into the neighbouring signals
+        double rounded = std::round(scaled);
+        if (operation.isSigned) {
+            double limit = std::ldexp(1.0, operation.length - 1);
+            rounded = std::min(std::max(rounded, -limit), limit - 1);
+            raw = static_cast<uint64_t>(static_cast<int64_t>(rounded));
+        }
+        else {
+            double limit = std::ldexp(1.0, operation.length);
+            rounded = std::min(std::max(rounded, 0.0), limit - 1);
+            raw = rounded >= 9223372036854775808.0
+                ? static_cast<uint64_t>(rounded - 9223372036854775808.0) | (uint64_t(1) << 63)
+                : static_cast<uint64_t>(rounded);
+        }
+        break;
+    }
+    }
+
+    encodeRaw(signal, raw, payload);
+}
+
+double SignalCodec::decode(int signal, const std::vector<uint8_t>& data) const
+{
+    uint8_t payload[PAYLOAD_SIZE] = {};
+    std::copy_n(data.begin(), std::min(data.size(), PAYLOAD_SIZE), payload);
+    return decode(signal, payload);
+}
+
+void SignalCodec::encode(int signal, double value, std::vector<uint8_t>& data) const
+{
+    uint8_t payload[PAYLOAD_SIZE] = {};
+    std::copy_n(data.begin(), std::min(data.size(), PAYLOAD_SIZE), payload);
+    encode(signal, value, payload);
+
+    data.resize(std::max(data.size(), static_cast<size_t>(std::min(dataLength, 8))));
+    std::copy_n(payload, std::min(data.size(), PAYLOAD_SIZE), data.begin());
+}
+
+// Integer signals shorter than 64 bits, specialised so the loop body has no branches left
+template <bool BigEndian, bool Signed>
+static void decodeIntegerColumn(const uint8_t* payloads, size_t count, int shift, int length,
+    double factor, double offset, double* column)
+{
+    int unused = 64 - length;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t word = loadLittleEndian(payloads + i * SignalCodec::PAYLOAD_SIZE);
+        if (BigEndian) {
+            word = byteSwap(word);
+        }
+        word = (word >> shift) << unused;
+        int64_t value = Signed ? static_cast<int64_t>(word) >> unused : static_cast<int64_t>(word >> unused);
+        column[i] = static_cast<double>(value) * factor + offset;
+    }
+}
+
+void SignalCodec::decodeBatch(const uint8_t* payloads, size_t count, std::vector<std::vector<double>>& columns) const
+{
+    columns.resize(operations.size());
+
+    // One signal at a time over all frames, so each pass is a straight loop over the payloads
+    for (size_t signal = 0; signal < operations.size(); ++signal) {
+        const Operation& operation = operations[signal];
+        std::vector<double>& column = columns[signal];
+        column.resize(count);
+
+        if (operation.valueType == SignalDefinition::ValueType::Integer && operation.length < 64) {
+            auto decodeColumn = operation.bigEndian
+                ? (operation.isSigned ? decodeIntegerColumn<true, true> : decodeIntegerColumn<true, false>)
+                : (operation.isSigned ? decodeIntegerColumn<false, true> : decodeIntegerColumn<false, false>);
+            decodeColumn(payloads, count, operation.shift, operation.length, operation.factor, operation.offset, column.data());
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                column[i] = physical(operation, load(operation, payloads + i * PAYLOAD_SIZE));
+            }
+        }
+
+        if (operation.multiplexer >= 0) {
+            const Operation& multiplexer = operations[operation.multiplexer];
+            for (size_t i = 0; i < count; ++i) {
+                if (load(multiplexer, payloads + i * PAYLOAD_SIZE) != operation.multiplexValue) {
+                    column[i] = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef SIGNAL_CODEC_H
+#define SIGNAL_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Network.h"
+
+// Signal layout of one message compiled into a flat list of shift and mask operations.
+// The payload is read as a single 64-bit word, little endian for Intel signals and big
+// endian for Motorola ones, so every signal is one shift and one mask regardless of how
+// many bytes it spans.
+class SignalCodec {
+public:
+    static constexpr size_t PAYLOAD_SIZE = 8;
+
+    explicit SignalCodec(const MessageDefinition& message);
+
+    size_t getSignalCount() const { return operations.size(); }
+    const std::string& getName(int signal) const { return names[signal]; }
+    int indexOf(const std::string& name) const;
+
+    uint64_t decodeRaw(int signal, const uint8_t* payload) const;
+    void encodeRaw(int signal, uint64_t raw, uint8_t* payload) const;
+
+    // Physical value, NaN when a multiplexed signal is not present in this frame
+    double decode(int signal, const uint8_t* payload) const;
+    void encode(int signal, double value, uint8_t* payload) const;
+
+    double decode(int signal, const std::vector<uint8_t>& data) const;
+    void encode(int signal, double value, std::vector<uint8_t>& data) const;
+
+    // Decodes count payloads of PAYLOAD_SIZE bytes stored back to back into one column per signal
+    void decodeBatch(const uint8_t* payloads, size_t count, std::vector<std::vector<double>>& columns) const;
+
+private:
+    struct Operation {
+        bool bigEndian;
+        int shift;
+        int length;
+        uint64_t mask;
+        bool isSigned;
+        SignalDefinition::ValueType valueType;
+        double factor;
+        double offset;
+        int multiplexer;                // operation holding the multiplexer switch, -1 if always present
+        uint64_t multiplexValue;
+    };
+
+    static uint64_t load(const Operation& operation, const uint8_t* payload);
+    static double physical(const Operation& operation, uint64_t raw);
+    bool present(const Operation& operation, const uint8_t* payload) const;
+
+    std::vector<Operation> operations;
+    std::vector<std::string> names;
+    int dataLength;
+};
+
+#endif
\ No newline at end of file
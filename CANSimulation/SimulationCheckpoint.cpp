@@ -0,0 +1,671 @@
+#include "SimulationCheckpoint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "CANBus.h"
+#include "Node.h"
+#include "Message.h"
+#include "TransmitQueue.h"
+#include "TimingMetrics.h"
+#include "LatencyHistogram.h"
+#include "BusCounters.h"
+
+static const char MAGIC[8] = { 'C', 'A', 'N', 'C', 'K', 'P', 'T', 0 };
+static const uint32_t VERSION = 2;
+
+// Fixed-width fields in host byte order, appended to one buffer that is written with a single call
+class SimulationCheckpoint::Writer {
+public:
+    template <typename T>
+    void put(T value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be plain values");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void putBool(bool value) { put<uint8_t>(value ? 1 : 0); }
+    void putCount(size_t count) { put<uint32_t>(static_cast<uint32_t>(count)); }
+
+    void putMessage(const Message& message)
+    {
+        std::vector<uint8_t> data = message.getData();
+        put<uint16_t>(message.getId());
+        put<int32_t>(message.getRound());
+        put<int32_t>(message.getSenderId());
+        put<uint16_t>(message.getCRC());
+        put<uint16_t>(message.getStuffedId());
+        putBool(message.getACK());
+        put<uint8_t>(static_cast<uint8_t>(data.size()));
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        putCount(message.getReceivers().size());
+        for (int receiverId : message.getReceivers()) {
+            put<int32_t>(receiverId);
+        }
+    }
+
+    std::vector<uint8_t> buffer;
+};
+
+// Bounds-checked reads over a snapshot held in memory
+class SimulationCheckpoint::Reader {
+public:
+    Reader(const uint8_t* begin, const uint8_t* end) : p(begin), end(end) {}
+
+    template <typename T>
+    T get()
+    {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    bool getBool() { return get<uint8_t>() != 0; }
+
+    // Element count, rejected when the remaining bytes cannot hold that many elements
+    size_t getCount(size_t minimumSize)
+    {
+        size_t count = get<uint32_t>();
+        if (count > static_cast<size_t>(end - p) / minimumSize) {
+            fail("element count exceeds the snapshot size");
+        }
+        return count;
+    }
+
+    Message getMessage()
+    {
+        uint16_t id = get<uint16_t>();
+        int round = get<int32_t>();
+        int senderId = get<int32_t>();
+        uint16_t crc = get<uint16_t>();
+        uint16_t stuffedId = get<uint16_t>();
+        bool ack = getBool();
+        size_t length = get<uint8_t>();
+        if (length > 8) {
+            fail("frame with more than 8 data bytes");
+        }
+
+        require(length);
+        std::vector<uint8_t> data(p, p + length);
+        p += length;
+
+        std::vector<int> receivers;
+        for (size_t i = getCount(4); i > 0; --i) {
+            receivers.push_back(get<int32_t>());
+        }
+
+        Message message(id, data, round, ack);
+        message.setACK(ack);
+        message.setCRC(crc);
+        message.setSenderId(senderId);
+        message.setStuffedId(stuffedId);
+        message.setReceivers(receivers);
+        return message;
+    }
+
+    bool atEnd() const { return p == end; }
+
+    [[noreturn]] static void fail(const std::string& reason)
+    {
+        throw std::invalid_argument("Invalid simulation checkpoint: " + reason);
+    }
+
+private:
+    void require(size_t size)
+    {
+        if (static_cast<size_t>(end - p) < size) {
+            fail("unexpected end of data");
+        }
+    }
+
+    const uint8_t* p;
+    const uint8_t* end;
+};
+
+static const size_t MIN_MESSAGE_SIZE = 20;
+static const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t);
+
+static uint64_t queueKey(const Message& message)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(message.getRound())) << 16) | message.getId();
+}
+
+static uint64_t pendingKey(const Message& message)
+{
+    return (static_cast<uint64_t>(static_cast<uint16_t>(message.getSenderId())) << 48) | queueKey(message);
+}
+
+static bool roundBefore(const Message* message, int round)
+{
+    return message->getRound() < round;
+}
+
+std::vector<uint8_t> SimulationCheckpoint::capture(const CANBus& bus)
+{
+    Writer out;
+    out.buffer.insert(out.buffer.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    out.put<uint32_t>(VERSION);
+
+    out.put<int32_t>(bus.round);
+    out.putCount(bus.pendingMessages.size());
+    for (const Message& message : bus.pendingMessages) {
+        out.putMessage(message);
+    }
+    out.putCount(bus.winners.size());
+    for (const Message& message : bus.winners) {
+        out.putMessage(message);
+    }
+
+    writeStatistics(out, bus.statistics);
+    writeMetrics(out, bus.metrics);
+    writeCounters(out, bus.counters);
+
+    out.putCount(bus.nodes.size());
+    for (const Node* node : bus.nodes) {
+        writeNode(out, *node);
+    }
+
+    return std::move(out.buffer);
+}
+
+void SimulationCheckpoint::apply(CANBus& bus, const std::vector<uint8_t>& snapshot)
+{
+    Reader in(snapshot.data(), snapshot.data() + snapshot.size());
+
+    char magic[sizeof(MAGIC)];
+    for (char& c : magic) {
+        c = static_cast<char>(in.get<uint8_t>());
+    }
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        Reader::fail("not a checkpoint");
+    }
+    if (in.get<uint32_t>() != VERSION) {
+        Reader::fail("unsupported version");
+    }
+
+    int round = in.get<int32_t>();
+    std::vector<Message> pendingMessages;
+    for (size_t i = in.getCount(MIN_MESSAGE_SIZE); i > 0; --i) {
+        pendingMessages.push_back(in.getMessage());
+    }
+    std::vector<Message> winners;
+    for (size_t i = in.getCount(MIN_MESSAGE_SIZE); i > 0; --i) {
+        winners.push_back(in.getMessage());
+    }
+
+    SimulationStatistics statistics;
+    readStatistics(in, statistics);
+    TimingMetrics metrics;
+    readMetrics(in, metrics);
+    BusCounters::Snapshot counters;
+    readCounters(in, counters);
+
+    size_t nodeCount = in.getCount(1);
+    if (nodeCount != bus.nodes.size()) {
+        Reader::fail("taken from a bus with " + std::to_string(nodeCount) + " nodes, this bus has " + std::to_string(bus.nodes.size()));
+    }
+
+    for (Node* node : bus.nodes) {
+        readNode(in, *node);
+    }
+    if (!in.atEnd()) {
+        Reader::fail("trailing data");
+    }
+
+    bus.round = round;
+    bus.pendingMessages = std::move(pendingMessages);
+    bus.winners = std::move(winners);
+    bus.statistics = std::move(statistics);
+    bus.metrics = std::move(metrics);
+    bus.counters.restore(counters);
+    bus.arbitrationSteps.clear();
+}
+
+int SimulationCheckpoint::snapshotRound(const std::vector<uint8_t>& snapshot)
+{
+    if (snapshot.size() < HEADER_SIZE || std::memcmp(snapshot.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        Reader::fail("not a checkpoint");
+    }
+
+    Reader in(snapshot.data() + HEADER_SIZE, snapshot.data() + snapshot.size());
+    return in.get<int32_t>();
+}
+
+void SimulationCheckpoint::applyPrefix(CANBus& bus, const std::vector<uint8_t>& snapshot)
+{
+    int round = snapshotRound(snapshot);
+
+    // Frames of the bus's own configuration from the snapshot round on, taken out so apply does not free them
+    struct Configuration {
+        std::vector<Message*> laterFrames;
+        std::map<int, std::vector<int>> nodesAndRounds;
+        int networkSize;
+        bool nodeError;
+        bool generatedWithError;
+    };
+    std::vector<Configuration> configurations;
+    for (Node* node : bus.nodes) {
+        auto firstLater = std::lower_bound(node->messagesToBeSent.begin(), node->messagesToBeSent.end(), round, roundBefore);
+
+        Configuration configuration;
+        configuration.laterFrames.assign(firstLater, node->messagesToBeSent.end());
+        configuration.nodesAndRounds = node->nodesAndRounds;
+        configuration.networkSize = node->networkSize;
+        configuration.nodeError = node->nodeError;
+        configuration.generatedWithError = node->generatedWithError;
+        configurations.push_back(std::move(configuration));
+
+        node->messagesToBeSent.erase(firstLater, node->messagesToBeSent.end());
+    }
+    std::vector<Message> configuredMessages = std::move(bus.pendingMessages);
+
+    apply(bus, snapshot);
+
+    for (size_t i = 0; i < bus.nodes.size(); ++i) {
+        Node& node = *bus.nodes[i];
+        Configuration& configuration = configurations[i];
+
+        auto firstLater = std::lower_bound(node.messagesToBeSent.begin(), node.messagesToBeSent.end(), round, roundBefore);
+        for (auto it = firstLater; it != node.messagesToBeSent.end(); ++it) {
+            delete *it;
+        }
+        node.messagesToBeSent.erase(firstLater, node.messagesToBeSent.end());
+        node.messagesToBeSent.insert(node.messagesToBeSent.end(), configuration.laterFrames.begin(), configuration.laterFrames.end());
+
+        node.messageIndex.clear();
+        for (Message* message : node.messagesToBeSent) {
+            node.messageIndex[queueKey(*message)] = message;
+        }
+
+        node.nodesAndRounds = std::move(configuration.nodesAndRounds);
+        node.networkSize = configuration.networkSize;
+        node.dirtyRounds.clear();
+        node.nodeError = configuration.nodeError;
+        node.generatedWithError = configuration.generatedWithError;
+    }
+
+    // Pending frames keep the order of the configuration, earlier ones only while the snapshot still has them
+    std::unordered_map<uint64_t, const Message*> earlierFrames;
+    for (const Message& message : bus.pendingMessages) {
+        if (message.getRound() < round) {
+            earlierFrames[pendingKey(message)] = &message;
+        }
+    }
+
+    std::vector<Message> pendingMessages;
+    size_t earlierCount = 0;
+    for (const Message& message : configuredMessages) {
+        if (message.getRound() >= round) {
+            pendingMessages.push_back(message);
+            continue;
+        }
+
+        auto found = earlierFrames.find(pendingKey(message));
+        if (found != earlierFrames.end()) {
+            pendingMessages.push_back(*found->second);
+            earlierCount++;
+        }
+    }
+    if (earlierCount != earlierFrames.size()) {
+        Reader::fail("frames before round " + std::to_string(round) + " differ from the configuration of the bus");
+    }
+
+    bus.pendingMessages = std::move(pendingMessages);
+}
+
+void SimulationCheckpoint::save(const CANBus& bus, const std::string& path)
+{
+    std::vector<uint8_t> snapshot = capture(bus);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+    if (!file) {
+        throw std::invalid_argument("Cannot write checkpoint file: " + path);
+    }
+}
+
+void SimulationCheckpoint::restore(CANBus& bus, const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::invalid_argument("Cannot open checkpoint file: " + path);
+    }
+
+    std::vector<uint8_t> snapshot(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(snapshot.data()), snapshot.size())) {
+        throw std::invalid_argument("Cannot read checkpoint file: " + path);
+    }
+
+    apply(bus, snapshot);
+}
+
+void SimulationCheckpoint::writeStatistics(Writer& out, const SimulationStatistics& statistics)
+{
+    out.put<uint64_t>(statistics.seed);
+    out.put<int32_t>(statistics.rounds);
+    out.put<int32_t>(statistics.framesDelivered);
+    out.put<int32_t>(statistics.failedTransmissions);
+    out.put<int32_t>(statistics.droppedFrames);
+
+    out.putCount(statistics.TEC.size());
+    for (size_t i = 0; i < statistics.TEC.size(); ++i) {
+        out.put<int32_t>(statistics.TEC[i]);
+        out.put<int32_t>(statistics.REC[i]);
+        out.putBool(statistics.nodeActive[i]);
+        out.putBool(statistics.nodeError[i]);
+    }
+}
+
+void SimulationCheckpoint::readStatistics(Reader& in, SimulationStatistics& statistics)
+{
+    statistics.seed = in.get<uint64_t>();
+    statistics.rounds = in.get<int32_t>();
+    statistics.framesDelivered = in.get<int32_t>();
+    statistics.failedTransmissions = in.get<int32_t>();
+    statistics.droppedFrames = in.get<int32_t>();
+
+    for (size_t i = in.getCount(10); i > 0; --i) {
+        statistics.TEC.push_back(in.get<int32_t>());
+        statistics.REC.push_back(in.get<int32_t>());
+        statistics.nodeActive.push_back(in.getBool());
+        statistics.nodeError.push_back(in.getBool());
+    }
+}
+
+void SimulationCheckpoint::writeNode(Writer& out, const Node& node)
+{
+    out.put<int32_t>(node.nodeId);
+    out.put<int32_t>(node.TEC);
+    out.put<int32_t>(node.REC);
+    out.putBool(node.nodeActive);
+    out.putBool(node.nodeError);
+    out.putBool(node.generatedWithError);
+    out.put<int32_t>(node.networkSize);
+
+    out.putCount(node.messagesToBeSent.size());
+    for (const Message* message : node.messagesToBeSent) {
+        out.putMessage(*message);
+    }
+    out.putCount(node.receivedMessages.size());
+    for (const Message* message : node.receivedMessages) {
+        out.putMessage(*message);
+    }
+
+    out.putCount(node.nodesAndRounds.size());
+    for (const auto& roundEntry : node.nodesAndRounds) {
+        out.put<int32_t>(roundEntry.first);
+        out.putCount(roundEntry.second.size());
+        for (int receiverId : roundEntry.second) {
+            out.put<int32_t>(receiverId);
+        }
+    }
+    out.putCount(node.dirtyRounds.size());
+    for (int round : node.dirtyRounds) {
+        out.put<int32_t>(round);
+    }
+
+    writeTransmitQueue(out, node.transmitQueue);
+}
+
+void SimulationCheckpoint::readNode(Reader& in, Node& node)
+{
+    int nodeId = in.get<int32_t>();
+    if (nodeId != node.nodeId) {
+        Reader::fail("node " + std::to_string(nodeId) + " does not match node " + std::to_string(node.nodeId) + " of the bus");
+    }
+
+    node.TEC = in.get<int32_t>();
+    node.REC = in.get<int32_t>();
+    node.nodeActive = in.getBool();
+    node.nodeError = in.getBool();
+    node.generatedWithError = in.getBool();
+    node.networkSize = in.get<int32_t>();
+    if (node.networkSize < 1 || node.networkSize > Node::MAX_NODES) {
+        Reader::fail("network size " + std::to_string(node.networkSize) + " out of range");
+    }
+
+    // The node owns its queued and received frames, and the queued ones are found again through the index
+    for (Message* message : node.messagesToBeSent) {
+        delete message;
+    }
+    node.messagesToBeSent.clear();
+    node.messageIndex.clear();
+    for (size_t i = in.getCount(MIN_MESSAGE_SIZE); i > 0; --i) {
+        Message* message = new Message(in.getMessage());
+        node.messagesToBeSent.push_back(message);
+        node.messageIndex[queueKey(*message)] = message;
+    }
+
+    for (Message* message : node.receivedMessages) {
+        delete message;
+    }
+    node.receivedMessages.clear();
+    for (size_t i = in.getCount(MIN_MESSAGE_SIZE); i > 0; --i) {
+        node.receivedMessages.push_back(new Message(in.getMessage()));
+    }
+
+    node.nodesAndRounds.clear();
+    for (size_t i = in.getCount(8); i > 0; --i) {
+        std::vector<int>& receiverIds = node.nodesAndRounds[in.get<int32_t>()];
+        for (size_t j = in.getCount(4); j > 0; --j) {
+            receiverIds.push_back(in.get<int32_t>());
+        }
+    }
+    node.dirtyRounds.clear();
+    for (size_t i = in.getCount(4); i > 0; --i) {
+        node.dirtyRounds.insert(in.get<int32_t>());
+    }
+
+    readTransmitQueue(in, node.transmitQueue);
+}
+
+void SimulationCheckpoint::writeTransmitQueue(Writer& out, const TransmitQueue& queue)
+{
+    out.put<int32_t>(queue.mailboxCount);
+    out.putBool(queue.order == TransmitQueue::Order::Priority);
+    out.put<uint64_t>(queue.sequence);
+    out.put<int32_t>(queue.threshold);
+
+    out.put<uint64_t>(queue.statistics.frames);
+    out.put<uint64_t>(queue.statistics.invertedFrames);
+    out.put<uint64_t>(queue.statistics.totalInversion);
+    out.put<uint64_t>(queue.statistics.maxInversion);
+    out.put<uint64_t>(queue.statistics.maxSoftwareDepth);
+
+    // Mailbox and software order both follow from the entries, which are written by key so
+    // that equal queues give equal snapshots whatever order the hash map iterates in
+    std::vector<uint64_t> keys;
+    keys.reserve(queue.entries.size());
+    for (const auto& entry : queue.entries) {
+        keys.push_back(entry.first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    out.putCount(keys.size());
+    for (uint64_t key : keys) {
+        const TransmitQueue::Entry& entry = queue.entries.at(key);
+        out.put<uint64_t>(key);
+        out.put<uint16_t>(entry.id);
+        out.put<uint64_t>(entry.sequence);
+        out.putBool(entry.inMailbox);
+        out.put<uint64_t>(entry.invertedSince);
+        out.put<uint64_t>(entry.inversion);
+    }
+}
+
+void SimulationCheckpoint::readTransmitQueue(Reader& in, TransmitQueue& queue)
+{
+    queue.mailboxCount = in.get<int32_t>();
+    queue.order = in.getBool() ? TransmitQueue::Order::Priority : TransmitQueue::Order::Fifo;
+    queue.sequence = in.get<uint64_t>();
+    queue.threshold = in.get<int32_t>();
+
+    queue.statistics.frames = in.get<uint64_t>();
+    queue.statistics.invertedFrames = in.get<uint64_t>();
+    queue.statistics.totalInversion = in.get<uint64_t>();
+    queue.statistics.maxInversion = in.get<uint64_t>();
+    queue.statistics.maxSoftwareDepth = static_cast<size_t>(in.get<uint64_t>());
+
+    queue.entries.clear();
+    queue.mailboxes.clear();
+    queue.software.clear();
+    queue.softwareById.clear();
+    for (size_t i = in.getCount(35); i > 0; --i) {
+        uint64_t key = in.get<uint64_t>();
+        TransmitQueue::Entry& entry = queue.entries[key];
+        entry.id = in.get<uint16_t>();
+        entry.sequence = in.get<uint64_t>();
+        entry.inMailbox = in.getBool();
+        entry.invertedSince = in.get<uint64_t>();
+        entry.inversion = in.get<uint64_t>();
+
+        uint64_t idOrder = TransmitQueue::idOrder(entry.id, entry.sequence);
+        if (entry.inMailbox) {
+            queue.mailboxes[idOrder] = key;
+        }
+        else {
+            queue.software[queue.order == TransmitQueue::Order::Priority ? idOrder : entry.sequence] = key;
+            queue.softwareById[idOrder] = key;
+        }
+    }
+}
+
+void SimulationCheckpoint::writeMetrics(Writer& out, const TimingMetrics& metrics)
+{
+    for (const auto* flows : { &metrics.perId, &metrics.perNode }) {
+        size_t used = 0;
+        for (const auto& flow : *flows) {
+            used += flow ? 1 : 0;
+        }
+
+        out.putCount(flows->size());
+        out.putCount(used);
+        for (size_t i = 0; i < flows->size(); ++i) {
+            const TimingMetrics::FlowMetrics* flow = (*flows)[i].get();
+            if (!flow) {
+                continue;
+            }
+
+            out.putCount(i);
+            writeHistogram(out, flow->queueingDelay);
+            writeHistogram(out, flow->transmissionLatency);
+            writeHistogram(out, flow->interArrivalJitter);
+            writeHistogram(out, flow->priorityInversion);
+            out.put<uint64_t>(flow->arbitrationLosses);
+            out.put<uint64_t>(flow->retransmissions);
+            out.put<uint64_t>(flow->lastDelivery);
+            out.put<uint64_t>(flow->lastInterval);
+            out.put<int32_t>(flow->deliveries);
+        }
+    }
+}
+
+void SimulationCheckpoint::readMetrics(Reader& in, TimingMetrics& metrics)
+{
+    for (auto* flows : { &metrics.perId, &metrics.perNode }) {
+        size_t size = in.get<uint32_t>();
+        if (size > TimingMetrics::ID_COUNT) {
+            Reader::fail("too many flows in the timing metrics");
+        }
+
+        flows->clear();
+        flows->resize(size);
+        for (size_t i = in.getCount(4); i > 0; --i) {
+            size_t index = in.get<uint32_t>();
+            if (index >= size) {
+                Reader::fail("flow index out of range");
+            }
+
+            std::unique_ptr<TimingMetrics::FlowMetrics> flow(new TimingMetrics::FlowMetrics());
+            readHistogram(in, flow->queueingDelay);
+            readHistogram(in, flow->transmissionLatency);
+            readHistogram(in, flow->interArrivalJitter);
+            readHistogram(in, flow->priorityInversion);
+            flow->arbitrationLosses = in.get<uint64_t>();
+            flow->retransmissions = in.get<uint64_t>();
+            flow->lastDelivery = in.get<uint64_t>();
+            flow->lastInterval = in.get<uint64_t>();
+            flow->deliveries = in.get<int32_t>();
+            (*flows)[index] = std::move(flow);
+        }
+    }
+}
+
+void SimulationCheckpoint::writeHistogram(Writer& out, const LatencyHistogram& histogram)
+{
+    out.put<uint64_t>(histogram.count);
+    out.put<uint64_t>(histogram.sum);
+    out.put<uint64_t>(histogram.min);
+    out.put<uint64_t>(histogram.max);
+
+    // Only occupied buckets are stored, most of the range stays empty in a run
+    size_t used = histogram.buckets.size() - std::count(histogram.buckets.begin(), histogram.buckets.end(), 0);
+    out.putCount(used);
+    for (size_t i = 0; i < histogram.buckets.size(); ++i) {
+        if (histogram.buckets[i] != 0) {
+            out.put<uint16_t>(static_cast<uint16_t>(i));
+            out.put<uint64_t>(histogram.buckets[i]);
+        }
+    }
+}
+
+void SimulationCheckpoint::readHistogram(Reader& in, LatencyHistogram& histogram)
+{
+    histogram.count = in.get<uint64_t>();
+    histogram.sum = in.get<uint64_t>();
+    histogram.min = in.get<uint64_t>();
+    histogram.max = in.get<uint64_t>();
+
+    histogram.buckets.assign(LatencyHistogram::BUCKET_COUNT, 0);
+    for (size_t i = in.getCount(10); i > 0; --i) {
+        size_t index = in.get<uint16_t>();
+        if (index >= histogram.buckets.size()) {
+            Reader::fail("histogram bucket out of range");
+        }
+        histogram.buckets[index] = in.get<uint64_t>();
+    }
+}
+
+void SimulationCheckpoint::writeCounters(Writer& out, const BusCounters& counters)
+{
+    BusCounters::Snapshot snapshot = counters.snapshot();
+    out.put<uint64_t>(snapshot.frames);
+    out.put<uint64_t>(snapshot.bits);
+    out.put<uint64_t>(snapshot.stuffBits);
+    out.put<uint64_t>(snapshot.errorFrames);
+    out.put<uint64_t>(snapshot.busTime);
+
+    out.putCount(snapshot.txFrames.size());
+    for (size_t i = 0; i < snapshot.txFrames.size(); ++i) {
+        out.put<uint64_t>(snapshot.txFrames[i]);
+        out.put<uint64_t>(snapshot.rxFrames[i]);
+    }
+}
+
+void SimulationCheckpoint::readCounters(Reader& in, BusCounters::Snapshot& snapshot)
+{
+    snapshot.frames = in.get<uint64_t>();
+    snapshot.bits = in.get<uint64_t>();
+    snapshot.stuffBits = in.get<uint64_t>();
+    snapshot.errorFrames = in.get<uint64_t>();
+    snapshot.busTime = in.get<uint64_t>();
+
+    size_t nodeCount = in.getCount(16);
+    if (nodeCount > BusCounters::MAX_NODES) {
+        Reader::fail("too many nodes in the bus counters");
+    }
+    for (size_t i = 0; i < nodeCount; ++i) {
+        snapshot.txFrames.push_back(in.get<uint64_t>());
+        snapshot.rxFrames.push_back(in.get<uint64_t>());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef SIMULATION_CHECKPOINT_H
+#define SIMULATION_CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BusCounters.h"
+
+class CANBus;
+class Node;
+class TransmitQueue;
+class TimingMetrics;
+class LatencyHistogram;
+struct SimulationStatistics;
+
+// Compact binary snapshot of a CANBus run: round, pending and won frames, statistics,
+// metrics and counters, and for every node its error counters, queued and received frames
+// and transmit queue. Restoring reads the snapshot in one go and rebuilds the state in
+// place on the nodes of the bus, which must be the same nodes the snapshot was taken from.
+// The arbitration history kept for the visualisation is not part of the snapshot.
+class SimulationCheckpoint {
+public:
+    static std::vector<uint8_t> capture(const CANBus& bus);
+    static void apply(CANBus& bus, const std::vector<uint8_t>& snapshot);
+
+    // Restores what a snapshot recorded before its round onto a bus set up with another
+    // configuration, keeping the bus's own frames from that round on and the error settings
+    // of its nodes. Both configurations must release the same frames before that round, and
+    // no frame of a later round may have been sent or dropped when the snapshot was taken.
+    static void applyPrefix(CANBus& bus, const std::vector<uint8_t>& snapshot);
+
+    static void save(const CANBus& bus, const std::string& path);
+    static void restore(CANBus& bus, const std::string& path);
+
+private:
+    class Writer;
+    class Reader;
+
+    static int snapshotRound(const std::vector<uint8_t>& snapshot);
+
+    static void writeStatistics(Writer& out, const SimulationStatistics& statistics);
+    static void writeNode(Writer& out, const Node& node);
+    static void writeTransmitQueue(Writer& out, const TransmitQueue& queue);
+    static void writeMetrics(Writer& out, const TimingMetrics& metrics);
+    static void writeHistogram(Writer& out, const LatencyHistogram& histogram);
+    static void writeCounters(Writer& out, const BusCounters& counters);
+
+    static void readStatistics(Reader& in, SimulationStatistics& statistics);
+    static void readNode(Reader& in, Node& node);
+    static void readTransmitQueue(Reader& in, TransmitQueue& queue);
+    static void readMetrics(Reader& in, TimingMetrics& metrics);
+    static void readHistogram(Reader& in, LatencyHistogram& histogram);
+    static void readCounters(Reader& in, BusCounters::Snapshot& snapshot);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef SIMULATION_STATISTICS_H
+#define SIMULATION_STATISTICS_H
+
+#include <cstdint>
+#include <vector>
+
+// Outcome of one simulated run, filled in the same way by CANBus and by every lane of BitSlicedBus
+struct SimulationStatistics {
+    uint64_t seed = 0;
+    int rounds = 0;
+    int framesDelivered = 0;
+    int failedTransmissions = 0;    // won arbitration but no receiver acknowledged it
+    int droppedFrames = 0;          // won arbitration without any active receiver
+    std::vector<int> TEC;
+    std::vector<int> REC;
+    std::vector<bool> nodeActive;
+    std::vector<bool> nodeError;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "SimulationWorker.h"
+
+#include <chrono>
+
+#include "Node.h"
+
+SimulationWorker::SimulationWorker(CANBus& bus, int rounds, size_t capacity)
+    : bus(bus), rounds(rounds), queue(capacity), stopping(false), finished(false), roundsSimulated(0)
+{
+}
+
+SimulationWorker::~SimulationWorker()
+{
+    stop();
+}
+
+void SimulationWorker::start()
+{
+    if (worker.joinable()) {
+        return;
+    }
+
+    worker = std::thread(&SimulationWorker::run, this);
+}
+
+void SimulationWorker::stop()
+{
+    stopping.store(true, std::memory_order_relaxed);
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool SimulationWorker::publish(Round& round)
+{
+    // Back-pressure: wait for the viewer instead of buffering without limit
+    while (!queue.push(round)) {
+        if (stopping.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void SimulationWorker::run()
+{
+    std::vector<size_t> receivedBefore;
+
+    bool messagesPending;
+    do {
+        messagesPending = true;
+
+        receivedBefore.clear();
+        for (const Node* node : bus.nodes) {
+            receivedBefore.push_back(node->receivedMessages.size());
+        }
+
+        bool success = bus.arbitrate();
+        roundsSimulated.fetch_add(1, std::memory_order_relaxed);
+
+        // The steps and the winner of this round move to the viewer, so the bus keeps no history
+        if (!bus.arbitrationSteps.empty()) {
+            Round round;
+            round.round = bus.arbitrationSteps.front().round;
+            round.steps = std::move(bus.arbitrationSteps);
+            bus.arbitrationSteps.clear();
+            round.nodes = bus.arbitrationNodes;
+
+            if (!bus.winners.empty()) {
+                round.winner = bus.winners.front();
+                bus.winners.clear();
+            }
+
+            uint16_t id = round.winner.getId();
+            for (int receiverId : round.winner.getReceivers()) {
+                size_t i = receiverId - 1;
+                if (i >= receivedBefore.size()) {
+                    continue;
+                }
+
+                const std::vector<Message*>& received = bus.nodes[i]->receivedMessages;
+                for (size_t j = receivedBefore[i]; j < received.size(); ++j) {
+                    if (received[j]->getId() == id && received[j]->getRound() == round.winner.getRound()) {
+                        round.receivers.push_back(receiverId);
+                        break;
+                    }
+                }
+            }
+
+            if (!publish(round)) {
+                break;
+            }
+        }
+
+        if (!bus.hasPendingMessages()) {
+            messagesPending = false;
+        }
+
+        if (success)
+            bus.incrementRound();
+
+        if (bus.getRound() > rounds) {
+            messagesPending = false;
+        }
+
+    } while (messagesPending && !stopping.load(std::memory_order_relaxed));
+
+    finished.store(true, std::memory_order_release);
+}
\ No newline at end of file
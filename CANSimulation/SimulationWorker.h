@@ -0,0 +1,57 @@
+#ifndef SIMULATION_WORKER_H
+#define SIMULATION_WORKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "CANBus.h"
+#include "Message.h"
+#include "SpscQueue.h"
+
+// Runs the rounds of a CANBus on its own thread and hands every arbitrated round to the
+// GUI thread through a bounded queue. When the viewer falls behind the queue fills up and
+// the simulation waits, so memory stays bounded however long the run is. The bus belongs
+// to the worker until it has finished.
+class SimulationWorker {
+public:
+    struct Round {
+        int round = 0;
+        std::vector<CANBus::ArbitrationStep> steps;
+        std::vector<CANBus::NodeState> nodes;                               // by node index, while arbitrating
+        Message winner = Message(0, std::vector<uint8_t>{0}, 0, false);    // identifier 0 when nothing was delivered
+        std::vector<int> receivers;                                         // ids of the nodes that received the winner
+    };
+
+    SimulationWorker(CANBus& bus, int rounds, size_t capacity = 256);
+    ~SimulationWorker();
+
+    void start();
+
+    // Stops a run that is still in progress and waits for the thread
+    void stop();
+
+    // GUI thread: next arbitrated round, false if none is ready yet
+    bool next(Round& round) { return queue.pop(round); }
+
+    // True once the last round has been queued
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+    int getRoundsSimulated() const { return roundsSimulated.load(std::memory_order_relaxed); }
+    int getRounds() const { return rounds; }
+
+private:
+    void run();
+    bool publish(Round& round);
+
+    CANBus& bus;
+    int rounds;
+    SpscQueue<Round> queue;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::atomic<bool> finished;
+    std::atomic<int> roundsSimulated;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue between exactly one producer thread and one consumer thread.
+// Each side owns one index and only reads the other's, refreshing its cached copy of it
+// when the queue looks full or empty, so the two cores rarely share a cache line.
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity)
+        : head(0), tail(0), cachedHead(0), cachedTail(0)
+    {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        buffer.resize(size);
+        mask = size - 1;
+    }
+
+    // Producer side; the value is moved from only when there was room
+    bool push(T& value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead == buffer.size()) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead == buffer.size()) {
+                return false;
+            }
+        }
+
+        buffer[position & mask] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& value)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position == cachedTail) {
+                return false;
+            }
+        }
+
+        value = std::move(buffer[position & mask]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; only a snapshot while the other side is active
+    size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+    size_t capacity() const { return buffer.size(); }
+
+private:
+    std::vector<T> buffer;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head;   // next slot to read, written by the consumer
+    alignas(64) std::atomic<size_t> tail;   // next slot to write, written by the producer
+    alignas(64) size_t cachedHead;          // producer's last view of head
+    alignas(64) size_t cachedTail;          // consumer's last view of tail
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int lowestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+static int highestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+static const int RANGE_BITS = TimerWheel::SLOT_BITS * TimerWheel::LEVELS;
+
+TimerWheel::TimerWheel(uint64_t start)
+    : overflow(-1), now(start), sequence(0), pending(0)
+{
+    for (int level = 0; level < LEVELS; ++level) {
+        std::fill(heads[level], heads[level] + SLOTS, -1);
+        occupied[level] = 0;
+    }
+}
+
+int TimerWheel::schedule(uint64_t time, int payload)
+{
+    int handle;
+    if (!freeTimers.empty()) {
+        handle = freeTimers.back();
+        freeTimers.pop_back();
+    }
+    else {
+        handle = static_cast<int>(timers.size());
+        timers.push_back(Timer());
+    }
+
+    timers[handle] = { time, sequence++, payload, -1, true };
+    pending++;
+    place(handle);
+    return handle;
+}
+
+void TimerWheel::cancel(int handle)
+{
+    // Unlinking would need a doubly linked list, the slot drops the timer when it comes up instead
+    if (handle >= 0 && handle < static_cast<int>(timers.size()) && timers[handle].active) {
+        timers[handle].active = false;
+        pending--;
+    }
+}
+
+void TimerWheel::release(int handle)
+{
+    freeTimers.push_back(handle);
+}
+
+void TimerWheel::place(int handle)
+{
+    Timer& timer = timers[handle];
+    uint64_t key = std::max(timer.time, now);
+    uint64_t difference = key ^ now;
+
+    int level = difference ? highestBit(difference) / SLOT_BITS : 0;
+    if (level >= LEVELS) {
+        timer.next = overflow;
+        overflow = handle;
+        return;
+    }
+
+    int slot = static_cast<int>((key >> (level * SLOT_BITS)) & (SLOTS - 1));
+    timer.next = heads[level][slot];
+    heads[level][slot] = handle;
+    occupied[level] |= 1ULL << slot;
+}
+
+void TimerWheel::cascade(uint64_t time)
+{
+    if ((time & ((1ULL << RANGE_BITS) - 1)) == 0 && overflow != -1) {
+        int handle = overflow;
+        overflow = -1;
+
+        while (handle != -1) {
+            int next = timers[handle].next;
+            if (timers[handle].active) {
+                place(handle);
+            }
+            else {
+                release(handle);
+            }
+            handle = next;
+        }
+    }
+
+    for (int level = LEVELS - 1; level > 0; --level) {
+        int shift = level * SLOT_BITS;
+        if ((time & ((1ULL << shift) - 1)) != 0) {
+            continue;
+        }
+
+        int slot = static_cast<int>((time >> shift) & (SLOTS - 1));
+        int handle = heads[level][slot];
+        heads[level][slot] = -1;
+        occupied[level] &= ~(1ULL << slot);
+
+        while (handle != -1) {
+            int next = timers[handle].next;
+            if (timers[handle].active) {
+                place(handle);
+            }
+            else {
+                release(handle);
+            }
+            handle = next;
+        }
+    }
+}
+
+uint64_t TimerWheel::nextEventTime() const
+{
+    uint64_t earliest = UINT64_MAX;
+
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = level * SLOT_BITS;
+        int digit = static_cast<int>((now >> shift) & (SLOTS - 1));
+
+        // The slot under the current digit still has to cascade only when now sits on its boundary
+        bool aligned = (now & ((1ULL << shift) - 1)) == 0;
+        uint64_t candidates = occupied[level];
+        if (aligned) {
+            candidates &= ~0ULL << digit;
+        }
+        else {
+            candidates = digit == SLOTS - 1 ? 0 : candidates & (~0ULL << (digit + 1));
+        }
+
+        if (candidates) {
+            uint64_t base = (now >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+            earliest = std::min(earliest, base | (static_cast<uint64_t>(lowestBit(candidates)) << shift));
+        }
+    }
+
+    if (overflow != -1) {
+        uint64_t boundary = (now & ((1ULL << RANGE_BITS) - 1)) == 0 ? now : ((now >> RANGE_BITS) + 1) << RANGE_BITS;
+        earliest = std::min(earliest, boundary);
+    }
+
+    return earliest;
+}
+
+void TimerWheel::advance(uint64_t time, std::vector<Expired>& expired)
+{
+    while (now <= time) {
+        uint64_t next = nextEventTime();
+        if (next > time) {
+            now = time + 1;
+            break;
+        }
+
+        now = next;
+        cascade(now);
+
+        int slot = static_cast<int>(now & (SLOTS - 1));
+        int handle = heads[0][slot];
+        heads[0][slot] = -1;
+        occupied[0] &= ~(1ULL << slot);
+
+        firing.clear();
+        while (handle != -1) {
+            Timer& timer = timers[handle];
+            int following = timer.next;
+            if (timer.active) {
+                firing.push_back({ timer.sequence, { timer.payload, timer.time } });
+                timer.active = false;
+                pending--;
+            }
+            release(handle);
+            handle = following;
+        }
+
+        std::sort(firing.begin(), firing.end(),
+            [](const std::pair<uint64_t, Expired>& a, const std::pair<uint64_t, Expired>& b) { return a.first < b.first; });
+        for (const auto& entry : firing) {
+            expired.push_back(entry.second);
+        }
+
+        ++now;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Hierarchical timer wheel: LEVELS wheels of 64 slots, each level 64 times coarser than
+// the one below. Timers sit in the slot of the first digit where they differ from the
+// current time and cascade down as that digit comes up, so scheduling is O(1) and
+// memory follows the number of pending timers, not how far ahead they are.
+// Occupancy bitmaps let advance() jump straight over idle stretches.
+class TimerWheel {
+public:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 5;
+
+    struct Expired {
+        int payload;
+        uint64_t time;
+    };
+
+    explicit TimerWheel(uint64_t start = 0);
+
+    // Timers in the past expire on the next advance(). Returns a handle for cancel().
+    int schedule(uint64_t time, int payload);
+    void cancel(int handle);
+
+    // Expires every timer up to and including time, in time order and in scheduling
+    // order within a tick. Timers scheduled from the results are not part of this call.
+    void advance(uint64_t time, std::vector<Expired>& expired);
+
+    // Earliest point where the wheel has work: an expiry or a cascade. UINT64_MAX if empty.
+    uint64_t nextEventTime() const;
+
+    uint64_t getTime() const { return now; }
+    size_t getPendingCount() const { return pending; }
+
+private:
+    struct Timer {
+        uint64_t time;
+        uint64_t sequence;
+        int payload;
+        int next;
+        bool active;
+    };
+
+    void place(int handle);
+    void cascade(uint64_t time);
+    void release(int handle);
+
+    std::vector<Timer> timers;
+    std::vector<int> freeTimers;
+    std::vector<std::pair<uint64_t, Expired>> firing;   // timers of the current tick with their sequence
+    int heads[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS];
+    int overflow;                       // timers beyond the range of the top level
+    uint64_t now;                       // next tick to process
+    uint64_t sequence;
+    size_t pending;
+};
+
+#endif
\ No newline at end of file
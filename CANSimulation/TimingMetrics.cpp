@@ -0,0 +1,151 @@
+#include "TimingMetrics.h"
+
+#include <fstream>
+#include <utility>
+
+TimingMetrics::FlowMetrics& TimingMetrics::idMetrics(uint16_t id)
+{
+    if (perId.empty()) {
+        perId.resize(ID_COUNT);
+    }
+
+    std::unique_ptr<FlowMetrics>& flow = perId[id & (ID_COUNT - 1)];
+    if (!flow) {
+        flow.reset(new FlowMetrics());
+    }
+    return *flow;
+}
+
+TimingMetrics::FlowMetrics& TimingMetrics::nodeMetrics(int node)
+{
+    if (node >= static_cast<int>(perNode.size())) {
+        perNode.resize(node + 1);
+    }
+
+    std::unique_ptr<FlowMetrics>& flow = perNode[node];
+    if (!flow) {
+        flow.reset(new FlowMetrics());
+    }
+    return *flow;
+}
+
+void TimingMetrics::recordDelivery(FlowMetrics& flow, uint64_t releaseTime, uint64_t startTime, uint64_t endTime)
+{
+    flow.queueingDelay.record(startTime - releaseTime);
+    flow.transmissionLatency.record(endTime - releaseTime);
+
+    if (flow.deliveries > 0) {
+        uint64_t interval = endTime - flow.lastDelivery;
+        if (flow.deliveries > 1) {
+            flow.interArrivalJitter.record(interval > flow.lastInterval ? interval - flow.lastInterval : flow.lastInterval - interval);
+        }
+        flow.lastInterval = interval;
+    }
+
+    flow.lastDelivery = endTime;
+    flow.deliveries++;
+}
+
+void TimingMetrics::recordDelivery(int node, uint16_t id, uint64_t releaseTime, uint64_t startTime, uint64_t endTime)
+{
+    recordDelivery(idMetrics(id), releaseTime, startTime, endTime);
+    recordDelivery(nodeMetrics(node), releaseTime, startTime, endTime);
+}
+
+void TimingMetrics::recordArbitrationLoss(int node, uint16_t id)
+{
+    idMetrics(id).arbitrationLosses++;
+    nodeMetrics(node).arbitrationLosses++;
+}
+
+void TimingMetrics::recordRetransmission(int node, uint16_t id)
+{
+    idMetrics(id).retransmissions++;
+    nodeMetrics(node).retransmissions++;
+}
+
+void TimingMetrics::recordPriorityInversion(int node, uint16_t id, uint64_t delay)
+{
+    idMetrics(id).priorityInversion.record(delay);
+    nodeMetrics(node).priorityInversion.record(delay);
+}
+
+void TimingMetrics::reset()
+{
+    perId.clear();
+    perNode.clear();
+}
+
+const TimingMetrics::FlowMetrics* TimingMetrics::getIdMetrics(uint16_t id) const
+{
+    if (perId.empty()) {
+        return nullptr;
+    }
+    return perId[id & (ID_COUNT - 1)].get();
+}
+
+const TimingMetrics::FlowMetrics* TimingMetrics::getNodeMetrics(int node) const
+{
+    if (node < 0 || node >= static_cast<int>(perNode.size())) {
+        return nullptr;
+    }
+    return perNode[node].get();
+}
+
+TimingMetrics::Summary TimingMetrics::summarize(const LatencyHistogram& histogram)
+{
+    Summary summary;
+    summary.count = histogram.getCount();
+    summary.p50 = histogram.valueAtPercentile(50.0);
+    summary.p99 = histogram.valueAtPercentile(99.0);
+    summary.p999 = histogram.valueAtPercentile(99.9);
+    summary.max = histogram.getMax();
+    return summary;
+}
+
+void TimingMetrics::writeFlow(std::ostream& out, const std::string& scope, int key, const FlowMetrics& flow)
+{
+    const std::pair<const char*, const LatencyHistogram*> histograms[] = {
+        { "queueing_delay", &flow.queueingDelay },
+        { "transmission_latency", &flow.transmissionLatency },
+        { "inter_arrival_jitter", &flow.interArrivalJitter },
+        { "priority_inversion", &flow.priorityInversion },
+    };
+
+    for (const auto& entry : histograms) {
+        Summary summary = summarize(*entry.second);
+        out << scope << "," << key << "," << entry.first << ","
+            << summary.count << "," << summary.p50 << "," << summary.p99 << ","
+            << summary.p999 << "," << summary.max << ","
+            << flow.arbitrationLosses << "," << flow.retransmissions << "\n";
+    }
+}
+
+void TimingMetrics::writeCsv(std::ostream& out) const
+{
+    out << "scope,key,metric,count,p50,p99,p99.9,max,arbitration_losses,retransmissions\n";
+
+    for (size_t id = 0; id < perId.size(); ++id) {
+        if (perId[id]) {
+            writeFlow(out, "id", static_cast<int>(id), *perId[id]);
+        }
+    }
+
+    for (size_t node = 0; node < perNode.size(); ++node) {
+        if (perNode[node]) {
+            writeFlow(out, "node", static_cast<int>(node) + 1, *perNode[node]);
+        }
+    }
+}
+
+bool TimingMetrics::exportCsv(const std::string& path) const
+{
+    std::ofstream file(path);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    writeCsv(file);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef TIMING_METRICS_H
+#define TIMING_METRICS_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+// Per CAN identifier and per node timing figures of a run. Times are in the unit of
+// the engine that records them: bit times for BitLevelBus, rounds for CANBus.
+class TimingMetrics {
+public:
+    struct FlowMetrics {
+        LatencyHistogram queueingDelay;         // release until the start of the successful attempt
+        LatencyHistogram transmissionLatency;   // release until the end of the frame
+        LatencyHistogram interArrivalJitter;    // change of the delivery interval between frames
+        LatencyHistogram priorityInversion;     // waiting in software behind a lower priority mailbox frame
+        uint64_t arbitrationLosses = 0;
+        uint64_t retransmissions = 0;
+        uint64_t lastDelivery = 0;
+        uint64_t lastInterval = 0;
+        int deliveries = 0;
+    };
+
+    struct Summary {
+        uint64_t count;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+    };
+
+    static const int ID_COUNT = 2048;
+
+    void recordDelivery(int node, uint16_t id, uint64_t releaseTime, uint64_t startTime, uint64_t endTime);
+    void recordArbitrationLoss(int node, uint16_t id);
+    void recordRetransmission(int node, uint16_t id);
+    void recordPriorityInversion(int node, uint16_t id, uint64_t delay);
+    void reset();
+
+    const FlowMetrics* getIdMetrics(uint16_t id) const;
+    const FlowMetrics* getNodeMetrics(int node) const;
+
+    static Summary summarize(const LatencyHistogram& histogram);
+
+    void writeCsv(std::ostream& out) const;
+    bool exportCsv(const std::string& path) const;
+
+private:
+    friend class SimulationCheckpoint;
+
+    FlowMetrics& idMetrics(uint16_t id);
+    FlowMetrics& nodeMetrics(int node);
+    static void recordDelivery(FlowMetrics& flow, uint64_t releaseTime, uint64_t startTime, uint64_t endTime);
+    static void writeFlow(std::ostream& out, const std::string& scope, int key, const FlowMetrics& flow);
+
+    // Allocated on first use so idle identifiers cost one pointer each
+    std::vector<std::unique_ptr<FlowMetrics>> perId;
+    std::vector<std::unique_ptr<FlowMetrics>> perNode;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "TopologyView.h"
+
+#include <cmath>
+
+#include <QOpenGLWidget>
+#include <QSurfaceFormat>
+#include <QWheelEvent>
+
+static const double MIN_SCALE = 0.02;
+static const double MAX_SCALE = 4.0;
+
+TopologyView::TopologyView(QWidget* parent)
+    : QGraphicsView(parent), detailed(true)
+{
+    QOpenGLWidget* openGLViewport = new QOpenGLWidget(this);
+    QSurfaceFormat format;
+    format.setSamples(4);
+    openGLViewport->setFormat(format);
+    setViewport(openGLViewport);
+
+    // An OpenGL viewport redraws whole frames anyway, so skip the update region bookkeeping
+    setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+}
+
+void TopologyView::addDetailItem(QGraphicsItem* item)
+{
+    detailItems.append(item);
+    item->setVisible(detailed);
+}
+
+void TopologyView::addAggregateItem(QGraphicsItem* item)
+{
+    aggregateItems.append(item);
+    item->setVisible(!detailed);
+}
+
+void TopologyView::updateAggregates()
+{
+    if (detailed) {
+        return;
+    }
+
+    for (QGraphicsItem* item : aggregateItems) {
+        item->update();
+    }
+}
+
+void TopologyView::wheelEvent(QWheelEvent* event)
+{
+    double factor = std::pow(1.25, event->angleDelta().y() / 120.0);
+    double scale = transform().m11() * factor;
+    if (scale < MIN_SCALE || scale > MAX_SCALE) {
+        event->accept();
+        return;
+    }
+
+    QGraphicsView::scale(factor, factor);
+    updateLevelOfDetail();
+    event->accept();
+}
+
+void TopologyView::updateLevelOfDetail()
+{
+    bool detail = transform().m11() >= DETAIL_SCALE;
+    if (detail == detailed) {
+        return;
+    }
+    detailed = detail;
+
+    // Only crossing the threshold touches every item, zooming within a level touches none
+    for (QGraphicsItem* item : detailItems) {
+        item->setVisible(detailed);
+    }
+    for (QGraphicsItem* item : aggregateItems) {
+        item->setVisible(!detailed);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef TOPOLOGY_VIEW_H
+#define TOPOLOGY_VIEW_H
+
+#include <QGraphicsItem>
+#include <QGraphicsView>
+#include <QVector>
+
+// View of the bus topology, rendered through an OpenGL viewport. The wheel zooms around
+// the cursor. Below DETAIL_SCALE the per-node items are hidden and the aggregate items
+// shown in their place, so a zoomed out view paints one item per row of nodes.
+class TopologyView : public QGraphicsView {
+public:
+    static constexpr double DETAIL_SCALE = 0.35;
+
+    explicit TopologyView(QWidget* parent = nullptr);
+
+    // Items shown only when zoomed in, e.g. node widgets and their stubs
+    void addDetailItem(QGraphicsItem* item);
+
+    // Items shown only when zoomed out
+    void addAggregateItem(QGraphicsItem* item);
+
+    // Repaints the aggregates while they are shown, detail items update themselves
+    void updateAggregates();
+
+    bool isDetailed() const { return detailed; }
+
+protected:
+    void wheelEvent(QWheelEvent* event) override;
+
+private:
+    void updateLevelOfDetail();
+
+    QVector<QGraphicsItem*> detailItems;
+    QVector<QGraphicsItem*> aggregateItems;
+    bool detailed;
+};
+
+#endif
\ No newline at end of file
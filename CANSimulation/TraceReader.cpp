@@ -0,0 +1,442 @@
+#include "TraceReader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRACE_READER_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static const size_t WINDOW_SIZE = 256 * MappedFile::ALIGNMENT;
+static const size_t MAX_LINE_LENGTH = 4096;
+
+static int lowestBit(uint32_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// Compares 16 bytes per instruction, trace lines are short so this is where most of the scanning happens
+static const char* findNewline(const char* p, const char* end)
+{
+#ifdef TRACE_READER_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+        if (mask != 0) {
+            return p + lowestBit(static_cast<uint32_t>(mask));
+        }
+        p += 16;
+    }
+#endif
+    return static_cast<const char*>(std::memchr(p, '\n', end - p));
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+namespace {
+
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        void skipSpace()
+        {
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                ++p;
+            }
+        }
+
+        bool atEnd()
+        {
+            skipSpace();
+            return p >= end;
+        }
+
+        bool expect(char c)
+        {
+            skipSpace();
+            if (p < end && *p == c) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+
+        std::string_view word()
+        {
+            skipSpace();
+            const char* start = p;
+            while (p < end && *p != ' ' && *p != '\t') {
+                ++p;
+            }
+            return std::string_view(start, p - start);
+        }
+
+        // Seconds with up to microsecond decimals, parsed without going through a double
+        bool seconds(uint64_t& microseconds)
+        {
+            skipSpace();
+            uint64_t whole = 0;
+            auto result = std::from_chars(p, end, whole);
+            if (result.ec != std::errc()) {
+                return false;
+            }
+            p = result.ptr;
+
+            uint64_t fraction = 0;
+            int digits = 0;
+            if (p < end && *p == '.') {
+                ++p;
+                while (p < end && *p >= '0' && *p <= '9') {
+                    if (digits < 6) {
+                        fraction = fraction * 10 + (*p - '0');
+                        digits++;
+                    }
+                    ++p;
+                }
+            }
+            for (; digits < 6; ++digits) {
+                fraction *= 10;
+            }
+
+            microseconds = whole * 1000000 + fraction;
+            return true;
+        }
+
+        bool hex(uint32_t& value, int& digits)
+        {
+            value = 0;
+            digits = 0;
+            while (p < end && hexValue(*p) >= 0 && digits < 8) {
+                value = (value << 4) | static_cast<uint32_t>(hexValue(*p));
+                ++p;
+                ++digits;
+            }
+            return digits > 0;
+        }
+
+        bool byte(uint8_t& value)
+        {
+            if (end - p < 2 || hexValue(p[0]) < 0 || hexValue(p[1]) < 0) {
+                return false;
+            }
+            value = static_cast<uint8_t>((hexValue(p[0]) << 4) | hexValue(p[1]));
+            p += 2;
+            return true;
+        }
+    };
+
+}
+
+TraceReader::TraceReader(const std::string& path)
+    : windowOffset(0), window(nullptr), windowLength(0), position(0), partialLine(false),
+    formatKnown(false), format(Format::Candump), decimalIds(false), relativeTimestamps(false), lastTimestamp(0)
+{
+    file.open(path);
+}
+
+bool TraceReader::next(TraceFrame& frame)
+{
+    const char* begin;
+    const char* end;
+
+    while (nextLine(begin, end)) {
+        statistics.lines++;
+        if (end > begin && end[-1] == '\r') {
+            --end;
+        }
+
+        if (!formatKnown) {
+            detectFormat(begin, end);
+            if (!formatKnown) {
+                continue;
+            }
+        }
+
+        bool parsed = format == Format::Candump ? parseCandump(begin, end, frame) : parseAsc(begin, end, frame);
+        if (parsed) {
+            statistics.frames++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TraceReader::nextLine(const char*& begin, const char*& end)
+{
+    if (partialLine) {
+        partial.clear();
+        partialLine = false;
+    }
+
+    while (true) {
+        if (position < windowLength) {
+            const char* start = window + position;
+            const char* limit = window + windowLength;
+            const char* newline = findNewline(start, limit);
+
+            if (newline && partial.empty()) {
+                position = newline - window + 1;
+                begin = start;
+                end = newline;
+                return true;
+            }
+
+            // The line continues in the next window; overlong lines are cut, they cannot be frames
+            const char* stop = newline ? newline : limit;
+            size_t room = MAX_LINE_LENGTH - std::min(partial.size(), MAX_LINE_LENGTH);
+            partial.append(start, std::min(static_cast<size_t>(stop - start), room));
+            position = (stop - window) + (newline ? 1 : 0);
+
+            if (newline) {
+                partialLine = true;
+                begin = partial.data();
+                end = begin + partial.size();
+                return true;
+            }
+        }
+
+        if (!nextWindow()) {
+            if (partial.empty()) {
+                return false;
+            }
+            partialLine = true;
+            begin = partial.data();
+            end = begin + partial.size();
+            return true;
+        }
+    }
+}
+
+bool TraceReader::nextWindow()
+{
+    uint64_t offset = window ? windowOffset + windowLength : 0;
+    if (offset >= file.size()) {
+        return false;
+    }
+
+    windowOffset = offset;
+    windowLength = static_cast<size_t>(std::min<uint64_t>(WINDOW_SIZE, file.size() - offset));
+    window = file.map(windowOffset, windowLength);
+    position = 0;
+    return true;
+}
+
+void TraceReader::detectFormat(const char* begin, const char* end)
+{
+    Cursor cursor{ begin, end };
+    if (cursor.atEnd()) {
+        return;
+    }
+
+    std::string_view first(cursor.p, end - cursor.p);
+    std::string_view keyword = cursor.word();
+    formatKnown = true;
+
+    if (first.front() == '(') {
+        format = Format::Candump;
+    }
+    else if (keyword == "date" || keyword == "base" || keyword == "Begin" || keyword.substr(0, 2) == "//") {
+        format = Format::Asc;
+    }
+    else {
+        format = (first.find('#') != std::string_view::npos || first.find('[') != std::string_view::npos)
+            ? Format::Candump : Format::Asc;
+    }
+}
+
+bool TraceReader::parseCandump(const char* begin, const char* end, TraceFrame& frame)
+{
+    Cursor cursor{ begin, end };
+    if (cursor.atEnd()) {
+        return false;
+    }
+
+    // "(1436509052.249713) can0 123#1122" from candump -l, or "(...) can0  123   [2]  11 22" from candump -t
+    frame.timestamp = 0;
+    if (cursor.expect('(')) {
+        if (!cursor.seconds(frame.timestamp) || !cursor.expect(')')) {
+            statistics.malformedLines++;
+            return false;
+        }
+    }
+
+    std::string_view interfaceName = cursor.word();
+    cursor.skipSpace();
+
+    int digits = 0;
+    if (interfaceName.empty() || !cursor.hex(frame.id, digits)) {
+        statistics.malformedLines++;
+        return false;
+    }
+    frame.channel = channelIndex(interfaceName.data(), interfaceName.data() + interfaceName.size());
+    frame.extended = digits > 3;
+    frame.remote = false;
+    frame.length = 0;
+
+    if (cursor.p < end && *cursor.p == '#') {
+        ++cursor.p;
+        if (cursor.p < end && *cursor.p == '#') {
+            return false;               // CAN FD
+        }
+        if (cursor.p < end && (*cursor.p == 'R' || *cursor.p == 'r')) {
+            ++cursor.p;
+            frame.remote = true;
+            if (cursor.p < end && *cursor.p >= '0' && *cursor.p <= '8') {
+                frame.length = static_cast<uint8_t>(*cursor.p - '0');
+            }
+            return true;
+        }
+
+        while (cursor.p < end && *cursor.p != ' ') {
+            if (*cursor.p == '.') {
+                ++cursor.p;
+                continue;
+            }
+            if (frame.length == 8 || !cursor.byte(frame.data[frame.length])) {
+                statistics.malformedLines++;
+                return false;
+            }
+            frame.length++;
+        }
+        return true;
+    }
+
+    uint32_t length = 0;
+    if (!cursor.expect('[') || !cursor.hex(length, digits) || length > 8 || !cursor.expect(']')) {
+        statistics.malformedLines++;
+        return false;
+    }
+    frame.length = static_cast<uint8_t>(length);
+
+    std::string_view next = cursor.word();
+    if (next == "remote") {
+        frame.remote = true;
+        return true;
+    }
+
+    cursor.p = next.data();
+    for (uint32_t i = 0; i < length; ++i) {
+        cursor.skipSpace();
+        if (!cursor.byte(frame.data[i])) {
+            statistics.malformedLines++;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TraceReader::parseAsc(const char* begin, const char* end, TraceFrame& frame)
+{
+    Cursor cursor{ begin, end };
+    if (cursor.atEnd()) {
+        return false;
+    }
+
+    // Header lines that change how the frame lines are read
+    if (*cursor.p < '0' || *cursor.p > '9') {
+        if (cursor.word() == "base") {
+            decimalIds = cursor.word() == "dec";
+            if (cursor.word() == "timestamps") {
+                relativeTimestamps = cursor.word() == "relative";
+            }
+        }
+        return false;
+    }
+
+    // "   0.015991 1  123             Rx   d 8 01 02 03 04 05 06 07 08"
+    uint64_t timestamp = 0;
+    if (!cursor.seconds(timestamp)) {
+        statistics.malformedLines++;
+        return false;
+    }
+    timestamp = relativeTimestamps ? lastTimestamp + timestamp : timestamp;
+    lastTimestamp = timestamp;
+
+    // Events, statistics, error frames and CAN FD lines do not have a channel number followed by an identifier
+    cursor.skipSpace();
+    int channel = 0;
+    auto channelResult = std::from_chars(cursor.p, end, channel);
+    if (channelResult.ec != std::errc()) {
+        return false;
+    }
+    cursor.p = channelResult.ptr;
+
+    std::string_view idText = cursor.word();
+    if (idText.empty()) {
+        return false;
+    }
+
+    frame.extended = idText.back() == 'x' || idText.back() == 'X';
+    if (frame.extended) {
+        idText.remove_suffix(1);
+    }
+
+    auto idResult = std::from_chars(idText.data(), idText.data() + idText.size(), frame.id, decimalIds ? 10 : 16);
+    if (idResult.ec != std::errc() || idResult.ptr != idText.data() + idText.size()) {
+        return false;
+    }
+
+    std::string_view direction = cursor.word();
+    if (direction != "Rx" && direction != "Tx") {
+        return false;
+    }
+
+    std::string_view type = cursor.word();
+    cursor.skipSpace();
+    int length = cursor.p < end ? hexValue(*cursor.p++) : -1;
+    if ((type != "d" && type != "r") || length < 0) {
+        statistics.malformedLines++;
+        return false;
+    }
+
+    frame.timestamp = timestamp;
+    frame.channel = channel;
+    frame.remote = type == "r";
+    frame.length = static_cast<uint8_t>(std::min(length, 8));
+
+    if (!frame.remote) {
+        for (int i = 0; i < frame.length; ++i) {
+            cursor.skipSpace();
+            if (!cursor.byte(frame.data[i])) {
+                statistics.malformedLines++;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int TraceReader::channelIndex(const char* begin, const char* end)
+{
+    std::string_view name(begin, end - begin);
+    for (size_t i = 0; i < channels.size(); ++i) {
+        if (channels[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+
+    channels.emplace_back(name);
+    return static_cast<int>(channels.size()) - 1;
+}
\ No newline at end of file
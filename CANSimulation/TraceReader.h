@@ -0,0 +1,60 @@
+#ifndef TRACE_READER_H
+#define TRACE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameSource.h"
+#include "MappedFile.h"
+
+// Streams CAN frames out of a candump (log or console output) or Vector ASC text trace.
+// The file is mapped one window at a time and only the current line is ever copied,
+// so memory use does not depend on the size of the trace. Lines that are not classic
+// CAN frames (headers, events, error frames, CAN FD) are skipped.
+class TraceReader : public FrameSource {
+public:
+    enum class Format { Candump, Asc };
+
+    struct Statistics {
+        uint64_t lines = 0;
+        uint64_t frames = 0;
+        uint64_t malformedLines = 0;
+    };
+
+    explicit TraceReader(const std::string& path);
+
+    // False once the end of the trace is reached
+    bool next(TraceFrame& frame) override;
+
+    Format getFormat() const { return format; }
+    const Statistics& getStatistics() const { return statistics; }
+    const std::vector<std::string>& getChannels() const { return channels; }
+
+private:
+    bool nextLine(const char*& begin, const char*& end);
+    bool nextWindow();
+    void detectFormat(const char* begin, const char* end);
+    bool parseCandump(const char* begin, const char* end, TraceFrame& frame);
+    bool parseAsc(const char* begin, const char* end, TraceFrame& frame);
+    int channelIndex(const char* begin, const char* end);
+
+    MappedFile file;
+    uint64_t windowOffset;
+    const char* window;
+    size_t windowLength;
+    size_t position;
+    std::string partial;
+    bool partialLine;
+
+    bool formatKnown;
+    Format format;
+    bool decimalIds;                    // ASC "base dec"
+    bool relativeTimestamps;            // ASC "timestamps relative"
+    uint64_t lastTimestamp;
+    std::vector<std::string> channels;
+    Statistics statistics;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "TraceReplayer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bus time is stepped in slices so the wall clock is only checked every few hundred bits
+static const uint64_t PACING_SLICE = 256;
+
+TraceReplayer::TraceReplayer(FrameSource& source, BitLevelBus& bus, uint32_t bitRate)
+    : source(source), bus(bus), bitRate(bitRate), speed(0.0), defaultNode(0),
+    channel(-1), channelChosen(false), started(false), firstTimestamp(0), startTime(0)
+{
+    if (bitRate == 0) {
+        throw std::invalid_argument("Bit rate must be positive");
+    }
+}
+
+void TraceReplayer::assignNode(uint32_t id, int node)
+{
+    if (node < 0 || node >= bus.getNodeCount()) {
+        throw std::invalid_argument("Node index out of range: " + std::to_string(node));
+    }
+    nodesById[id] = node;
+}
+
+void TraceReplayer::assignNodes(const NetworkDefinition& network)
+{
+    for (const MessageDefinition& message : network.messages) {
+        if (!message.extended && message.transmitter >= 0 && message.transmitter < bus.getNodeCount()) {
+            nodesById[message.id] = message.transmitter;
+        }
+    }
+}
+
+void TraceReplayer::assignNodes(const ScenarioDefinition& scenario)
+{
+    for (const ScenarioNode& node : scenario.nodes) {
+        for (const ScenarioMessage& message : node.periodicMessages) {
+            assignNode(message.id, node.nodeId - 1);
+        }
+    }
+}
+
+bool TraceReplayer::replayNext()
+{
+    TraceFrame frame;
+
+    while (source.next(frame)) {
+        if (channel < 0) {
+            channel = frame.channel;
+        }
+        if (frame.channel != channel) {
+            if (!channelChosen) {
+                throw std::invalid_argument("The trace has frames on channels " + std::to_string(channel) + " and " +
+                    std::to_string(frame.channel) + ", choose the one to replay");
+            }
+            statistics.otherChannelFrames++;
+            continue;
+        }
+
+        if (frame.extended || frame.remote || frame.id > 0x7FF) {
+            statistics.framesSkipped++;
+            continue;
+        }
+
+        if (!started) {
+            started = true;
+            firstTimestamp = frame.timestamp;
+            startTime = bus.getTime();
+            wallStart = std::chrono::steady_clock::now();
+        }
+
+        uint64_t releaseTime = startTime;
+        if (frame.timestamp >= firstTimestamp) {
+            releaseTime += (frame.timestamp - firstTimestamp) * bitRate / 1000000;
+        }
+        if (releaseTime < bus.getTime()) {
+            statistics.lateFrames++;
+            releaseTime = bus.getTime();
+        }
+
+        advanceTo(releaseTime);
+
+        auto found = nodesById.find(frame.id);
+        int node = found == nodesById.end() ? defaultNode : found->second;
+        bus.queueFrame(node, static_cast<uint16_t>(frame.id), std::vector<uint8_t>(frame.data, frame.data + frame.length), releaseTime);
+        statistics.framesReplayed++;
+        return true;
+    }
+
+    return false;
+}
+
+void TraceReplayer::run(uint64_t drainTime)
+{
+    while (replayNext()) {
+    }
+
+    uint64_t end = bus.getTime() + drainTime;
+    while (pending() && bus.getTime() < end) {
+        advanceTo(std::min(end, bus.getTime() + PACING_SLICE));
+    }
+}
+
+void TraceReplayer::advanceTo(uint64_t bitTime)
+{
+    while (bus.getTime() < bitTime) {
+        uint64_t slice = std::min(bitTime - bus.getTime(), PACING_SLICE);
+        bus.run(slice);
+        pace();
+    }
+}
+
+void TraceReplayer::pace()
+{
+    if (speed <= 0.0 || !started) {
+        return;
+    }
+
+    double seconds = static_cast<double>(bus.getTime() - startTime) / bitRate / speed;
+    auto due = wallStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    if (due > std::chrono::steady_clock::now()) {
+        std::this_thread::sleep_until(due);
+    }
+}
+
+bool TraceReplayer::pending() const
+{
+    for (int node = 0; node < bus.getNodeCount(); ++node) {
+        if (bus.getQueuedFrames(node) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef TRACE_REPLAYER_H
+#define TRACE_REPLAYER_H
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+#include "BitLevelBus.h"
+#include "FrameSource.h"
+#include "Network.h"
+#include "Scenario.h"
+
+// Replays a recorded trace or generated workload through the bit-level bus model: every
+// frame is released by the node that sends its identifier at its timestamp, then arbitrates,
+// is checked and retransmitted like a simulated frame. Frames are read one at a time just
+// before they are due, so a stream of any length replays in constant memory.
+class TraceReplayer {
+public:
+    struct Statistics {
+        uint64_t framesReplayed = 0;
+        uint64_t framesSkipped = 0;     // extended and remote frames, the bus model sends base data frames only
+        uint64_t lateFrames = 0;        // recorded earlier than the previous frame
+        uint64_t otherChannelFrames = 0;    // recorded on a channel other than the one replayed
+    };
+
+    TraceReplayer(FrameSource& source, BitLevelBus& bus, uint32_t bitRate);
+
+    // 1.0 replays in real time, 10.0 ten times faster, 0 as fast as possible
+    void setSpeed(double speedUp) { speed = speedUp; }
+
+    void assignNode(uint32_t id, int node);
+    void assignNodes(const NetworkDefinition& network);
+    void assignNodes(const ScenarioDefinition& scenario);
+    void setDefaultNode(int node) { defaultNode = node; }
+
+    // The bus model is a single bus, so only one channel of a trace can be replayed. Without a
+    // chosen channel, replayNext throws std::invalid_argument when a second channel shows up.
+    void setChannel(int selected) { channel = selected; channelChosen = true; }
+
+    // Runs the bus up to the next frame and releases it, false at the end of the stream
+    bool replayNext();
+
+    // Replays the whole stream, then gives the bus up to drainTime bit times to send what is still queued
+    void run(uint64_t drainTime);
+
+    const Statistics& getStatistics() const { return statistics; }
+
+private:
+    void advanceTo(uint64_t bitTime);
+    void pace();
+    bool pending() const;
+
+    FrameSource& source;
+    BitLevelBus& bus;
+    uint32_t bitRate;
+    double speed;
+    int defaultNode;
+    int channel;                        // -1 until chosen or seen in the first frame
+    bool channelChosen;
+    std::unordered_map<uint32_t, int> nodesById;
+
+    bool started;
+    uint64_t firstTimestamp;
+    uint64_t startTime;                 // bus time of the first frame
+    std::chrono::steady_clock::time_point wallStart;
+    Statistics statistics;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "TransmitQueue.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+static const uint64_t NOT_INVERTED = UINT64_MAX;
+
+TransmitQueue::TransmitQueue(int mailboxCount, Order order)
+    : mailboxCount(0), order(order), sequence(0), threshold(0)
+{
+    configure(mailboxCount, order);
+}
+
+void TransmitQueue::configure(int count, Order softwareOrder)
+{
+    if (count < 0) {
+        throw std::invalid_argument("Mailbox count cannot be negative");
+    }
+    if (!entries.empty()) {
+        throw std::invalid_argument("Mailboxes can only be configured while the transmit queue is empty");
+    }
+
+    mailboxCount = count;
+    order = softwareOrder;
+}
+
+bool TransmitQueue::hasFreeMailbox() const
+{
+    return mailboxCount == 0 || static_cast<int>(mailboxes.size()) < mailboxCount;
+}
+
+bool TransmitQueue::push(uint16_t id, uint64_t key, uint64_t now)
+{
+    if (entries.count(key)) {
+        return false;
+    }
+
+    Entry& entry = entries[key];
+    entry.id = id;
+    entry.sequence = sequence++;
+    entry.inversion = 0;
+    entry.invertedSince = NOT_INVERTED;
+    statistics.frames++;
+
+    if (hasFreeMailbox()) {
+        entry.inMailbox = true;
+        mailboxes[idOrder(id, entry.sequence)] = key;
+        updateThreshold(now);
+        return true;
+    }
+
+    entry.inMailbox = false;
+    software[order == Order::Priority ? idOrder(id, entry.sequence) : entry.sequence] = key;
+    softwareById[idOrder(id, entry.sequence)] = key;
+    statistics.maxSoftwareDepth = std::max(statistics.maxSoftwareDepth, software.size());
+
+    if (id < threshold) {
+        entry.invertedSince = now;
+    }
+    return true;
+}
+
+bool TransmitQueue::remove(uint64_t key, uint64_t now, uint64_t* inversion)
+{
+    auto found = entries.find(key);
+    if (found == entries.end()) {
+        return false;
+    }
+
+    Entry& entry = found->second;
+    if (entry.inMailbox) {
+        mailboxes.erase(idOrder(entry.id, entry.sequence));
+    }
+    else {
+        stopInversion(entry, now);
+        software.erase(order == Order::Priority ? idOrder(entry.id, entry.sequence) : entry.sequence);
+        softwareById.erase(idOrder(entry.id, entry.sequence));
+    }
+
+    if (entry.inversion > 0) {
+        statistics.invertedFrames++;
+        statistics.totalInversion += entry.inversion;
+        statistics.maxInversion = std::max(statistics.maxInversion, entry.inversion);
+    }
+    if (inversion) {
+        *inversion = entry.inversion;
+    }
+
+    entries.erase(found);
+
+    fillMailboxes(now);
+    updateThreshold(now);
+    return true;
+}
+
+bool TransmitQueue::next(Frame& frame) const
+{
+    if (mailboxes.empty()) {
+        return false;
+    }
+
+    frame.key = mailboxes.begin()->second;
+    frame.id = static_cast<uint16_t>(mailboxes.begin()->first >> 48);
+    return true;
+}
+
+bool TransmitQueue::inMailbox(uint64_t key) const
+{
+    auto found = entries.find(key);
+    return found != entries.end() && found->second.inMailbox;
+}
+
+void TransmitQueue::fillMailboxes(uint64_t now)
+{
+    while (hasFreeMailbox() && !software.empty()) {
+        uint64_t key = software.begin()->second;
+        Entry& entry = entries[key];
+
+        stopInversion(entry, now);
+        software.erase(software.begin());
+        softwareById.erase(idOrder(entry.id, entry.sequence));
+
+        entry.inMailbox = true;
+        mailboxes[idOrder(entry.id, entry.sequence)] = key;
+    }
+}
+
+void TransmitQueue::stopInversion(Entry& entry, uint64_t now)
+{
+    if (entry.invertedSince != NOT_INVERTED) {
+        entry.inversion += now - entry.invertedSince;
+        entry.invertedSince = NOT_INVERTED;
+    }
+}
+
+void TransmitQueue::updateThreshold(uint64_t now)
+{
+    // Only frames whose ID lies between the old and the new lowest-priority mailbox change state
+    int updated = mailboxes.empty() ? 0 : static_cast<int>(mailboxes.rbegin()->first >> 48);
+    if (updated == threshold) {
+        return;
+    }
+
+    int low = std::min(threshold, updated);
+    int high = std::max(threshold, updated);
+    auto first = softwareById.lower_bound(idOrder(static_cast<uint16_t>(low), 0));
+    auto last = softwareById.lower_bound(idOrder(static_cast<uint16_t>(high), 0));
+
+    for (auto it = first; it != last; ++it) {
+        Entry& entry = entries[it->second];
+        if (updated > threshold) {
+            entry.invertedSince = now;
+        }
+        else {
+            stopInversion(entry, now);
+        }
+    }
+
+    threshold = updated;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef TRANSMIT_QUEUE_H
+#define TRANSMIT_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+// Transmit path of a CAN controller and its driver: a fixed number of hardware
+// mailboxes that the controller offers for arbitration lowest ID first, fed from
+// a software queue in FIFO or priority order. A frame that waits in software
+// while a mailbox holds a lower priority frame suffers priority inversion; the
+// queue measures that time per frame.
+class TransmitQueue {
+public:
+    enum class Order { Fifo, Priority };
+
+    struct Frame {
+        uint16_t id;
+        uint64_t key;                   // caller's handle for the frame, unique within the queue
+    };
+
+    struct Statistics {
+        uint64_t frames = 0;
+        uint64_t invertedFrames = 0;
+        uint64_t totalInversion = 0;
+        uint64_t maxInversion = 0;
+        size_t maxSoftwareDepth = 0;
+    };
+
+    // mailboxCount 0 gives every queued frame its own mailbox
+    explicit TransmitQueue(int mailboxCount = 0, Order order = Order::Fifo);
+
+    void configure(int mailboxCount, Order order);
+
+    bool push(uint16_t id, uint64_t key, uint64_t now);
+    bool remove(uint64_t key, uint64_t now, uint64_t* inversion = nullptr);
+
+    // Mailbox frame the controller sends next, false if nothing is queued
+    bool next(Frame& frame) const;
+    bool inMailbox(uint64_t key) const;
+    bool contains(uint64_t key) const { return entries.count(key) != 0; }
+
+    size_t size() const { return entries.size(); }
+    size_t getSoftwareDepth() const { return software.size(); }
+    int getMailboxCount() const { return mailboxCount; }
+    Order getOrder() const { return order; }
+    const Statistics& getStatistics() const { return statistics; }
+
+private:
+    friend class SimulationCheckpoint;
+
+    struct Entry {
+        uint16_t id;
+        uint64_t sequence;
+        bool inMailbox;
+        uint64_t invertedSince;
+        uint64_t inversion;
+    };
+
+    static uint64_t idOrder(uint16_t id, uint64_t sequence) { return (static_cast<uint64_t>(id) << 48) | sequence; }
+
+    bool hasFreeMailbox() const;
+    void fillMailboxes(uint64_t now);
+    void updateThreshold(uint64_t now);
+    void stopInversion(Entry& entry, uint64_t now);
+
+    int mailboxCount;
+    Order order;
+    uint64_t sequence;
+    int threshold;                                  // software frames below this ID are inverted
+
+    std::unordered_map<uint64_t, Entry> entries;
+    std::map<uint64_t, uint64_t> mailboxes;         // (ID, sequence) -> key
+    std::map<uint64_t, uint64_t> software;          // driver order -> key
+    std::map<uint64_t, uint64_t> softwareById;      // (ID, sequence) -> key
+    Statistics statistics;
+};
+
+#endif
\ No newline at end of file
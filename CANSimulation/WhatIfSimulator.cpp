@@ -0,0 +1,253 @@
+#include "WhatIfSimulator.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#include "CANBus.h"
+#include "Node.h"
+#include "SimulationCheckpoint.h"
+
+static const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+static void mix(uint64_t& hash, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * FNV_PRIME;
+    }
+}
+
+static uint64_t frameKey(const Message& message)
+{
+    return (static_cast<uint64_t>(static_cast<uint16_t>(message.getSenderId())) << 48) |
+        (static_cast<uint64_t>(static_cast<uint32_t>(message.getRound())) << 16) | message.getId();
+}
+
+static uint64_t fingerprintAt(const std::vector<uint64_t>& fingerprints, int round)
+{
+    return fingerprints[std::min(static_cast<size_t>(round), fingerprints.size() - 1)];
+}
+
+WhatIfSimulator::WhatIfSimulator(int interval)
+    : checkpointInterval(interval), finalFingerprint(0), finalRounds(0), hasRun(false)
+{
+    if (interval <= 0) {
+        throw std::invalid_argument("Checkpoint interval must be positive");
+    }
+}
+
+void WhatIfSimulator::clear()
+{
+    checkpoints.clear();
+    drops.clear();
+    hasRun = false;
+}
+
+std::vector<uint64_t> WhatIfSimulator::releaseFingerprints(const CANBus& bus)
+{
+    int lastRound = -1;
+    for (const Message& message : bus.pendingMessages) {
+        lastRound = std::max(lastRound, message.getRound());
+    }
+
+    // One digest per release round, frames in the order the engine sees them
+    std::vector<uint64_t> digests(lastRound + 1, FNV_OFFSET);
+    for (const Message& message : bus.pendingMessages) {
+        uint64_t& digest = digests[message.getRound()];
+        mix(digest, message.getSenderId());
+        mix(digest, message.getId());
+        mix(digest, bus.nodes[message.getSenderId() - 1]->nodeError);
+
+        for (int receiverId : message.getReceivers()) {
+            if (receiverId <= static_cast<int>(bus.nodes.size())) {
+                mix(digest, bus.nodes[receiverId - 1]->nodeError);
+            }
+        }
+    }
+
+    // fingerprints[r] covers every frame released before round r
+    std::vector<uint64_t> fingerprints(digests.size() + 1);
+    uint64_t fingerprint = FNV_OFFSET;
+    mix(fingerprint, bus.nodes.size());
+    for (size_t round = 0; round < digests.size(); ++round) {
+        fingerprints[round] = fingerprint;
+        mix(fingerprint, digests[round]);
+    }
+    // The last one also covers nodes without frames, whose error setting only shows in the statistics
+    for (const Node* node : bus.nodes) {
+        mix(fingerprint, node->nodeError);
+    }
+    fingerprints.back() = fingerprint;
+
+    return fingerprints;
+}
+
+std::vector<size_t> WhatIfSimulator::laterFrameCounts(const CANBus& bus)
+{
+    std::vector<size_t> counts;
+    for (const Message& message : bus.pendingMessages) {
+        if (message.getRound() >= static_cast<int>(counts.size())) {
+            counts.resize(message.getRound() + 1, 0);
+        }
+        counts[message.getRound()]++;
+    }
+
+    // counts[r] becomes the number of frames released in round r or later
+    counts.push_back(0);
+    for (size_t round = counts.size() - 1; round > 0; --round) {
+        counts[round - 1] += counts[round];
+    }
+    return counts;
+}
+
+bool WhatIfSimulator::laterFramesUntouched(const CANBus& bus, const std::vector<size_t>& laterFrames)
+{
+    size_t expected = laterFrames[std::min(static_cast<size_t>(bus.round), laterFrames.size() - 1)];
+
+    size_t pending = std::count_if(bus.pendingMessages.begin(), bus.pendingMessages.end(),
+        [&bus](const Message& message) { return message.getRound() >= bus.round; });
+
+    size_t queued = 0;
+    for (const Node* node : bus.nodes) {
+        for (const Message* message : node->getMessagesToBeSent()) {
+            queued += message->getRound() >= bus.round ? 1 : 0;
+        }
+    }
+
+    return pending == expected && queued == expected;
+}
+
+bool WhatIfSimulator::canResume(const Checkpoint& checkpoint, const CANBus& bus) const
+{
+    // A drop removes every queued frame of the identifier, later rounds included
+    std::unordered_set<uint16_t> droppedIds;
+    for (const Drop& drop : drops) {
+        if (drop.round >= checkpoint.round) {
+            break;
+        }
+        droppedIds.insert(drop.id);
+    }
+
+    for (const Message& message : bus.pendingMessages) {
+        if (message.getRound() >= checkpoint.round && droppedIds.count(message.getId())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+WhatIfSimulator::Result WhatIfSimulator::run(const ScenarioDefinition& scenario)
+{
+    for (size_t i = 0; i < scenario.nodes.size(); ++i) {
+        if (scenario.nodes[i].nodeId != static_cast<int>(i) + 1) {
+            throw std::invalid_argument("What-if runs need node ids 1 to N in order, found " +
+                std::to_string(scenario.nodes[i].nodeId) + " at position " + std::to_string(i + 1));
+        }
+    }
+
+    CANBus bus(nullptr, nullptr, CANBus::Logging::Off);
+    bus.bitStuffingVisible = false;
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    int networkSize = getNetworkSize(scenario);
+    for (const ScenarioNode& definition : scenario.nodes) {
+        nodes.emplace_back(new Node(definition.nodeId, &bus));
+        nodes.back()->setError(definition.error);
+        nodes.back()->setNodeActive(true);
+        scheduleScenarioNode(nodes.back().get(), definition, networkSize);
+        bus.nodes.push_back(nodes.back().get());
+    }
+    for (const Node* node : bus.nodes) {
+        for (const Message* message : node->getMessagesToBeSent()) {
+            bus.pendingMessages.push_back(*message);
+        }
+    }
+
+    std::vector<uint64_t> fingerprints = releaseFingerprints(bus);
+    std::vector<size_t> laterFrames = laterFrameCounts(bus);
+
+    Result result;
+    result.resumedRound = 0;
+    result.simulatedRounds = 0;
+
+    if (hasRun && fingerprints.back() == finalFingerprint && scenario.rounds == finalRounds) {
+        result.statistics = finalStatistics;
+        result.resumedRound = finalStatistics.rounds;
+        return result;
+    }
+
+    // Checkpoints stay valid as long as the frames released before them are the same
+    size_t shared = 0;
+    while (hasRun && shared < checkpoints.size() && checkpoints[shared].round <= scenario.rounds &&
+        checkpoints[shared].fingerprint == fingerprintAt(fingerprints, checkpoints[shared].round)) {
+        shared++;
+    }
+    size_t resume = shared;
+    while (resume > 0 && !canResume(checkpoints[resume - 1], bus)) {
+        resume--;
+    }
+    checkpoints.resize(resume);
+
+    if (!checkpoints.empty() && checkpoints.back().round > 0) {
+        SimulationCheckpoint::applyPrefix(bus, checkpoints.back().snapshot);
+        result.resumedRound = bus.round;
+    }
+    drops.erase(std::find_if(drops.begin(), drops.end(), [&bus](const Drop& drop) { return drop.round >= bus.round; }), drops.end());
+
+    bool messagesPending;
+    std::vector<uint64_t> pendingBefore;
+    do {
+        messagesPending = true;
+
+        if (bus.round % checkpointInterval == 0 && (checkpoints.empty() || checkpoints.back().round < bus.round) &&
+            laterFramesUntouched(bus, laterFrames)) {
+            checkpoints.push_back({ bus.round, fingerprintAt(fingerprints, bus.round), SimulationCheckpoint::capture(bus) });
+        }
+
+        pendingBefore.clear();
+        for (const Message& message : bus.pendingMessages) {
+            pendingBefore.push_back(frameKey(message));
+        }
+        int dropped = bus.statistics.droppedFrames;
+
+        bool success = bus.arbitrate();
+        result.simulatedRounds++;
+
+        if (bus.statistics.droppedFrames != dropped) {
+            std::unordered_set<uint64_t> remaining;
+            for (const Message& message : bus.pendingMessages) {
+                remaining.insert(frameKey(message));
+            }
+            for (uint64_t key : pendingBefore) {
+                if (!remaining.count(key)) {
+                    drops.push_back({ bus.round, static_cast<uint16_t>(key & 0xFFFF) });
+                    break;
+                }
+            }
+        }
+
+        if (!bus.hasPendingMessages()) {
+            messagesPending = false;
+        }
+
+        if (success)
+            bus.incrementRound();
+
+        if (bus.round > scenario.rounds) {
+            messagesPending = false;
+        }
+
+    } while (messagesPending);
+
+    result.statistics = bus.getStatistics();
+
+    finalFingerprint = fingerprints.back();
+    finalRounds = scenario.rounds;
+    finalStatistics = result.statistics;
+    hasRun = true;
+
+    return result;
+}
\ No newline at end of file
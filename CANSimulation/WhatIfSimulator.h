@@ -0,0 +1,62 @@
+#ifndef WHAT_IF_SIMULATOR_H
+#define WHAT_IF_SIMULATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Scenario.h"
+#include "SimulationStatistics.h"
+
+class CANBus;
+
+// Runs scenarios on the round-based engine without a window and reuses the previous run
+// for the next one. Every few rounds a checkpoint is kept together with a fingerprint of
+// all frames released before that round, including the error settings of their sender and
+// receivers; the state of the bus at a round follows from exactly those. A modified
+// scenario resumes from the last checkpoint whose fingerprint it shares and only the
+// remaining rounds are simulated. A checkpoint is only kept while no frame of a later round
+// has been touched, and skipped on resume when a later frame of the new scenario would have
+// been dropped together with an earlier one of the same identifier.
+class WhatIfSimulator {
+public:
+    struct Result {
+        SimulationStatistics statistics;
+        int resumedRound;               // round the run was restored at, 0 when simulated from the start
+        int simulatedRounds;
+    };
+
+    explicit WhatIfSimulator(int checkpointInterval = 5);
+
+    // Node ids have to be 1 to N in order, as the engine addresses nodes by id
+    Result run(const ScenarioDefinition& scenario);
+
+    // Forgets the previous run, the next one starts from round 0
+    void clear();
+
+private:
+    struct Checkpoint {
+        int round;
+        uint64_t fingerprint;
+        std::vector<uint8_t> snapshot;
+    };
+
+    struct Drop {
+        int round;
+        uint16_t id;
+    };
+
+    static std::vector<uint64_t> releaseFingerprints(const CANBus& bus);
+    static std::vector<size_t> laterFrameCounts(const CANBus& bus);
+    static bool laterFramesUntouched(const CANBus& bus, const std::vector<size_t>& laterFrames);
+    bool canResume(const Checkpoint& checkpoint, const CANBus& bus) const;
+
+    int checkpointInterval;
+    std::vector<Checkpoint> checkpoints;
+    std::vector<Drop> drops;                // frames dropped without an active receiver, in round order
+    uint64_t finalFingerprint;
+    int finalRounds;
+    SimulationStatistics finalStatistics;
+    bool hasRun;
+};
+
+#endif
\ No newline at end of file
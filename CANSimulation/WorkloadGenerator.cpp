@@ -0,0 +1,209 @@
+#include "WorkloadGenerator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "BitFrame.h"
+
+static const int INTERMISSION_BITS = 3;
+
+WorkloadGenerator::WorkloadGenerator(const Profile& profile)
+    : profile(profile), expectedLoad(0.0), scheduler(profile.seed), releaseIndex(0),
+    burstId(0), burstLength(0), burstRemaining(0), burstTime(0), end(0), generator(profile.seed)
+{
+    if (profile.busLoad <= 0.0 || profile.busLoad > 1.0) {
+        throw std::invalid_argument("Bus load must be between 0 and 1");
+    }
+    if (profile.bitRate == 0 || profile.duration <= 0.0 || profile.nodes < 1) {
+        throw std::invalid_argument("Workload needs a bit rate, a duration and at least one node");
+    }
+    if (profile.minId > profile.maxId || profile.maxId > 0x7FF) {
+        throw std::invalid_argument("Invalid identifier range");
+    }
+    if (profile.periods.empty()) {
+        throw std::invalid_argument("Workload needs at least one period class");
+    }
+    for (const PeriodClass& periodClass : profile.periods) {
+        if (periodClass.period <= 0.0 || periodClass.weight <= 0.0) {
+            throw std::invalid_argument("Period classes need a positive period and weight");
+        }
+    }
+    if (profile.minDataLength < 0 || profile.minDataLength > profile.maxDataLength || profile.maxDataLength > 8) {
+        throw std::invalid_argument("Invalid data length range");
+    }
+    if (profile.jitter < 0.0 || profile.jitter >= 1.0) {
+        throw std::invalid_argument("Jitter must be a share of the period below 1");
+    }
+    if (profile.burstProbability < 0.0 || profile.burstProbability > 1.0 || profile.burstLength < 0) {
+        throw std::invalid_argument("Invalid burst pattern");
+    }
+    if (profile.faultyNodes < 0.0 || profile.faultyNodes > 1.0) {
+        throw std::invalid_argument("Faulty node share must be between 0 and 1");
+    }
+
+    buildStreams();
+    buildFaults();
+    restart();
+}
+
+void WorkloadGenerator::buildStreams()
+{
+    struct Stream {
+        double period;
+        int dataLength;
+    };
+
+    std::vector<double> weights;
+    for (const PeriodClass& periodClass : profile.periods) {
+        weights.push_back(periodClass.weight);
+    }
+    std::discrete_distribution<size_t> pickPeriod(weights.begin(), weights.end());
+    std::uniform_int_distribution<int> pickLength(profile.minDataLength, profile.maxDataLength);
+
+    // Every stream needs its own identifier, so the range caps the load that can be reached
+    size_t idCount = static_cast<size_t>(profile.maxId - profile.minId) + 1;
+    double burstFactor = 1.0 + profile.burstProbability * profile.burstLength;
+
+    std::vector<Stream> streams;
+    while (expectedLoad < profile.busLoad && streams.size() < idCount) {
+        Stream stream;
+        stream.period = profile.periods[pickPeriod(generator)].period;
+        stream.dataLength = pickLength(generator);
+
+        std::vector<uint8_t> sample(stream.dataLength);
+        for (uint8_t& byte : sample) {
+            byte = static_cast<uint8_t>(generator());
+        }
+        size_t bits = encodeFrame(0x2AA, sample).bits.size() + INTERMISSION_BITS;
+
+        expectedLoad += bits * burstFactor / (stream.period / 1000.0 * profile.bitRate);
+        streams.push_back(stream);
+    }
+
+    std::vector<uint16_t> ids(idCount);
+    std::iota(ids.begin(), ids.end(), profile.minId);
+    std::shuffle(ids.begin(), ids.end(), generator);
+    ids.resize(streams.size());
+
+    if (profile.idAssignment == IdAssignment::RateMonotonic) {
+        std::sort(ids.begin(), ids.end());
+        std::stable_sort(streams.begin(), streams.end(),
+            [](const Stream& a, const Stream& b) { return a.period < b.period; });
+    }
+
+    scenario = ScenarioDefinition();
+    scenario.name = "Workload " + std::to_string(profile.seed);
+    scenario.bitRate = profile.bitRate;
+    scenario.duration = profile.duration;
+    for (int id = 1; id <= profile.nodes; ++id) {
+        ScenarioNode node;
+        node.nodeId = id;
+        node.error = false;
+        scenario.nodes.push_back(node);
+    }
+
+    std::uniform_int_distribution<int> pickNode(0, profile.nodes - 1);
+    for (size_t i = 0; i < streams.size(); ++i) {
+        // Offsets spread the first releases over the period, in whole microseconds
+        uint64_t periodMicroseconds = PeriodicScheduler::milliseconds(streams[i].period);
+        uint64_t offset = std::uniform_int_distribution<uint64_t>(0, periodMicroseconds - 1)(generator);
+
+        ScenarioMessage message;
+        message.id = ids[i];
+        message.dataLength = streams[i].dataLength;
+        message.period = streams[i].period;
+        message.offset = offset / 1000.0;
+        message.jitter = streams[i].period * profile.jitter;
+
+        scenario.nodes[pickNode(generator)].periodicMessages.push_back(message);
+    }
+}
+
+void WorkloadGenerator::buildFaults()
+{
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    for (ScenarioNode& node : scenario.nodes) {
+        if (uniform(generator) < profile.faultyNodes) {
+            node.transmitBitErrorRate = profile.transmitBitErrorRate;
+            node.receiveBitErrorRate = profile.receiveBitErrorRate;
+        }
+    }
+}
+
+void WorkloadGenerator::restart()
+{
+    scheduler = PeriodicScheduler(profile.seed);
+    for (const ScenarioNode& node : scenario.nodes) {
+        for (const ScenarioMessage& message : node.periodicMessages) {
+            PeriodicScheduler::PeriodicMessage periodic;
+            periodic.node = node.nodeId - 1;
+            periodic.id = message.id;
+            periodic.data = std::vector<uint8_t>(message.dataLength, 0);
+            periodic.period = PeriodicScheduler::milliseconds(message.period);
+            periodic.offset = PeriodicScheduler::milliseconds(message.offset);
+            periodic.jitter = PeriodicScheduler::milliseconds(message.jitter);
+            scheduler.addMessage(periodic);
+        }
+    }
+
+    releases.clear();
+    releaseIndex = 0;
+    burstRemaining = 0;
+    end = PeriodicScheduler::milliseconds(profile.duration);
+
+    // Payloads and bursts come from their own sequence so restarting repeats them exactly
+    generator.seed(profile.seed ^ 0x9E3779B97F4A7C15ULL);
+}
+
+bool WorkloadGenerator::next(TraceFrame& frame)
+{
+    frame.channel = 0;
+    frame.extended = false;
+    frame.remote = false;
+
+    if (burstRemaining > 0) {
+        burstRemaining--;
+        frame.timestamp = burstTime;
+        frame.id = burstId;
+        frame.length = burstLength;
+        fillPayload(frame);
+        return true;
+    }
+
+    // The next wheel event can be a cascade without any release, so poll until one comes out
+    while (releaseIndex == releases.size()) {
+        releases.clear();
+        releaseIndex = 0;
+
+        uint64_t time = scheduler.nextReleaseTime();
+        if (time >= end) {
+            return false;
+        }
+        scheduler.releaseUntil(time, releases);
+    }
+
+    const PeriodicScheduler::Release& release = releases[releaseIndex++];
+    frame.timestamp = release.time;
+    frame.id = release.id;
+    frame.length = static_cast<uint8_t>(scheduler.getMessage(release.stream).data.size());
+    fillPayload(frame);
+
+    if (profile.burstLength > 0 && profile.burstProbability > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(generator) < profile.burstProbability) {
+        burstRemaining = profile.burstLength;
+        burstId = release.id;
+        burstLength = frame.length;
+        burstTime = release.time;
+    }
+    return true;
+}
+
+void WorkloadGenerator::fillPayload(TraceFrame& frame)
+{
+    uint64_t random = generator();
+    std::memcpy(frame.data, &random, sizeof(frame.data));
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef WORKLOAD_GENERATOR_H
+#define WORKLOAD_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "FrameSource.h"
+#include "PeriodicScheduler.h"
+#include "Scenario.h"
+
+// Synthetic bus workload built from a seed: periodic streams are added until their frames
+// fill the requested share of the bus, and the generator then produces those frames in time
+// order, with optional bursts, one at a time. The same profile and seed always give the
+// same scenario and the same frames.
+class WorkloadGenerator : public FrameSource {
+public:
+    enum class IdAssignment {
+        Random,                         // identifiers drawn uniformly from the range
+        RateMonotonic                   // shorter periods get lower identifiers, as on most real networks
+    };
+
+    struct PeriodClass {
+        double period;                  // milliseconds
+        double weight;
+    };
+
+    struct Profile {
+        uint64_t seed = 0;
+        uint32_t bitRate = 500000;
+        double busLoad = 0.5;           // share of bus time carrying frames, 0 to 1
+        double duration = 1000.0;       // milliseconds of traffic to generate
+        int nodes = 16;
+
+        IdAssignment idAssignment = IdAssignment::RateMonotonic;
+        uint16_t minId = 0;
+        uint16_t maxId = 0x7FF;
+        std::vector<PeriodClass> periods = { {10, 1}, {20, 2}, {50, 2}, {100, 4}, {1000, 1} };
+        int minDataLength = 0;
+        int maxDataLength = 8;
+        double jitter = 0.0;            // share of the period each release may be delayed by
+
+        double burstProbability = 0.0;  // chance that a release is followed by a burst
+        int burstLength = 4;            // extra frames of the same identifier sent back to back
+
+        double faultyNodes = 0.0;       // share of nodes given the bit error rates below
+        double transmitBitErrorRate = 0.0;
+        double receiveBitErrorRate = 0.0;
+    };
+
+    explicit WorkloadGenerator(const Profile& profile);
+
+    // Scenario holding the periodic streams and fault profiles, ready for applyScenario or a file
+    const ScenarioDefinition& getScenario() const { return scenario; }
+
+    // Load the streams are expected to put on the bus, bursts included
+    double getExpectedLoad() const { return expectedLoad; }
+
+    bool next(TraceFrame& frame) override;
+
+    // Starts the frame stream over from the beginning
+    void restart();
+
+private:
+    void buildStreams();
+    void buildFaults();
+    void fillPayload(TraceFrame& frame);
+
+    Profile profile;
+    ScenarioDefinition scenario;
+    double expectedLoad;
+
+    PeriodicScheduler scheduler;
+    std::vector<PeriodicScheduler::Release> releases;
+    size_t releaseIndex;
+    uint16_t burstId;
+    uint8_t burstLength;
+    int burstRemaining;
+    uint64_t burstTime;
+    uint64_t end;
+    std::mt19937_64 generator;
+};
+
+#endif
\ No newline at end of file
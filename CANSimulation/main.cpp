@@ -1,10 +1,53 @@
-#include "CANSim.h"
-#include <QtWidgets/QApplication>
-
-int main(int argc, char *argv[])
-{
-    QApplication a(argc, argv);
-    CANSim w;
-    w.show();
-    return a.exec();
-}
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include <QtWidgets/QApplication>
+#include <QCommandLineParser>
+#include <QMessageBox>
+
+#include "CANSim.h"
+#include "CANBus.h"
+#include "BinaryLogWriter.h"
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    // Unattended runs write a compact binary log instead of log.txt, CANTools renders it back to text
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption binaryLogOption("binary-log", "Write the log in binary to files named <base>-<time>.canlog.", "base");
+    QCommandLineOption maxSizeOption("log-max-size", "Start a new binary log file after <MB> megabytes.", "MB", "64");
+    QCommandLineOption maxAgeOption("log-max-age", "Start a new binary log file after <minutes> minutes.", "minutes", "60");
+    QCommandLineOption maxFilesOption("log-max-files", "Keep only the newest <count> binary log files, 0 keeps all.", "count", "48");
+    parser.addOptions({ binaryLogOption, maxSizeOption, maxAgeOption, maxFilesOption });
+    parser.process(a);
+
+    std::unique_ptr<BinaryLogWriter> binaryLog;
+    if (parser.isSet(binaryLogOption)) {
+        BinaryLogWriter::Settings settings;
+        settings.basePath = parser.value(binaryLogOption).toStdString();
+        settings.maxFileSize = static_cast<uint64_t>(std::max(1, parser.value(maxSizeOption).toInt())) * 1024 * 1024;
+        settings.maxFileAge = std::chrono::minutes(std::max(1, parser.value(maxAgeOption).toInt()));
+        settings.maxFiles = std::max(0, parser.value(maxFilesOption).toInt());
+
+        try {
+            binaryLog = std::make_unique<BinaryLogWriter>(settings);
+            CANBus::setBinaryLog(binaryLog.get());
+        }
+        catch (const std::invalid_argument& e) {
+            QMessageBox::warning(nullptr, "Binary Log", QString("%1\nThe text log is used instead.").arg(e.what()));
+        }
+    }
+
+    int result;
+    {
+        CANSim w;
+        w.show();
+        result = a.exec();
+    }
+
+    CANBus::setBinaryLog(nullptr);
+    return result;
+}
\ No newline at end of file